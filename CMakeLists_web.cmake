@@ -22,8 +22,12 @@ set(CMAKE_EXECUTABLE_SUFFIX ".html")
 set(CAFE_WEB_SOURCES
     src/main.cpp
     src/engine/game_loop.cpp
+    src/engine/frame_pacer.cpp
+    src/engine/input_recorder.cpp
+    src/engine/render_stats.cpp
     src/platform/web/web_platform.cpp
     src/renderer/webgl/webgl_renderer.cpp
+    src/audio/web/web_audio.cpp
 )
 
 add_executable(cafe_engine ${CAFE_WEB_SOURCES})
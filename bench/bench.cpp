@@ -0,0 +1,344 @@
+#include "bench.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <thread>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#endif
+
+#ifndef CAFE_BENCH_BUILD_TYPE
+#define CAFE_BENCH_BUILD_TYPE ""
+#endif
+
+namespace cafe::bench {
+
+// ============================================================================
+// Registry
+// ============================================================================
+
+namespace {
+
+struct Benchmark {
+    std::string name;
+    BenchmarkFn fn;
+    std::vector<int64_t> args;
+};
+
+// Function-local static avoids static initialization order issues
+std::vector<Benchmark>& registry() {
+    static std::vector<Benchmark> benchmarks;
+    return benchmarks;
+}
+
+struct Options {
+    std::string filter;
+    double min_time = 0.5;  // Seconds per benchmark
+    int repetitions = 1;
+    std::string json_path;
+};
+
+constexpr const char* kUsage =
+    "Usage: %s [--filter=substring] [--min-time=seconds] [--repetitions=n] [--json=path]\n";
+
+Options parse_options(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        if (std::strncmp(arg, "--filter=", 9) == 0) {
+            options.filter = arg + 9;
+        } else if (std::strncmp(arg, "--min-time=", 11) == 0) {
+            options.min_time = std::atof(arg + 11);
+        } else if (std::strncmp(arg, "--repetitions=", 14) == 0) {
+            options.repetitions = std::max(1, std::atoi(arg + 14));
+        } else if (std::strncmp(arg, "--json=", 7) == 0) {
+            options.json_path = arg + 7;
+        } else {
+            std::fprintf(stderr, "Unknown option: %s\n", arg);
+            std::fprintf(stderr, kUsage, argv[0]);
+            std::exit(1);
+        }
+    }
+    return options;
+}
+
+// Run with growing iteration counts until the run is long enough to trust
+State run_one(const Benchmark& bench, int64_t arg, double min_time) {
+    int64_t iterations = 1;
+    while (true) {
+        State state(iterations, arg);
+        bench.fn(state);
+
+        double elapsed = state.elapsed_seconds();
+        if (elapsed >= min_time || iterations >= 1000000000) {
+            return state;
+        }
+
+        // Predict the count needed, growing at most 10x per step
+        double scale = elapsed > 0.0 ? (min_time * 1.4) / elapsed : 10.0;
+        scale = std::clamp(scale, 2.0, 10.0);
+        iterations = static_cast<int64_t>(static_cast<double>(iterations) * scale);
+    }
+}
+
+std::string display_name(const Benchmark& bench, int64_t arg) {
+    if (bench.args.empty()) return bench.name;
+    return bench.name + "/" + std::to_string(arg);
+}
+
+// One line of output: a single run, or an aggregate over repetitions
+struct Result {
+    std::string name;               // "bm_x/64", "bm_x/64_median"
+    std::string run_name;           // "bm_x/64"
+    std::string aggregate;          // "", "mean", "median", "stddev"
+    int repetition = 0;
+    int64_t iterations = 0;
+    double ns_per_iter = 0.0;
+    double items_per_second = 0.0;
+    double bytes_per_second = 0.0;
+    std::map<std::string, double> counters;
+};
+
+Result make_result(const std::string& name, const State& state, int repetition) {
+    double seconds = state.elapsed_seconds();
+    Result result;
+    result.name = name;
+    result.run_name = name;
+    result.repetition = repetition;
+    result.iterations = state.iterations();
+    result.ns_per_iter = seconds * 1e9 / static_cast<double>(state.iterations());
+    if (seconds > 0.0) {
+        result.items_per_second = static_cast<double>(state.items_processed()) / seconds;
+        result.bytes_per_second = static_cast<double>(state.bytes_processed()) / seconds;
+    }
+    result.counters = state.counters();
+    return result;
+}
+
+// Mean, median and standard deviation of every number across repetitions
+std::vector<Result> aggregate(const std::vector<Result>& runs) {
+    auto mean = [](std::vector<double> v) {
+        double sum = 0.0;
+        for (double x : v) sum += x;
+        return sum / static_cast<double>(v.size());
+    };
+    auto median = [](std::vector<double> v) {
+        std::sort(v.begin(), v.end());
+        size_t mid = v.size() / 2;
+        return v.size() % 2 ? v[mid] : 0.5 * (v[mid - 1] + v[mid]);
+    };
+    auto stddev = [&](std::vector<double> v) {
+        double m = mean(v), sum = 0.0;
+        for (double x : v) sum += (x - m) * (x - m);
+        return v.size() > 1 ? std::sqrt(sum / static_cast<double>(v.size() - 1)) : 0.0;
+    };
+
+    std::vector<Result> out;
+    for (const char* kind : {"mean", "median", "stddev"}) {
+        std::string which = kind;
+        auto apply = [&](auto field) {
+            std::vector<double> values;
+            for (const Result& run : runs) values.push_back(field(run));
+            return which == "mean" ? mean(values) : which == "median" ? median(values) : stddev(values);
+        };
+
+        Result result;
+        result.run_name = runs.front().run_name;
+        result.name = result.run_name + "_" + which;
+        result.aggregate = which;
+        result.iterations = static_cast<int64_t>(runs.size());
+        result.ns_per_iter = apply([](const Result& r) { return r.ns_per_iter; });
+        result.items_per_second = apply([](const Result& r) { return r.items_per_second; });
+        result.bytes_per_second = apply([](const Result& r) { return r.bytes_per_second; });
+        for (const auto& entry : runs.front().counters) {
+            const std::string& counter = entry.first;
+            result.counters[counter] = apply([&](const Result& r) {
+                auto it = r.counters.find(counter);
+                return it != r.counters.end() ? it->second : 0.0;
+            });
+        }
+        out.push_back(std::move(result));
+    }
+    return out;
+}
+
+void print_result(const Result& result) {
+    std::printf("%-48s %14.1f ns %12lld", result.name.c_str(), result.ns_per_iter,
+                static_cast<long long>(result.iterations));
+
+    if (result.items_per_second > 0.0) {
+        std::printf("  %10.2f M items/s", result.items_per_second / 1e6);
+    }
+    if (result.bytes_per_second > 0.0) {
+        std::printf("  %10.2f MB/s", result.bytes_per_second / 1e6);
+    }
+    for (const auto& [counter, value] : result.counters) {
+        std::printf("  %s=%g", counter.c_str(), value);
+    }
+    std::printf("\n");
+}
+
+// ============================================================================
+// JSON Output
+// ============================================================================
+//
+// The layout of Google Benchmark's --benchmark_format=json, so its tools
+// read it too: a "context" object describing the machine and build, then
+// one entry per run (run_type "iteration") and, with --repetitions, per
+// aggregate (run_type "aggregate"). Times are real (wall clock) ns.
+// scripts/compare_bench.py diffs two of these files.
+
+bool is_optimized_build() {
+    std::string type = CAFE_BENCH_BUILD_TYPE;
+    return type == "Release" || type == "RelWithDebInfo" || type == "MinSizeRel";
+}
+
+std::string json_string(const std::string& text) {
+    std::string out = "\"";
+    for (char c : text) {
+        if (c == '"' || c == '\\') out += '\\';
+        out += c;
+    }
+    return out + "\"";
+}
+
+// %g, but JSON has no inf/nan
+std::string json_number(double value) {
+    if (!std::isfinite(value)) return "0";
+    char text[32];
+    std::snprintf(text, sizeof(text), "%.6g", value);
+    return text;
+}
+
+bool write_json(const std::string& path, const char* executable, const Options& options,
+                const std::vector<Result>& results) {
+    FILE* file = std::fopen(path.c_str(), "w");
+    if (!file) {
+        std::fprintf(stderr, "Failed to create file: %s\n", path.c_str());
+        return false;
+    }
+
+    char date[64] = "";
+    std::time_t now = std::time(nullptr);
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+    char host[256] = "unknown";
+#if defined(__unix__) || defined(__APPLE__)
+    if (gethostname(host, sizeof(host)) != 0) std::strcpy(host, "unknown");
+    host[sizeof(host) - 1] = '\0';
+#endif
+    std::string build_type = CAFE_BENCH_BUILD_TYPE;
+
+    std::fprintf(file, "{\n  \"context\": {\n");
+    std::fprintf(file, "    \"date\": %s,\n", json_string(date).c_str());
+    std::fprintf(file, "    \"host_name\": %s,\n", json_string(host).c_str());
+    std::fprintf(file, "    \"executable\": %s,\n", json_string(executable).c_str());
+    std::fprintf(file, "    \"num_cpus\": %u,\n", std::thread::hardware_concurrency());
+    std::fprintf(file, "    \"build_type\": %s,\n", json_string(build_type.empty() ? "none" : build_type).c_str());
+    std::fprintf(file, "    \"library_build_type\": \"%s\",\n", is_optimized_build() ? "release" : "debug");
+    std::fprintf(file, "    \"min_time\": %s,\n", json_number(options.min_time).c_str());
+    std::fprintf(file, "    \"repetitions\": %d\n", options.repetitions);
+    std::fprintf(file, "  },\n  \"benchmarks\": [");
+
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result& result = results[i];
+        std::fprintf(file, "%s\n    {\n", i > 0 ? "," : "");
+        std::fprintf(file, "      \"name\": %s,\n", json_string(result.name).c_str());
+        std::fprintf(file, "      \"run_name\": %s,\n", json_string(result.run_name).c_str());
+        if (result.aggregate.empty()) {
+            std::fprintf(file, "      \"run_type\": \"iteration\",\n");
+            std::fprintf(file, "      \"repetitions\": %d,\n", options.repetitions);
+            std::fprintf(file, "      \"repetition_index\": %d,\n", result.repetition);
+        } else {
+            std::fprintf(file, "      \"run_type\": \"aggregate\",\n");
+            std::fprintf(file, "      \"aggregate_name\": %s,\n", json_string(result.aggregate).c_str());
+            std::fprintf(file, "      \"repetitions\": %d,\n", options.repetitions);
+        }
+        std::fprintf(file, "      \"iterations\": %lld,\n", static_cast<long long>(result.iterations));
+        std::fprintf(file, "      \"real_time\": %s,\n", json_number(result.ns_per_iter).c_str());
+        if (result.items_per_second > 0.0) {
+            std::fprintf(file, "      \"items_per_second\": %s,\n", json_number(result.items_per_second).c_str());
+        }
+        if (result.bytes_per_second > 0.0) {
+            std::fprintf(file, "      \"bytes_per_second\": %s,\n", json_number(result.bytes_per_second).c_str());
+        }
+        for (const auto& [counter, value] : result.counters) {
+            std::fprintf(file, "      %s: %s,\n", json_string(counter).c_str(), json_number(value).c_str());
+        }
+        std::fprintf(file, "      \"time_unit\": \"ns\"\n    }");
+    }
+    std::fprintf(file, "\n  ]\n}\n");
+
+    bool ok = std::ferror(file) == 0;
+    ok = (std::fclose(file) == 0) && ok;
+    if (!ok) {
+        std::fprintf(stderr, "Failed to write file: %s\n", path.c_str());
+    }
+    return ok;
+}
+
+} // namespace
+
+bool register_benchmark(const char* name, BenchmarkFn fn, std::vector<int64_t> args) {
+    registry().push_back({name, fn, std::move(args)});
+    return true;
+}
+
+int run_benchmarks(int argc, char** argv) {
+    Options options = parse_options(argc, argv);
+
+    if (!is_optimized_build()) {
+        std::fprintf(stderr, "Warning: cafe_bench was built without optimizations (CMAKE_BUILD_TYPE=%s); "
+                             "configure with -DCMAKE_BUILD_TYPE=Release for meaningful numbers\n",
+                     CAFE_BENCH_BUILD_TYPE);
+    }
+
+    auto& benchmarks = registry();
+    std::sort(benchmarks.begin(), benchmarks.end(),
+              [](const Benchmark& a, const Benchmark& b) { return a.name < b.name; });
+
+    std::printf("%-48s %17s %12s\n", "Benchmark", "Time", "Iterations");
+    std::printf("%s\n", std::string(80, '-').c_str());
+
+    std::vector<Result> results;
+    for (const auto& bench : benchmarks) {
+        std::vector<int64_t> args = bench.args;
+        if (args.empty()) args.push_back(0);
+
+        for (int64_t arg : args) {
+            std::string name = display_name(bench, arg);
+            if (!options.filter.empty() && name.find(options.filter) == std::string::npos) {
+                continue;
+            }
+
+            std::vector<Result> runs;
+            for (int repetition = 0; repetition < options.repetitions; ++repetition) {
+                State state = run_one(bench, arg, options.min_time);
+                runs.push_back(make_result(name, state, repetition));
+                print_result(runs.back());
+            }
+            results.insert(results.end(), runs.begin(), runs.end());
+
+            if (runs.size() > 1) {
+                for (const Result& result : aggregate(runs)) {
+                    print_result(result);
+                    results.push_back(result);
+                }
+            }
+        }
+    }
+
+    if (!options.json_path.empty() && !write_json(options.json_path, argv[0], options, results)) {
+        return 1;
+    }
+    return 0;
+}
+
+} // namespace cafe::bench
+
+int main(int argc, char** argv) {
+    return cafe::bench::run_benchmarks(argc, argv);
+}
@@ -0,0 +1,118 @@
+#ifndef CAFE_BENCH_H
+#define CAFE_BENCH_H
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace cafe::bench {
+
+// ============================================================================
+// Minimal Benchmark Harness
+// ============================================================================
+//
+// A tiny Google-Benchmark-style runner so hot paths can be measured without
+// pulling in a third-party dependency.
+//
+// Usage:
+//   static void bm_something(cafe::bench::State& state) {
+//       Setup setup(state.arg());           // Not timed
+//       while (state.keep_running()) {      // Timed loop
+//           cafe::bench::do_not_optimize(work(setup));
+//       }
+//       state.set_items_processed(state.iterations() * items_per_iteration);
+//   }
+//   CAFE_BENCHMARK(bm_something, 256, 1024);  // Optional argument list
+//
+// The runner grows the iteration count until a run lasts at least the
+// minimum time, then reports time per iteration.
+//
+// Command line:
+//   --filter=substring   only benchmarks whose name contains it
+//   --min-time=seconds   minimum run time (default 0.5)
+//   --repetitions=n      run each n times, add mean/median/stddev rows
+//   --json=path          also write results as JSON (Google Benchmark's
+//                        layout); compare two with scripts/compare_bench.py
+// ============================================================================
+
+using Clock = std::chrono::steady_clock;
+
+class State {
+public:
+    State(int64_t max_iterations, int64_t arg)
+        : max_iterations_(max_iterations), arg_(arg) {}
+
+    // Returns true while more iterations should run; timing starts on the
+    // first call and stops when it returns false
+    bool keep_running() {
+        if (!started_) {
+            started_ = true;
+            start_ = Clock::now();
+        }
+        if (iterations_ < max_iterations_) {
+            ++iterations_;
+            return true;
+        }
+        elapsed_ += Clock::now() - start_;
+        return false;
+    }
+
+    // Exclude setup work inside the timed loop
+    void pause_timing() { elapsed_ += Clock::now() - start_; }
+    void resume_timing() { start_ = Clock::now(); }
+
+    int64_t arg() const { return arg_; }
+    int64_t iterations() const { return iterations_; }
+    double elapsed_seconds() const { return std::chrono::duration<double>(elapsed_).count(); }
+
+    // Throughput reporting
+    void set_items_processed(int64_t items) { items_processed_ = items; }
+    void set_bytes_processed(int64_t bytes) { bytes_processed_ = bytes; }
+    int64_t items_processed() const { return items_processed_; }
+    int64_t bytes_processed() const { return bytes_processed_; }
+
+    // Arbitrary named values printed next to the timing (e.g. "tiles")
+    void set_counter(const std::string& name, double value) { counters_[name] = value; }
+    const std::map<std::string, double>& counters() const { return counters_; }
+
+private:
+    int64_t max_iterations_;
+    int64_t arg_;
+    int64_t iterations_ = 0;
+    bool started_ = false;
+    Clock::time_point start_;
+    Clock::duration elapsed_{};
+    int64_t items_processed_ = 0;
+    int64_t bytes_processed_ = 0;
+    std::map<std::string, double> counters_;
+};
+
+using BenchmarkFn = void (*)(State&);
+
+// Register a benchmark (called by CAFE_BENCHMARK at static init time)
+bool register_benchmark(const char* name, BenchmarkFn fn, std::vector<int64_t> args);
+
+// Run all registered benchmarks whose name contains filter
+int run_benchmarks(int argc, char** argv);
+
+// Prevent the compiler from discarding a computed value
+template<typename T>
+inline void do_not_optimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// Force pending writes to memory
+inline void clobber_memory() {
+    asm volatile("" : : : "memory");
+}
+
+} // namespace cafe::bench
+
+#define CAFE_BENCHMARK(fn, ...) \
+    [[maybe_unused]] static const bool cafe_bench_registered_##fn = \
+        ::cafe::bench::register_benchmark(#fn, fn, {__VA_ARGS__})
+
+#endif // CAFE_BENCH_H
@@ -0,0 +1,136 @@
+#include "bench.h"
+#include "engine/animation.h"
+#include "engine/sprite_sheet.h"
+#include <string>
+#include <vector>
+
+// ============================================================================
+// Animating 100k customers: name lookups vs cached players vs AnimationSystem
+// ============================================================================
+//
+// Every benchmark advances 100,000 customers by one 60 Hz frame and reads
+// each customer's current UV rect, like a sprite batch would. Customers
+// are spread across five animations with staggered start times.
+//
+//   by_name  SpriteSheet string API each frame (what AnimationPlayer did)
+//   player   AnimationPlayer objects (animation pointer cached on play)
+//   system   AnimationSystem::update_all() + frames() / regions()
+
+namespace {
+
+constexpr int kCustomers = 100000;
+constexpr float kDt = 1.0f / 60.0f;
+
+const char* const kAnimations[] = {"idle", "walk", "sit", "order", "eat"};
+constexpr int kAnimationCount = 5;
+
+cafe::SpriteSheet& customer_sheet() {
+    static cafe::SpriteSheet sheet = [] {
+        cafe::SpriteSheet s;
+        s.set_texture(1, 512, 512);  // Fake handle: no renderer needed
+        s.define_grid(32, 32);        // 256 frames
+        s.define_animation("idle", 0, 3, 0.25f);
+        s.define_animation("walk", 16, 23, 0.1f);
+        s.define_animation("sit", 32, 33, 0.5f);
+        s.define_animation("order", 48, 53, 0.15f, false);
+        s.define_animation("eat", 64, 69, 0.2f);
+        return s;
+    }();
+    return sheet;
+}
+
+float start_time(int customer) {
+    return static_cast<float>(customer % 97) * 0.037f;
+}
+
+void bm_animation_by_name(cafe::bench::State& state) {
+    const cafe::SpriteSheet& sheet = customer_sheet();
+    std::vector<std::string> names(kCustomers);
+    std::vector<float> elapsed(kCustomers);
+    for (int i = 0; i < kCustomers; ++i) {
+        names[i] = kAnimations[i % kAnimationCount];
+        elapsed[i] = start_time(i);
+    }
+
+    while (state.keep_running()) {
+        float u_sum = 0.0f;
+        for (int i = 0; i < kCustomers; ++i) {
+            elapsed[i] += kDt;
+            const cafe::Animation* anim = sheet.animation(names[i]);
+            if (anim && !anim->looping && elapsed[i] >= anim->total_duration()) {
+                elapsed[i] = anim->total_duration();
+            }
+            u_sum += sheet.animation_frame(names[i], elapsed[i]).u0;
+        }
+        cafe::bench::do_not_optimize(u_sum);
+    }
+    state.set_items_processed(state.iterations() * kCustomers);
+}
+CAFE_BENCHMARK(bm_animation_by_name);
+
+void bm_animation_player(cafe::bench::State& state) {
+    const cafe::SpriteSheet& sheet = customer_sheet();
+    std::vector<cafe::AnimationPlayer> players(kCustomers, cafe::AnimationPlayer(&sheet));
+    for (int i = 0; i < kCustomers; ++i) {
+        players[i].play(kAnimations[i % kAnimationCount]);
+        players[i].update(start_time(i));
+    }
+
+    while (state.keep_running()) {
+        float u_sum = 0.0f;
+        for (auto& player : players) {
+            player.update(kDt);
+            u_sum += player.current_region().u0;
+        }
+        cafe::bench::do_not_optimize(u_sum);
+    }
+    state.set_items_processed(state.iterations() * kCustomers);
+}
+CAFE_BENCHMARK(bm_animation_player);
+
+void bm_animation_system(cafe::bench::State& state) {
+    cafe::AnimationTable table;
+    table.add_all(customer_sheet());
+
+    cafe::AnimationSystem animators(&table);
+    animators.reserve(kCustomers);
+    for (int i = 0; i < kCustomers; ++i) {
+        cafe::AnimatorID id = animators.create(table.find(kAnimations[i % kAnimationCount]));
+        animators.set_speed(id, 1.0f + start_time(i));  // Staggered via speed
+    }
+    animators.update_all(0.5f);
+
+    const std::vector<cafe::TextureRegion>& regions = table.regions();
+    while (state.keep_running()) {
+        animators.update_all(kDt);
+
+        float u_sum = 0.0f;
+        for (int32_t frame : animators.frames()) {
+            u_sum += regions[frame].u0;
+        }
+        cafe::bench::do_not_optimize(u_sum);
+    }
+    state.set_items_processed(state.iterations() * kCustomers);
+}
+CAFE_BENCHMARK(bm_animation_system);
+
+// update_all() alone: the SoA time/frame advance without reading regions
+void bm_animation_system_update_only(cafe::bench::State& state) {
+    cafe::AnimationTable table;
+    table.add_all(customer_sheet());
+
+    cafe::AnimationSystem animators(&table);
+    animators.reserve(kCustomers);
+    for (int i = 0; i < kCustomers; ++i) {
+        animators.create(table.find(kAnimations[i % kAnimationCount]));
+    }
+
+    while (state.keep_running()) {
+        animators.update_all(kDt);
+        cafe::bench::clobber_memory();
+    }
+    state.set_items_processed(state.iterations() * kCustomers);
+}
+CAFE_BENCHMARK(bm_animation_system_update_only);
+
+} // namespace
@@ -0,0 +1,135 @@
+#include "bench.h"
+#include "bench_files.h"
+#include "engine/asset_archive.h"
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+// ============================================================================
+// Loose files vs a .cpak archive
+// ============================================================================
+//
+// 1000 small assets (1-32 KB: sprite PNGs, JSON, sounds) written once as
+// loose files and once packed into an archive. Each iteration drops both
+// from the page cache (see bench_files.h) and reads every asset:
+//
+//   arg 0  loose    fopen + fread + fclose per asset (a separate file each)
+//   arg 1  archive  open the .cpak once, then load() every asset (mmap)
+//
+// bm_archive_lookup measures the perfect-hash lookup alone (warm).
+
+namespace {
+
+constexpr int kAssetCount = 1000;
+
+std::string asset_name(int i) {
+    static const char* const kFolders[] = {"sprites", "tiles", "ui", "audio", "data"};
+    return std::string(kFolders[i % 5]) + "/asset_" + std::to_string(i) + ".bin";
+}
+
+// Written once, removed at exit
+struct AssetFiles {
+    std::string dir;
+    std::string archive;
+    std::vector<std::string> names;
+    int64_t total_bytes = 0;
+
+    AssetFiles() {
+        auto root = std::filesystem::temp_directory_path() / "cafe_bench_archive";
+        dir = (root / "assets").string();
+        archive = (root / "assets.cpak").string();
+
+        uint32_t seed = 12345;
+        std::vector<uint8_t> data;
+        for (int i = 0; i < kAssetCount; ++i) {
+            names.push_back(asset_name(i));
+            std::string path = dir + "/" + names.back();
+            std::filesystem::create_directories(std::filesystem::path(path).parent_path());
+
+            data.resize(1024 + (i * 7919) % (31 * 1024));
+            for (uint8_t& byte : data) {
+                seed = seed * 1664525u + 1013904223u;
+                byte = static_cast<uint8_t>(seed >> 24);
+            }
+            FILE* file = std::fopen(path.c_str(), "wb");
+            if (file) {
+                std::fwrite(data.data(), 1, data.size(), file);
+                std::fclose(file);
+            }
+            cafe::bench::sync_file(path);
+            total_bytes += static_cast<int64_t>(data.size());
+        }
+
+        cafe::AssetArchive::pack(archive, cafe::AssetArchive::list_directory(dir));
+        cafe::bench::sync_file(archive);
+    }
+
+    ~AssetFiles() {
+        std::error_code error;
+        std::filesystem::remove_all(std::filesystem::path(dir).parent_path(), error);
+    }
+};
+
+const AssetFiles& asset_files() {
+    static AssetFiles files;
+    return files;
+}
+
+void bm_archive_cold_read(cafe::bench::State& state) {
+    const AssetFiles& files = asset_files();
+    std::vector<uint8_t> buffer(32 * 1024);
+
+    while (state.keep_running()) {
+        state.pause_timing();
+        cafe::bench::drop_from_page_cache(files.archive);
+        for (const std::string& name : files.names) {
+            cafe::bench::drop_from_page_cache(files.dir + "/" + name);
+        }
+        state.resume_timing();
+
+        uint64_t checksum = 0;
+        if (state.arg() == 0) {
+            for (const std::string& name : files.names) {
+                FILE* file = std::fopen((files.dir + "/" + name).c_str(), "rb");
+                if (!file) continue;
+                size_t bytes = std::fread(buffer.data(), 1, buffer.size(), file);
+                std::fclose(file);
+                checksum += bytes ? buffer[bytes - 1] : 0;
+            }
+        } else {
+            cafe::AssetArchive archive;
+            archive.open(files.archive);
+            for (const std::string& name : files.names) {
+                cafe::AssetBytes bytes = archive.load(name);
+                // Touch every page, as a decoder would
+                for (size_t i = 0; i < bytes.size(); i += 4096) {
+                    checksum += bytes.data()[i];
+                }
+            }
+        }
+        cafe::bench::do_not_optimize(checksum);
+    }
+
+    state.set_items_processed(state.iterations() * kAssetCount);
+    state.set_bytes_processed(state.iterations() * files.total_bytes);
+}
+CAFE_BENCHMARK(bm_archive_cold_read, 0, 1);
+
+void bm_archive_lookup(cafe::bench::State& state) {
+    const AssetFiles& files = asset_files();
+    cafe::AssetArchive archive;
+    archive.open(files.archive);
+
+    while (state.keep_running()) {
+        size_t total = 0;
+        for (const std::string& name : files.names) {
+            total += archive.entry_size(name);
+        }
+        cafe::bench::do_not_optimize(total);
+    }
+    state.set_items_processed(state.iterations() * kAssetCount);
+}
+CAFE_BENCHMARK(bm_archive_lookup);
+
+} // namespace
@@ -0,0 +1,137 @@
+#include "bench.h"
+#include "audio/mixer.h"
+#include "audio/spatial.h"
+#include <cmath>
+#include <vector>
+
+// ============================================================================
+// Software mixer: N looping voices into one 512-frame device buffer
+// ============================================================================
+//
+// Eight synthetic 44.1 kHz clips (half mono, half stereo) mixed to 48 kHz,
+// so every voice resamples. Each voice has its own volume, pan and a pitch
+// between 0.8 and 1.25.
+//
+//   mixer_linear/N   linear interpolation
+//   mixer_cubic/N    Catmull-Rom interpolation
+//
+//   mixer_crowd/N    200 positional voices spread over a 3000 px cafe,
+//                    N real voices (256 = no virtualization)
+//
+// realtime_x is how many times faster than real time the buffer was
+// mixed: at 256 voices it needs to stay well above 1 on the audio thread.
+// mixer_crowd also reports the real/virtual split of the last buffer.
+
+namespace {
+
+constexpr size_t kBufferFrames = 512;
+constexpr int kClipCount = 8;
+
+const std::vector<cafe::AudioClip>& test_clips() {
+    static const std::vector<cafe::AudioClip> clips = [] {
+        std::vector<cafe::AudioClip> result(kClipCount);
+        for (int c = 0; c < kClipCount; ++c) {
+            cafe::AudioClip& clip = result[c];
+            clip.channels = c % 2 == 0 ? 1 : 2;
+            clip.sample_rate = 44100;
+            size_t frames = 88200;
+            clip.samples.resize(frames * clip.channels);
+            float freq = 110.0f * static_cast<float>(c + 1);
+            for (size_t i = 0; i < frames; ++i) {
+                float s = 0.5f * std::sin(6.2831853f * freq * static_cast<float>(i) / 44100.0f);
+                for (int ch = 0; ch < clip.channels; ++ch) {
+                    clip.samples[i * clip.channels + ch] = s;
+                }
+            }
+        }
+        return result;
+    }();
+    return clips;
+}
+
+void run_mixer(cafe::bench::State& state, cafe::Resampler resampler) {
+    const auto& clips = test_clips();
+    int voices = static_cast<int>(state.arg());
+
+    cafe::MixerConfig config;
+    config.max_voices = voices;
+    config.resampler = resampler;
+    cafe::AudioMixer mixer(config);
+
+    for (int v = 0; v < voices; ++v) {
+        cafe::VoiceParams params;
+        params.volume = 0.2f + 0.8f * static_cast<float>(v % 5) / 4.0f;
+        params.pan = static_cast<float>(v % 9) / 4.0f - 1.0f;
+        params.pitch = 0.8f + 0.45f * static_cast<float>(v % 7) / 6.0f;
+        params.loop = true;
+        mixer.play(&clips[v % kClipCount], params);
+    }
+
+    std::vector<float> buffer(2 * kBufferFrames);
+    mixer.mix(buffer.data(), kBufferFrames);   // Apply the play commands
+
+    while (state.keep_running()) {
+        mixer.mix(buffer.data(), kBufferFrames);
+        cafe::bench::do_not_optimize(buffer[0]);
+    }
+
+    double buffer_seconds = static_cast<double>(kBufferFrames) / mixer.sample_rate();
+    double per_buffer = state.elapsed_seconds() / static_cast<double>(state.iterations());
+    state.set_counter("voices", mixer.stats().active_voices);
+    state.set_counter("realtime_x", per_buffer > 0.0 ? buffer_seconds / per_buffer : 0.0);
+    state.set_items_processed(state.iterations() * voices * static_cast<int64_t>(kBufferFrames));
+}
+
+void bm_mixer_linear(cafe::bench::State& state) {
+    run_mixer(state, cafe::Resampler::Linear);
+}
+CAFE_BENCHMARK(bm_mixer_linear, 32, 256);
+
+void bm_mixer_cubic(cafe::bench::State& state) {
+    run_mixer(state, cafe::Resampler::Cubic);
+}
+CAFE_BENCHMARK(bm_mixer_cubic, 32, 256);
+
+void bm_mixer_crowd(cafe::bench::State& state) {
+    const auto& clips = test_clips();
+    constexpr int kCustomers = 200;
+
+    cafe::MixerConfig config;
+    config.max_real_voices = static_cast<int>(state.arg());
+    cafe::AudioMixer mixer(config);
+
+    // Customers on a grid around a listener in the middle
+    cafe::SpatialConfig spatial;
+    for (int v = 0; v < kCustomers; ++v) {
+        float x = static_cast<float>(v % 20) * 150.0f - 1500.0f;
+        float y = static_cast<float>(v / 20) * 75.0f - 375.0f;
+        cafe::SpatialGain gain = cafe::spatialize(spatial, 0.0f, 0.0f, x, y);
+
+        cafe::VoiceParams params;
+        params.volume = 0.5f;
+        params.pan = gain.pan;
+        params.attenuation = gain.attenuation;
+        params.pitch = 0.8f + 0.45f * static_cast<float>(v % 7) / 6.0f;
+        params.loop = true;
+        mixer.play(&clips[v % kClipCount], params);
+    }
+
+    std::vector<float> buffer(2 * kBufferFrames);
+    mixer.mix(buffer.data(), kBufferFrames);
+
+    while (state.keep_running()) {
+        mixer.mix(buffer.data(), kBufferFrames);
+        cafe::bench::do_not_optimize(buffer[0]);
+    }
+
+    cafe::MixerStats stats = mixer.stats();
+    double buffer_seconds = static_cast<double>(kBufferFrames) / mixer.sample_rate();
+    double per_buffer = state.elapsed_seconds() / static_cast<double>(state.iterations());
+    state.set_counter("real", stats.real_voices);
+    state.set_counter("virtual", stats.virtual_voices);
+    state.set_counter("realtime_x", per_buffer > 0.0 ? buffer_seconds / per_buffer : 0.0);
+    state.set_items_processed(state.iterations() * static_cast<int64_t>(kBufferFrames));
+}
+CAFE_BENCHMARK(bm_mixer_crowd, 32, 256);
+
+} // namespace
@@ -0,0 +1,135 @@
+#include "bench.h"
+#include "core/dynamic_array.h"
+#include "core/hash_map.h"
+#include "core/object_pool.h"
+#include "core/ring_buffer.h"
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+
+// ============================================================================
+// Core containers: HashMap, ObjectPool, RingBuffer, DynamicArray
+// ============================================================================
+//
+// The include/core containers in the ways the game uses them. Data comes
+// from a fixed-seed generator so every run measures the same work.
+//
+//   hash_map_insert/N      insert N random keys into an empty map (rehashes)
+//   hash_map_lookup/N      get() N keys that are present, in random order
+//   object_pool/0          acquire and release 4096 particles from a pool
+//   object_pool/1          the same with new/delete (baseline)
+//   ring_buffer            push_overwrite a frame time, average of 120
+//   dynamic_array/N        push_back N items from empty, then sum them
+
+namespace {
+
+std::vector<uint32_t> random_keys(int count) {
+    std::mt19937 rng(1234);
+    std::vector<uint32_t> keys(static_cast<size_t>(count));
+    for (uint32_t& key : keys) {
+        key = rng();
+    }
+    return keys;
+}
+
+void bm_hash_map_insert(cafe::bench::State& state) {
+    const std::vector<uint32_t> keys = random_keys(static_cast<int>(state.arg()));
+
+    while (state.keep_running()) {
+        cafe::HashMap<uint32_t, uint32_t> map;
+        for (uint32_t key : keys) {
+            map.insert(key, key ^ 0x9E3779B9u);
+        }
+        cafe::bench::do_not_optimize(map.size());
+    }
+    state.set_items_processed(state.iterations() * state.arg());
+}
+CAFE_BENCHMARK(bm_hash_map_insert, 1024, 65536);
+
+void bm_hash_map_lookup(cafe::bench::State& state) {
+    std::vector<uint32_t> keys = random_keys(static_cast<int>(state.arg()));
+    cafe::HashMap<uint32_t, uint32_t> map;
+    for (uint32_t key : keys) {
+        map.insert(key, key ^ 0x9E3779B9u);
+    }
+    std::shuffle(keys.begin(), keys.end(), std::mt19937(99));
+
+    while (state.keep_running()) {
+        uint32_t sum = 0;
+        for (uint32_t key : keys) {
+            sum += *map.get(key);
+        }
+        cafe::bench::do_not_optimize(sum);
+    }
+    state.set_items_processed(state.iterations() * state.arg());
+}
+CAFE_BENCHMARK(bm_hash_map_lookup, 1024, 65536);
+
+struct Particle {
+    float x = 0.0f, y = 0.0f;
+    float vx = 0.0f, vy = 0.0f;
+    float life = 1.0f;
+
+    Particle() = default;
+    Particle(float px, float py) : x(px), y(py) {}
+};
+
+constexpr int kParticles = 4096;
+
+void bm_object_pool(cafe::bench::State& state) {
+    const bool use_pool = state.arg() == 0;
+    auto pool = std::make_unique<cafe::ObjectPool<Particle, kParticles>>();
+    std::vector<Particle*> live(kParticles);
+
+    while (state.keep_running()) {
+        for (int i = 0; i < kParticles; ++i) {
+            float x = static_cast<float>(i);
+            live[i] = use_pool ? pool->acquire(x, x) : new Particle(x, x);
+        }
+        cafe::bench::clobber_memory();
+        for (Particle* particle : live) {
+            if (use_pool) {
+                pool->release(particle);
+            } else {
+                delete particle;
+            }
+        }
+    }
+    state.set_items_processed(state.iterations() * kParticles);
+}
+CAFE_BENCHMARK(bm_object_pool, 0, 1);
+
+void bm_ring_buffer(cafe::bench::State& state) {
+    cafe::RingBuffer<float, 120> frame_times;
+    float dt = 1.0f / 60.0f;
+
+    while (state.keep_running()) {
+        frame_times.push_overwrite(dt);
+        dt += 1e-7f;
+        cafe::bench::do_not_optimize(frame_times.average());
+    }
+    state.set_items_processed(state.iterations());
+}
+CAFE_BENCHMARK(bm_ring_buffer);
+
+void bm_dynamic_array(cafe::bench::State& state) {
+    const int count = static_cast<int>(state.arg());
+
+    while (state.keep_running()) {
+        cafe::DynamicArray<int> array;
+        for (int i = 0; i < count; ++i) {
+            array.push_back(i);
+        }
+        int64_t sum = 0;
+        for (int value : array) {
+            sum += value;
+        }
+        cafe::bench::do_not_optimize(sum);
+    }
+    state.set_items_processed(state.iterations() * count);
+}
+CAFE_BENCHMARK(bm_dynamic_array, 1024, 65536);
+
+} // namespace
@@ -0,0 +1,194 @@
+#include "bench.h"
+#include "bench_files.h"
+#include "bench_png.h"
+#include "engine/cooked_texture.h"
+#include "engine/image.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+// ============================================================================
+// Cold-start texture loading: PNG vs cooked .ctex
+// ============================================================================
+//
+// 500 sprite-like textures (32 to 256 pixels square, 42 MB of RGBA) are
+// written to a temporary directory three ways: PNG, raw cooked and LZ4
+// cooked. Each iteration loads the whole set and copies every level 0 into
+// a staging buffer, standing in for the driver's upload copy.
+//
+// Before each iteration the files are dropped from the OS page cache
+// (posix_fadvise DONTNEED), so reads hit the disk as on a cold start. On
+// tmpfs nothing can be dropped and the numbers are warm-cache ones.
+//
+//   arg 0  PNG          Image::load_from_file (stb_image inflate + unfilter)
+//   arg 1  cooked       CookedTexture::open + pixels(), zero-copy mmap
+//   arg 2  cooked LZ4   CookedTexture::open + pixels(), LZ4 decompress
+//
+// bm_png_decode_threads decodes the PNG set with Image::load_many() on
+// 1, 2, 4 and 8 threads (warm cache: decode throughput, not disk). The
+// "threads" counter shows how many the machine could actually give it.
+
+namespace {
+
+constexpr int kTextureCount = 500;
+
+// ============================================================================
+// Asset set
+// ============================================================================
+
+// A sprite: soft-edged blob over transparency, banded shading, a little
+// noise so it does not compress unrealistically well
+std::unique_ptr<cafe::Image> make_sprite(int index) {
+    int size = 32 << (index % 4);
+    auto image = cafe::Image::create(size, size, 4);
+    uint32_t seed = 0x9E3779B9u * static_cast<uint32_t>(index + 1);
+    float radius = size * 0.45f;
+
+    for (int y = 0; y < size; ++y) {
+        for (int x = 0; x < size; ++x) {
+            float dx = x - size * 0.5f;
+            float dy = y - size * 0.5f;
+            float dist = std::sqrt(dx * dx + dy * dy);
+            seed = seed * 1664525u + 1013904223u;
+            uint8_t noise = static_cast<uint8_t>((seed >> 24) & 7);
+            if (dist > radius) {
+                image->set_pixel(x, y, 0, 0, 0, 0);
+                continue;
+            }
+            int band = static_cast<int>(dist / radius * 4.0f);
+            image->set_pixel(x, y,
+                static_cast<uint8_t>(((index * 37) & 0xFF) / (band + 1) + noise),
+                static_cast<uint8_t>(((index * 91) & 0xFF) / (band + 1) + noise),
+                static_cast<uint8_t>(160 - band * 30 + noise), 255);
+        }
+    }
+    return image;
+}
+
+// Written once, removed at exit
+struct AssetSet {
+    std::string dir;
+    std::vector<std::string> png;
+    std::vector<std::string> cooked;
+    std::vector<std::string> cooked_lz4;
+    int64_t pixel_bytes = 0;
+
+    AssetSet() {
+        dir = (std::filesystem::temp_directory_path() / "cafe_bench_textures").string();
+        std::filesystem::create_directories(dir + "/lz4");
+
+        cafe::CookOptions raw;
+        cafe::CookOptions lz4;
+        lz4.compress = true;
+
+        for (int i = 0; i < kTextureCount; ++i) {
+            auto image = make_sprite(i);
+            std::string name = dir + "/sprite_" + std::to_string(i);
+            png.push_back(name + ".png");
+            cooked.push_back(name + ".ctex");
+            cooked_lz4.push_back(dir + "/lz4/sprite_" + std::to_string(i) + ".ctex");
+
+            cafe::bench::write_png(png.back(), *image);
+            cafe::CookedTexture::cook(*image, cooked.back(), raw);
+            cafe::CookedTexture::cook(*image, cooked_lz4.back(), lz4);
+            for (const std::string* path : {&png.back(), &cooked.back(), &cooked_lz4.back()}) {
+                cafe::bench::sync_file(*path);
+            }
+            pixel_bytes += static_cast<int64_t>(image->width()) * image->height() * 4;
+        }
+    }
+
+    ~AssetSet() {
+        std::error_code error;
+        std::filesystem::remove_all(dir, error);
+    }
+
+    const std::vector<std::string>& files(int64_t kind) const {
+        return kind == 0 ? png : (kind == 1 ? cooked : cooked_lz4);
+    }
+
+    int64_t disk_bytes(int64_t kind) const {
+        int64_t total = 0;
+        for (const std::string& path : files(kind)) {
+            total += static_cast<int64_t>(std::filesystem::file_size(path));
+        }
+        return total;
+    }
+};
+
+const AssetSet& asset_set() {
+    static AssetSet set;
+    return set;
+}
+
+void bm_texture_cold_start(cafe::bench::State& state) {
+    const AssetSet& set = asset_set();
+    const std::vector<std::string>& files = set.files(state.arg());
+    std::vector<uint8_t> staging(256 * 256 * 4);
+
+    while (state.keep_running()) {
+        state.pause_timing();
+        for (const std::string& path : files) {
+            cafe::bench::drop_from_page_cache(path);
+        }
+        state.resume_timing();
+
+        for (const std::string& path : files) {
+            const uint8_t* pixels = nullptr;
+            size_t bytes = 0;
+
+            std::unique_ptr<cafe::Image> image;
+            cafe::CookedTexture cooked;
+            if (state.arg() == 0) {
+                image = cafe::Image::load_from_file(path);
+                if (image) {
+                    pixels = image->data();
+                    bytes = static_cast<size_t>(image->width()) * image->height() * 4;
+                }
+            } else if (cooked.open(path)) {
+                pixels = cooked.pixels();
+                bytes = static_cast<size_t>(cooked.width()) * cooked.height() * 4;
+            }
+
+            if (pixels) {
+                std::memcpy(staging.data(), pixels, std::min(bytes, staging.size()));
+            }
+            cafe::bench::clobber_memory();
+        }
+    }
+
+    state.set_items_processed(state.iterations() * kTextureCount);
+    state.set_bytes_processed(state.iterations() * set.pixel_bytes);
+    state.set_counter("disk_MB", static_cast<double>(set.disk_bytes(state.arg())) / (1024.0 * 1024.0));
+}
+CAFE_BENCHMARK(bm_texture_cold_start, 0, 1, 2);
+
+void bm_png_decode_threads(cafe::bench::State& state) {
+    const AssetSet& set = asset_set();
+    int threads = static_cast<int>(state.arg());
+    cafe::ImageBufferStats before = cafe::Image::buffer_stats();
+
+    while (state.keep_running()) {
+        auto images = cafe::Image::load_many(set.png, threads);
+        cafe::bench::do_not_optimize(images.back().get());
+    }
+
+    cafe::ImageBufferStats after = cafe::Image::buffer_stats();
+    double allocations = static_cast<double>((after.reused - before.reused) +
+                                             (after.allocated - before.allocated));
+    state.set_counter("threads", std::min(threads, cafe::Image::max_decode_threads()));
+    state.set_counter("images_per_s",
+                      static_cast<double>(state.iterations() * kTextureCount) / state.elapsed_seconds());
+    state.set_counter("pool_reuse_pct",
+                      allocations > 0 ? 100.0 * static_cast<double>(after.reused - before.reused) / allocations : 0.0);
+    state.set_items_processed(state.iterations() * kTextureCount);
+    state.set_bytes_processed(state.iterations() * set.pixel_bytes);
+}
+CAFE_BENCHMARK(bm_png_decode_threads, 1, 2, 4, 8);
+
+} // namespace
@@ -0,0 +1,46 @@
+#ifndef CAFE_BENCH_FILES_H
+#define CAFE_BENCH_FILES_H
+
+#include <string>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace cafe::bench {
+
+// ============================================================================
+// File helpers for cold-start benchmarks
+// ============================================================================
+
+// Flush a file to disk so its cached pages can be dropped later
+inline void sync_file(const std::string& path) {
+#if defined(__unix__) || defined(__APPLE__)
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd >= 0) {
+        ::fsync(fd);
+        ::close(fd);
+    }
+#else
+    (void)path;
+#endif
+}
+
+// Evict a (synced) file from the OS page cache so the next read hits the
+// disk. Linux only; elsewhere, and on tmpfs, reads stay warm.
+inline void drop_from_page_cache(const std::string& path) {
+#if defined(__linux__)
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd >= 0) {
+        ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+        ::close(fd);
+    }
+#else
+    (void)path;
+#endif
+}
+
+} // namespace cafe::bench
+
+#endif // CAFE_BENCH_FILES_H
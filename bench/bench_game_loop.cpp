@@ -0,0 +1,180 @@
+#include "bench.h"
+#include "engine/game_loop.h"
+#include "engine/snapshot_buffer.h"
+#include "platform/headless/headless_platform.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <ctime>
+#include <vector>
+
+// ============================================================================
+// GameLoop: single thread vs threaded simulation
+// ============================================================================
+//
+// A 60 Hz simulation step costs 6 ms of CPU and a rendered frame 10 ms
+// (busy loops on thread CPU time, headless platform). One iteration is
+// one rendered frame:
+//
+//   arg 0  single thread: poll, fixed updates, render in turn
+//   arg 1  threaded: updates on the simulation thread, 200-sprite
+//          snapshots through a SnapshotBuffer
+//
+// Counters: sim_hz is fixed updates per second actually reached (60 is
+// on schedule), latency_ms the age of the newest state when a frame
+// starts rendering, overlap_pct the share of simulation time that ran
+// while a frame was rendering. The gain needs a second free core.
+
+namespace {
+
+struct SpriteState {
+    float x, y;
+};
+
+struct Snapshot {
+    std::vector<SpriteState> sprites;
+};
+
+double thread_cpu_ms() {
+    timespec now;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+    return static_cast<double>(now.tv_sec) * 1e3 + static_cast<double>(now.tv_nsec) * 1e-6;
+}
+
+// Burn CPU time on this thread (not wall time: a preempted thread keeps going)
+void spin(double milliseconds) {
+    double until = thread_cpu_ms() + milliseconds;
+    while (thread_cpu_ms() < until) {
+    }
+}
+
+void bm_game_loop(cafe::bench::State& state) {
+    const bool threaded = state.arg() == 1;
+
+    cafe::HeadlessPlatform platform;
+    auto window = platform.create_window(cafe::WindowConfig());
+    cafe::GameLoop loop(&platform, window.get());
+    loop.set_threaded(threaded);
+
+    cafe::SnapshotBuffer<Snapshot> snapshots;
+    if (threaded) {
+        loop.set_snapshot_buffer(&snapshots);
+    }
+
+    std::vector<SpriteState> world(200, SpriteState{0.0f, 0.0f});
+    loop.set_update_callback([&](float dt) {
+        spin(6.0);
+        for (SpriteState& sprite : world) {
+            sprite.x += dt;
+        }
+        if (threaded) {
+            snapshots.write().sprites = world;
+        }
+    });
+
+    float checksum = 0.0f;
+    loop.set_render_callback([&](float alpha) {
+        if (!state.keep_running()) {
+            loop.stop();
+            return;
+        }
+        const std::vector<SpriteState>& drawn = threaded ? snapshots.current().sprites : world;
+        checksum += drawn.empty() ? alpha : drawn.front().x;
+        spin(10.0);
+    });
+
+    double latency = 0.0, sim = 0.0, overlap = 0.0;
+    int frames = 0, steps = 0;
+    loop.set_timing_callback([&](const cafe::LoopTiming& timing) {
+        latency += timing.latency_ms;
+        sim += timing.sim_ms;
+        overlap += timing.overlap_ms;
+        steps += timing.steps;
+        ++frames;
+    });
+
+    loop.run();
+    cafe::bench::do_not_optimize(checksum);
+
+    double seconds = state.elapsed_seconds();
+    state.set_counter("sim_hz", seconds > 0.0 ? steps / seconds : 0.0);
+    state.set_counter("latency_ms", frames > 0 ? latency / frames : 0.0);
+    state.set_counter("overlap_pct", sim > 0.0 ? 100.0 * overlap / sim : 0.0);
+    state.set_items_processed(state.iterations());
+}
+CAFE_BENCHMARK(bm_game_loop, 0, 1);
+
+// ============================================================================
+// Frame pacing: CPU use and frame-time jitter
+// ============================================================================
+//
+// Rendering costs 2 ms of CPU per frame, updates are free:
+//
+//   arg 0  unpaced: the loop renders again as soon as it can
+//   arg 1  set_render_rate(60): sleep, then spin the last stretch
+//   arg 2  set_render_rate(60), sleep only (no spin)
+//
+// cpu_pct is process CPU time over wall time. Jitter is how far each
+// frame interval lands from the median interval (p50 / p99).
+
+double process_cpu_seconds() {
+    timespec now;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &now);
+    return static_cast<double>(now.tv_sec) + static_cast<double>(now.tv_nsec) * 1e-9;
+}
+
+double percentile(std::vector<double> values, double p) {
+    if (values.empty()) return 0.0;
+    size_t index = static_cast<size_t>(p * static_cast<double>(values.size() - 1));
+    std::nth_element(values.begin(), values.begin() + index, values.end());
+    return values[index];
+}
+
+void bm_frame_pacing(cafe::bench::State& state) {
+    const int variant = static_cast<int>(state.arg());
+
+    cafe::HeadlessPlatform platform;
+    auto window = platform.create_window(cafe::WindowConfig());
+    cafe::GameLoop loop(&platform, window.get());
+    if (variant > 0) {
+        loop.set_render_rate(60.0);
+        loop.pacer().set_spin(variant == 1);
+    }
+
+    loop.set_update_callback([](float) {});
+    loop.set_render_callback([&](float) {
+        if (!state.keep_running()) {
+            loop.stop();
+            return;
+        }
+        spin(2.0);
+    });
+
+    std::vector<double> intervals;
+    loop.set_timing_callback([&](const cafe::LoopTiming& timing) {
+        if (timing.interval_ms > 0.0) {
+            intervals.push_back(timing.interval_ms);
+        }
+    });
+
+    double cpu_start = process_cpu_seconds();
+    auto wall_start = cafe::bench::Clock::now();
+    loop.run();
+    double cpu = process_cpu_seconds() - cpu_start;
+    double wall = std::chrono::duration<double>(cafe::bench::Clock::now() - wall_start).count();
+
+    double median = percentile(intervals, 0.5);
+    std::vector<double> jitter;
+    for (double interval : intervals) {
+        jitter.push_back(std::abs(interval - median));
+    }
+
+    state.set_counter("cpu_pct", wall > 0.0 ? 100.0 * cpu / wall : 0.0);
+    state.set_counter("interval_ms", median);
+    state.set_counter("jitter_p50_ms", percentile(jitter, 0.5));
+    state.set_counter("jitter_p99_ms", percentile(jitter, 0.99));
+    state.set_items_processed(state.iterations());
+}
+CAFE_BENCHMARK(bm_frame_pacing, 0, 1, 2);
+
+} // namespace
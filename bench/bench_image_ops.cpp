@@ -0,0 +1,160 @@
+#include "bench.h"
+#include "engine/image_ops.h"
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+// ============================================================================
+// ImageOps kernels: scalar baseline vs SIMD
+// ============================================================================
+//
+// Every kernel runs over a 1024x1024 RGBA image (4 MB, larger than most
+// L2 caches) once per SIMD level. The argument is the SimdLevel:
+//
+//   0  Scalar    1  SSE2    2  AVX2    3  NEON
+//
+// A level the CPU cannot run falls back to the best one it can; the
+// "level" counter shows what actually ran.
+
+namespace {
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+#define CAFE_BENCH_SIMD_LEVELS 0, 3
+#else
+#define CAFE_BENCH_SIMD_LEVELS 0, 1, 2
+#endif
+
+constexpr int kSize = 1024;
+constexpr size_t kPixels = static_cast<size_t>(kSize) * kSize;
+
+std::vector<uint8_t> make_pixels(uint32_t seed) {
+    std::vector<uint8_t> pixels(kPixels * 4);
+    for (uint8_t& byte : pixels) {
+        seed = seed * 1664525u + 1013904223u;
+        byte = static_cast<uint8_t>(seed >> 24);
+    }
+    return pixels;
+}
+
+// Select the level for this run; restore the detected one afterwards
+class LevelScope {
+public:
+    explicit LevelScope(cafe::bench::State& state) {
+        auto level = cafe::image_ops::set_simd_level(static_cast<cafe::SimdLevel>(state.arg()));
+        state.set_counter("level", static_cast<double>(level));
+    }
+    ~LevelScope() {
+        cafe::image_ops::set_simd_level(cafe::image_ops::detected_simd_level());
+    }
+};
+
+void finish(cafe::bench::State& state) {
+    state.set_items_processed(state.iterations() * static_cast<int64_t>(kPixels));
+    state.set_bytes_processed(state.iterations() * static_cast<int64_t>(kPixels) * 4);
+}
+
+void bm_image_premultiply(cafe::bench::State& state) {
+    LevelScope scope(state);
+    const std::vector<uint8_t> source = make_pixels(1);
+    std::vector<uint8_t> pixels = source;
+    while (state.keep_running()) {
+        cafe::image_ops::premultiply_alpha(pixels.data(), kPixels);
+        cafe::bench::clobber_memory();
+    }
+    finish(state);
+}
+CAFE_BENCHMARK(bm_image_premultiply, CAFE_BENCH_SIMD_LEVELS);
+
+void bm_image_swizzle(cafe::bench::State& state) {
+    LevelScope scope(state);
+    const std::vector<uint8_t> source = make_pixels(2);
+    std::vector<uint8_t> pixels(source.size());
+    while (state.keep_running()) {
+        cafe::image_ops::swizzle_rb(pixels.data(), source.data(), kPixels);
+        cafe::bench::clobber_memory();
+    }
+    finish(state);
+}
+CAFE_BENCHMARK(bm_image_swizzle, CAFE_BENCH_SIMD_LEVELS);
+
+void bm_image_fill(cafe::bench::State& state) {
+    LevelScope scope(state);
+    std::vector<uint8_t> pixels(kPixels * 4);
+    uint32_t color = cafe::image_ops::rgba(120, 80, 40);
+    while (state.keep_running()) {
+        cafe::image_ops::fill(pixels.data(), kPixels, color);
+        cafe::bench::clobber_memory();
+    }
+    finish(state);
+}
+CAFE_BENCHMARK(bm_image_fill, CAFE_BENCH_SIMD_LEVELS);
+
+// Customer variant: 8 clothing colors swapped in a sprite-like image
+void bm_image_palette_swap(cafe::bench::State& state) {
+    LevelScope scope(state);
+    cafe::image_ops::Palette palette;
+    for (int i = 0; i < 8; ++i) {
+        palette.add(cafe::image_ops::rgba(static_cast<uint8_t>(i * 30), 40, 40),
+                    cafe::image_ops::rgba(40, 40, static_cast<uint8_t>(i * 30)));
+    }
+
+    // Mostly palette colors, some others
+    std::vector<uint8_t> source = make_pixels(3);
+    for (size_t i = 0; i < kPixels; i += 2) {
+        uint32_t color = palette.from[(i / 2) % palette.size()];
+        std::memcpy(&source[i * 4], &color, 4);
+    }
+
+    std::vector<uint8_t> pixels(source.size());
+    while (state.keep_running()) {
+        state.pause_timing();
+        pixels = source;
+        state.resume_timing();
+        cafe::image_ops::palette_swap(pixels.data(), kPixels, palette.from.data(),
+                                      palette.to.data(), palette.size());
+        cafe::bench::clobber_memory();
+    }
+    finish(state);
+}
+CAFE_BENCHMARK(bm_image_palette_swap, CAFE_BENCH_SIMD_LEVELS);
+
+void bm_image_blend(cafe::bench::State& state) {
+    LevelScope scope(state);
+    const std::vector<uint8_t> source = make_pixels(4);
+    std::vector<uint8_t> pixels = make_pixels(5);
+    while (state.keep_running()) {
+        cafe::image_ops::blend(pixels.data(), source.data(), kPixels);
+        cafe::bench::clobber_memory();
+    }
+    finish(state);
+}
+CAFE_BENCHMARK(bm_image_blend, CAFE_BENCH_SIMD_LEVELS);
+
+void bm_image_downscale_box(cafe::bench::State& state) {
+    LevelScope scope(state);
+    const std::vector<uint8_t> source = make_pixels(6);
+    std::vector<uint8_t> pixels(kPixels);   // (1024 / 2)^2 * 4 bytes
+    while (state.keep_running()) {
+        cafe::image_ops::downscale_box(source.data(), kSize, kSize, pixels.data());
+        cafe::bench::clobber_memory();
+    }
+    finish(state);
+}
+CAFE_BENCHMARK(bm_image_downscale_box, CAFE_BENCH_SIMD_LEVELS);
+
+// 1024 -> 600: items and bytes count source pixels, as for the box filter
+void bm_image_downscale_bilinear(cafe::bench::State& state) {
+    LevelScope scope(state);
+    constexpr int kTarget = 600;
+    const std::vector<uint8_t> source = make_pixels(7);
+    std::vector<uint8_t> pixels(static_cast<size_t>(kTarget) * kTarget * 4);
+    while (state.keep_running()) {
+        cafe::image_ops::downscale_bilinear(source.data(), kSize, kSize,
+                                            pixels.data(), kTarget, kTarget);
+        cafe::bench::clobber_memory();
+    }
+    finish(state);
+}
+CAFE_BENCHMARK(bm_image_downscale_bilinear, CAFE_BENCH_SIMD_LEVELS);
+
+} // namespace
@@ -0,0 +1,169 @@
+#include "bench.h"
+#include "engine/input_map.h"
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// ============================================================================
+// InputMap::update with 500 actions
+// ============================================================================
+//
+// 500 actions, each bound to two keys or a key and a mouse button; every
+// fourth action has a pressed and a released callback. Each frame two
+// keys change state, as when a player taps keys:
+//
+//   arg 0  walk every action by name (the previous InputMap::update:
+//          string lookups per action, binding loop, prev-state map)
+//   arg 1  compiled tables, only the actions bound to changed keys
+//
+// Both variants fire the same callbacks ("fired_per_frame").
+
+namespace {
+
+constexpr int kActions = 500;
+constexpr int kFrames = 256;
+constexpr int kKeys = static_cast<int>(cafe::Key::KeyCount);
+
+// Window whose key state the bench sets directly
+class ScriptedWindow : public cafe::Window {
+public:
+    bool is_open() const override { return true; }
+    void close() override {}
+    int width() const override { return 1280; }
+    int height() const override { return 720; }
+    float scale_factor() const override { return 1.0f; }
+    void set_title(const std::string&) override {}
+    void* native_handle() override { return nullptr; }
+
+    bool is_key_down(cafe::Key key) const override { return keys[static_cast<int>(key)]; }
+    bool is_key_pressed(cafe::Key) const override { return false; }
+    bool is_key_released(cafe::Key) const override { return false; }
+    bool is_mouse_button_down(cafe::MouseButton button) const override {
+        return buttons[static_cast<int>(button)];
+    }
+    float mouse_x() const override { return 0.0f; }
+    float mouse_y() const override { return 0.0f; }
+    void update_input() override {}
+
+    bool keys[kKeys] = {};
+    bool buttons[3] = {};
+};
+
+uint32_t next_random(uint32_t& state) {
+    state = state * 1664525u + 1013904223u;
+    return state >> 8;
+}
+
+cafe::Key random_key(uint32_t& state) {
+    return static_cast<cafe::Key>(1 + next_random(state) % (kKeys - 1));
+}
+
+void define_actions(cafe::InputMap& input, int& fired) {
+    uint32_t seed = 7;
+    for (int i = 0; i < kActions; ++i) {
+        std::string name = "action_" + std::to_string(i);
+        cafe::InputAction& action = input.define_action(name).add_key(random_key(seed));
+        if (i % 10 == 0) {
+            action.add_mouse(static_cast<cafe::MouseButton>(next_random(seed) % 3));
+        } else {
+            action.add_key(random_key(seed));
+        }
+        if (i % 4 == 0) {
+            input.on_action_pressed(name, [&fired] { ++fired; });
+            input.on_action_released(name, [&fired] { ++fired; });
+        }
+    }
+}
+
+// The per-frame walk InputMap::update did before it was compiled
+struct NameWalk {
+    const cafe::Window* window;
+    std::unordered_map<std::string, cafe::InputAction> actions;
+    std::unordered_map<std::string, std::vector<std::function<void()>>> pressed_callbacks;
+    std::unordered_map<std::string, std::vector<std::function<void()>>> released_callbacks;
+    std::unordered_map<std::string, bool> prev_action_state;
+
+    bool is_action_held(const std::string& name) const {
+        auto it = actions.find(name);
+        if (it == actions.end()) return false;
+        for (const cafe::InputBinding& binding : it->second.bindings) {
+            if (binding.is_mouse ? window->is_mouse_button_down(binding.mouse_button)
+                                 : window->is_key_down(binding.key)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void update() {
+        for (const auto& [name, action] : actions) {
+            bool current_state = is_action_held(name);
+            bool prev_state = prev_action_state[name];
+            if (current_state && !prev_state) {
+                auto it = pressed_callbacks.find(name);
+                if (it != pressed_callbacks.end()) {
+                    for (const auto& callback : it->second) callback();
+                }
+            }
+            if (!current_state && prev_state) {
+                auto it = released_callbacks.find(name);
+                if (it != released_callbacks.end()) {
+                    for (const auto& callback : it->second) callback();
+                }
+            }
+            prev_action_state[name] = current_state;
+        }
+    }
+};
+
+void bm_input_map_update(cafe::bench::State& state) {
+    const int variant = static_cast<int>(state.arg());
+    ScriptedWindow window;
+    int fired = 0;
+
+    cafe::InputMap input;
+    input.set_window(&window);
+    define_actions(input, fired);
+
+    NameWalk walk{&window, {}, {}, {}, {}};
+    if (variant == 0) {
+        for (int i = 0; i < kActions; ++i) {
+            std::string name = "action_" + std::to_string(i);
+            walk.actions[name] = *input.get_action(name);
+            if (i % 4 == 0) {
+                walk.pressed_callbacks[name].push_back([&fired] { ++fired; });
+                walk.released_callbacks[name].push_back([&fired] { ++fired; });
+            }
+        }
+    }
+
+    // Two key toggles per frame
+    std::vector<cafe::Key> toggles(kFrames * 2);
+    uint32_t seed = 99;
+    for (cafe::Key& key : toggles) {
+        key = random_key(seed);
+    }
+
+    int frame = 0;
+    int frames = 0;
+    while (state.keep_running()) {
+        window.keys[static_cast<int>(toggles[frame * 2])] ^= true;
+        window.keys[static_cast<int>(toggles[frame * 2 + 1])] ^= true;
+        frame = (frame + 1) % kFrames;
+
+        if (variant == 0) {
+            walk.update();
+        } else {
+            input.update();
+        }
+        ++frames;
+    }
+
+    state.set_counter("fired_per_frame", frames > 0 ? static_cast<double>(fired) / frames : 0.0);
+    state.set_items_processed(state.iterations());
+}
+CAFE_BENCHMARK(bm_input_map_update, 0, 1);
+
+} // namespace
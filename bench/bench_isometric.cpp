@@ -0,0 +1,92 @@
+#include "bench.h"
+#include "engine/isometric.h"
+
+// ============================================================================
+// TileMap visible-tile iteration
+// ============================================================================
+//
+// 1024x1024 map, camera centred on the map. The argument is the viewport
+// width in pixels (16:9), so larger values model zooming out.
+
+namespace {
+
+constexpr int kMapSize = 1024;
+
+cafe::TileMap& bench_map() {
+    static cafe::TileMap map = [] {
+        cafe::TileMap m(kMapSize, kMapSize);
+        for (int y = 0; y < kMapSize; ++y) {
+            for (int x = 0; x < kMapSize; ++x) {
+                cafe::Tile& tile = m.at(x, y);
+                tile.tile_id = 1 + (x * 7 + y * 13) % 4;
+                if ((x ^ y) % 17 == 0) tile.tile_id = 0;  // Some holes
+            }
+        }
+        return m;
+    }();
+    return map;
+}
+
+cafe::Rect centred_viewport(int64_t width) {
+    float w = static_cast<float>(width);
+    float h = w * 9.0f / 16.0f;
+
+    cafe::Isometric::set_tile_size(64.0f, 32.0f);
+    float centre_y = static_cast<float>(kMapSize) * 32.0f * 0.5f;
+    cafe::Isometric::set_camera(-w * 0.5f, centre_y - h * 0.5f);
+
+    return {0.0f, 0.0f, w, h};
+}
+
+void bm_tilemap_visible_sorted(cafe::bench::State& state) {
+    const cafe::TileMap& map = bench_map();
+    cafe::Rect viewport = centred_viewport(state.arg());
+
+    int64_t tiles = 0;
+    while (state.keep_running()) {
+        int count = 0;
+        map.for_each_visible(viewport, [&](int, int, const cafe::Tile&, float sx, float) {
+            cafe::bench::do_not_optimize(sx);
+            ++count;
+        });
+        tiles += count;
+    }
+    state.set_items_processed(tiles);
+    state.set_counter("tiles", static_cast<double>(tiles / state.iterations()));
+}
+CAFE_BENCHMARK(bm_tilemap_visible_sorted, 1280, 4096, 16384);
+
+void bm_tilemap_visible_diagonal(cafe::bench::State& state) {
+    const cafe::TileMap& map = bench_map();
+    cafe::Rect viewport = centred_viewport(state.arg());
+
+    int64_t tiles = 0;
+    while (state.keep_running()) {
+        int count = 0;
+        map.for_each_visible_diagonal(viewport, [&](int, int, const cafe::Tile&, float sx, float) {
+            cafe::bench::do_not_optimize(sx);
+            ++count;
+        });
+        tiles += count;
+    }
+    state.set_items_processed(tiles);
+    state.set_counter("tiles", static_cast<double>(tiles / state.iterations()));
+}
+CAFE_BENCHMARK(bm_tilemap_visible_diagonal, 1280, 4096, 16384);
+
+void bm_tilemap_count_visible(cafe::bench::State& state) {
+    const cafe::TileMap& map = bench_map();
+    cafe::Rect viewport = centred_viewport(state.arg());
+
+    int64_t tiles = 0;
+    while (state.keep_running()) {
+        int count = map.count_visible(viewport);
+        cafe::bench::do_not_optimize(count);
+        tiles += count;
+    }
+    state.set_items_processed(tiles);
+    state.set_counter("tiles", static_cast<double>(tiles / state.iterations()));
+}
+CAFE_BENCHMARK(bm_tilemap_count_visible, 1280, 4096, 16384);
+
+} // namespace
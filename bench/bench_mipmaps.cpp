@@ -0,0 +1,95 @@
+#include "bench.h"
+#include "null_renderer.h"
+#include "engine/image.h"
+#include "engine/image_ops.h"
+#include "engine/mip_chain.h"
+#include "engine/resource.h"
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// ============================================================================
+// Mip chains: build cost and texture memory
+// ============================================================================
+//
+// bm_mip_chain builds the full chain of a 1024x1024 RGBA texture (11
+// levels). The argument is SimdLevel * 2 + gamma:
+//
+//   0 / 1  Scalar, plain / gamma-correct average
+//   2 / 3  SSE2      4 / 5  AVX2      6 / 7  NEON
+//
+// The gamma-correct average is table lookups and runs the same code at
+// every level; it is the price of mips that keep their brightness.
+//
+// bm_mip_memory creates 64 textures of 256x256 through ResourceManager
+// with mipmaps off (arg 0) and on (arg 1) and reports the resident texture
+// memory: the chain adds a third.
+
+namespace {
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+#define CAFE_BENCH_MIP_ARGS 0, 1, 6, 7
+#else
+#define CAFE_BENCH_MIP_ARGS 0, 1, 2, 3, 4, 5
+#endif
+
+std::vector<uint8_t> make_pixels(int width, int height, uint32_t seed) {
+    std::vector<uint8_t> pixels(static_cast<size_t>(width) * height * 4);
+    for (uint8_t& byte : pixels) {
+        seed = seed * 1664525u + 1013904223u;
+        byte = static_cast<uint8_t>(seed >> 24);
+    }
+    return pixels;
+}
+
+void bm_mip_chain(cafe::bench::State& state) {
+    constexpr int kSize = 1024;
+    auto level = cafe::image_ops::set_simd_level(static_cast<cafe::SimdLevel>(state.arg() / 2));
+    state.set_counter("level", static_cast<double>(level));
+
+    cafe::MipOptions options;
+    options.gamma_correct = (state.arg() % 2) == 1;
+    const std::vector<uint8_t> pixels = make_pixels(kSize, kSize, 7);
+    cafe::MipChain chain;
+
+    while (state.keep_running()) {
+        chain.build(pixels.data(), kSize, kSize, options);
+        cafe::bench::do_not_optimize(chain.level(chain.count() - 1));
+    }
+
+    cafe::image_ops::set_simd_level(cafe::image_ops::detected_simd_level());
+    state.set_counter("levels", chain.count());
+    state.set_items_processed(state.iterations() * static_cast<int64_t>(kSize) * kSize);
+    state.set_bytes_processed(state.iterations() * static_cast<int64_t>(kSize) * kSize * 4);
+}
+CAFE_BENCHMARK(bm_mip_chain, CAFE_BENCH_MIP_ARGS);
+
+void bm_mip_memory(cafe::bench::State& state) {
+    constexpr int kTextures = 64;
+    constexpr int kSize = 256;
+    auto image = cafe::Image::create(kSize, kSize);
+    std::vector<uint8_t> pixels = make_pixels(kSize, kSize, 11);
+    std::copy(pixels.begin(), pixels.end(), image->data());
+
+    cafe::bench::NullRenderer renderer;
+    cafe::ResourceMemoryStats stats;
+    while (state.keep_running()) {
+        cafe::ResourceManager resources;
+        resources.initialize(&renderer);
+        resources.set_generate_mipmaps(state.arg() == 1);
+
+        std::vector<cafe::TextureResource> textures;
+        for (int i = 0; i < kTextures; ++i) {
+            textures.push_back(resources.create_texture("texture_" + std::to_string(i), *image));
+        }
+        stats = resources.memory_stats();
+    }
+
+    state.set_counter("resident_mb", static_cast<double>(stats.resident_bytes) / (1024.0 * 1024.0));
+    state.set_counter("mip_mb", static_cast<double>(stats.mip_bytes) / (1024.0 * 1024.0));
+    state.set_items_processed(state.iterations() * kTextures);
+}
+CAFE_BENCHMARK(bm_mip_memory, 0, 1);
+
+} // namespace
@@ -0,0 +1,127 @@
+#include "bench.h"
+#include "audio/music_stream.h"
+#include "audio/qoa.h"
+#include "audio/wav.h"
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <thread>
+#include <vector>
+
+// ============================================================================
+// Music streaming: decode cost per second of audio
+// ============================================================================
+//
+// Ten seconds of synthetic 44.1 kHz stereo music (a chord plus a little
+// noise), stored as QOA and as 16-bit WAV in the temp directory.
+//
+//   qoa_decode         qoa::decode_frame over the whole track, in memory
+//   music_stream/0     MusicStream on the WAV: read, convert, resample to 48k
+//   music_stream/1     MusicStream on the QOA: read, decode, resample to 48k
+//
+// ms_per_audio_s is decode time per second of audio produced - the share
+// of a core music costs (10 = 1%). music_stream reports the decode
+// thread's own measurement, plus resident_kb, the stream's memory.
+
+namespace {
+
+constexpr int kRate = 44100;
+constexpr uint32_t kFrames = kRate * 10;
+
+std::vector<int16_t> make_music() {
+    std::vector<int16_t> samples(static_cast<size_t>(kFrames) * 2);
+    uint32_t noise = 12345;
+    for (uint32_t i = 0; i < kFrames; ++i) {
+        float t = static_cast<float>(i) / kRate;
+        float chord = 0.2f * (std::sin(6.2831853f * 220.0f * t) + std::sin(6.2831853f * 277.2f * t) +
+                              std::sin(6.2831853f * 329.6f * t));
+        for (int c = 0; c < 2; ++c) {
+            noise = noise * 1664525u + 1013904223u;
+            float n = static_cast<float>(static_cast<int32_t>(noise >> 16) - 32768) * (0.02f / 32768.0f);
+            samples[i * 2 + c] = static_cast<int16_t>(std::lround((chord + n) * 32767.0f));
+        }
+    }
+    return samples;
+}
+
+// Both files, written once and removed at exit
+struct MusicFiles {
+    std::vector<uint8_t> qoa;
+    std::string qoa_path;
+    std::string wav_path;
+
+    MusicFiles() {
+        auto dir = std::filesystem::temp_directory_path();
+        qoa_path = (dir / "cafe_bench_music.qoa").string();
+        wav_path = (dir / "cafe_bench_music.wav").string();
+
+        std::vector<int16_t> samples = make_music();
+        cafe::qoa::encode(samples.data(), kFrames, 2, kRate, qoa);
+        if (std::FILE* file = std::fopen(qoa_path.c_str(), "wb")) {
+            std::fwrite(qoa.data(), 1, qoa.size(), file);
+            std::fclose(file);
+        }
+
+        std::vector<float> floats(samples.size());
+        for (size_t i = 0; i < samples.size(); ++i) floats[i] = samples[i] / 32768.0f;
+        cafe::WavWriter writer;
+        if (writer.open(wav_path, kRate, 2)) writer.write(floats.data(), kFrames);
+    }
+    ~MusicFiles() {
+        std::remove(qoa_path.c_str());
+        std::remove(wav_path.c_str());
+    }
+};
+
+const MusicFiles& music_files() {
+    static MusicFiles files;
+    return files;
+}
+
+void bm_qoa_decode(cafe::bench::State& state) {
+    const std::vector<uint8_t>& data = music_files().qoa;
+    std::vector<int16_t> out(static_cast<size_t>(cafe::qoa::FRAME_LEN) * 2);
+
+    int64_t frames = 0;
+    while (state.keep_running()) {
+        size_t pos = cafe::qoa::FILE_HEADER_SIZE;
+        cafe::qoa::FrameHeader header;
+        while (cafe::qoa::read_frame_header(data.data() + pos, data.size() - pos, header) &&
+               cafe::qoa::decode_frame(data.data() + pos, data.size() - pos, header, out.data())) {
+            pos += header.size;
+            frames += header.samples;
+            if (pos >= data.size()) break;
+        }
+        cafe::bench::do_not_optimize(out[0]);
+    }
+
+    double audio_seconds = static_cast<double>(frames) / kRate;
+    state.set_counter("ms_per_audio_s", audio_seconds > 0.0 ? state.elapsed_seconds() * 1000.0 / audio_seconds : 0.0);
+    state.set_items_processed(frames);
+}
+CAFE_BENCHMARK(bm_qoa_decode);
+
+void bm_music_stream(cafe::bench::State& state) {
+    const MusicFiles& files = music_files();
+    cafe::MusicStream stream(48000);
+    if (!stream.open(state.arg() == 1 ? files.qoa_path : files.wav_path, true)) return;
+
+    // Drain it like the audio thread would, a device buffer at a time
+    constexpr size_t kBufferFrames = 512;
+    std::vector<float> buffer(kBufferFrames * 2);
+    while (state.keep_running()) {
+        size_t got = 0;
+        while (got < kBufferFrames) {
+            got += stream.read(buffer.data() + got * 2, kBufferFrames - got);
+            if (got < kBufferFrames) std::this_thread::yield();
+        }
+        cafe::bench::do_not_optimize(buffer[0]);
+    }
+
+    state.set_counter("ms_per_audio_s", stream.stats().cost_ms_per_second());
+    state.set_counter("resident_kb", static_cast<double>(stream.resident_bytes()) / 1024.0);
+    state.set_items_processed(state.iterations() * static_cast<int64_t>(kBufferFrames));
+}
+CAFE_BENCHMARK(bm_music_stream, 0, 1);
+
+} // namespace
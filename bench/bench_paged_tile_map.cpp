@@ -0,0 +1,94 @@
+#include "bench.h"
+#include "engine/paged_tile_map.h"
+#include <cstdio>
+#include <filesystem>
+
+// ============================================================================
+// PagedTileMap streaming while the camera pans across a city
+// ============================================================================
+//
+// 4096x4096 city (64 MB as a TileMap) written to a temporary chunk file:
+// 256x256 districts of cafes, with every fifth district an empty lot that
+// is not stored at all. Each iteration is one 60 Hz frame: pan the camera,
+// update() and walk the visible tiles. Memory budget is 2 MB (42 chunks).
+// The argument selects prefetching: 0 = page faults only, 1 = prefetch.
+
+namespace {
+
+constexpr int kCitySize = 4096;
+constexpr int kDistrict = 256;
+constexpr int kRoom = 16;
+constexpr float kPanSpeed = 24.0f;  // Pixels per frame
+
+cafe::Tile city_tile(int x, int y) {
+    cafe::Tile tile;
+    int district = (x / kDistrict) * 7 + (y / kDistrict) * 3;
+    if (district % 5 == 0) return tile;  // Empty lot
+
+    bool street = (x % kDistrict) < 8 || (y % kDistrict) < 8;
+    bool wall = (x % kRoom == 0) || (y % kRoom == 0);
+    tile.tile_id = street ? 1 : (wall ? 2 : 3);
+    tile.height = wall && !street ? 2 : 0;
+    tile.flags = wall ? 0 : 1;
+    return tile;
+}
+
+// Chunk file shared by every run, removed at exit
+struct CityFile {
+    std::string path;
+
+    CityFile() {
+        path = (std::filesystem::temp_directory_path() / "cafe_bench_city.tiles").string();
+        cafe::PagedTileMap::write_chunk_file(path, kCitySize, kCitySize, city_tile);
+    }
+    ~CityFile() { std::remove(path.c_str()); }
+};
+
+const std::string& city_path() {
+    static CityFile file;
+    return file.path;
+}
+
+void bm_paged_tile_map_pan(cafe::bench::State& state) {
+    cafe::PagedTileMap map;
+    if (!map.open(city_path())) return;
+    map.set_memory_budget(2 * 1024 * 1024);
+    map.set_prefetch_enabled(state.arg() == 1);
+
+    cafe::Isometric::set_tile_size(64.0f, 32.0f);
+    cafe::Rect viewport(0.0f, 0.0f, 1280.0f, 720.0f);
+
+    // Ping-pong along the middle row of the city
+    const float limit = kCitySize * 32.0f * 0.6f;
+    const float centre_y = kCitySize * 16.0f - 360.0f;
+    float camera_x = -limit;
+    float direction = 1.0f;
+
+    int64_t tiles = 0;
+    int64_t frames = 0;
+    while (state.keep_running()) {
+        camera_x += kPanSpeed * direction;
+        if (camera_x > limit || camera_x < -limit) direction = -direction;
+        cafe::Isometric::set_camera(camera_x, centre_y + camera_x * 0.25f);
+
+        map.update(viewport, 1.0f / 60.0f);
+        map.for_each_visible_diagonal(viewport, [&](int, int, const cafe::Tile& tile, float sx, float) {
+            cafe::bench::do_not_optimize(tile.tile_id);
+            cafe::bench::do_not_optimize(sx);
+            ++tiles;
+        });
+        ++frames;
+    }
+
+    const auto& stats = map.stats();
+    double per_k_frames = frames > 0 ? 1000.0 / static_cast<double>(frames) : 0.0;
+    state.set_items_processed(tiles);
+    state.set_counter("faults/1kf", static_cast<double>(stats.page_faults) * per_k_frames);
+    state.set_counter("prefetched/1kf", static_cast<double>(stats.prefetched) * per_k_frames);
+    state.set_counter("stall_us/f", frames > 0 ? stats.fault_stall_us / static_cast<double>(frames) : 0.0);
+    state.set_counter("load_us", stats.average_load_us());
+    state.set_counter("resident", stats.resident_chunks);
+}
+CAFE_BENCHMARK(bm_paged_tile_map_pan, 0, 1);
+
+} // namespace
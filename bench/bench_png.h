@@ -0,0 +1,190 @@
+#ifndef CAFE_BENCH_PNG_H
+#define CAFE_BENCH_PNG_H
+
+#include "engine/image.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace cafe::bench {
+
+// ============================================================================
+// Minimal PNG writer (fixed-Huffman deflate, like stb_image_write)
+// ============================================================================
+//
+// Benchmarks write their own PNGs so they need no asset files or encoder
+// library. Output is a valid RGBA8 PNG that stb_image decodes.
+
+class BitWriter {
+public:
+    void put(uint32_t bits, int count) {
+        buffer_ |= static_cast<uint64_t>(bits) << count_;
+        count_ += count;
+        while (count_ >= 8) {
+            bytes.push_back(static_cast<uint8_t>(buffer_));
+            buffer_ >>= 8;
+            count_ -= 8;
+        }
+    }
+
+    // Huffman codes are sent most significant bit first
+    void put_code(uint32_t code, int count) {
+        uint32_t reversed = 0;
+        for (int i = 0; i < count; ++i) {
+            reversed |= ((code >> i) & 1u) << (count - 1 - i);
+        }
+        put(reversed, count);
+    }
+
+    void flush() {
+        if (count_ > 0) put(0, 8 - count_);
+    }
+
+    std::vector<uint8_t> bytes;
+
+private:
+    uint64_t buffer_ = 0;
+    int count_ = 0;
+};
+
+inline void put_literal(BitWriter& out, int value) {
+    if (value < 144) out.put_code(0x30 + value, 8);
+    else if (value < 256) out.put_code(0x190 + value - 144, 9);
+    else if (value < 280) out.put_code(value - 256, 7);
+    else out.put_code(0xC0 + value - 280, 8);
+}
+
+inline void put_match(BitWriter& out, int length, int distance) {
+    static const int kLengthBase[] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+                                      35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+    static const int kLengthExtra[] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+                                       3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+    static const int kDistBase[] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+                                    257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145,
+                                    8193, 12289, 16385, 24577};
+    static const int kDistExtra[] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+                                     7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+
+    int l = 28;
+    while (kLengthBase[l] > length) --l;
+    put_literal(out, 257 + l);
+    out.put(length - kLengthBase[l], kLengthExtra[l]);
+
+    int d = 29;
+    while (kDistBase[d] > distance) --d;
+    out.put_code(d, 5);
+    out.put(distance - kDistBase[d], kDistExtra[d]);
+}
+
+// zlib stream: one fixed-Huffman block, greedy 3-byte hash matching
+inline std::vector<uint8_t> zlib_compress(const std::vector<uint8_t>& data) {
+    BitWriter out;
+    out.put(0x78, 8);
+    out.put(0x01, 8);
+    out.put(1, 1);  // Final block
+    out.put(1, 2);  // Fixed Huffman
+
+    std::vector<int> head(1 << 15, -1);
+    size_t pos = 0;
+    while (pos < data.size()) {
+        int best_length = 0;
+        int best_distance = 0;
+        if (pos + 3 <= data.size()) {
+            uint32_t h = ((data[pos] << 16) | (data[pos + 1] << 8) | data[pos + 2]) * 2654435761u >> 17;
+            int candidate = head[h];
+            head[h] = static_cast<int>(pos);
+            if (candidate >= 0 && pos - candidate <= 32768) {
+                size_t limit = std::min<size_t>(258, data.size() - pos);
+                size_t length = 0;
+                while (length < limit && data[candidate + length] == data[pos + length]) ++length;
+                if (length >= 3) {
+                    best_length = static_cast<int>(length);
+                    best_distance = static_cast<int>(pos - candidate);
+                }
+            }
+        }
+
+        if (best_length > 0) {
+            put_match(out, best_length, best_distance);
+            pos += best_length;
+        } else {
+            put_literal(out, data[pos++]);
+        }
+    }
+    put_literal(out, 256);  // End of block
+    out.flush();
+
+    uint32_t a = 1, b = 0;
+    for (uint8_t byte : data) {
+        a = (a + byte) % 65521;
+        b = (b + a) % 65521;
+    }
+    uint32_t adler = (b << 16) | a;
+    for (int shift = 24; shift >= 0; shift -= 8) {
+        out.bytes.push_back(static_cast<uint8_t>(adler >> shift));
+    }
+    return out.bytes;
+}
+
+inline uint32_t crc32(const uint8_t* data, size_t size, uint32_t crc = 0) {
+    static uint32_t table[256] = {};
+    if (table[1] == 0) {
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; ++k) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            table[i] = c;
+        }
+    }
+    crc = ~crc;
+    for (size_t i = 0; i < size; ++i) crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    return ~crc;
+}
+
+inline void put_chunk(std::vector<uint8_t>& png, const char* type, const std::vector<uint8_t>& data) {
+    uint32_t size = static_cast<uint32_t>(data.size());
+    for (int shift = 24; shift >= 0; shift -= 8) png.push_back(static_cast<uint8_t>(size >> shift));
+    size_t type_start = png.size();
+    png.insert(png.end(), type, type + 4);
+    png.insert(png.end(), data.begin(), data.end());
+    uint32_t crc = crc32(png.data() + type_start, png.size() - type_start);
+    for (int shift = 24; shift >= 0; shift -= 8) png.push_back(static_cast<uint8_t>(crc >> shift));
+}
+
+inline bool write_png(const std::string& path, const cafe::Image& image) {
+    int w = image.width();
+    int h = image.height();
+
+    // Sub filter on every row, as PNG encoders commonly pick for sprites
+    std::vector<uint8_t> filtered;
+    filtered.reserve(static_cast<size_t>(w * 4 + 1) * h);
+    for (int y = 0; y < h; ++y) {
+        const uint8_t* row = image.data() + static_cast<size_t>(y) * w * 4;
+        filtered.push_back(1);
+        for (int i = 0; i < w * 4; ++i) {
+            filtered.push_back(static_cast<uint8_t>(row[i] - (i >= 4 ? row[i - 4] : 0)));
+        }
+    }
+
+    std::vector<uint8_t> ihdr = {
+        static_cast<uint8_t>(w >> 24), static_cast<uint8_t>(w >> 16),
+        static_cast<uint8_t>(w >> 8), static_cast<uint8_t>(w),
+        static_cast<uint8_t>(h >> 24), static_cast<uint8_t>(h >> 16),
+        static_cast<uint8_t>(h >> 8), static_cast<uint8_t>(h),
+        8, 6, 0, 0, 0};  // 8-bit RGBA
+
+    std::vector<uint8_t> png = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    put_chunk(png, "IHDR", ihdr);
+    put_chunk(png, "IDAT", zlib_compress(filtered));
+    put_chunk(png, "IEND", {});
+
+    FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) return false;
+    bool ok = std::fwrite(png.data(), 1, png.size(), file) == png.size();
+    return (std::fclose(file) == 0) && ok;
+}
+
+} // namespace cafe::bench
+
+#endif // CAFE_BENCH_PNG_H
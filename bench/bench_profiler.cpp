@@ -0,0 +1,51 @@
+#include "bench.h"
+#include "engine/profiler.h"
+#include <cstdint>
+
+// ============================================================================
+// Profiler zone overhead
+// ============================================================================
+//
+// One iteration is a zone around a few dozen instructions of work:
+//
+//   arg 0  no zone (baseline)
+//   arg 1  zone compiled in, profiler disabled (one relaxed load)
+//   arg 2  zone recorded (two timestamps, one ring buffer write)
+//
+// The cost of a zone is the time per iteration above the baseline.
+// Built with -DCAFE_PROFILER=OFF, arg 1 and 2 match arg 0.
+
+namespace {
+
+uint64_t work(uint64_t x) {
+    for (int i = 0; i < 16; ++i) {
+        x = x * 6364136223846793005ull + 1442695040888963407ull;
+    }
+    return x;
+}
+
+void bm_profile_scope(cafe::bench::State& state) {
+    const int variant = static_cast<int>(state.arg());
+    cafe::Profiler::set_enabled(variant == 2);
+
+    uint64_t x = 1;
+    if (variant == 0) {
+        while (state.keep_running()) {
+            x = work(x);
+            cafe::bench::do_not_optimize(x);
+        }
+    } else {
+        while (state.keep_running()) {
+            CAFE_PROFILE_SCOPE("bench::zone");
+            x = work(x);
+            cafe::bench::do_not_optimize(x);
+        }
+    }
+
+    cafe::Profiler::set_enabled(false);
+    cafe::Profiler::clear();
+    state.set_items_processed(state.iterations());
+}
+CAFE_BENCHMARK(bm_profile_scope, 0, 1, 2);
+
+} // namespace
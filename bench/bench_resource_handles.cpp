@@ -0,0 +1,197 @@
+#include "bench.h"
+#include "null_renderer.h"
+#include "bench_png.h"
+#include "engine/image.h"
+#include "engine/resource.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+// ============================================================================
+// ResourceManager: integer handles and the memory budget
+// ============================================================================
+//
+// bm_texture_lookup resolves 1000 textures per iteration:
+//
+//   arg 0  get_texture("sprites/customer_42.png")  string hash + compare
+//   arg 1  get_texture(handle)                      slot index + generation check
+//
+// bm_texture_budget simulates frames over 256 on-disk textures (64x64) with
+// a budget of 64 resident. Each frame draws a working set of `arg`
+// textures that drifts by one per frame, then process_uploads() trims to
+// the budget. A working set inside the budget only reloads the texture
+// that drifts into it each frame; one larger than the budget reloads
+// (synchronously, from disk) the overflow every frame.
+//
+// bm_hot_reload saves over a 256x256 PNG that a loaded texture came from and
+// runs frames (process_uploads() every millisecond) until the renderer's
+// texture is updated. edit_to_swap_ms is the whole round trip: the watcher
+// noticing the write, the debounce (arg, in ms), the decode on the loader
+// thread and the in-place swap. A 60 Hz game adds up to one frame to it.
+
+namespace {
+
+constexpr int kLookupCount = 1000;
+constexpr int kBudgetTextures = 256;
+constexpr int kBudgetResident = 64;
+constexpr int kBudgetSize = 64;
+
+void bm_texture_lookup(cafe::bench::State& state) {
+    cafe::bench::NullRenderer renderer;
+    cafe::ResourceManager resources;
+    resources.initialize(&renderer);
+
+    auto image = cafe::Image::create(4, 4);
+    std::vector<std::string> ids;
+    std::vector<cafe::TextureResource> handles;
+    for (int i = 0; i < kLookupCount; ++i) {
+        ids.push_back("sprites/customer_" + std::to_string(i) + ".png");
+        handles.push_back(resources.create_texture(ids.back(), *image));
+    }
+
+    while (state.keep_running()) {
+        uint64_t sum = 0;
+        if (state.arg() == 0) {
+            for (const std::string& id : ids) {
+                sum += resources.get_texture(id);
+            }
+        } else {
+            for (const cafe::TextureResource& handle : handles) {
+                sum += resources.get_texture(handle);
+            }
+        }
+        cafe::bench::do_not_optimize(sum);
+    }
+    state.set_items_processed(state.iterations() * kLookupCount);
+}
+CAFE_BENCHMARK(bm_texture_lookup, 0, 1);
+
+// Binary PPMs (stb_image reads them), written once and removed at exit
+struct BudgetFiles {
+    std::string dir;
+
+    BudgetFiles() {
+        dir = (std::filesystem::temp_directory_path() / "cafe_bench_budget").string();
+        std::filesystem::create_directories(dir);
+
+        std::vector<uint8_t> pixels(kBudgetSize * kBudgetSize * 3);
+        for (int i = 0; i < kBudgetTextures; ++i) {
+            for (size_t p = 0; p < pixels.size(); ++p) {
+                pixels[p] = static_cast<uint8_t>(p * 7 + i);
+            }
+            FILE* file = std::fopen(path(i).c_str(), "wb");
+            if (file) {
+                std::fprintf(file, "P6\n%d %d\n255\n", kBudgetSize, kBudgetSize);
+                std::fwrite(pixels.data(), 1, pixels.size(), file);
+                std::fclose(file);
+            }
+        }
+    }
+
+    ~BudgetFiles() {
+        std::error_code error;
+        std::filesystem::remove_all(dir, error);
+    }
+
+    std::string path(int i) const { return dir + "/texture_" + std::to_string(i) + ".ppm"; }
+};
+
+void bm_texture_budget(cafe::bench::State& state) {
+    static BudgetFiles files;
+    const int working_set = static_cast<int>(state.arg());
+
+    cafe::bench::NullRenderer renderer;
+    cafe::ResourceManager resources;
+    resources.initialize(&renderer);
+
+    cafe::TextureInfo info;
+    info.width = kBudgetSize;
+    info.height = kBudgetSize;
+    resources.set_memory_budget(cafe::ResourceManager::texture_bytes(info) * kBudgetResident);
+
+    // Loaded, then unreferenced: everything is evictable
+    std::vector<std::string> ids;
+    for (int i = 0; i < kBudgetTextures; ++i) {
+        ids.push_back(files.path(i));
+        resources.load_texture(ids.back());
+    }
+    resources.process_uploads();
+    resources.reset_memory_stats();
+
+    int frame = 0;
+    while (state.keep_running()) {
+        uint64_t sum = 0;
+        for (int i = 0; i < working_set; ++i) {
+            // Held for the draw only (get_texture(id) would pin it)
+            cafe::TextureResource handle = resources.find_texture(ids[(frame + i) % kBudgetTextures]);
+            sum += resources.get_texture(handle);
+        }
+        resources.process_uploads();
+        cafe::bench::do_not_optimize(sum);
+        frame++;
+    }
+
+    cafe::ResourceMemoryStats stats = resources.memory_stats();
+    state.set_items_processed(state.iterations() * working_set);
+    state.set_counter("reloads_per_frame",
+                      static_cast<double>(stats.reloads) / static_cast<double>(state.iterations()));
+    state.set_counter("resident_kb", static_cast<double>(stats.resident_bytes) / 1024.0);
+}
+CAFE_BENCHMARK(bm_texture_budget, 48, 96);
+
+void bm_hot_reload(cafe::bench::State& state) {
+    constexpr int kSize = 256;
+    using Clock = std::chrono::steady_clock;
+
+    std::string dir = (std::filesystem::temp_directory_path() / "cafe_bench_hot_reload").string();
+    std::filesystem::create_directories(dir);
+    std::string path = dir + "/barista.png";
+    auto image = cafe::Image::create(kSize, kSize);
+    cafe::bench::write_png(path, *image);
+
+    cafe::bench::NullRenderer renderer;
+    cafe::ResourceManager resources;
+    resources.initialize(&renderer);
+    resources.set_hot_reload(true, static_cast<int>(state.arg()));
+    cafe::TextureResource texture = resources.load_texture(path);
+
+    double total_ms = 0.0;
+    double max_ms = 0.0;
+    uint8_t shade = 0;
+    while (state.keep_running()) {
+        state.pause_timing();
+        image->set_pixel(0, 0, ++shade, 0, 0);
+        int updated = renderer.updated_textures();
+        state.resume_timing();
+
+        // Save the way most editors do: write a new file, rename it over
+        auto start = Clock::now();
+        cafe::bench::write_png(path + ".tmp", *image);
+        std::filesystem::rename(path + ".tmp", path);
+        while (renderer.updated_textures() == updated) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            resources.process_uploads();
+        }
+        double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        total_ms += ms;
+        max_ms = std::max(max_ms, ms);
+    }
+
+    cafe::LoaderStats stats = resources.loader_stats();
+    state.set_counter("edit_to_swap_ms", total_ms / static_cast<double>(state.iterations()));
+    state.set_counter("max_ms", max_ms);
+    state.set_counter("swap_p50_ms", stats.hot_reload.percentile_us(0.5) / 1000.0);
+    state.set_items_processed(state.iterations());
+    cafe::bench::do_not_optimize(texture);
+
+    resources.shutdown();
+    std::error_code error;
+    std::filesystem::remove_all(dir, error);
+}
+CAFE_BENCHMARK(bm_hot_reload, 0, 30);
+
+} // namespace
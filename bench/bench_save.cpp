@@ -0,0 +1,70 @@
+#include "bench.h"
+#include "game/save.h"
+#include <filesystem>
+#include <string>
+
+// ============================================================================
+// SaveSystem: writing and reading a save file
+// ============================================================================
+//
+// A mid-game save with 64 unlocked items (~1.5 KB), in the temp directory.
+// Both directions go through the OS page cache, so this measures the
+// formatting and parsing, not the disk.
+//
+//   save_system_save   SaveSystem::save()
+//   save_system_load   SaveSystem::load()
+
+namespace {
+
+std::string save_path() {
+    return (std::filesystem::temp_directory_path() / "cafe_bench_save.json").string();
+}
+
+cafe::SaveData sample_save() {
+    cafe::SaveData data;
+    data.money = 12345.5f;
+    data.xp = 48210;
+    data.level = 17;
+    data.day = 88;
+    data.hour = 14;
+    data.customers_served = 9120;
+    data.customers_lost = 311;
+    data.total_revenue = 80500.25f;
+    data.total_costs = 31020.75f;
+    for (int i = 0; i < 64; ++i) {
+        data.unlocked_items.push_back("menu_item_" + std::to_string(i));
+    }
+    return data;
+}
+
+void bm_save_system_save(cafe::bench::State& state) {
+    cafe::SaveSystem saves(save_path());
+    const cafe::SaveData data = sample_save();
+
+    bool ok = true;
+    while (state.keep_running()) {
+        ok = saves.save(data) && ok;
+    }
+    saves.delete_save();
+    state.set_counter("ok", ok ? 1.0 : 0.0);
+    state.set_items_processed(state.iterations());
+}
+CAFE_BENCHMARK(bm_save_system_save);
+
+void bm_save_system_load(cafe::bench::State& state) {
+    cafe::SaveSystem saves(save_path());
+    saves.save(sample_save());
+
+    size_t items = 0;
+    while (state.keep_running()) {
+        auto loaded = saves.load();
+        items += loaded ? loaded->unlocked_items.size() : 0;
+    }
+    saves.delete_save();
+    cafe::bench::do_not_optimize(items);
+    state.set_counter("items", static_cast<double>(items) / static_cast<double>(state.iterations()));
+    state.set_items_processed(state.iterations());
+}
+CAFE_BENCHMARK(bm_save_system_load);
+
+} // namespace
@@ -0,0 +1,87 @@
+#include "bench.h"
+#include "null_renderer.h"
+#include "engine/scene.h"
+#include <cstdint>
+#include <random>
+
+// ============================================================================
+// Entities and sprite batching
+// ============================================================================
+//
+// N entities, each with a Transform; three in four also have a
+// SpriteRenderer on one of four layers. Positions come from a fixed-seed
+// generator.
+//
+//   entity_for_each/N        for_each<SpriteRenderer>, touching the sprite
+//   entity_get_component/N   for_each over all entities, get_component<>
+//                            of Transform and SpriteRenderer
+//   render_sprites/N         Scene::render(): collect, sort by layer and
+//                            submit every sprite to a NullRenderer batch
+
+namespace {
+
+void populate(cafe::Scene& scene, int count) {
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> position(0.0f, 2048.0f);
+    for (int i = 0; i < count; ++i) {
+        cafe::Entity* entity = scene.create_entity();
+        cafe::Transform* transform = entity->add_component<cafe::Transform>();
+        transform->position = {position(rng), position(rng)};
+        if (i % 4 != 0) {
+            cafe::SpriteRenderer* sprite = entity->add_component<cafe::SpriteRenderer>();
+            sprite->layer = static_cast<int>(rng() % 4);
+        }
+    }
+}
+
+void bm_entity_for_each(cafe::bench::State& state) {
+    cafe::Scene scene;
+    populate(scene, static_cast<int>(state.arg()));
+
+    while (state.keep_running()) {
+        int layers = 0;
+        scene.entities().for_each<cafe::SpriteRenderer>([&](cafe::Entity*, cafe::SpriteRenderer* sprite) {
+            layers += sprite->layer;
+        });
+        cafe::bench::do_not_optimize(layers);
+    }
+    state.set_items_processed(state.iterations() * state.arg());
+}
+CAFE_BENCHMARK(bm_entity_for_each, 1000, 10000);
+
+void bm_entity_get_component(cafe::bench::State& state) {
+    cafe::Scene scene;
+    populate(scene, static_cast<int>(state.arg()));
+
+    while (state.keep_running()) {
+        float sum = 0.0f;
+        scene.entities().for_each([&](cafe::Entity* entity) {
+            const cafe::Transform* transform = entity->get_component<cafe::Transform>();
+            const cafe::SpriteRenderer* sprite = entity->get_component<cafe::SpriteRenderer>();
+            if (transform && sprite) {
+                sum += transform->position.x;
+            }
+        });
+        cafe::bench::do_not_optimize(sum);
+    }
+    state.set_items_processed(state.iterations() * state.arg());
+}
+CAFE_BENCHMARK(bm_entity_get_component, 1000, 10000);
+
+void bm_render_sprites(cafe::bench::State& state) {
+    cafe::Scene scene;
+    populate(scene, static_cast<int>(state.arg()));
+    cafe::bench::NullRenderer renderer;
+
+    while (state.keep_running()) {
+        scene.render(&renderer);
+    }
+    cafe::bench::do_not_optimize(renderer.checksum());
+
+    double sprites = static_cast<double>(renderer.sprites_drawn()) / static_cast<double>(state.iterations());
+    state.set_counter("sprites", sprites);
+    state.set_items_processed(static_cast<int64_t>(renderer.sprites_drawn()));
+}
+CAFE_BENCHMARK(bm_render_sprites, 1000, 10000);
+
+} // namespace
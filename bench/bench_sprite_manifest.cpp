@@ -0,0 +1,137 @@
+#include "bench.h"
+#include "engine/sprite_manifest.h"
+#include "engine/sprite_sheet.h"
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+// ============================================================================
+// Sprite sheet startup: definitions in code vs a manifest
+// ============================================================================
+//
+// Defines 200 sprite sheets of 512x512, each a 32x32 grid (256 frames),
+// four named frames and six animations, two of them by frame name:
+//
+//   arg 0  define_grid / define_frame / define_animation calls in code
+//   arg 1  .sheets text manifest, compiled when opened
+//   arg 2  cooked .csheets, mapped and bound with define_from()
+//
+// Every variant ends with the same 200 SpriteSheets ready to animate.
+// Textures are not loaded (fake handles): this is the definition cost
+// that runs on top of texture loading at startup.
+
+namespace {
+
+constexpr int kSheets = 200;
+constexpr int kTextureSize = 512;
+
+struct AnimationSpec {
+    const char* name;
+    int first;
+    int last;
+    float seconds;
+    bool looping;
+};
+
+const AnimationSpec kAnimations[] = {
+    {"idle", 0, 3, 0.25f, true},
+    {"walk", 16, 23, 0.1f, true},
+    {"sit", 32, 33, 0.5f, true},
+    {"order", 48, 53, 0.15f, false},
+};
+
+// The manifest every variant describes
+struct ManifestFiles {
+    std::string dir;
+    std::string text_path;
+    std::string cooked_path;
+
+    ManifestFiles() {
+        dir = (std::filesystem::temp_directory_path() / "cafe_bench_sheets").string();
+        std::filesystem::create_directories(dir);
+        // Cooked copy elsewhere, so opening the text really compiles it
+        std::filesystem::create_directories(dir + "/cooked");
+        text_path = dir + "/cafe.sheets";
+        cooked_path = dir + "/cooked/cafe" + cafe::SpriteManifest::EXTENSION;
+
+        std::string text;
+        char line[128];
+        for (int s = 0; s < kSheets; ++s) {
+            std::snprintf(line, sizeof(line), "[customer_%d]\nimage = customer_%d.png\nsize = %d %d\n",
+                          s, s, kTextureSize, kTextureSize);
+            text += line;
+            text += "grid = 32 32\n";
+            text += "frame.cup = 0 480 16 16\nframe.tray = 16 480 32 16\n";
+            text += "frame.coin = 48 480 8 8\nframe.receipt = 56 480 8 16\n";
+            for (const AnimationSpec& a : kAnimations) {
+                std::snprintf(line, sizeof(line), "anim.%s = %d..%d @ %g%s\n",
+                              a.name, a.first, a.last, a.seconds, a.looping ? "" : " once");
+                text += line;
+            }
+            text += "anim.pay = frame_64 coin receipt @ 0.2 once\n";
+            text += "anim.drink = frame_70 cup frame_71 cup @ 0.3\n";
+        }
+
+        FILE* file = std::fopen(text_path.c_str(), "wb");
+        if (file) {
+            std::fwrite(text.data(), 1, text.size(), file);
+            std::fclose(file);
+        }
+        cafe::SpriteManifest::cook_file(text_path, cooked_path);
+    }
+
+    ~ManifestFiles() {
+        std::error_code error;
+        std::filesystem::remove_all(dir, error);
+    }
+};
+
+void define_in_code(cafe::SpriteSheet& sheet) {
+    sheet.define_grid(32, 32);
+    sheet.define_frame("cup", 0, 480, 16, 16);
+    sheet.define_frame("tray", 16, 480, 32, 16);
+    sheet.define_frame("coin", 48, 480, 8, 8);
+    sheet.define_frame("receipt", 56, 480, 8, 16);
+    for (const AnimationSpec& a : kAnimations) {
+        sheet.define_animation(a.name, a.first, a.last, a.seconds, a.looping);
+    }
+    sheet.define_animation("pay", {"frame_64", "coin", "receipt"}, 0.2f, false);
+    sheet.define_animation("drink", {"frame_70", "cup", "frame_71", "cup"}, 0.3f);
+}
+
+void bm_sprite_sheet_startup(cafe::bench::State& state) {
+    static ManifestFiles files;
+    const int variant = static_cast<int>(state.arg());
+    int frames = 0;
+
+    while (state.keep_running()) {
+        cafe::SpriteManifest manifest;
+        std::vector<cafe::SpriteSheet> sheets(kSheets);
+
+        if (variant == 0) {
+            for (cafe::SpriteSheet& sheet : sheets) {
+                sheet.set_texture(1, kTextureSize, kTextureSize);
+                define_in_code(sheet);
+            }
+        } else {
+            manifest.open(variant == 1 ? files.text_path : files.cooked_path);
+            for (int s = 0; s < manifest.sheet_count(); ++s) {
+                sheets[s].set_texture(1, kTextureSize, kTextureSize);
+                sheets[s].define_from(manifest, s);
+            }
+        }
+
+        frames = 0;
+        for (const cafe::SpriteSheet& sheet : sheets) {
+            frames += sheet.frame_count();
+        }
+        cafe::bench::do_not_optimize(sheets.back().animation_frame("drink", 0.35f));
+    }
+
+    state.set_counter("frames", frames);
+    state.set_items_processed(state.iterations() * kSheets);
+}
+CAFE_BENCHMARK(bm_sprite_sheet_startup, 0, 1, 2);
+
+} // namespace
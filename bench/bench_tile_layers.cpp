@@ -0,0 +1,93 @@
+#include "bench.h"
+#include "engine/tile_layers.h"
+#include "engine/sprite_sheet.h"
+
+// ============================================================================
+// LayeredTileMap occlusion culling on an indoor cafe map
+// ============================================================================
+//
+// 256x256 map of 16x16 rooms: floor everywhere, furniture, walls along room
+// borders and a roof slab over every room. The argument selects the case:
+//   0 = roof hidden, culling off     1 = roof hidden, culling on
+//   2 = roof shown,  culling off     3 = roof shown,  culling on
+
+namespace {
+
+constexpr int kMapSize = 256;
+constexpr int kRoomSize = 16;
+
+enum TileIds { kFloor = 1, kWall = 2, kTable = 3, kRoof = 4 };
+
+cafe::SpriteSheet& bench_tileset() {
+    static cafe::SpriteSheet sheet = [] {
+        cafe::SpriteSheet s;
+        s.set_texture(1, 256, 64);  // Fake handle: no renderer needed
+        s.define_frame("floor", 0, 0, 64, 32);
+        s.define_frame("wall", 64, 0, 64, 64);
+        s.define_frame("table", 128, 0, 64, 48);
+        s.define_frame("roof", 192, 0, 64, 48);
+        return s;
+    }();
+    return sheet;
+}
+
+cafe::LayeredTileMap& cafe_map() {
+    static cafe::LayeredTileMap map = [] {
+        cafe::LayeredTileMap m(kMapSize, kMapSize);
+        m.add_standard_layers();
+        m.set_tileset(&bench_tileset());
+
+        cafe::TileMap& floor = m.layer("floor")->tiles;
+        cafe::TileMap& furniture = m.layer("furniture")->tiles;
+        cafe::TileMap& walls = m.layer("walls")->tiles;
+        cafe::TileMap& roof = m.layer("roof")->tiles;
+
+        for (int y = 0; y < kMapSize; ++y) {
+            for (int x = 0; x < kMapSize; ++x) {
+                floor.at(x, y).tile_id = kFloor;
+                roof.at(x, y).tile_id = kRoof;
+
+                bool border = (x % kRoomSize == 0) || (y % kRoomSize == 0);
+                bool door = (x % kRoomSize == kRoomSize / 2) || (y % kRoomSize == kRoomSize / 2);
+                if (border && !door) {
+                    walls.at(x, y).tile_id = kWall;
+                } else if (!border && (x * 3 + y * 5) % 7 == 0) {
+                    furniture.at(x, y).tile_id = kTable;
+                }
+            }
+        }
+        return m;
+    }();
+    return map;
+}
+
+void bm_tile_layers_render(cafe::bench::State& state) {
+    cafe::LayeredTileMap& map = cafe_map();
+    bool roof = state.arg() >= 2;
+    bool culling = (state.arg() % 2) == 1;
+    map.set_layer_visible("roof", roof);
+    map.set_occlusion_culling(culling);
+
+    cafe::Isometric::set_tile_size(64.0f, 32.0f);
+    float centre_y = static_cast<float>(kMapSize) * 32.0f * 0.5f;
+    cafe::Isometric::set_camera(-640.0f, centre_y - 360.0f);
+    cafe::Rect viewport(0.0f, 0.0f, 1280.0f, 720.0f);
+
+    int64_t drawn = 0;
+    while (state.keep_running()) {
+        map.for_each_visible(viewport, [&](int, int, int, const cafe::Tile& tile, float sx, float) {
+            cafe::bench::do_not_optimize(tile.tile_id);
+            cafe::bench::do_not_optimize(sx);
+            ++drawn;
+        });
+    }
+
+    const auto& stats = map.last_stats();
+    state.set_items_processed(drawn);
+    state.set_counter("drawn", stats.drawn);
+    state.set_counter("culled", stats.culled);
+    state.set_counter("overdraw", stats.overdraw);
+}
+CAFE_BENCHMARK(bm_tile_layers_render, 0, 1, 2, 3);
+
+} // namespace
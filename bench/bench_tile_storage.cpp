@@ -0,0 +1,157 @@
+#include "bench.h"
+#include "engine/compact_tile_map.h"
+#include <map>
+#include <memory>
+
+// ============================================================================
+// TileMap (AoS, 12 bytes/tile) vs CompactTileMap (planes, 4 bytes/tile)
+// ============================================================================
+//
+// The argument is the map size (N x N). Each benchmark reports the memory
+// of the storage it ran against as a "MB" counter.
+
+namespace {
+
+constexpr uint8_t kWalkable = 1 << 0;
+
+cafe::Tile make_tile(int x, int y) {
+    cafe::Tile tile;
+    tile.tile_id = 1 + (x * 7 + y * 13) % 4;
+    tile.height = (x / 32 + y / 32) % 3;
+    tile.flags = ((x + y) % 3 != 0) ? kWalkable : 0;
+    return tile;
+}
+
+const cafe::TileMap& aos_map(int64_t size) {
+    static std::map<int64_t, std::unique_ptr<cafe::TileMap>> maps;
+    auto& map = maps[size];
+    if (!map) {
+        int n = static_cast<int>(size);
+        map = std::make_unique<cafe::TileMap>(n, n);
+        for (int y = 0; y < n; ++y) {
+            for (int x = 0; x < n; ++x) {
+                map->at(x, y) = make_tile(x, y);
+            }
+        }
+    }
+    return *map;
+}
+
+const cafe::CompactTileMap& compact_map(int64_t size) {
+    static std::map<int64_t, std::unique_ptr<cafe::CompactTileMap>> maps;
+    auto& map = maps[size];
+    if (!map) {
+        map = std::make_unique<cafe::CompactTileMap>(aos_map(size));
+    }
+    return *map;
+}
+
+double megabytes(size_t bytes) {
+    return static_cast<double>(bytes) / (1024.0 * 1024.0);
+}
+
+cafe::Rect zoomed_out_viewport(int64_t size) {
+    cafe::Isometric::set_tile_size(64.0f, 32.0f);
+    float w = 8192.0f;
+    float h = 4608.0f;
+    float centre_y = static_cast<float>(size) * 32.0f * 0.5f;
+    cafe::Isometric::set_camera(-w * 0.5f, centre_y - h * 0.5f);
+    return {0.0f, 0.0f, w, h};
+}
+
+// Grid-order scan of every tile
+
+void bm_tile_storage_scan_aos(cafe::bench::State& state) {
+    const cafe::TileMap& map = aos_map(state.arg());
+    while (state.keep_running()) {
+        int64_t sum = 0;
+        for (int y = 0; y < map.height(); ++y) {
+            for (int x = 0; x < map.width(); ++x) {
+                sum += map.at(x, y).tile_id;
+            }
+        }
+        cafe::bench::do_not_optimize(sum);
+    }
+    state.set_items_processed(state.iterations() * state.arg() * state.arg());
+    state.set_counter("MB", megabytes(map.memory_bytes()));
+}
+CAFE_BENCHMARK(bm_tile_storage_scan_aos, 1024, 4096);
+
+void bm_tile_storage_scan_compact(cafe::bench::State& state) {
+    const cafe::CompactTileMap& map = compact_map(state.arg());
+    while (state.keep_running()) {
+        int64_t sum = 0;
+        for (int y = 0; y < map.height(); ++y) {
+            for (int x = 0; x < map.width(); ++x) {
+                sum += map.tile_id(x, y);
+            }
+        }
+        cafe::bench::do_not_optimize(sum);
+    }
+    state.set_items_processed(state.iterations() * state.arg() * state.arg());
+    state.set_counter("MB", megabytes(map.memory_bytes()));
+}
+CAFE_BENCHMARK(bm_tile_storage_scan_compact, 1024, 4096);
+
+// Screen-space (diagonal) iteration over a zoomed-out view
+
+void bm_tile_storage_visible_aos(cafe::bench::State& state) {
+    const cafe::TileMap& map = aos_map(state.arg());
+    cafe::Rect viewport = zoomed_out_viewport(state.arg());
+
+    int64_t tiles = 0;
+    while (state.keep_running()) {
+        map.for_each_visible_diagonal(viewport, [&](int, int, const cafe::Tile& tile, float, float) {
+            cafe::bench::do_not_optimize(tile.height);
+            ++tiles;
+        });
+    }
+    state.set_items_processed(tiles);
+    state.set_counter("MB", megabytes(map.memory_bytes()));
+}
+CAFE_BENCHMARK(bm_tile_storage_visible_aos, 1024, 4096);
+
+void bm_tile_storage_visible_compact(cafe::bench::State& state) {
+    const cafe::CompactTileMap& map = compact_map(state.arg());
+    cafe::Rect viewport = zoomed_out_viewport(state.arg());
+
+    int64_t tiles = 0;
+    while (state.keep_running()) {
+        map.for_each_visible_diagonal(viewport, [&](int, int, const cafe::Tile& tile, float, float) {
+            cafe::bench::do_not_optimize(tile.height);
+            ++tiles;
+        });
+    }
+    state.set_items_processed(tiles);
+    state.set_counter("MB", megabytes(map.memory_bytes()));
+}
+CAFE_BENCHMARK(bm_tile_storage_visible_compact, 1024, 4096);
+
+// Count walkable tiles
+
+void bm_tile_storage_walkable_aos(cafe::bench::State& state) {
+    const cafe::TileMap& map = aos_map(state.arg());
+    while (state.keep_running()) {
+        int64_t count = 0;
+        for (int y = 0; y < map.height(); ++y) {
+            for (int x = 0; x < map.width(); ++x) {
+                count += (map.at(x, y).flags & kWalkable) ? 1 : 0;
+            }
+        }
+        cafe::bench::do_not_optimize(count);
+    }
+    state.set_items_processed(state.iterations() * state.arg() * state.arg());
+}
+CAFE_BENCHMARK(bm_tile_storage_walkable_aos, 1024, 4096);
+
+void bm_tile_storage_walkable_compact(cafe::bench::State& state) {
+    const cafe::CompactTileMap& map = compact_map(state.arg());
+    while (state.keep_running()) {
+        size_t count = map.count_flag(0);
+        cafe::bench::do_not_optimize(count);
+    }
+    state.set_items_processed(state.iterations() * state.arg() * state.arg());
+}
+CAFE_BENCHMARK(bm_tile_storage_walkable_compact, 1024, 4096);
+
+} // namespace
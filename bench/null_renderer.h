@@ -0,0 +1,79 @@
+#ifndef CAFE_BENCH_NULL_RENDERER_H
+#define CAFE_BENCH_NULL_RENDERER_H
+
+#include "renderer/renderer.h"
+
+namespace cafe::bench {
+
+// ============================================================================
+// NullRenderer - Renderer that draws nothing
+// ============================================================================
+//
+// Hands out texture handles and counts live textures and drawn sprites so
+// engine code that needs a Renderer (ResourceManager, Scene, ...) can be
+// benchmarked without a GPU.
+// create_texture() reads the first and last pixel so the source bytes are
+// really touched, as an upload would.
+
+class NullRenderer : public Renderer {
+public:
+    bool initialize(Window*) override { return true; }
+    void shutdown() override {}
+
+    void begin_frame() override {}
+    void end_frame() override {}
+
+    void set_clear_color(const Color&) override {}
+    void clear() override {}
+
+    void set_viewport(int, int, int, int) override {}
+    void set_projection(float, float, float, float) override {}
+
+    TextureHandle create_texture(const uint8_t* pixels, const TextureInfo& info) override {
+        if (!pixels || info.width <= 0 || info.height <= 0) {
+            return INVALID_TEXTURE;
+        }
+        checksum_ += pixels[0] + pixels[static_cast<size_t>(info.width) * info.height * 4 - 1];
+        live_textures_++;
+        return next_texture_++;
+    }
+    bool update_texture(TextureHandle, const uint8_t* const* levels, const TextureInfo& info) override {
+        if (!levels || !levels[0] || info.width <= 0 || info.height <= 0) {
+            return false;
+        }
+        checksum_ += levels[0][0] + levels[0][static_cast<size_t>(info.width) * info.height * 4 - 1];
+        updated_textures_++;
+        return true;
+    }
+    void destroy_texture(TextureHandle) override { live_textures_--; }
+    TextureInfo get_texture_info(TextureHandle) const override { return TextureInfo(); }
+
+    void draw_quad(Vec2, Vec2, const Color&) override {}
+    void draw_textured_quad(Vec2, Vec2, const TextureRegion&, const Color&) override {}
+
+    void begin_batch() override {}
+    void draw_sprite(const Sprite& sprite) override {
+        sprites_drawn_++;
+        checksum_ += static_cast<uint64_t>(sprite.position.x);
+    }
+    void end_batch() override {}
+
+    const char* backend_name() const override { return "Null"; }
+    int max_texture_size() const override { return 16384; }
+
+    int live_textures() const { return live_textures_; }
+    uint64_t checksum() const { return checksum_; }
+    int updated_textures() const { return updated_textures_; }
+    uint64_t sprites_drawn() const { return sprites_drawn_; }
+
+private:
+    TextureHandle next_texture_ = 1;
+    int live_textures_ = 0;
+    int updated_textures_ = 0;
+    uint64_t checksum_ = 0;
+    uint64_t sprites_drawn_ = 0;
+};
+
+} // namespace cafe::bench
+
+#endif // CAFE_BENCH_NULL_RENDERER_H
@@ -0,0 +1,102 @@
+#!/usr/bin/env python3
+# ============================================================================
+# Cafe Engine - Benchmark Comparison
+# ============================================================================
+# Compares two cafe_bench --json runs and flags benchmarks that got slower
+# by more than a threshold. Exits 1 if any did, so CI can gate on it.
+#
+# Usage:
+#   ./_build/cafe_bench --repetitions=5 --json=before.json
+#   ... change code, rebuild ...
+#   ./_build/cafe_bench --repetitions=5 --json=after.json
+#   ./scripts/compare_bench.py before.json after.json [--threshold=5] [--filter=hash_map]
+#
+# With repetitions, each side's median is compared, and a change within
+# both runs' noise (the larger stddev) is reported as noise, not as a
+# regression. Only the Python standard library is needed.
+# ============================================================================
+
+import argparse
+import json
+import statistics
+import sys
+
+
+def load_times(path):
+    """Map run_name -> (time in ns, stddev in ns) for one JSON file."""
+    with open(path) as f:
+        data = json.load(f)
+
+    samples = {}
+    for bench in data.get("benchmarks", []):
+        if bench.get("run_type", "iteration") != "iteration":
+            continue
+        name = bench.get("run_name", bench["name"])
+        samples.setdefault(name, []).append(float(bench["real_time"]))
+
+    times = {}
+    for name, values in samples.items():
+        spread = statistics.stdev(values) if len(values) > 1 else 0.0
+        times[name] = (statistics.median(values), spread)
+    return data.get("context", {}), times
+
+
+def format_ns(ns):
+    for unit, scale in (("s", 1e9), ("ms", 1e6), ("us", 1e3)):
+        if ns >= scale:
+            return "%.2f %s" % (ns / scale, unit)
+    return "%.1f ns" % ns
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Compare two cafe_bench --json runs")
+    parser.add_argument("baseline")
+    parser.add_argument("contender")
+    parser.add_argument("--threshold", type=float, default=5.0,
+                        help="percent slowdown that counts as a regression (default 5)")
+    parser.add_argument("--filter", default="", help="only benchmarks whose name contains this")
+    args = parser.parse_args()
+
+    base_context, base = load_times(args.baseline)
+    new_context, new = load_times(args.contender)
+
+    for label, context in (("baseline", base_context), ("contender", new_context)):
+        if context.get("library_build_type") == "debug":
+            print("Warning: %s was built without optimizations" % label, file=sys.stderr)
+
+    names = sorted(n for n in base.keys() & new.keys() if args.filter in n)
+    if not names:
+        print("No benchmarks in common", file=sys.stderr)
+        return 1
+
+    print("%-48s %12s %12s %9s  %s" % ("Benchmark", "Baseline", "Contender", "Change", ""))
+    print("-" * 92)
+
+    regressions = 0
+    for name in names:
+        (old_ns, old_sd), (new_ns, new_sd) = base[name], new[name]
+        change = (new_ns - old_ns) / old_ns * 100.0 if old_ns > 0 else 0.0
+        noise = max(old_sd, new_sd)
+
+        verdict = ""
+        if change > args.threshold:
+            if noise > 0 and new_ns - old_ns <= noise:
+                verdict = "noise"
+            else:
+                verdict = "REGRESSION"
+                regressions += 1
+        elif change < -args.threshold:
+            verdict = "faster"
+
+        print("%-48s %12s %12s %+8.1f%%  %s" % (name, format_ns(old_ns), format_ns(new_ns), change, verdict))
+
+    for label, only in (("baseline", base.keys() - new.keys()), ("contender", new.keys() - base.keys())):
+        for name in sorted(n for n in only if args.filter in n):
+            print("%-48s only in %s" % (name, label))
+
+    print("\n%d regression(s) beyond %.1f%%" % (regressions, args.threshold))
+    return 1 if regressions else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -59,9 +59,39 @@ public:
         float pitch = 1.0f;   // 1.0 = normal, 0.5 = half speed, 2.0 = double
         float pan = 0.0f;     // -1.0 = left, 0.0 = center, 1.0 = right
         bool loop = false;
+        int priority = 128;   // 0-255: higher keeps its voice when too many play
     };
     virtual ChannelHandle play_sound(SoundHandle sound, const PlayOptions& options) = 0;
 
+    // ========================================================================
+    // Positional Sounds
+    // ========================================================================
+    //
+    // Positions are world pixels - the space of Transform::position and of
+    // Isometric::tile_to_screen() before the camera scroll. Volume falls
+    // off with distance from the listener and pan follows the horizontal
+    // offset (options.pan is ignored). Backends without a software mixer
+    // play these as plain sounds.
+
+    virtual ChannelHandle play_sound_at(SoundHandle sound, float x, float y, const PlayOptions& options) {
+        (void)x;
+        (void)y;
+        return play_sound(sound, options);
+    }
+
+    // Move a playing positional sound (e.g. to follow its entity)
+    virtual void set_channel_position(ChannelHandle channel, float x, float y) {
+        (void)channel;
+        (void)x;
+        (void)y;
+    }
+
+    // Where the player hears from: usually the centre of the camera view
+    virtual void set_listener(float x, float y) {
+        (void)x;
+        (void)y;
+    }
+
     // ========================================================================
     // Music (streaming, only one at a time)
     // ========================================================================
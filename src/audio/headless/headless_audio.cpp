@@ -0,0 +1,102 @@
+#include "../software_audio.h"
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace cafe {
+
+// ============================================================================
+// Headless Audio Device (no sound card)
+// ============================================================================
+//
+// Stands in for the sound card on servers and CI: a thread pulls one
+// buffer from the mixer every buffer period, paced to the wall clock like
+// a real device, so the mixer sees the same callback pattern and cost.
+// With a path the mixed output is also written to a 16-bit WAV file -
+// listen to what a headless run played, or diff two runs.
+//
+// create_audio_system() picks the WAV sink when CAFE_AUDIO_WAV=<path> is
+// set and discards the samples otherwise.
+
+class HeadlessAudioDevice : public AudioDevice {
+public:
+    explicit HeadlessAudioDevice(std::string wav_path = std::string())
+        : wav_path_(std::move(wav_path)) {}
+
+    ~HeadlessAudioDevice() override { stop(); }
+
+    bool start(int sample_rate, FillCallback fill) override {
+        stop();
+        if (!fill || sample_rate <= 0) return false;
+
+        if (!wav_path_.empty() && !wav_.open(wav_path_, sample_rate, 2)) {
+            return false;
+        }
+
+        running_.store(true, std::memory_order_relaxed);
+        thread_ = std::thread([this, sample_rate, fill = std::move(fill)] {
+            run(sample_rate, fill);
+        });
+        return true;
+    }
+
+    void stop() override {
+        if (!thread_.joinable()) return;
+        running_.store(false, std::memory_order_relaxed);
+        thread_.join();
+        if (wav_.is_open()) {
+            std::cout << "Audio: " << wav_.frames_written() << " frames written to " << wav_path_ << "\n";
+            wav_.close();
+        }
+    }
+
+    const char* name() const override { return wav_path_.empty() ? "Null" : "WAV file"; }
+
+private:
+    static constexpr size_t BUFFER_FRAMES = 512;   // ~10.7 ms at 48 kHz
+
+    void run(int sample_rate, const FillCallback& fill) {
+        using clock = std::chrono::steady_clock;
+        const auto period = std::chrono::duration_cast<clock::duration>(
+            std::chrono::duration<double>(static_cast<double>(BUFFER_FRAMES) / sample_rate));
+
+        std::vector<float> buffer(2 * BUFFER_FRAMES);
+        auto deadline = clock::now();
+        while (running_.load(std::memory_order_relaxed)) {
+            fill(buffer.data(), BUFFER_FRAMES);
+            if (wav_.is_open()) {
+                wav_.write(buffer.data(), BUFFER_FRAMES);
+            }
+
+            // A device that fell behind drops the time instead of bursting
+            deadline += period;
+            auto now = clock::now();
+            if (deadline < now) deadline = now;
+            std::this_thread::sleep_until(deadline);
+        }
+    }
+
+    std::string wav_path_;
+    WavWriter wav_;
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+};
+
+// ============================================================================
+// Factory Function
+// ============================================================================
+
+#if !defined(__APPLE__) && !defined(__EMSCRIPTEN__)
+
+std::unique_ptr<AudioSystem> create_audio_system() {
+    const char* wav_path = std::getenv("CAFE_AUDIO_WAV");
+    return std::make_unique<SoftwareAudioSystem>(
+        std::make_unique<HeadlessAudioDevice>(wav_path ? wav_path : ""));
+}
+
+#endif
+
+} // namespace cafe
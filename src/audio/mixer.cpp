@@ -0,0 +1,730 @@
+#include "mixer.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define CAFE_SIMD_SSE2 1
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#define CAFE_SIMD_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace cafe {
+
+namespace {
+
+constexpr float kMinPitch = 1.0f / 64.0f;
+constexpr float kMaxPitch = 16.0f;
+constexpr float kHalfPi = 1.57079632679f;
+
+// bus[i] += src[i] * gain, gain moving linearly from (l0, r0) towards
+// (l1, r1) by the end of the block. Interleaved stereo, `frames` frames.
+void mix_ramp(float* bus, const float* src, size_t frames, float l0, float r0, float l1, float r1) {
+    const float inv = 1.0f / static_cast<float>(frames);
+    const float dl = (l1 - l0) * inv;
+    const float dr = (r1 - r0) * inv;
+    size_t i = 0;
+
+#if defined(CAFE_SIMD_SSE2)
+    // Two stereo frames per vector: (L0 R0 L1 R1)
+    __m128 gain = _mm_setr_ps(l0, r0, l0 + dl, r0 + dr);
+    const __m128 delta = _mm_setr_ps(2.0f * dl, 2.0f * dr, 2.0f * dl, 2.0f * dr);
+    for (; i + 2 <= frames; i += 2) {
+        __m128 acc = _mm_loadu_ps(bus + 2 * i);
+        acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(src + 2 * i), gain));
+        _mm_storeu_ps(bus + 2 * i, acc);
+        gain = _mm_add_ps(gain, delta);
+    }
+#elif defined(CAFE_SIMD_NEON)
+    const float init[4] = {l0, r0, l0 + dl, r0 + dr};
+    const float step[4] = {2.0f * dl, 2.0f * dr, 2.0f * dl, 2.0f * dr};
+    float32x4_t gain = vld1q_f32(init);
+    const float32x4_t delta = vld1q_f32(step);
+    for (; i + 2 <= frames; i += 2) {
+        float32x4_t acc = vld1q_f32(bus + 2 * i);
+        acc = vmlaq_f32(acc, vld1q_f32(src + 2 * i), gain);
+        vst1q_f32(bus + 2 * i, acc);
+        gain = vaddq_f32(gain, delta);
+    }
+#endif
+
+    // Scalar version (remainder, or the whole block without SIMD)
+    for (; i < frames; ++i) {
+        float t = static_cast<float>(i);
+        bus[2 * i] += src[2 * i] * (l0 + dl * t);
+        bus[2 * i + 1] += src[2 * i + 1] * (r0 + dr * t);
+    }
+}
+
+// Catmull-Rom through p1..p2 (p0 and p3 shape the tangents)
+inline float cubic(float p0, float p1, float p2, float p3, float t) {
+    float a = -0.5f * p0 + 1.5f * p1 - 1.5f * p2 + 0.5f * p3;
+    float b = p0 - 2.5f * p1 + 2.0f * p2 - 0.5f * p3;
+    float c = -0.5f * p0 + 0.5f * p2;
+    return ((a * t + b) * t + c) * t + p1;
+}
+
+// Resample one voice into `out` (interleaved stereo, mono duplicated).
+// Returns the frames produced; fewer than `frames` when a one-shot clip
+// ends (the rest is zeroed).
+template<int Channels, Resampler Mode>
+size_t render(const AudioClip& clip, bool loop, double& position, double step, float* out, size_t frames) {
+    const float* data = clip.samples.data();
+    const int64_t length = static_cast<int64_t>(clip.frames());
+
+    // Sample c of frame i, wrapping for loops and silent past either end
+    auto at = [&](int64_t i, int c) -> float {
+        if (loop) {
+            i %= length;
+            if (i < 0) i += length;
+        } else if (i < 0 || i >= length) {
+            return 0.0f;
+        }
+        return data[i * Channels + c];
+    };
+
+    size_t n = 0;
+    for (; n < frames; ++n) {
+        if (position >= static_cast<double>(length)) {
+            if (!loop) break;
+            position = std::fmod(position, static_cast<double>(length));
+        }
+
+        const int64_t i = static_cast<int64_t>(position);
+        const float t = static_cast<float>(position - static_cast<double>(i));
+        const bool inside = i >= 1 && i + 2 < length;   // No wrap or edge checks needed
+        const float* p = data + i * Channels;
+
+        for (int c = 0; c < Channels; ++c) {
+            float s;
+            if constexpr (Mode == Resampler::Linear) {
+                float s0 = inside ? p[c] : at(i, c);
+                float s1 = inside ? p[Channels + c] : at(i + 1, c);
+                s = s0 + (s1 - s0) * t;
+            } else {
+                s = inside ? cubic(p[c - Channels], p[c], p[Channels + c], p[2 * Channels + c], t)
+                           : cubic(at(i - 1, c), at(i, c), at(i + 1, c), at(i + 2, c), t);
+            }
+            out[2 * n + c] = s;
+            if constexpr (Channels == 1) {
+                out[2 * n + 1] = s;
+            }
+        }
+        position += step;
+    }
+
+    std::fill(out + 2 * n, out + 2 * frames, 0.0f);
+    return n;
+}
+
+} // namespace
+
+// ============================================================================
+// Construction
+// ============================================================================
+
+AudioMixer::AudioMixer(const MixerConfig& config) : config_(config) {
+    config_.sample_rate = std::max(config_.sample_rate, 1);
+    config_.max_voices = std::clamp(config_.max_voices, 1, 0xFFFF);
+
+    size_t count = static_cast<size_t>(config_.max_voices);
+    config_.max_real_voices = std::clamp(config_.max_real_voices, 1, config_.max_voices);
+    generations_.assign(count, 0);
+    priorities_.assign(count, 0);
+    streams_.assign(count, 0);
+    owners_ = std::make_unique<std::atomic<VoiceHandle>[]>(count);
+    audibility_ = std::make_unique<std::atomic<float>[]>(count);
+    for (size_t i = 0; i < count; ++i) {
+        owners_[i].store(INVALID_VOICE, std::memory_order_relaxed);
+        audibility_[i].store(0.0f, std::memory_order_relaxed);
+    }
+    for (auto& volume : bus_volume_) {
+        volume.store(1.0f, std::memory_order_relaxed);
+    }
+
+    voices_.resize(count);
+    active_.reserve(count);
+    tails_.reserve(count);
+    ranked_.reserve(count);
+    bus_.resize(2 * BLOCK_FRAMES);
+    scratch_.resize(2 * BLOCK_FRAMES);
+
+    float release_frames = std::max(config_.limiter_release_ms, 0.1f) * 0.001f * config_.sample_rate;
+    limiter_release_ = 1.0f - std::exp(-1.0f / release_frames);
+}
+
+AudioMixer::~AudioMixer() = default;
+
+// ============================================================================
+// Game thread
+// ============================================================================
+
+bool AudioMixer::push(const Command& command) {
+    Command sequenced = command;
+    sequenced.sequence = next_sequence_;
+    if (!commands_.push(sequenced)) {
+        return false;
+    }
+    ++next_sequence_;
+    return true;
+}
+
+VoiceHandle AudioMixer::play(const AudioClip* clip, const VoiceParams& params) {
+    if (!clip || !clip->is_valid() || clip->channels > 2) {
+        return INVALID_VOICE;
+    }
+    Command command;
+    command.type = Command::Type::Play;
+    command.clip = clip;
+    command.params = params;
+    return start(command);
+}
+
+VoiceHandle AudioMixer::play_stream(AudioStream* stream, const VoiceParams& params) {
+    if (!stream) {
+        return INVALID_VOICE;
+    }
+    Command command;
+    command.type = Command::Type::Play;
+    command.stream = stream;
+    command.params = params;
+    command.params.pitch = 1.0f;
+    return start(command);
+}
+
+VoiceHandle AudioMixer::start(Command& command) {
+    // Round-robin search for a slot the audio thread has released
+    uint32_t count = static_cast<uint32_t>(config_.max_voices);
+    for (uint32_t n = 0; n < count; ++n) {
+        uint32_t slot = (next_slot_ + n) % count;
+        if (owners_[slot].load(std::memory_order_acquire) != INVALID_VOICE) continue;
+
+        uint16_t generation = static_cast<uint16_t>(generations_[slot] + 1);
+        if (generation == 0) generation = 1;   // Keep handles non-zero
+        VoiceHandle handle = (static_cast<VoiceHandle>(generation) << 16) | slot;
+        command.handle = handle;
+
+        owners_[slot].store(handle, std::memory_order_relaxed);
+        if (!push(command)) {
+            owners_[slot].store(INVALID_VOICE, std::memory_order_relaxed);
+            break;
+        }
+        generations_[slot] = generation;
+        priorities_[slot] = command.params.priority;
+        streams_[slot] = command.stream != nullptr;
+        next_slot_ = (slot + 1) % count;
+        return handle;
+    }
+
+    // Every voice is taken: replace the least important one
+    uint32_t slot = steal_slot(command.params.priority);
+    if (slot < count) {
+        uint16_t generation = static_cast<uint16_t>(generations_[slot] + 1);
+        if (generation == 0) generation = 1;
+        VoiceHandle handle = (static_cast<VoiceHandle>(generation) << 16) | slot;
+        command.handle = handle;
+
+        // The old voice's handle stops matching at once; the audio thread
+        // swaps the voice when it sees the Play
+        VoiceHandle previous = owners_[slot].exchange(handle, std::memory_order_relaxed);
+        if (push(command)) {
+            generations_[slot] = generation;
+            priorities_[slot] = command.params.priority;
+            streams_[slot] = command.stream != nullptr;
+            stolen_voices_.fetch_add(1, std::memory_order_relaxed);
+            return handle;
+        }
+        VoiceHandle expected = handle;
+        owners_[slot].compare_exchange_strong(expected, previous, std::memory_order_relaxed);
+    }
+
+    dropped_plays_.fetch_add(1, std::memory_order_relaxed);
+    return INVALID_VOICE;
+}
+
+// Lowest priority, then quietest; `count` if every voice outranks `priority`.
+// Streams are skipped: their owner frees the stream once the voice is gone.
+uint32_t AudioMixer::steal_slot(uint8_t priority) const {
+    uint32_t count = static_cast<uint32_t>(config_.max_voices);
+    uint32_t best = count;
+    float best_audibility = 0.0f;
+    for (uint32_t slot = 0; slot < count; ++slot) {
+        if (streams_[slot] || priorities_[slot] > priority) continue;
+        float audibility = audibility_[slot].load(std::memory_order_relaxed);
+        if (best == count || priorities_[slot] < priorities_[best] ||
+            (priorities_[slot] == priorities_[best] && audibility < best_audibility)) {
+            best = slot;
+            best_audibility = audibility;
+        }
+    }
+    return best;
+}
+
+void AudioMixer::stop(VoiceHandle voice) {
+    if (!is_playing(voice)) return;
+    Command command;
+    command.type = Command::Type::Stop;
+    command.handle = voice;
+    if (!push(command)) dropped_commands_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void AudioMixer::stop_all() {
+    Command command;
+    command.type = Command::Type::StopAll;
+    if (!push(command)) dropped_commands_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void AudioMixer::stop_bus(AudioBus bus) {
+    Command command;
+    command.type = Command::Type::StopBus;
+    command.params.bus = bus;
+    if (!push(command)) dropped_commands_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void AudioMixer::set_paused(VoiceHandle voice, bool paused) {
+    if (!is_playing(voice)) return;
+    Command command;
+    command.type = paused ? Command::Type::Pause : Command::Type::Resume;
+    command.handle = voice;
+    if (!push(command)) dropped_commands_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void AudioMixer::set_volume(VoiceHandle voice, float volume) {
+    if (!is_playing(voice)) return;
+    Command command;
+    command.type = Command::Type::SetVolume;
+    command.handle = voice;
+    command.value = std::max(volume, 0.0f);
+    if (!push(command)) dropped_commands_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void AudioMixer::set_pan(VoiceHandle voice, float pan) {
+    if (!is_playing(voice)) return;
+    Command command;
+    command.type = Command::Type::SetPan;
+    command.handle = voice;
+    command.value = std::clamp(pan, -1.0f, 1.0f);
+    if (!push(command)) dropped_commands_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void AudioMixer::set_pitch(VoiceHandle voice, float pitch) {
+    if (!is_playing(voice)) return;
+    Command command;
+    command.type = Command::Type::SetPitch;
+    command.handle = voice;
+    command.value = std::clamp(pitch, kMinPitch, kMaxPitch);
+    if (!push(command)) dropped_commands_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void AudioMixer::set_spatial(VoiceHandle voice, float attenuation, float pan) {
+    if (!is_playing(voice)) return;
+    Command command;
+    command.type = Command::Type::SetSpatial;
+    command.handle = voice;
+    command.value = std::max(attenuation, 0.0f);
+    command.params.pan = std::clamp(pan, -1.0f, 1.0f);
+    if (!push(command)) dropped_commands_.fetch_add(1, std::memory_order_relaxed);
+}
+
+bool AudioMixer::is_playing(VoiceHandle voice) const {
+    if (voice == INVALID_VOICE || slot_of(voice) >= static_cast<uint32_t>(config_.max_voices)) {
+        return false;
+    }
+    return owners_[slot_of(voice)].load(std::memory_order_acquire) == voice;
+}
+
+void AudioMixer::fade(VoiceHandle voice, float volume, float seconds, bool stop_at_end) {
+    if (!is_playing(voice)) return;
+    Command command;
+    command.type = Command::Type::Fade;
+    command.handle = voice;
+    command.value = std::max(volume, 0.0f);
+    command.rate = seconds > 0.0f ? 1.0f / (seconds * static_cast<float>(config_.sample_rate)) : 0.0f;
+    command.flag = stop_at_end;
+    if (!push(command)) dropped_commands_.fetch_add(1, std::memory_order_relaxed);
+}
+
+uint64_t AudioMixer::stop_clip(const AudioClip* clip) {
+    return stop_source(clip, nullptr);
+}
+
+uint64_t AudioMixer::stop_stream(AudioStream* stream) {
+    return stop_source(nullptr, stream);
+}
+
+uint64_t AudioMixer::stop_source(const AudioClip* clip, AudioStream* stream) {
+    Command command;
+    command.type = Command::Type::StopSource;
+    command.clip = clip;
+    command.stream = stream;
+    uint64_t sequence = next_sequence_;
+    return push(command) ? sequence : 0;
+}
+
+bool AudioMixer::is_done(uint64_t sequence) const {
+    return sequence != 0 && completed_sequence_.load(std::memory_order_acquire) >= sequence;
+}
+
+void AudioMixer::set_master_volume(float volume) {
+    master_volume_.store(std::max(volume, 0.0f), std::memory_order_relaxed);
+}
+
+void AudioMixer::set_bus_volume(AudioBus bus, float volume) {
+    if (bus >= AudioBus::Count) return;
+    bus_volume_[static_cast<size_t>(bus)].store(std::max(volume, 0.0f), std::memory_order_relaxed);
+}
+
+MixerStats AudioMixer::stats() const {
+    MixerStats stats;
+    stats.active_voices = active_count_.load(std::memory_order_relaxed);
+    stats.dropped_plays = dropped_plays_.load(std::memory_order_relaxed);
+    stats.dropped_commands = dropped_commands_.load(std::memory_order_relaxed);
+    stats.frames_mixed = frames_mixed_.load(std::memory_order_relaxed);
+    stats.stream_underruns = stream_underruns_.load(std::memory_order_relaxed);
+    stats.limiter_gain = limiter_gain_stat_.load(std::memory_order_relaxed);
+    stats.real_voices = real_count_.load(std::memory_order_relaxed);
+    stats.virtual_voices = stats.active_voices - std::min(stats.real_voices, stats.active_voices);
+    stats.stolen_voices = stolen_voices_.load(std::memory_order_relaxed);
+    stats.mix_ms = mix_ms_.load(std::memory_order_relaxed);
+    stats.cpu_load = cpu_load_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+// ============================================================================
+// Audio thread
+// ============================================================================
+
+AudioMixer::Voice* AudioMixer::find(VoiceHandle handle) {
+    Voice& voice = voices_[slot_of(handle)];
+    return voice.active && voice.handle == handle ? &voice : nullptr;
+}
+
+void AudioMixer::apply(const Command& command) {
+    switch (command.type) {
+        case Command::Type::Play:
+            start_voice(command);
+            break;
+        case Command::Type::StopAll:
+            for (uint32_t slot : active_) voices_[slot].stopping = true;
+            break;
+        case Command::Type::StopBus:
+            for (uint32_t slot : active_) {
+                if (voices_[slot].params.bus == command.params.bus) voices_[slot].stopping = true;
+            }
+            break;
+        case Command::Type::StopSource:
+            for (uint32_t slot : active_) {
+                Voice& voice = voices_[slot];
+                if ((command.clip && voice.clip == command.clip) ||
+                    (command.stream && voice.stream == command.stream)) {
+                    // Silent at once: the source may be freed right after
+                    voice.clip = nullptr;
+                    voice.stream = nullptr;
+                    voice.stopping = true;
+                }
+            }
+            for (size_t t = 0; t < tails_.size();) {
+                if (command.clip && tails_[t].clip == command.clip) {
+                    tails_[t] = tails_.back();
+                    tails_.pop_back();
+                } else {
+                    ++t;
+                }
+            }
+            break;
+        default:
+            if (Voice* voice = find(command.handle)) {
+                switch (command.type) {
+                    case Command::Type::Stop:      voice->stopping = true; break;
+                    case Command::Type::Pause:     voice->paused = true; break;
+                    case Command::Type::Resume:    voice->paused = false; break;
+                    case Command::Type::SetVolume: voice->params.volume = command.value; break;
+                    case Command::Type::SetPan:    voice->params.pan = command.value; break;
+                    case Command::Type::SetSpatial:
+                        voice->params.attenuation = command.value;
+                        voice->params.pan = command.params.pan;
+                        break;
+                    case Command::Type::SetPitch:
+                        voice->params.pitch = command.value;
+                        update_step(*voice);
+                        break;
+                    case Command::Type::Fade:
+                        voice->fade_target = command.value;
+                        voice->fade_stop = command.flag;
+                        voice->fade_rate = command.rate;
+                        if (command.rate == 0.0f) {    // Zero length: jump
+                            voice->params.volume = command.value;
+                            voice->stopping = voice->stopping || command.flag;
+                        }
+                        break;
+                    default: break;
+                }
+            }
+            break;
+    }
+    completed_sequence_.store(command.sequence, std::memory_order_release);
+}
+
+void AudioMixer::start_voice(const Command& command) {
+    Voice& voice = voices_[slot_of(command.handle)];
+    bool stolen = voice.active;     // play() took this slot from a live voice
+
+    // Cutting an audible voice would click: let it ramp out for one block
+    if (stolen && voice.clip && !voice.paused && voice.gain_l + voice.gain_r > 0.0f &&
+        tails_.size() < tails_.capacity()) {
+        tails_.push_back(voice);
+    }
+
+    voice = Voice();
+    voice.clip = command.clip;
+    voice.stream = command.stream;
+    voice.handle = command.handle;
+    voice.params = command.params;
+    voice.params.volume = std::max(voice.params.volume, 0.0f);
+    voice.params.attenuation = std::max(voice.params.attenuation, 0.0f);
+    voice.params.pan = std::clamp(voice.params.pan, -1.0f, 1.0f);
+    voice.params.pitch = std::clamp(voice.params.pitch, kMinPitch, kMaxPitch);
+    if (voice.params.bus >= AudioBus::Count) voice.params.bus = AudioBus::Sound;
+    voice.active = true;
+    voice.fresh = true;
+    update_step(voice);
+
+    // Start at full gain: the clip's own attack decides how it begins
+    target_gains(voice, voice.gain_l, voice.gain_r);
+    if (!stolen) active_.push_back(slot_of(command.handle));
+}
+
+void AudioMixer::finish_voice(size_t active_index) {
+    uint32_t slot = active_[active_index];
+    Voice& voice = voices_[slot];
+    voice.active = false;
+    voice.clip = nullptr;
+    voice.stream = nullptr;
+
+    VoiceHandle expected = voice.handle;
+    owners_[slot].compare_exchange_strong(expected, INVALID_VOICE, std::memory_order_release);
+
+    active_[active_index] = active_.back();
+    active_.pop_back();
+}
+
+void AudioMixer::advance_fade(Voice& voice, size_t frames) const {
+    if (voice.fade_rate == 0.0f) return;
+
+    float step = voice.fade_rate * static_cast<float>(frames);
+    float& volume = voice.params.volume;
+    if (std::fabs(voice.fade_target - volume) <= step) {
+        volume = voice.fade_target;
+        voice.fade_rate = 0.0f;
+        if (voice.fade_stop) voice.stopping = true;
+    } else {
+        volume += volume < voice.fade_target ? step : -step;
+    }
+}
+
+void AudioMixer::update_step(Voice& voice) const {
+    if (!voice.clip) return;
+    voice.step = static_cast<double>(voice.params.pitch) * voice.clip->sample_rate / config_.sample_rate;
+}
+
+void AudioMixer::target_gains(const Voice& voice, float& left, float& right) const {
+    float gain = voice.params.volume * voice.params.attenuation *
+                 bus_volume_[static_cast<size_t>(voice.params.bus)].load(std::memory_order_relaxed) *
+                 master_volume_.load(std::memory_order_relaxed);
+    float pan = voice.params.pan;
+
+    if (voice.clip && voice.clip->channels == 1) {   // Streams are stereo
+        // Constant power: centre is -3 dB per side, loudness stays level
+        float angle = (pan + 1.0f) * 0.5f * kHalfPi;
+        left = gain * std::cos(angle);
+        right = gain * std::sin(angle);
+    } else {
+        // Stereo clips: balance, attenuating the far side only
+        left = gain * std::min(1.0f, 1.0f - pan);
+        right = gain * std::min(1.0f, 1.0f + pan);
+    }
+}
+
+size_t AudioMixer::render_voice(Voice& voice, float* out, size_t frames) {
+    if (voice.stream) {
+        // Underruns play silence but keep the voice; only the end stops it
+        size_t got = voice.stream->read(out, frames);
+        std::fill(out + 2 * got, out + 2 * frames, 0.0f);
+        if (got < frames) {
+            if (voice.stream->finished()) return got;
+            stream_underruns_.fetch_add(1, std::memory_order_relaxed);
+        }
+        return frames;
+    }
+
+    const AudioClip& clip = *voice.clip;
+    bool loop = voice.params.loop;
+    bool cubic = config_.resampler == Resampler::Cubic;
+
+    if (clip.channels == 1) {
+        return cubic ? render<1, Resampler::Cubic>(clip, loop, voice.position, voice.step, out, frames)
+                     : render<1, Resampler::Linear>(clip, loop, voice.position, voice.step, out, frames);
+    }
+    return cubic ? render<2, Resampler::Cubic>(clip, loop, voice.position, voice.step, out, frames)
+                 : render<2, Resampler::Linear>(clip, loop, voice.position, voice.step, out, frames);
+}
+
+// Advance a virtual voice as if it had played; fewer than `frames` when
+// a one-shot clip ends
+size_t AudioMixer::skip_voice(Voice& voice, size_t frames) const {
+    const double length = static_cast<double>(voice.clip->frames());
+    voice.position += voice.step * static_cast<double>(frames);
+    if (voice.position >= length) {
+        if (!voice.params.loop) return 0;
+        voice.position = std::fmod(voice.position, length);
+    }
+    return frames;
+}
+
+// Mark the voices mixed this block: the max_real_voices most important
+// audible ones. Streams always play - their samples must be consumed.
+void AudioMixer::choose_real_voices() {
+    ranked_.clear();
+    for (uint32_t slot : active_) {
+        Voice& voice = voices_[slot];
+        float left = 0.0f;
+        float right = 0.0f;
+        target_gains(voice, left, right);
+        voice.audibility = std::max(left, right);
+        audibility_[slot].store(voice.audibility, std::memory_order_relaxed);
+
+        voice.real = voice.stream != nullptr;
+        if (!voice.real && !voice.paused && voice.audibility >= config_.virtual_threshold) {
+            ranked_.push_back(slot);
+        }
+    }
+
+    size_t budget = static_cast<size_t>(config_.max_real_voices);
+    if (ranked_.size() > budget) {
+        // A voice already playing counts ~3.5 dB louder, so two voices near
+        // the cut do not trade places (and fade in and out) every block
+        auto rank = [this](uint32_t slot) {
+            const Voice& voice = voices_[slot];
+            return voice.audibility * (voice.gain_l + voice.gain_r > 0.0f ? 1.5f : 1.0f);
+        };
+        std::nth_element(ranked_.begin(), ranked_.begin() + static_cast<std::ptrdiff_t>(budget), ranked_.end(),
+                         [this, &rank](uint32_t a, uint32_t b) {
+                             uint8_t pa = voices_[a].params.priority;
+                             uint8_t pb = voices_[b].params.priority;
+                             return pa != pb ? pa > pb : rank(a) > rank(b);
+                         });
+        ranked_.resize(budget);
+    }
+    for (uint32_t slot : ranked_) voices_[slot].real = true;
+}
+
+void AudioMixer::mix_block(float* out, size_t frames) {
+    std::fill(bus_.begin(), bus_.begin() + 2 * frames, 0.0f);
+    choose_real_voices();
+
+    uint32_t mixed = 0;
+    for (Voice& tail : tails_) {
+        render_voice(tail, scratch_.data(), frames);
+        mix_ramp(bus_.data(), scratch_.data(), frames, tail.gain_l, tail.gain_r, 0.0f, 0.0f);
+        ++mixed;
+    }
+    tails_.clear();
+
+    for (size_t a = 0; a < active_.size();) {
+        Voice& voice = voices_[active_[a]];
+        if (!voice.clip && !voice.stream) {    // Its source was stopped
+            finish_voice(a);
+            continue;
+        }
+        if (voice.paused && !voice.stopping) {
+            ++a;
+            continue;
+        }
+
+        if (voice.fresh) {
+            // Born virtual (a crowd over budget): never ramp in at all
+            if (!voice.real) voice.gain_l = voice.gain_r = 0.0f;
+            voice.fresh = false;
+        }
+
+        advance_fade(voice, frames);
+        float left = 0.0f;
+        float right = 0.0f;
+        if (!voice.stopping && voice.real) {
+            target_gains(voice, left, right);
+        }
+
+        // Silent at both ends of the block: virtual, only the position moves.
+        // Going virtual or coming back ramps over one block like any change.
+        size_t produced;
+        if (voice.clip && voice.gain_l + voice.gain_r == 0.0f && left + right == 0.0f) {
+            produced = skip_voice(voice, frames);
+        } else {
+            produced = render_voice(voice, scratch_.data(), frames);
+            mix_ramp(bus_.data(), scratch_.data(), frames, voice.gain_l, voice.gain_r, left, right);
+            ++mixed;
+        }
+        voice.gain_l = left;
+        voice.gain_r = right;
+
+        if (voice.stopping || produced < frames) {
+            finish_voice(a);
+        } else {
+            ++a;
+        }
+    }
+    real_count_.store(mixed, std::memory_order_relaxed);
+
+    // Master limiter: instant attack, exponential release
+    const float threshold = config_.limiter_threshold;
+    float gain = limiter_gain_;
+    float lowest = 1.0f;
+    for (size_t i = 0; i < frames; ++i) {
+        float l = bus_[2 * i];
+        float r = bus_[2 * i + 1];
+        float peak = std::max(std::fabs(l), std::fabs(r));
+        float target = peak > threshold ? threshold / peak : 1.0f;
+        gain = target < gain ? target : gain + (target - gain) * limiter_release_;
+        lowest = std::min(lowest, gain);
+        out[2 * i] = std::clamp(l * gain, -1.0f, 1.0f);
+        out[2 * i + 1] = std::clamp(r * gain, -1.0f, 1.0f);
+    }
+    limiter_gain_ = gain;
+    limiter_gain_stat_.store(lowest, std::memory_order_relaxed);
+}
+
+void AudioMixer::mix(float* out, size_t frames) {
+    using Clock = std::chrono::steady_clock;
+    auto start = Clock::now();
+
+    Command command;
+    while (commands_.pop(command)) {
+        apply(command);
+    }
+
+    float lowest = 1.0f;
+    for (size_t done = 0; done < frames;) {
+        size_t n = std::min(frames - done, BLOCK_FRAMES);
+        mix_block(out + 2 * done, n);
+        lowest = std::min(lowest, limiter_gain_stat_.load(std::memory_order_relaxed));
+        done += n;
+    }
+    limiter_gain_stat_.store(lowest, std::memory_order_relaxed);
+
+    active_count_.store(static_cast<uint32_t>(active_.size()), std::memory_order_relaxed);
+    frames_mixed_.fetch_add(frames, std::memory_order_relaxed);
+
+    // CPU cost as a share of the audio it produced (1 = just keeping up)
+    float ms = std::chrono::duration<float, std::milli>(Clock::now() - start).count();
+    float buffer_ms = static_cast<float>(frames) * 1000.0f / static_cast<float>(config_.sample_rate);
+    float load = cpu_load_.load(std::memory_order_relaxed);
+    mix_ms_.store(ms, std::memory_order_relaxed);
+    if (buffer_ms > 0.0f) {
+        cpu_load_.store(load + (ms / buffer_ms - load) * 0.05f, std::memory_order_relaxed);
+    }
+}
+
+} // namespace cafe
@@ -0,0 +1,287 @@
+#ifndef CAFE_MIXER_H
+#define CAFE_MIXER_H
+
+#include "wav.h"
+#include "../engine/spsc_queue.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace cafe {
+
+// ============================================================================
+// AudioMixer - Portable software mixer
+// ============================================================================
+//
+// Mixes any number of playing clips into one interleaved stereo float
+// stream. A backend only has to call mix() from its audio callback to
+// fill the device buffer; everything else is plain C++.
+//
+// Two threads use a mixer:
+//
+//   game thread    play(), stop(), set_volume(), ... - never blocks
+//   audio thread   mix() - never locks, allocates or frees
+//
+// Game-thread calls become commands in a lock-free SPSC queue that mix()
+// drains at the start of each buffer, so a play() is heard from the next
+// device buffer on. The audio thread owns all voice state; the game
+// thread only sees which handle each voice slot belongs to.
+//
+// Voices:
+//   A fixed pool (MixerConfig::max_voices) allocated up front. play()
+//   returns INVALID_VOICE when every voice is busy and none may be
+//   stolen (counted in stats).
+//   Handles carry a generation, so a stale handle never controls the
+//   voice that reused its slot.
+//
+// Per voice: volume, pan and pitch. Pitch resamples on the fly (the clip's
+// own sample rate is folded in), with linear or cubic (Catmull-Rom)
+// interpolation. Gain changes - volume, pan, stop - ramp over one block
+// (256 frames, ~5 ms) instead of jumping, which would click.
+//
+// The per-voice add into the mix bus is SSE2 / NEON (two stereo frames per
+// vector). The master limiter at the end holds peaks under the threshold
+// with an instant attack and a smooth release, so 200 overlapping sounds
+// get quieter instead of clipping.
+//
+// Streams: play_stream() plays an AudioStream - samples produced while
+// playing, e.g. music decoded on another thread - instead of a clip.
+// fade() ramps a voice's volume over any length of time; with a new and
+// an old voice fading in opposite directions it is a cross-fade.
+//
+// Virtual voices: only the max_real_voices most important voices are
+// resampled and mixed each block; the rest - and any voice quieter than
+// virtual_threshold - are virtual: their play position still advances, so
+// when one becomes audible again it ramps back in exactly where it would
+// have been. Importance is VoiceParams::priority first, then loudness. A
+// crowd of 200 positional sounds costs what max_real_voices cost.
+//
+// Stealing: when every voice is taken, play() replaces the least
+// important one (lowest priority, then quietest - usually a virtual voice)
+// if its priority is not above the new sound's. Stream voices are never
+// stolen. A stolen voice that was audible fades out over one block.
+//
+// Clip lifetime: a clip must outlive every voice playing it. To free one,
+// call stop_clip() and wait until is_done() reports the returned sequence
+// (SoftwareAudioSystem does this in update()). Streams likewise, with
+// stop_stream().
+//
+// ============================================================================
+
+using VoiceHandle = uint32_t;
+constexpr VoiceHandle INVALID_VOICE = 0;
+
+enum class Resampler {
+    Linear,   // 2 taps; cheap, slight high-frequency loss when pitched
+    Cubic     // 4 taps (Catmull-Rom); smoother when pitched down
+};
+
+// Volume groups (SoftwareAudioSystem: sound effects and music)
+enum class AudioBus : uint8_t {
+    Sound,
+    Music,
+    Count
+};
+
+// Samples produced while they play. read() runs on the audio thread and
+// must not block: return what is ready, even if that is less than asked.
+class AudioStream {
+public:
+    virtual ~AudioStream() = default;
+
+    // Interleaved stereo at the mixer's sample rate
+    virtual size_t read(float* out, size_t frames) = 0;
+
+    // No more samples will come (read() returning short is an underrun
+    // until this is true)
+    virtual bool finished() const = 0;
+};
+
+struct VoiceParams {
+    float volume = 1.0f;
+    float pan = 0.0f;        // -1 = left, 0 = center, 1 = right
+    float pitch = 1.0f;      // Playback rate: 2 = an octave up, twice as fast (clips only)
+    bool loop = false;
+    AudioBus bus = AudioBus::Sound;
+    float attenuation = 1.0f;  // Distance gain (set_spatial), applied with volume
+    uint8_t priority = 128;    // Higher keeps its voice when voices run out
+};
+
+struct MixerConfig {
+    int sample_rate = 48000;
+    int max_voices = 256;
+    Resampler resampler = Resampler::Linear;
+    float limiter_threshold = 0.9f;     // Peak output level
+    float limiter_release_ms = 100.0f;  // Time to recover after a peak
+    int max_real_voices = 64;           // Voices actually mixed per block
+    float virtual_threshold = 0.001f;   // Quieter voices (-60 dB) are not mixed
+};
+
+struct MixerStats {
+    uint32_t active_voices = 0;
+    uint64_t dropped_plays = 0;     // play() with no free voice or a full queue
+    uint64_t dropped_commands = 0;  // Other commands lost to a full queue
+    uint64_t frames_mixed = 0;
+    uint64_t stream_underruns = 0;  // Buffers where a stream had too few samples
+    float limiter_gain = 1.0f;      // Lowest gain in the last buffer (1 = idle)
+    uint32_t real_voices = 0;       // Mixed in the last block
+    uint32_t virtual_voices = 0;    // Tracked but not mixed (includes paused)
+    uint64_t stolen_voices = 0;     // Voices replaced by a play()
+    float mix_ms = 0.0f;            // CPU time of the last mix() call
+    float cpu_load = 0.0f;          // mix() time / buffer duration, smoothed
+};
+
+class AudioMixer {
+public:
+    explicit AudioMixer(const MixerConfig& config = MixerConfig());
+    ~AudioMixer();
+
+    AudioMixer(const AudioMixer&) = delete;
+    AudioMixer& operator=(const AudioMixer&) = delete;
+
+    // ========================================================================
+    // Game thread
+    // ========================================================================
+
+    VoiceHandle play(const AudioClip* clip, const VoiceParams& params = VoiceParams());
+    VoiceHandle play_stream(AudioStream* stream, const VoiceParams& params = VoiceParams());
+    void stop(VoiceHandle voice);                 // Fades out over one block
+    void stop_all();
+    void stop_bus(AudioBus bus);
+    void set_paused(VoiceHandle voice, bool paused);
+    void set_volume(VoiceHandle voice, float volume);
+    void set_pan(VoiceHandle voice, float pan);
+    void set_pitch(VoiceHandle voice, float pitch);
+
+    // Positional sounds: distance gain and pan in one command
+    void set_spatial(VoiceHandle voice, float attenuation, float pan);
+
+    // Move the voice's volume to `volume` over `seconds`; stop it when
+    // done if `stop_at_end` (a fade-out)
+    void fade(VoiceHandle voice, float volume, float seconds, bool stop_at_end = false);
+
+    // True from play() until the voice finishes or its stop is processed
+    bool is_playing(VoiceHandle voice) const;
+
+    // Stop every voice playing `clip`; returns a sequence for is_done(),
+    // or 0 if the queue is full (retry later)
+    uint64_t stop_clip(const AudioClip* clip);
+    uint64_t stop_stream(AudioStream* stream);
+    bool is_done(uint64_t sequence) const;
+
+    // Applied on top of voice volumes (ramped, so changes do not click)
+    void set_master_volume(float volume);
+    void set_bus_volume(AudioBus bus, float volume);
+
+    MixerStats stats() const;
+    int sample_rate() const { return config_.sample_rate; }
+    int max_voices() const { return config_.max_voices; }
+
+    // ========================================================================
+    // Audio thread
+    // ========================================================================
+
+    // Fill `frames` interleaved stereo frames (out[2 * frames])
+    void mix(float* out, size_t frames);
+
+    static constexpr size_t BLOCK_FRAMES = 256;
+
+private:
+    struct Command {
+        enum class Type : uint8_t {
+            Play, Stop, StopAll, StopBus, Pause, Resume, SetVolume, SetPan, SetPitch, SetSpatial, Fade,
+            StopSource
+        };
+        Type type = Type::Stop;
+        VoiceHandle handle = INVALID_VOICE;
+        const AudioClip* clip = nullptr;
+        AudioStream* stream = nullptr;
+        VoiceParams params;
+        float value = 0.0f;
+        float rate = 0.0f;         // Fade: volume change per frame
+        bool flag = false;         // Fade: stop at the end
+        uint64_t sequence = 0;
+    };
+
+    struct Voice {
+        const AudioClip* clip = nullptr;
+        AudioStream* stream = nullptr;
+        VoiceHandle handle = INVALID_VOICE;
+        double position = 0.0;     // In clip frames
+        double step = 1.0;         // Clip frames per output frame
+        VoiceParams params;
+        float gain_l = 0.0f;       // Gains applied at the end of the last block
+        float gain_r = 0.0f;
+        float fade_target = 0.0f;
+        float fade_rate = 0.0f;    // Volume per frame; 0 = not fading
+        bool fade_stop = false;
+        float audibility = 0.0f;   // Loudest target gain this block
+        bool real = false;         // Mixed this block (else virtual)
+        bool fresh = false;        // Not through a block yet
+        bool paused = false;
+        bool stopping = false;
+        bool active = false;
+    };
+
+    bool push(const Command& command);
+    VoiceHandle start(Command& command);
+    uint32_t steal_slot(uint8_t priority) const;
+    uint64_t stop_source(const AudioClip* clip, AudioStream* stream);
+    void advance_fade(Voice& voice, size_t frames) const;
+    void apply(const Command& command);
+    Voice* find(VoiceHandle handle);
+    void start_voice(const Command& command);
+    void finish_voice(size_t active_index);
+    void update_step(Voice& voice) const;
+    void target_gains(const Voice& voice, float& left, float& right) const;
+    size_t render_voice(Voice& voice, float* out, size_t frames);
+    size_t skip_voice(Voice& voice, size_t frames) const;
+    void choose_real_voices();
+    void mix_block(float* out, size_t frames);
+
+    static uint32_t slot_of(VoiceHandle handle) { return handle & 0xFFFF; }
+
+    MixerConfig config_;
+
+    // Game thread
+    std::vector<uint16_t> generations_;
+    std::vector<uint8_t> priorities_;
+    std::vector<uint8_t> streams_;        // Per slot: last play was a stream
+    uint32_t next_slot_ = 0;
+    uint64_t next_sequence_ = 1;
+
+    // Shared: owner handle per slot (0 = free). The game thread claims free
+    // slots, the audio thread releases them when the voice ends.
+    std::unique_ptr<std::atomic<VoiceHandle>[]> owners_;
+    std::unique_ptr<std::atomic<float>[]> audibility_;   // Per slot, for stealing
+    SpscQueue<Command, 1024> commands_;
+    std::atomic<uint64_t> completed_sequence_{0};
+    std::atomic<float> master_volume_{1.0f};
+    std::atomic<float> bus_volume_[static_cast<size_t>(AudioBus::Count)];
+    std::atomic<uint32_t> active_count_{0};
+    std::atomic<uint64_t> dropped_plays_{0};
+    std::atomic<uint64_t> dropped_commands_{0};
+    std::atomic<uint64_t> frames_mixed_{0};
+    std::atomic<uint64_t> stream_underruns_{0};
+    std::atomic<float> limiter_gain_stat_{1.0f};
+    std::atomic<uint32_t> real_count_{0};
+    std::atomic<uint64_t> stolen_voices_{0};
+    std::atomic<float> mix_ms_{0.0f};
+    std::atomic<float> cpu_load_{0.0f};
+
+    // Audio thread
+    std::vector<Voice> voices_;
+    std::vector<uint32_t> active_;        // Slots of active voices
+    std::vector<Voice> tails_;            // Stolen voices fading out this block
+    std::vector<uint32_t> ranked_;        // choose_real_voices() scratch
+    std::vector<float> bus_;              // Stereo mix of one block
+    std::vector<float> scratch_;          // One voice, resampled
+    float limiter_gain_ = 1.0f;
+    float limiter_release_ = 0.0f;        // Per-frame recovery coefficient
+};
+
+} // namespace cafe
+
+#endif // CAFE_MIXER_H
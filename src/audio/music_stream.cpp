@@ -0,0 +1,357 @@
+#include "music_stream.h"
+#include "qoa.h"
+#include "wav.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+namespace cafe {
+
+// ============================================================================
+// Sources - Read a file a piece at a time
+// ============================================================================
+
+class MusicStream::Source {
+public:
+    virtual ~Source() {
+        if (file_) std::fclose(file_);
+    }
+
+    // Up to `frames` interleaved frames at the file's rate and channels;
+    // 0 at the end of the data
+    virtual size_t read(float* out, size_t frames) = 0;
+
+    // Back to the first sample
+    virtual bool rewind() = 0;
+
+    virtual size_t buffer_bytes() const = 0;
+
+    int channels = 0;
+    int sample_rate = 0;
+    uint64_t frames = 0;        // Per pass, 0 if unknown
+
+protected:
+    std::FILE* file_ = nullptr;
+};
+
+namespace {
+
+constexpr int kMaxMusicChannels = 2;
+
+class QoaSource : public MusicStream::Source {
+public:
+    bool open(std::FILE* file) {
+        file_ = file;
+        uint8_t header[qoa::FILE_HEADER_SIZE + qoa::FRAME_HEADER_SIZE];
+        uint32_t samples = 0;
+        qoa::FrameHeader first;
+        if (std::fread(header, 1, sizeof(header), file_) != sizeof(header) ||
+            !qoa::read_file_header(header, sizeof(header), samples) ||
+            !qoa::read_frame_header(header + qoa::FILE_HEADER_SIZE, qoa::FRAME_HEADER_SIZE, first)) {
+            std::cerr << "MusicStream: Bad QOA header\n";
+            return false;
+        }
+        if (first.channels > kMaxMusicChannels) {
+            std::cerr << "MusicStream: " << first.channels << "-channel QOA not supported\n";
+            return false;
+        }
+
+        channels = first.channels;
+        sample_rate = first.sample_rate;
+        frames = samples;
+        bytes_.resize(qoa::frame_size(channels, qoa::FRAME_LEN));
+        decoded_.resize(static_cast<size_t>(qoa::FRAME_LEN) * static_cast<size_t>(channels));
+        return rewind();
+    }
+
+    size_t read(float* out, size_t count) override {
+        size_t done = 0;
+        while (done < count) {
+            if (cursor_ == available_ && !next_frame()) break;
+            size_t n = std::min(count - done, available_ - cursor_);
+            const int16_t* src = decoded_.data() + cursor_ * static_cast<size_t>(channels);
+            float* dst = out + done * static_cast<size_t>(channels);
+            for (size_t i = 0; i < n * static_cast<size_t>(channels); ++i) {
+                dst[i] = static_cast<float>(src[i]) * (1.0f / 32768.0f);
+            }
+            cursor_ += n;
+            done += n;
+        }
+        return done;
+    }
+
+    bool rewind() override {
+        cursor_ = available_ = 0;
+        return std::fseek(file_, static_cast<long>(qoa::FILE_HEADER_SIZE), SEEK_SET) == 0;
+    }
+
+    size_t buffer_bytes() const override {
+        return bytes_.capacity() + decoded_.capacity() * sizeof(int16_t);
+    }
+
+private:
+    // Decode the next frame into decoded_; false at the end (or a bad frame)
+    bool next_frame() {
+        qoa::FrameHeader header;
+        if (std::fread(bytes_.data(), 1, qoa::FRAME_HEADER_SIZE, file_) != qoa::FRAME_HEADER_SIZE ||
+            !qoa::read_frame_header(bytes_.data(), qoa::FRAME_HEADER_SIZE, header) ||
+            header.channels != channels) {
+            return false;
+        }
+        size_t body = header.size - qoa::FRAME_HEADER_SIZE;
+        if (std::fread(bytes_.data() + qoa::FRAME_HEADER_SIZE, 1, body, file_) != body ||
+            !qoa::decode_frame(bytes_.data(), header.size, header, decoded_.data())) {
+            return false;
+        }
+        cursor_ = 0;
+        available_ = static_cast<size_t>(header.samples);
+        return true;
+    }
+
+    std::vector<uint8_t> bytes_;      // One encoded frame
+    std::vector<int16_t> decoded_;    // One decoded frame
+    size_t cursor_ = 0;
+    size_t available_ = 0;
+};
+
+class WavSource : public MusicStream::Source {
+public:
+    bool open(std::FILE* file) {
+        file_ = file;
+        if (!read_wav_format(file_, format_)) return false;
+        channels = format_.channels;
+        sample_rate = format_.sample_rate;
+        frames = format_.frames();
+        bytes_.resize(MusicStream::CHUNK_FRAMES * format_.frame_bytes());
+        return rewind();
+    }
+
+    size_t read(float* out, size_t count) override {
+        count = static_cast<size_t>(std::min<uint64_t>({count, remaining_, MusicStream::CHUNK_FRAMES}));
+        size_t got = std::fread(bytes_.data(), format_.frame_bytes(), count, file_);
+        decode_wav_samples(bytes_.data(), got * static_cast<size_t>(channels), format_, out);
+        remaining_ = got == count ? remaining_ - got : 0;   // A short read ends the data
+        return got;
+    }
+
+    bool rewind() override {
+        remaining_ = frames;
+        return std::fseek(file_, static_cast<long>(format_.data_offset), SEEK_SET) == 0;
+    }
+
+    size_t buffer_bytes() const override { return bytes_.capacity(); }
+
+private:
+    WavFormat format_;
+    std::vector<uint8_t> bytes_;
+    uint64_t remaining_ = 0;
+};
+
+std::unique_ptr<MusicStream::Source> open_source(const std::string& path) {
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) {
+        std::cerr << "MusicStream: Cannot open " << path << "\n";
+        return nullptr;
+    }
+
+    char magic[4] = {};
+    bool have_magic = std::fread(magic, 1, 4, file) == 4 && std::fseek(file, 0, SEEK_SET) == 0;
+
+    // The sources close the file from here on
+    if (have_magic && std::memcmp(magic, "qoaf", 4) == 0) {
+        auto source = std::make_unique<QoaSource>();
+        if (source->open(file)) return source;
+    } else if (have_magic && std::memcmp(magic, "RIFF", 4) == 0) {
+        auto source = std::make_unique<WavSource>();
+        if (source->open(file)) return source;
+    } else {
+        std::cerr << "MusicStream: " << path << " is neither QOA nor WAV\n";
+        std::fclose(file);
+    }
+    return nullptr;
+}
+
+} // namespace
+
+// ============================================================================
+// MusicStream
+// ============================================================================
+
+MusicStream::MusicStream(int output_rate, Resampler resampler)
+    : output_rate_(output_rate), resampler_(resampler), ring_(RING_FRAMES * 2) {}
+
+MusicStream::~MusicStream() {
+    close();
+}
+
+bool MusicStream::open(const std::string& path, bool loop) {
+    close();
+
+    // Leftovers of a previous track (never reopen while a voice plays it)
+    while (ring_.read(output_.data(), output_.size()) > 0) {}
+    decode_ns_.store(0, std::memory_order_relaxed);
+    frames_out_.store(0, std::memory_order_relaxed);
+    loops_.store(0, std::memory_order_relaxed);
+
+    source_ = open_source(path);
+    if (!source_) return false;
+    if (loop && source_->frames == 0) loop = false;   // Nothing to loop over
+
+    loop_ = loop;
+    step_ = static_cast<double>(source_->sample_rate) / output_rate_;
+    position_ = 1.0;
+    end_frame_ = SIZE_MAX;
+
+    // One frame of silence before the start: the cubic filter's first tap
+    window_.assign(2, 0.0f);
+    window_.reserve((CHUNK_FRAMES + 8) * 2);
+    chunk_.resize(CHUNK_FRAMES * static_cast<size_t>(source_->channels));
+    output_.resize(CHUNK_FRAMES * 2);
+
+    resident_bytes_ = sizeof(*this) + ring_.capacity() * sizeof(float) +
+                      (window_.capacity() + chunk_.capacity() + output_.capacity()) * sizeof(float) +
+                      source_->buffer_bytes();
+
+    // A head start, so the first buffers never underrun
+    for (int i = 0; i < 2; ++i) {
+        size_t n = produce(output_.data(), CHUNK_FRAMES);
+        ring_.write(output_.data(), n * 2);
+    }
+
+    quit_.store(false, std::memory_order_relaxed);
+    thread_ = std::thread(&MusicStream::decode_loop, this);
+    return true;
+}
+
+void MusicStream::close() {
+    if (thread_.joinable()) {
+        quit_.store(true, std::memory_order_relaxed);
+        thread_.join();
+    }
+    source_.reset();
+    done_.store(false, std::memory_order_relaxed);
+}
+
+size_t MusicStream::read(float* out, size_t frames) {
+    return ring_.read(out, frames * 2) / 2;
+}
+
+bool MusicStream::finished() const {
+    return done_.load(std::memory_order_acquire) && ring_.available() == 0;
+}
+
+MusicStreamStats MusicStream::stats() const {
+    MusicStreamStats stats;
+    stats.audio_seconds = static_cast<double>(frames_out_.load(std::memory_order_relaxed)) / output_rate_;
+    stats.decode_seconds = static_cast<double>(decode_ns_.load(std::memory_order_relaxed)) * 1e-9;
+    stats.loops = loops_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+double MusicStream::duration() const {
+    return source_ && source_->sample_rate > 0 ? static_cast<double>(source_->frames) / source_->sample_rate : 0.0;
+}
+
+int MusicStream::source_rate() const {
+    return source_ ? source_->sample_rate : 0;
+}
+
+int MusicStream::source_channels() const {
+    return source_ ? source_->channels : 0;
+}
+
+// ============================================================================
+// Decode thread
+// ============================================================================
+
+void MusicStream::decode_loop() {
+    using Clock = std::chrono::steady_clock;
+
+    while (!quit_.load(std::memory_order_relaxed)) {
+        if (ring_.free_space() < CHUNK_FRAMES * 2) {
+            // Full: the ring holds ~170 ms, so a 5 ms nap is plenty early
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            continue;
+        }
+
+        auto start = Clock::now();
+        size_t n = produce(output_.data(), CHUNK_FRAMES);
+        auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start);
+        decode_ns_.fetch_add(static_cast<uint64_t>(elapsed.count()), std::memory_order_relaxed);
+
+        ring_.write(output_.data(), n * 2);
+        if (n < CHUNK_FRAMES) {
+            // End of the track (or a read error): nothing more will come
+            done_.store(true, std::memory_order_release);
+            return;
+        }
+    }
+}
+
+// Resample window_ into `frames` stereo output frames; short only at the end
+size_t MusicStream::produce(float* out, size_t frames) {
+    bool cubic = resampler_ == Resampler::Cubic;
+    size_t n = 0;
+
+    while (n < frames) {
+        size_t i = static_cast<size_t>(position_);
+        if (i >= end_frame_) break;
+        if (i + 2 >= window_.size() / 2) {
+            if (!refill()) break;
+            continue;
+        }
+
+        const float* p = window_.data() + (i - 1) * 2;   // Frames i-1 .. i+2
+        float t = static_cast<float>(position_ - static_cast<double>(i));
+        for (int c = 0; c < 2; ++c) {
+            float p0 = p[c], p1 = p[2 + c], p2 = p[4 + c], p3 = p[6 + c];
+            out[n * 2 + c] = cubic
+                ? p1 + 0.5f * t * (p2 - p0 + t * (2.0f * p0 - 5.0f * p1 + 4.0f * p2 - p3 +
+                                                   t * (3.0f * (p1 - p2) + p3 - p0)))
+                : p1 + (p2 - p1) * t;
+        }
+        position_ += step_;
+        ++n;
+    }
+
+    frames_out_.fetch_add(n, std::memory_order_relaxed);
+    return n;
+}
+
+// Drop used frames (keeping one of history) and append the next chunk
+bool MusicStream::refill() {
+    if (end_frame_ != SIZE_MAX) return false;
+
+    size_t used = std::min(static_cast<size_t>(position_) - 1, window_.size() / 2);
+    window_.erase(window_.begin(), window_.begin() + static_cast<std::ptrdiff_t>(used * 2));
+    position_ -= static_cast<double>(used);
+
+    size_t got = source_->read(chunk_.data(), CHUNK_FRAMES);
+    if (got == 0 && loop_) {
+        // Gapless: the first frames follow the last ones in the same window
+        if (source_->rewind()) {
+            loops_.fetch_add(1, std::memory_order_relaxed);
+            got = source_->read(chunk_.data(), CHUNK_FRAMES);
+        }
+    }
+    if (got == 0) {
+        // Track over: pad so the filter can reach the last real frame
+        end_frame_ = window_.size() / 2;
+        window_.insert(window_.end(), 6, 0.0f);
+        return true;
+    }
+
+    if (source_->channels == 1) {
+        for (size_t f = 0; f < got; ++f) {
+            window_.push_back(chunk_[f]);
+            window_.push_back(chunk_[f]);
+        }
+    } else {
+        window_.insert(window_.end(), chunk_.begin(), chunk_.begin() + static_cast<std::ptrdiff_t>(got * 2));
+    }
+    return true;
+}
+
+} // namespace cafe
@@ -0,0 +1,112 @@
+#ifndef CAFE_MUSIC_STREAM_H
+#define CAFE_MUSIC_STREAM_H
+
+#include "mixer.h"
+#include "../engine/spsc_queue.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace cafe {
+
+// ============================================================================
+// MusicStream - Music decoded while it plays
+// ============================================================================
+//
+// A whole track decoded up front costs ~23 MB for 2 minutes of 48 kHz
+// stereo float, and a long load before it starts. A MusicStream keeps
+// only a small window of the track in memory instead:
+//
+//   file ──fread──> decoder ──resample──> ring (~170 ms) ──read()──> mixer
+//                   └──── decode thread ────┘            audio thread
+//
+// The decode thread tops the ring up in 1024-frame chunks and sleeps while
+// it is full; the audio thread's read() only copies out of the ring, so
+// neither side ever waits on the other. Memory stays the same whatever
+// the track length (resident_bytes(), ~120 KB).
+//
+// Formats: .qoa (see qoa.h; tools/encode_qoa.cpp converts WAV) and PCM WAV,
+// mono or stereo, any sample rate (resampled to the mixer's with cubic
+// interpolation).
+//
+// Looping is gapless: at the end of the file the decoder seeks back to the
+// first sample and keeps going, so the interpolation runs straight across
+// the seam with no silence or click.
+//
+// ============================================================================
+
+struct MusicStreamStats {
+    double audio_seconds = 0.0;     // Output produced so far
+    double decode_seconds = 0.0;    // Decode thread CPU time spent producing it
+    uint64_t loops = 0;
+
+    // Milliseconds of decoding per second of audio (0.1% of a core = 1.0)
+    double cost_ms_per_second() const {
+        return audio_seconds > 0.0 ? decode_seconds * 1000.0 / audio_seconds : 0.0;
+    }
+};
+
+class MusicStream : public AudioStream {
+public:
+    explicit MusicStream(int output_rate, Resampler resampler = Resampler::Cubic);
+    ~MusicStream() override;
+
+    MusicStream(const MusicStream&) = delete;
+    MusicStream& operator=(const MusicStream&) = delete;
+
+    // Open a .qoa or .wav file, pre-fill part of the ring and start the
+    // decode thread
+    bool open(const std::string& path, bool loop);
+    void close();
+
+    // AudioStream (audio thread)
+    size_t read(float* out, size_t frames) override;
+    bool finished() const override;
+
+    MusicStreamStats stats() const;
+    size_t resident_bytes() const { return resident_bytes_; }
+    double duration() const;            // Seconds, one pass through the file
+    int source_rate() const;
+    int source_channels() const;
+
+    class Source;
+
+    static constexpr size_t RING_FRAMES = 8192;
+    static constexpr size_t CHUNK_FRAMES = 1024;
+
+private:
+    void decode_loop();
+    size_t produce(float* out, size_t frames);
+    bool refill();
+
+    int output_rate_;
+    Resampler resampler_;
+    bool loop_ = false;
+
+    // Decode thread (or open(), before the thread starts)
+    std::unique_ptr<Source> source_;
+    std::vector<float> window_;     // Stereo source frames not yet fully used
+    std::vector<float> chunk_;      // Source frames as read, source channels
+    std::vector<float> output_;     // One chunk, resampled
+    double position_ = 1.0;         // Read position in window_ frames
+    double step_ = 1.0;             // Source frames per output frame
+    size_t end_frame_ = SIZE_MAX;   // Window frame where the track ends (no loop)
+
+    // Shared
+    SpscRing<float> ring_;
+    std::thread thread_;
+    std::atomic<bool> quit_{false};
+    std::atomic<bool> done_{false};       // Track ended and the last samples are in the ring
+    std::atomic<uint64_t> decode_ns_{0};
+    std::atomic<uint64_t> frames_out_{0};
+    std::atomic<uint64_t> loops_{0};
+    size_t resident_bytes_ = 0;
+};
+
+} // namespace cafe
+
+#endif // CAFE_MUSIC_STREAM_H
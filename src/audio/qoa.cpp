@@ -0,0 +1,226 @@
+#include "qoa.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+namespace cafe {
+namespace qoa {
+
+namespace {
+
+// Scale factors grow as (s + 1)^2.75; the reciprocals let the encoder
+// divide with a multiply
+constexpr int kScaleFactor[16] = {1, 7, 21, 45, 84, 138, 211, 304, 421, 562, 731, 928, 1157, 1419, 1715, 2048};
+constexpr int kReciprocal[16] = {65536, 9363, 3121, 1457, 781, 475, 311, 216, 156, 117, 90, 71, 57, 47, 39, 32};
+
+// Residual (-8..8, after scaling) -> 3-bit code, and code -> residual
+constexpr int kQuantize[17] = {7, 7, 7, 5, 5, 3, 3, 1, 0, 0, 2, 2, 4, 4, 6, 6, 6};
+constexpr float kDequantize[8] = {0.75f, -0.75f, 2.5f, -2.5f, 4.5f, -4.5f, 7.0f, -7.0f};
+
+struct DequantTable {
+    int values[16][8];
+    DequantTable() {
+        for (int s = 0; s < 16; ++s) {
+            for (int q = 0; q < 8; ++q) {
+                values[s][q] = static_cast<int>(std::round(kScaleFactor[s] * kDequantize[q]));
+            }
+        }
+    }
+};
+const DequantTable kDequant;
+
+struct Lms {
+    int history[4] = {};
+    int weights[4] = {};
+
+    // 64-bit sum: weights from a corrupt file can grow far past 16 bits
+    int predict() const {
+        int64_t prediction = 0;
+        for (int i = 0; i < 4; ++i) prediction += static_cast<int64_t>(weights[i]) * history[i];
+        return static_cast<int>(prediction >> 13);
+    }
+
+    void update(int sample, int residual) {
+        int delta = residual >> 4;
+        for (int i = 0; i < 4; ++i) weights[i] += history[i] < 0 ? -delta : delta;
+        history[0] = history[1];
+        history[1] = history[2];
+        history[2] = history[3];
+        history[3] = sample;
+    }
+};
+
+inline int clamp_s16(int v) {
+    return v < -32768 ? -32768 : (v > 32767 ? 32767 : v);
+}
+
+// Round away from zero, like the decoder's table
+inline int scaled_div(int v, int scale) {
+    int n = static_cast<int>((static_cast<int64_t>(v) * kReciprocal[scale] + (1 << 15)) >> 16);
+    return n + ((v > 0) - (v < 0)) - ((n > 0) - (n < 0));
+}
+
+uint64_t read_u64(const uint8_t* p) {
+    uint64_t v = 0;
+    for (int i = 0; i < 8; ++i) v = (v << 8) | p[i];
+    return v;
+}
+
+void put_u64(std::vector<uint8_t>& out, uint64_t v) {
+    for (int i = 7; i >= 0; --i) out.push_back(static_cast<uint8_t>(v >> (i * 8)));
+}
+
+} // namespace
+
+size_t frame_size(int channels, int samples) {
+    size_t slices = static_cast<size_t>((samples + SLICE_LEN - 1) / SLICE_LEN);
+    return FRAME_HEADER_SIZE + static_cast<size_t>(channels) * (16 + slices * 8);
+}
+
+bool read_file_header(const uint8_t* data, size_t size, uint32_t& samples) {
+    if (!data || size < FILE_HEADER_SIZE || std::memcmp(data, "qoaf", 4) != 0) {
+        return false;
+    }
+    samples = static_cast<uint32_t>(read_u64(data) & 0xFFFFFFFF);
+    return true;
+}
+
+bool read_frame_header(const uint8_t* data, size_t size, FrameHeader& header) {
+    if (!data || size < FRAME_HEADER_SIZE) return false;
+    uint64_t v = read_u64(data);
+    header.channels = static_cast<int>((v >> 56) & 0xFF);
+    header.sample_rate = static_cast<int>((v >> 32) & 0xFFFFFF);
+    header.samples = static_cast<int>((v >> 16) & 0xFFFF);
+    header.size = static_cast<size_t>(v & 0xFFFF);
+
+    return header.channels >= 1 && header.channels <= MAX_CHANNELS && header.sample_rate > 0 &&
+           header.samples >= 1 && header.samples <= FRAME_LEN &&
+           header.size == frame_size(header.channels, header.samples);
+}
+
+bool decode_frame(const uint8_t* data, size_t size, const FrameHeader& header, int16_t* out) {
+    if (size < header.size) return false;
+
+    const int channels = header.channels;
+    const int samples = header.samples;
+    const uint8_t* p = data + FRAME_HEADER_SIZE;
+
+    Lms lms[MAX_CHANNELS];
+    for (int c = 0; c < channels; ++c) {
+        uint64_t history = read_u64(p);
+        uint64_t weights = read_u64(p + 8);
+        p += 16;
+        for (int i = 0; i < 4; ++i) {
+            lms[c].history[i] = static_cast<int16_t>(history >> 48);
+            lms[c].weights[i] = static_cast<int16_t>(weights >> 48);
+            history <<= 16;
+            weights <<= 16;
+        }
+    }
+
+    for (int start = 0; start < samples; start += SLICE_LEN) {
+        int end = std::min(start + SLICE_LEN, samples);
+        for (int c = 0; c < channels; ++c) {
+            uint64_t slice = read_u64(p);
+            p += 8;
+            const int* dequant = kDequant.values[(slice >> 60) & 0xF];
+
+            for (int i = start; i < end; ++i) {
+                int residual = dequant[(slice >> 57) & 0x7];
+                int sample = clamp_s16(lms[c].predict() + residual);
+                out[i * channels + c] = static_cast<int16_t>(sample);
+                lms[c].update(sample, residual);
+                slice <<= 3;
+            }
+        }
+    }
+    return true;
+}
+
+bool encode(const int16_t* samples, uint32_t frames, int channels, int sample_rate,
+            std::vector<uint8_t>& out) {
+    if (!samples || frames == 0 || channels < 1 || channels > MAX_CHANNELS ||
+        sample_rate <= 0 || sample_rate > 0xFFFFFF) {
+        std::cerr << "Qoa: Invalid input for encoding\n";
+        return false;
+    }
+
+    out.clear();
+    out.reserve(FILE_HEADER_SIZE + (static_cast<size_t>(frames) / FRAME_LEN + 1) *
+                                       frame_size(channels, FRAME_LEN));
+    put_u64(out, (static_cast<uint64_t>(0x716F6166) << 32) | frames);   // "qoaf"
+
+    // Weights start as a simple "continue the slope" predictor
+    Lms lms[MAX_CHANNELS];
+    for (int c = 0; c < channels; ++c) {
+        lms[c].weights[2] = -(1 << 13);
+        lms[c].weights[3] = 1 << 14;
+    }
+
+    for (uint32_t frame_start = 0; frame_start < frames; frame_start += FRAME_LEN) {
+        int count = static_cast<int>(std::min<uint32_t>(FRAME_LEN, frames - frame_start));
+        size_t size = frame_size(channels, count);
+        put_u64(out, (static_cast<uint64_t>(channels) << 56) | (static_cast<uint64_t>(sample_rate) << 32) |
+                     (static_cast<uint64_t>(count) << 16) | size);
+
+        for (int c = 0; c < channels; ++c) {
+            uint64_t history = 0;
+            uint64_t weights = 0;
+            for (int i = 0; i < 4; ++i) {
+                history = (history << 16) | static_cast<uint16_t>(lms[c].history[i]);
+                weights = (weights << 16) | static_cast<uint16_t>(lms[c].weights[i]);
+            }
+            put_u64(out, history);
+            put_u64(out, weights);
+        }
+
+        const int16_t* frame = samples + static_cast<size_t>(frame_start) * channels;
+        for (int start = 0; start < count; start += SLICE_LEN) {
+            int end = std::min(start + SLICE_LEN, count);
+            for (int c = 0; c < channels; ++c) {
+                // Try every scale factor, keep the one with the least error
+                uint64_t best_error = UINT64_MAX;
+                uint64_t best_slice = 0;
+                Lms best_lms;
+
+                for (int scale = 0; scale < 16; ++scale) {
+                    Lms trial = lms[c];
+                    uint64_t slice = static_cast<uint64_t>(scale);
+                    uint64_t error = 0;
+
+                    for (int i = start; i < end; ++i) {
+                        int sample = frame[i * channels + c];
+                        int predicted = trial.predict();
+                        int scaled = std::clamp(scaled_div(sample - predicted, scale), -8, 8);
+                        int code = kQuantize[scaled + 8];
+                        int residual = kDequant.values[scale][code];
+                        int decoded = clamp_s16(predicted + residual);
+
+                        int64_t diff = sample - decoded;
+                        error += static_cast<uint64_t>(diff * diff);
+                        if (error >= best_error) break;
+
+                        trial.update(decoded, residual);
+                        slice = (slice << 3) | static_cast<uint64_t>(code);
+                    }
+
+                    if (error < best_error) {
+                        best_error = error;
+                        best_slice = slice;
+                        best_lms = trial;
+                    }
+                }
+
+                lms[c] = best_lms;
+                // Left-align a short last slice
+                best_slice <<= (SLICE_LEN - (end - start)) * 3;
+                put_u64(out, best_slice);
+            }
+        }
+    }
+    return true;
+}
+
+} // namespace qoa
+} // namespace cafe
@@ -0,0 +1,68 @@
+#ifndef CAFE_QOA_H
+#define CAFE_QOA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace cafe {
+namespace qoa {
+
+// ============================================================================
+// QOA - "Quite OK Audio" codec
+// ============================================================================
+//
+// A lossy 16-bit PCM codec at a fixed 3.2 bits per sample (5x smaller than
+// 16-bit WAV), simple enough to decode in a few hundred cycles per frame
+// with no tables beyond 16x8 ints. Music is stored as .qoa (tools/
+// encode_qoa.cpp converts WAV) and decoded a frame at a time while it
+// plays, so a track never has to be in memory whole.
+//
+// Layout (all big-endian):
+//
+//   file header    "qoaf", u32 samples per channel
+//   frame          u8 channels, u24 sample rate, u16 samples, u16 frame bytes
+//                  per channel: LMS history (4 x i16), LMS weights (4 x i16)
+//                  slices, channel-interleaved: u64 each
+//   slice          4-bit scale factor, then 20 x 3-bit residuals
+//
+// A frame holds up to 256 slices of 20 samples per channel (5120). Each
+// sample is predicted from the previous four by a sign-sign LMS filter;
+// the slice stores the quantized prediction error.
+//
+// ============================================================================
+
+constexpr int SLICE_LEN = 20;
+constexpr int SLICES_PER_FRAME = 256;
+constexpr int FRAME_LEN = SLICE_LEN * SLICES_PER_FRAME;
+constexpr int MAX_CHANNELS = 8;
+constexpr size_t FILE_HEADER_SIZE = 8;
+constexpr size_t FRAME_HEADER_SIZE = 8;
+
+struct FrameHeader {
+    int channels = 0;
+    int sample_rate = 0;
+    int samples = 0;        // Per channel
+    size_t size = 0;        // Whole frame in bytes, header included
+};
+
+// Bytes of a frame with `samples` samples per channel
+size_t frame_size(int channels, int samples);
+
+// "qoaf" header: samples per channel in the file (0 = streaming/unknown)
+bool read_file_header(const uint8_t* data, size_t size, uint32_t& samples);
+
+bool read_frame_header(const uint8_t* data, size_t size, FrameHeader& header);
+
+// Decode one whole frame (header included) into interleaved int16;
+// `out` needs header.samples * header.channels entries
+bool decode_frame(const uint8_t* data, size_t size, const FrameHeader& header, int16_t* out);
+
+// Encode interleaved int16 PCM (1..MAX_CHANNELS channels) as a .qoa file
+bool encode(const int16_t* samples, uint32_t frames, int channels, int sample_rate,
+            std::vector<uint8_t>& out);
+
+} // namespace qoa
+} // namespace cafe
+
+#endif // CAFE_QOA_H
@@ -0,0 +1,336 @@
+#include "software_audio.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace cafe {
+
+SoftwareAudioSystem::SoftwareAudioSystem(std::unique_ptr<AudioDevice> device, const MixerConfig& config)
+    : device_(std::move(device)), config_(config), mixer_(std::make_unique<AudioMixer>(config)) {}
+
+SoftwareAudioSystem::~SoftwareAudioSystem() {
+    shutdown();
+}
+
+bool SoftwareAudioSystem::initialize() {
+    if (running_) return true;
+    if (!device_) {
+        std::cerr << "SoftwareAudioSystem: No audio device\n";
+        return false;
+    }
+
+    AudioMixer* mixer = mixer_.get();
+    if (!device_->start(mixer->sample_rate(), [mixer](float* out, size_t frames) { mixer->mix(out, frames); })) {
+        std::cerr << "SoftwareAudioSystem: Cannot start " << device_->name() << " device\n";
+        return false;
+    }
+    running_ = true;
+    apply_master_volume();
+    return true;
+}
+
+void SoftwareAudioSystem::shutdown() {
+    if (!running_) return;
+
+    // With the device stopped nothing reads the clips any more
+    device_->stop();
+    running_ = false;
+    music_voice_ = INVALID_VOICE;
+    music_.reset();
+    music_paused_ = false;
+    retired_music_.clear();
+    retired_.clear();
+    sounds_.clear();
+    emitters_.clear();
+
+    // Fresh mixer: no voice may point at the clips just freed
+    mixer_ = std::make_unique<AudioMixer>(config_);
+}
+
+// ============================================================================
+// Sounds
+// ============================================================================
+
+SoundHandle SoftwareAudioSystem::load_sound(const std::string& path) {
+    auto clip = std::make_shared<AudioClip>();
+    if (!load_wav(path, *clip)) {
+        return INVALID_SOUND;
+    }
+    SoundHandle handle = next_sound_id_++;
+    sounds_[handle] = std::move(clip);
+    return handle;
+}
+
+void SoftwareAudioSystem::unload_sound(SoundHandle sound) {
+    auto it = sounds_.find(sound);
+    if (it == sounds_.end()) return;
+    retire(std::move(it->second));
+    sounds_.erase(it);
+}
+
+bool SoftwareAudioSystem::is_sound_loaded(SoundHandle sound) const {
+    return sounds_.count(sound) > 0;
+}
+
+ChannelHandle SoftwareAudioSystem::play_sound(SoundHandle sound, float volume) {
+    PlayOptions options;
+    options.volume = volume;
+    return play_sound(sound, options);
+}
+
+ChannelHandle SoftwareAudioSystem::play_sound(SoundHandle sound, const PlayOptions& options) {
+    auto it = sounds_.find(sound);
+    if (!running_ || it == sounds_.end()) {
+        return INVALID_CHANNEL;
+    }
+
+    VoiceParams params;
+    params.volume = options.volume;
+    params.pitch = options.pitch;
+    params.pan = options.pan;
+    params.loop = options.loop;
+    params.bus = AudioBus::Sound;
+    params.priority = static_cast<uint8_t>(std::clamp(options.priority, 0, 255));
+    return mixer_->play(it->second.get(), params);
+}
+
+// ============================================================================
+// Positional sounds
+// ============================================================================
+
+ChannelHandle SoftwareAudioSystem::play_sound_at(SoundHandle sound, float x, float y,
+                                                 const PlayOptions& options) {
+    auto it = sounds_.find(sound);
+    if (!running_ || it == sounds_.end()) {
+        return INVALID_CHANNEL;
+    }
+
+    Emitter emitter;
+    emitter.x = x;
+    emitter.y = y;
+    emitter.sent = spatialize(spatial_, listener_x_, listener_y_, x, y);
+
+    VoiceParams params;
+    params.volume = options.volume;
+    params.pitch = options.pitch;
+    params.pan = emitter.sent.pan;
+    params.attenuation = emitter.sent.attenuation;
+    params.loop = options.loop;
+    params.bus = AudioBus::Sound;
+    params.priority = static_cast<uint8_t>(std::clamp(options.priority, 0, 255));
+
+    // One-shots out of earshot are not worth a voice
+    if (!options.loop && params.attenuation <= 0.0f) {
+        return INVALID_CHANNEL;
+    }
+
+    VoiceHandle voice = mixer_->play(it->second.get(), params);
+    if (voice != INVALID_VOICE) {
+        emitters_[voice] = emitter;
+    }
+    return voice;
+}
+
+void SoftwareAudioSystem::set_channel_position(ChannelHandle channel, float x, float y) {
+    auto it = emitters_.find(channel);
+    if (it == emitters_.end()) return;
+    it->second.x = x;
+    it->second.y = y;
+    it->second.moved = true;
+}
+
+void SoftwareAudioSystem::set_listener(float x, float y) {
+    if (x == listener_x_ && y == listener_y_) return;
+    listener_x_ = x;
+    listener_y_ = y;
+    listener_moved_ = true;
+}
+
+// Resend gains that changed audibly; forget emitters whose voice ended
+void SoftwareAudioSystem::update_emitters() {
+    for (auto it = emitters_.begin(); it != emitters_.end();) {
+        Emitter& emitter = it->second;
+        if (!mixer_->is_playing(it->first)) {
+            it = emitters_.erase(it);
+            continue;
+        }
+        if (emitter.moved || listener_moved_) {
+            SpatialGain gain = spatialize(spatial_, listener_x_, listener_y_, emitter.x, emitter.y);
+            if (std::fabs(gain.attenuation - emitter.sent.attenuation) > 0.002f ||
+                std::fabs(gain.pan - emitter.sent.pan) > 0.01f) {
+                mixer_->set_spatial(it->first, gain.attenuation, gain.pan);
+                emitter.sent = gain;
+            }
+            emitter.moved = false;
+        }
+        ++it;
+    }
+    listener_moved_ = false;
+}
+
+// ============================================================================
+// Music
+// ============================================================================
+
+bool SoftwareAudioSystem::play_music(const std::string& path, bool loop) {
+    if (!running_) return false;
+
+    auto stream = std::make_unique<MusicStream>(mixer_->sample_rate());
+    if (!stream->open(path, loop)) {
+        return false;
+    }
+
+    // Cross-fade only from a track that is audible; a paused one is cut
+    bool crossfade = music_crossfade_ > 0.0f && is_music_playing();
+
+    VoiceParams params;
+    params.volume = crossfade ? 0.0f : 1.0f;
+    params.bus = AudioBus::Music;
+    params.priority = 255;
+    VoiceHandle voice = mixer_->play_stream(stream.get(), params);
+    if (voice == INVALID_VOICE) {
+        std::cerr << "SoftwareAudioSystem: No free voice for music\n";
+        return false;
+    }
+
+    if (crossfade) {
+        mixer_->fade(voice, 1.0f, music_crossfade_);
+        mixer_->fade(music_voice_, 0.0f, music_crossfade_, true);
+    } else {
+        mixer_->stop(music_voice_);
+    }
+    retire_music();
+
+    music_ = std::move(stream);
+    music_voice_ = voice;
+    music_paused_ = false;
+    return true;
+}
+
+void SoftwareAudioSystem::stop_music() {
+    mixer_->stop(music_voice_);
+    retire_music();
+    music_voice_ = INVALID_VOICE;
+    music_paused_ = false;
+}
+
+void SoftwareAudioSystem::pause_music() {
+    if (is_music_playing()) {
+        mixer_->set_paused(music_voice_, true);
+        music_paused_ = true;
+    }
+}
+
+void SoftwareAudioSystem::resume_music() {
+    if (music_paused_) {
+        mixer_->set_paused(music_voice_, false);
+        music_paused_ = false;
+    }
+}
+
+bool SoftwareAudioSystem::is_music_playing() const {
+    return !music_paused_ && mixer_->is_playing(music_voice_);
+}
+
+void SoftwareAudioSystem::set_music_volume(float volume) {
+    music_volume_ = std::clamp(volume, 0.0f, 1.0f);
+    mixer_->set_bus_volume(AudioBus::Music, music_volume_);
+}
+
+// ============================================================================
+// Channels and volumes
+// ============================================================================
+
+void SoftwareAudioSystem::stop_channel(ChannelHandle channel) {
+    if (channel != music_voice_) mixer_->stop(channel);
+}
+
+void SoftwareAudioSystem::stop_all_sounds() {
+    mixer_->stop_bus(AudioBus::Sound);
+}
+
+bool SoftwareAudioSystem::is_channel_playing(ChannelHandle channel) const {
+    return mixer_->is_playing(channel);
+}
+
+void SoftwareAudioSystem::set_channel_volume(ChannelHandle channel, float volume) {
+    mixer_->set_volume(channel, volume);
+}
+
+void SoftwareAudioSystem::set_master_volume(float volume) {
+    master_volume_ = std::clamp(volume, 0.0f, 1.0f);
+    apply_master_volume();
+}
+
+void SoftwareAudioSystem::set_sound_volume(float volume) {
+    sound_volume_ = std::clamp(volume, 0.0f, 1.0f);
+    mixer_->set_bus_volume(AudioBus::Sound, sound_volume_);
+}
+
+void SoftwareAudioSystem::set_muted(bool muted) {
+    muted_ = muted;
+    apply_master_volume();
+}
+
+void SoftwareAudioSystem::apply_master_volume() {
+    mixer_->set_master_volume(muted_ ? 0.0f : master_volume_);
+    mixer_->set_bus_volume(AudioBus::Sound, sound_volume_);
+    mixer_->set_bus_volume(AudioBus::Music, music_volume_);
+}
+
+// ============================================================================
+// Update
+// ============================================================================
+
+void SoftwareAudioSystem::retire(std::shared_ptr<AudioClip> clip) {
+    if (!clip) return;
+    RetiredClip retired;
+    retired.sequence = running_ ? mixer_->stop_clip(clip.get()) : 0;
+    retired.clip = std::move(clip);
+    retired_.push_back(std::move(retired));
+}
+
+// The stream stays alive until its voice has stopped or faded out
+void SoftwareAudioSystem::retire_music() {
+    if (!music_) return;
+    RetiredStream retired;
+    retired.stream = std::move(music_);
+    retired.voice = music_voice_;
+    retired_music_.push_back(std::move(retired));
+}
+
+void SoftwareAudioSystem::update() {
+    if (running_) update_emitters();
+
+    // Free streams the audio thread no longer uses. The voice handle only
+    // says when the fade-out is over; the stream is released by the
+    // stop_stream() sequence, like clips.
+    for (size_t i = 0; i < retired_music_.size();) {
+        RetiredStream& retired = retired_music_[i];
+        if (retired.sequence == 0 && running_ && !mixer_->is_playing(retired.voice)) {
+            retired.sequence = mixer_->stop_stream(retired.stream.get());
+        }
+        if (!running_ || mixer_->is_done(retired.sequence)) {
+            retired_music_[i] = std::move(retired_music_.back());
+            retired_music_.pop_back();
+        } else {
+            ++i;
+        }
+    }
+
+    // Free clips the audio thread no longer uses; retry full-queue stops
+    for (size_t i = 0; i < retired_.size();) {
+        RetiredClip& retired = retired_[i];
+        if (retired.sequence == 0 && running_) {
+            retired.sequence = mixer_->stop_clip(retired.clip.get());
+        }
+        if (!running_ || mixer_->is_done(retired.sequence)) {
+            retired_[i] = std::move(retired_.back());
+            retired_.pop_back();
+        } else {
+            ++i;
+        }
+    }
+}
+
+} // namespace cafe
@@ -0,0 +1,168 @@
+#ifndef CAFE_SOFTWARE_AUDIO_H
+#define CAFE_SOFTWARE_AUDIO_H
+
+#include "audio.h"
+#include "mixer.h"
+#include "music_stream.h"
+#include "spatial.h"
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace cafe {
+
+// ============================================================================
+// AudioDevice - Where mixed audio goes
+// ============================================================================
+//
+// The only platform-specific part of SoftwareAudioSystem. A device owns
+// the audio thread (or the OS callback) and asks for samples through
+// `fill`: interleaved stereo float, `frames` frames at the requested rate.
+// `fill` runs on that thread and must not be called after stop().
+
+class AudioDevice {
+public:
+    using FillCallback = std::function<void(float* out, size_t frames)>;
+
+    virtual ~AudioDevice() = default;
+
+    virtual bool start(int sample_rate, FillCallback fill) = 0;
+    virtual void stop() = 0;
+    virtual const char* name() const = 0;
+};
+
+// ============================================================================
+// SoftwareAudioSystem - AudioSystem on top of AudioMixer
+// ============================================================================
+//
+// Sounds are WAV files decoded into memory at load_sound(). Every sound
+// and the music play through one AudioMixer, on the Sound and Music
+// buses; master volume and mute act on the mixer's master gain.
+//
+// Music streams from disk (MusicStream: .qoa or .wav, decoded on its own
+// thread), so a track costs the same ~120 KB however long it is. A new
+// play_music() while a track is playing cross-fades: the new track fades
+// in as the old one fades out (set_music_crossfade(), 0 = cut).
+//
+// Positional sounds get their attenuation and pan from spatialize(),
+// recomputed in update() for every one still playing when it or the
+// listener moved. With a crowd of them the mixer's voice virtualization
+// keeps the cost at max_real_voices (see AudioMixer).
+//
+// unload_sound() may be called while the sound plays: the clip is kept
+// until the audio thread has stopped its voices (checked in update()).
+// Replaced music streams are likewise kept until their fade has ended and
+// the audio thread has confirmed a stop_stream().
+//
+// ============================================================================
+
+class SoftwareAudioSystem : public AudioSystem {
+public:
+    explicit SoftwareAudioSystem(std::unique_ptr<AudioDevice> device,
+                                 const MixerConfig& config = MixerConfig());
+    ~SoftwareAudioSystem() override;
+
+    bool initialize() override;
+    void shutdown() override;
+
+    SoundHandle load_sound(const std::string& path) override;
+    void unload_sound(SoundHandle sound) override;
+    bool is_sound_loaded(SoundHandle sound) const override;
+
+    ChannelHandle play_sound(SoundHandle sound, float volume = 1.0f) override;
+    ChannelHandle play_sound(SoundHandle sound, const PlayOptions& options) override;
+
+    ChannelHandle play_sound_at(SoundHandle sound, float x, float y, const PlayOptions& options) override;
+    void set_channel_position(ChannelHandle channel, float x, float y) override;
+    void set_listener(float x, float y) override;
+    void set_spatial_config(const SpatialConfig& config) { spatial_ = config; listener_moved_ = true; }
+    const SpatialConfig& spatial_config() const { return spatial_; }
+
+    bool play_music(const std::string& path, bool loop = true) override;
+    void stop_music() override;
+    void pause_music() override;
+    void resume_music() override;
+    bool is_music_playing() const override;
+    bool is_music_paused() const override { return music_paused_; }
+    void set_music_volume(float volume) override;
+    float music_volume() const override { return music_volume_; }
+    void set_music_crossfade(float seconds) { music_crossfade_ = std::max(seconds, 0.0f); }
+    const MusicStream* music_stream() const { return music_.get(); }
+
+    void stop_channel(ChannelHandle channel) override;
+    void stop_all_sounds() override;
+    bool is_channel_playing(ChannelHandle channel) const override;
+    void set_channel_volume(ChannelHandle channel, float volume) override;
+
+    void set_master_volume(float volume) override;
+    float master_volume() const override { return master_volume_; }
+    void set_sound_volume(float volume) override;
+    float sound_volume() const override { return sound_volume_; }
+    void set_muted(bool muted) override;
+    bool is_muted() const override { return muted_; }
+
+    void update() override;
+
+    AudioMixer& mixer() { return *mixer_; }
+    const AudioDevice& device() const { return *device_; }
+
+private:
+    // A clip waiting for the audio thread to let go of it
+    struct RetiredClip {
+        std::shared_ptr<AudioClip> clip;
+        uint64_t sequence = 0;     // 0 = stop_clip not queued yet
+    };
+
+    // A positional sound; the last gains sent, to skip unchanged ones
+    struct Emitter {
+        float x = 0.0f;
+        float y = 0.0f;
+        SpatialGain sent;
+        bool moved = false;
+    };
+
+    // A music stream whose voice is still stopping or fading out
+    struct RetiredStream {
+        std::unique_ptr<MusicStream> stream;
+        VoiceHandle voice = INVALID_VOICE;
+        uint64_t sequence = 0;     // 0 = stop_stream not queued yet
+    };
+
+    void retire(std::shared_ptr<AudioClip> clip);
+    void retire_music();
+    void apply_master_volume();
+    void update_emitters();
+
+    std::unique_ptr<AudioDevice> device_;
+    MixerConfig config_;
+    std::unique_ptr<AudioMixer> mixer_;
+    bool running_ = false;
+
+    std::unordered_map<SoundHandle, std::shared_ptr<AudioClip>> sounds_;
+    SoundHandle next_sound_id_ = 1;
+    std::vector<RetiredClip> retired_;
+
+    std::unordered_map<ChannelHandle, Emitter> emitters_;
+    SpatialConfig spatial_;
+    float listener_x_ = 0.0f;
+    float listener_y_ = 0.0f;
+    bool listener_moved_ = false;
+
+    std::unique_ptr<MusicStream> music_;
+    VoiceHandle music_voice_ = INVALID_VOICE;
+    bool music_paused_ = false;
+    float music_crossfade_ = 1.0f;     // Seconds
+    std::vector<RetiredStream> retired_music_;
+
+    float master_volume_ = 1.0f;
+    float sound_volume_ = 1.0f;
+    float music_volume_ = 1.0f;
+    bool muted_ = false;
+};
+
+} // namespace cafe
+
+#endif // CAFE_SOFTWARE_AUDIO_H
@@ -0,0 +1,63 @@
+#ifndef CAFE_SPATIAL_H
+#define CAFE_SPATIAL_H
+
+#include <algorithm>
+#include <cmath>
+
+namespace cafe {
+
+// ============================================================================
+// Spatial audio - Distance attenuation and pan for positional sounds
+// ============================================================================
+//
+// Positions are world pixels on the isometric screen plane; the listener
+// is normally the centre of the camera view. Two adjustments make screen
+// distance behave like distance on the floor:
+//
+//   vertical_scale   the 2:1 projection squashes the floor vertically, so a
+//                    pixel up or down the screen is two pixels of floor
+//   pan              left/right only: the player sits in front of the
+//                    screen, so "behind" the camera is not a direction
+//
+// Loudness uses the inverse-distance model games have used since DirectSound:
+// full volume inside min_distance, then min / (min + rolloff * (d - min)),
+// tapering to silence over the last quarter of max_distance so sounds leave
+// without a jump - and become virtual (not mixed) once they are inaudible.
+//
+// ============================================================================
+
+struct SpatialConfig {
+    float min_distance = 96.0f;      // Full volume within this (1.5 tiles)
+    float max_distance = 1600.0f;    // Silent beyond this
+    float rolloff = 1.0f;            // 1 = -6 dB per doubling of distance
+    float pan_distance = 640.0f;     // Horizontal offset of a hard left/right
+    float vertical_scale = 2.0f;     // Tile width / tile height
+};
+
+struct SpatialGain {
+    float attenuation = 1.0f;
+    float pan = 0.0f;
+};
+
+inline SpatialGain spatialize(const SpatialConfig& config, float listener_x, float listener_y,
+                              float x, float y) {
+    float dx = x - listener_x;
+    float dy = (y - listener_y) * config.vertical_scale;
+    float distance = std::sqrt(dx * dx + dy * dy);
+
+    SpatialGain result;
+    if (distance > config.min_distance) {
+        result.attenuation = config.min_distance /
+                             (config.min_distance + config.rolloff * (distance - config.min_distance));
+    }
+    float taper_start = config.max_distance * 0.75f;
+    if (distance > taper_start) {
+        result.attenuation *= std::max(0.0f, (config.max_distance - distance) / (config.max_distance - taper_start));
+    }
+    result.pan = config.pan_distance > 0.0f ? std::clamp(dx / config.pan_distance, -1.0f, 1.0f) : 0.0f;
+    return result;
+}
+
+} // namespace cafe
+
+#endif // CAFE_SPATIAL_H
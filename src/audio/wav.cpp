@@ -0,0 +1,283 @@
+#include "wav.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+namespace cafe {
+
+namespace {
+
+constexpr uint16_t kFormatPcm = 1;
+constexpr uint16_t kFormatFloat = 3;
+constexpr uint16_t kFormatExtensible = 0xFFFE;
+
+uint16_t read_u16(const uint8_t* p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+uint32_t read_u32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+void put_u16(uint8_t* p, uint32_t v) {
+    p[0] = static_cast<uint8_t>(v);
+    p[1] = static_cast<uint8_t>(v >> 8);
+}
+
+void put_u32(uint8_t* p, uint32_t v) {
+    put_u16(p, v);
+    put_u16(p + 2, v >> 16);
+}
+
+// One sample of `bits` at p, as float in [-1, 1]
+float decode_sample(const uint8_t* p, int bits, bool is_float) {
+    switch (bits) {
+        case 8:
+            return (static_cast<float>(p[0]) - 128.0f) * (1.0f / 128.0f);   // Unsigned
+        case 16:
+            return static_cast<float>(static_cast<int16_t>(read_u16(p))) * (1.0f / 32768.0f);
+        case 24: {
+            int32_t v = static_cast<int32_t>((static_cast<uint32_t>(p[0]) << 8) |
+                                             (static_cast<uint32_t>(p[1]) << 16) |
+                                             (static_cast<uint32_t>(p[2]) << 24)) >> 8;
+            return static_cast<float>(v) * (1.0f / 8388608.0f);
+        }
+        default: {
+            uint32_t bits32 = read_u32(p);
+            if (is_float) {
+                float f;
+                std::memcpy(&f, &bits32, sizeof(f));
+                return f;
+            }
+            return static_cast<float>(static_cast<int32_t>(bits32)) * (1.0f / 2147483648.0f);
+        }
+    }
+}
+
+} // namespace
+
+// ============================================================================
+// Loading
+// ============================================================================
+
+namespace {
+
+// fmt chunk payload -> format fields; false for layouts we cannot play
+bool parse_fmt(const uint8_t* chunk, size_t chunk_size, WavFormat& format) {
+    if (chunk_size < 16) {
+        std::cerr << "Wav: Truncated fmt chunk\n";
+        return false;
+    }
+    uint16_t tag = read_u16(chunk);
+    format.channels = read_u16(chunk + 2);
+    format.sample_rate = static_cast<int>(read_u32(chunk + 4));
+    format.bits = read_u16(chunk + 14);
+    if (tag == kFormatExtensible && chunk_size >= 40) {
+        tag = read_u16(chunk + 24);   // First two bytes of the subformat GUID
+    }
+    format.is_float = tag == kFormatFloat;
+
+    int bits = format.bits;
+    if (!(tag == kFormatPcm && (bits == 8 || bits == 16 || bits == 24 || bits == 32)) &&
+        !(format.is_float && bits == 32)) {
+        std::cerr << "Wav: Unsupported sample format " << tag << " (" << bits << "-bit)\n";
+        return false;
+    }
+    if (format.channels < 1 || format.channels > 2 || format.sample_rate <= 0) {
+        std::cerr << "Wav: Unsupported layout (" << format.channels << " channels, "
+                  << format.sample_rate << " Hz)\n";
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+void decode_wav_samples(const uint8_t* data, size_t count, const WavFormat& format, float* out) {
+    size_t bytes_per_sample = static_cast<size_t>(format.bits / 8);
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = decode_sample(data + i * bytes_per_sample, format.bits, format.is_float);
+    }
+}
+
+bool load_wav_from_memory(const uint8_t* data, size_t size, AudioClip& out) {
+    if (!data || size < 12 || std::memcmp(data, "RIFF", 4) != 0 || std::memcmp(data + 8, "WAVE", 4) != 0) {
+        std::cerr << "Wav: Not a RIFF/WAVE file\n";
+        return false;
+    }
+
+    WavFormat format;
+    bool have_format = false;
+    const uint8_t* samples = nullptr;
+
+    // Chunks: 4-byte id, 4-byte size, payload padded to an even size
+    size_t pos = 12;
+    while (pos + 8 <= size) {
+        const uint8_t* chunk = data + pos;
+        size_t chunk_size = read_u32(chunk + 4);
+        size_t available = size - pos - 8;
+
+        if (std::memcmp(chunk, "fmt ", 4) == 0) {
+            if (!parse_fmt(chunk + 8, std::min(chunk_size, available), format)) return false;
+            have_format = true;
+        } else if (std::memcmp(chunk, "data", 4) == 0) {
+            samples = chunk + 8;
+            format.data_bytes = std::min(chunk_size, available);   // Tolerate a short last chunk
+        }
+
+        if (chunk_size > available) break;
+        pos += 8 + chunk_size + (chunk_size & 1);
+    }
+
+    if (!samples || !have_format) {
+        std::cerr << "Wav: Missing fmt or data chunk\n";
+        return false;
+    }
+
+    out.channels = format.channels;
+    out.sample_rate = format.sample_rate;
+    out.samples.resize(static_cast<size_t>(format.frames()) * static_cast<size_t>(format.channels));
+    decode_wav_samples(samples, out.samples.size(), format, out.samples.data());
+    return true;
+}
+
+bool read_wav_format(std::FILE* file, WavFormat& format) {
+    uint8_t header[12];
+    if (!file || std::fread(header, 1, 12, file) != 12 ||
+        std::memcmp(header, "RIFF", 4) != 0 || std::memcmp(header + 8, "WAVE", 4) != 0) {
+        std::cerr << "Wav: Not a RIFF/WAVE file\n";
+        return false;
+    }
+
+    bool have_format = false;
+    uint64_t pos = 12;
+    uint8_t chunk[8];
+    while (std::fread(chunk, 1, 8, file) == 8) {
+        uint32_t chunk_size = read_u32(chunk + 4);
+        pos += 8;
+
+        if (std::memcmp(chunk, "fmt ", 4) == 0) {
+            uint8_t fmt[40] = {};
+            size_t n = std::min<size_t>(chunk_size, sizeof(fmt));
+            if (std::fread(fmt, 1, n, file) != n || !parse_fmt(fmt, n, format)) return false;
+            have_format = true;
+        } else if (std::memcmp(chunk, "data", 4) == 0) {
+            if (!have_format) break;
+            format.data_offset = pos;
+            format.data_bytes = chunk_size;
+            return true;   // Positioned at the first sample
+        }
+
+        pos += chunk_size + (chunk_size & 1);
+        if (std::fseek(file, static_cast<long>(pos), SEEK_SET) != 0) break;
+    }
+
+    std::cerr << "Wav: Missing fmt or data chunk\n";
+    return false;
+}
+
+bool load_wav(const std::string& path, AudioClip& out) {
+    FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) {
+        std::cerr << "Wav: Cannot open " << path << "\n";
+        return false;
+    }
+
+    std::vector<uint8_t> bytes;
+    bool ok = std::fseek(file, 0, SEEK_END) == 0;
+    long size = ok ? std::ftell(file) : -1;
+    ok = ok && size >= 0 && std::fseek(file, 0, SEEK_SET) == 0;
+    if (ok) {
+        bytes.resize(static_cast<size_t>(size));
+        ok = bytes.empty() || std::fread(bytes.data(), 1, bytes.size(), file) == bytes.size();
+    }
+    std::fclose(file);
+
+    if (!ok) {
+        std::cerr << "Wav: Cannot read " << path << "\n";
+        return false;
+    }
+    return load_wav_from_memory(bytes.data(), bytes.size(), out);
+}
+
+// ============================================================================
+// WavWriter
+// ============================================================================
+
+WavWriter::~WavWriter() {
+    close();
+}
+
+bool WavWriter::open(const std::string& path, int sample_rate, int channels) {
+    close();
+    if (sample_rate <= 0 || channels <= 0) return false;
+
+    file_ = std::fopen(path.c_str(), "wb");
+    if (!file_) {
+        std::cerr << "Wav: Cannot create " << path << "\n";
+        return false;
+    }
+
+    // Canonical 44-byte header; the two sizes are patched by close()
+    uint8_t header[44] = {};
+    std::memcpy(header, "RIFF", 4);
+    std::memcpy(header + 8, "WAVEfmt ", 8);
+    put_u32(header + 16, 16);
+    put_u16(header + 20, kFormatPcm);
+    put_u16(header + 22, static_cast<uint32_t>(channels));
+    put_u32(header + 24, static_cast<uint32_t>(sample_rate));
+    put_u32(header + 28, static_cast<uint32_t>(sample_rate * channels * 2));
+    put_u16(header + 32, static_cast<uint32_t>(channels * 2));
+    put_u16(header + 34, 16);
+    std::memcpy(header + 36, "data", 4);
+
+    if (std::fwrite(header, 1, sizeof(header), file_) != sizeof(header)) {
+        std::fclose(file_);
+        file_ = nullptr;
+        return false;
+    }
+    channels_ = channels;
+    frames_ = 0;
+    return true;
+}
+
+void WavWriter::write(const float* samples, size_t frames) {
+    if (!file_ || !samples) return;
+
+    size_t count = frames * static_cast<size_t>(channels_);
+    buffer_.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        float s = std::clamp(samples[i], -1.0f, 1.0f);
+        buffer_[i] = static_cast<int16_t>(std::lround(s * 32767.0f));
+    }
+
+    // Samples are little-endian on disk
+    uint8_t* bytes = reinterpret_cast<uint8_t*>(buffer_.data());
+    for (size_t i = 0; i < count; ++i) {
+        uint16_t v = static_cast<uint16_t>(buffer_[i]);
+        put_u16(bytes + i * 2, v);
+    }
+    std::fwrite(bytes, 2, count, file_);
+    frames_ += frames;
+}
+
+bool WavWriter::close() {
+    if (!file_) return false;
+
+    uint32_t data_bytes = static_cast<uint32_t>(frames_ * static_cast<size_t>(channels_) * 2);
+    uint8_t size_field[4];
+    bool ok = true;
+
+    put_u32(size_field, 36 + data_bytes);
+    ok = ok && std::fseek(file_, 4, SEEK_SET) == 0 && std::fwrite(size_field, 1, 4, file_) == 4;
+    put_u32(size_field, data_bytes);
+    ok = ok && std::fseek(file_, 40, SEEK_SET) == 0 && std::fwrite(size_field, 1, 4, file_) == 4;
+
+    ok = std::fclose(file_) == 0 && ok;
+    file_ = nullptr;
+    return ok;
+}
+
+} // namespace cafe
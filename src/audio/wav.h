@@ -0,0 +1,86 @@
+#ifndef CAFE_WAV_H
+#define CAFE_WAV_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace cafe {
+
+// ============================================================================
+// AudioClip - Decoded sound in memory
+// ============================================================================
+//
+// Samples are float in [-1, 1], interleaved (L R L R ... for stereo), at
+// the file's own sample rate; the mixer resamples while it plays.
+
+struct AudioClip {
+    std::vector<float> samples;
+    int channels = 0;        // 1 (mono) or 2 (stereo)
+    int sample_rate = 0;
+
+    size_t frames() const { return channels > 0 ? samples.size() / static_cast<size_t>(channels) : 0; }
+    double duration() const { return sample_rate > 0 ? static_cast<double>(frames()) / sample_rate : 0.0; }
+    bool is_valid() const { return channels > 0 && sample_rate > 0 && !samples.empty(); }
+};
+
+// ============================================================================
+// WAV files
+// ============================================================================
+//
+// RIFF/WAVE with PCM 8/16/24/32-bit integer or 32-bit float samples, mono
+// or stereo (WAVE_FORMAT_EXTENSIBLE headers included). Unknown chunks
+// (LIST, cue, ...) are skipped. Compressed formats are rejected.
+
+bool load_wav(const std::string& path, AudioClip& out);
+bool load_wav_from_memory(const uint8_t* data, size_t size, AudioClip& out);
+
+// Sample layout of a WAV file, for reading the data chunk in pieces
+// (streamed music) instead of loading it whole
+struct WavFormat {
+    int channels = 0;
+    int sample_rate = 0;
+    int bits = 0;
+    bool is_float = false;
+    uint64_t data_offset = 0;    // File position of the first sample
+    uint64_t data_bytes = 0;
+
+    size_t frame_bytes() const { return static_cast<size_t>(bits / 8) * static_cast<size_t>(channels); }
+    uint64_t frames() const { return frame_bytes() > 0 ? data_bytes / frame_bytes() : 0; }
+};
+
+// Walk the chunks of an open file; leaves it positioned at the first sample
+bool read_wav_format(std::FILE* file, WavFormat& format);
+
+// Convert `count` samples (not frames) from file bytes to float
+void decode_wav_samples(const uint8_t* data, size_t count, const WavFormat& format, float* out);
+
+// Streams float frames to a 16-bit PCM WAV file; the header sizes are
+// filled in by close() (or the destructor)
+class WavWriter {
+public:
+    WavWriter() = default;
+    ~WavWriter();
+
+    WavWriter(const WavWriter&) = delete;
+    WavWriter& operator=(const WavWriter&) = delete;
+
+    bool open(const std::string& path, int sample_rate, int channels);
+    void write(const float* samples, size_t frames);   // Interleaved
+    bool close();
+
+    bool is_open() const { return file_ != nullptr; }
+    size_t frames_written() const { return frames_; }
+
+private:
+    std::FILE* file_ = nullptr;
+    int channels_ = 0;
+    size_t frames_ = 0;
+    std::vector<int16_t> buffer_;
+};
+
+} // namespace cafe
+
+#endif // CAFE_WAV_H
@@ -0,0 +1,401 @@
+#include "animation.h"
+#include "sprite_sheet.h"
+#include <algorithm>
+#include <cfloat>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define CAFE_SIMD_SSE2 1
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#define CAFE_SIMD_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace cafe {
+
+namespace {
+
+const AnimationClip kBlankClip;
+const TextureRegion kBlankRegion;
+
+// Upper bound for loop / frame counts before float -> int conversion
+constexpr float kMaxSteps = 1e9f;
+
+// Keep the arrays dense: the last element fills the removed slot
+template<typename T>
+void move_last_into(std::vector<T>& values, uint32_t slot) {
+    values[slot] = values.back();
+    values.pop_back();
+}
+
+} // namespace
+
+// ============================================================================
+// AnimationTable Implementation
+// ============================================================================
+
+AnimationTable::AnimationTable() {
+    clear();
+}
+
+void AnimationTable::clear() {
+    clips_.clear();
+    regions_.clear();
+    by_name_.clear();
+
+    // Entry 0: a single blank frame, so INVALID_ANIMATION needs no checks
+    clips_.push_back(AnimationClip{});
+    regions_.push_back(TextureRegion());
+}
+
+AnimationHandle AnimationTable::add(const SpriteSheet& sheet, const std::string& name,
+                                    const std::string& prefix) {
+    const Animation* anim = sheet.animation(name);
+    if (!anim) {
+        return INVALID_ANIMATION;
+    }
+
+    AnimationClip clip;
+    clip.first_frame = static_cast<int32_t>(regions_.size());
+    clip.frame_duration = anim->frame_duration;
+    clip.looping = anim->looping;
+
+    for (int index : anim->frame_indices) {
+        const SpriteFrame* frame = sheet.frame(index);
+        regions_.push_back(frame ? frame->region : TextureRegion(sheet.texture()));
+    }
+    if (anim->frame_indices.empty()) {
+        regions_.push_back(TextureRegion(sheet.texture()));  // Same fallback as SpriteSheet
+    }
+    clip.frame_count = static_cast<int32_t>(regions_.size()) - clip.first_frame;
+
+    // Zero duration holds the first frame (inv_frame_duration stays 0)
+    if (anim->total_duration() > 0.0f) {
+        clip.total_duration = anim->total_duration();
+        clip.inv_frame_duration = 1.0f / anim->frame_duration;
+    }
+
+    // Re-adding a name points it at the new clip
+    AnimationHandle handle = static_cast<AnimationHandle>(clips_.size());
+    clips_.push_back(clip);
+    by_name_[prefix + name] = handle;
+    return handle;
+}
+
+int AnimationTable::add_all(const SpriteSheet& sheet, const std::string& prefix) {
+    // Sort names so handles do not depend on hash map order
+    std::vector<std::string> names;
+    for (const auto& [name, anim] : sheet.animations()) {
+        names.push_back(name);
+    }
+    std::sort(names.begin(), names.end());
+
+    for (const auto& name : names) {
+        add(sheet, name, prefix);
+    }
+    return static_cast<int>(names.size());
+}
+
+AnimationHandle AnimationTable::find(const std::string& name) const {
+    auto it = by_name_.find(name);
+    return it != by_name_.end() ? it->second : INVALID_ANIMATION;
+}
+
+int32_t AnimationTable::frame_at(AnimationHandle handle, float time) const {
+    const AnimationClip& c = clip(handle);
+
+    float t = std::max(time, 0.0f);
+    if (c.looping && c.total_duration > 0.0f) {
+        t -= static_cast<float>(static_cast<int64_t>(t / c.total_duration)) * c.total_duration;
+    }
+    int32_t local = static_cast<int32_t>(std::min(t * c.inv_frame_duration, kMaxSteps));
+    return c.first_frame + std::min(local, c.frame_count - 1);
+}
+
+// ============================================================================
+// AnimationSystem - Animators
+// ============================================================================
+
+AnimationSystem::AnimationSystem(const AnimationTable* table)
+    : table_(table) {
+}
+
+AnimatorID AnimationSystem::create(AnimationHandle animation, float speed) {
+    AnimatorID id;
+    if (!free_ids_.empty()) {
+        id = free_ids_.back();
+        free_ids_.pop_back();
+    } else {
+        if (slot_of_.empty()) {
+            slot_of_.push_back(NO_SLOT);  // ID 0 is INVALID_ANIMATOR
+        }
+        id = static_cast<AnimatorID>(slot_of_.size());
+        slot_of_.push_back(NO_SLOT);
+    }
+
+    uint32_t s = static_cast<uint32_t>(time_.size());
+    slot_of_[id] = s;
+    id_of_.push_back(id);
+
+    time_.push_back(0.0f);
+    rate_.push_back(0.0f);
+    wrap_.push_back(0.0f);
+    inv_wrap_.push_back(0.0f);
+    limit_.push_back(0.0f);
+    inv_frame_duration_.push_back(0.0f);
+    first_frame_.push_back(0);
+    last_local_.push_back(0);
+    frame_.push_back(0);
+
+    animation_.push_back(INVALID_ANIMATION);
+    speed_.push_back(speed);
+    playing_.push_back(0);
+
+    if (animation != INVALID_ANIMATION) {
+        play(id, animation, true);
+    }
+    return id;
+}
+
+void AnimationSystem::destroy(AnimatorID id) {
+    uint32_t s = slot(id);
+    if (s == NO_SLOT) return;
+
+    AnimatorID moved = id_of_.back();
+    move_last_into(time_, s);
+    move_last_into(rate_, s);
+    move_last_into(wrap_, s);
+    move_last_into(inv_wrap_, s);
+    move_last_into(limit_, s);
+    move_last_into(inv_frame_duration_, s);
+    move_last_into(first_frame_, s);
+    move_last_into(last_local_, s);
+    move_last_into(frame_, s);
+    move_last_into(animation_, s);
+    move_last_into(speed_, s);
+    move_last_into(playing_, s);
+    move_last_into(id_of_, s);
+
+    slot_of_[moved] = s;
+    slot_of_[id] = NO_SLOT;
+    free_ids_.push_back(id);
+}
+
+bool AnimationSystem::is_valid(AnimatorID id) const {
+    return slot(id) != NO_SLOT;
+}
+
+void AnimationSystem::reserve(size_t count) {
+    time_.reserve(count);
+    rate_.reserve(count);
+    wrap_.reserve(count);
+    inv_wrap_.reserve(count);
+    limit_.reserve(count);
+    inv_frame_duration_.reserve(count);
+    first_frame_.reserve(count);
+    last_local_.reserve(count);
+    frame_.reserve(count);
+    animation_.reserve(count);
+    speed_.reserve(count);
+    playing_.reserve(count);
+    id_of_.reserve(count);
+    slot_of_.reserve(count + 1);
+}
+
+void AnimationSystem::clear() {
+    time_.clear();
+    rate_.clear();
+    wrap_.clear();
+    inv_wrap_.clear();
+    limit_.clear();
+    inv_frame_duration_.clear();
+    first_frame_.clear();
+    last_local_.clear();
+    frame_.clear();
+    animation_.clear();
+    speed_.clear();
+    playing_.clear();
+    id_of_.clear();
+    slot_of_.clear();
+    free_ids_.clear();
+}
+
+// ============================================================================
+// AnimationSystem - Playback
+// ============================================================================
+
+void AnimationSystem::load_clip(uint32_t s, AnimationHandle animation) {
+    const AnimationClip& c = table_ ? table_->clip(animation) : kBlankClip;
+
+    animation_[s] = table_ ? animation : INVALID_ANIMATION;
+    first_frame_[s] = c.first_frame;
+    last_local_[s] = c.frame_count - 1;
+    inv_frame_duration_[s] = c.inv_frame_duration;
+
+    bool loops = c.looping && c.total_duration > 0.0f;
+    wrap_[s] = loops ? c.total_duration : 0.0f;
+    inv_wrap_[s] = loops ? 1.0f / c.total_duration : 0.0f;
+    limit_[s] = c.looping ? FLT_MAX : c.total_duration;
+}
+
+void AnimationSystem::refresh_rate(uint32_t s) {
+    rate_[s] = playing_[s] ? speed_[s] : 0.0f;
+}
+
+void AnimationSystem::refresh_frame(uint32_t s) {
+    int32_t local = static_cast<int32_t>(std::min(time_[s] * inv_frame_duration_[s], kMaxSteps));
+    frame_[s] = first_frame_[s] + std::min(local, last_local_[s]);
+}
+
+void AnimationSystem::play(AnimatorID id, AnimationHandle animation, bool force) {
+    uint32_t s = slot(id);
+    if (s == NO_SLOT) return;
+    if (!force && playing_[s] && animation_[s] == animation) return;
+
+    load_clip(s, animation);
+    time_[s] = 0.0f;
+    playing_[s] = 1;
+    refresh_rate(s);
+    refresh_frame(s);
+}
+
+void AnimationSystem::stop(AnimatorID id) {
+    uint32_t s = slot(id);
+    if (s == NO_SLOT) return;
+
+    load_clip(s, INVALID_ANIMATION);
+    time_[s] = 0.0f;
+    playing_[s] = 0;
+    refresh_rate(s);
+    refresh_frame(s);
+}
+
+void AnimationSystem::pause(AnimatorID id) {
+    uint32_t s = slot(id);
+    if (s == NO_SLOT) return;
+    playing_[s] = 0;
+    refresh_rate(s);
+}
+
+void AnimationSystem::resume(AnimatorID id) {
+    uint32_t s = slot(id);
+    if (s == NO_SLOT) return;
+    playing_[s] = 1;
+    refresh_rate(s);
+}
+
+void AnimationSystem::set_speed(AnimatorID id, float speed) {
+    uint32_t s = slot(id);
+    if (s == NO_SLOT) return;
+    speed_[s] = speed;
+    refresh_rate(s);
+}
+
+void AnimationSystem::update_all(float dt) {
+    const size_t count = time_.size();
+
+    // Plain pointers: no bounds checks in the hot loop
+    float* time = time_.data();
+    const float* rate = rate_.data();
+    const float* wrap = wrap_.data();
+    const float* inv_wrap = inv_wrap_.data();
+    const float* limit = limit_.data();
+    const float* inv_frame_duration = inv_frame_duration_.data();
+    const int32_t* first_frame = first_frame_.data();
+    const int32_t* last_local = last_local_.data();
+    int32_t* frame = frame_.data();
+
+    // Branch-free: looping and one-shot clips differ only in their wrap /
+    // limit values. kMaxSteps keeps float -> int conversions in range for
+    // absurd time steps.
+    //
+    // Written with intrinsics, four animators per step: compilers will not
+    // vectorize the float min/max themselves unless trapping math is off.
+    size_t i = 0;
+
+#if defined(CAFE_SIMD_SSE2)
+    const __m128 vdt = _mm_set1_ps(dt);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 max_steps = _mm_set1_ps(kMaxSteps);
+    for (; i + 4 <= count; i += 4) {
+        __m128 t = _mm_add_ps(_mm_loadu_ps(time + i), _mm_mul_ps(vdt, _mm_loadu_ps(rate + i)));
+        __m128 wraps = _mm_min_ps(_mm_mul_ps(t, _mm_loadu_ps(inv_wrap + i)), max_steps);
+        t = _mm_sub_ps(t, _mm_mul_ps(_mm_cvtepi32_ps(_mm_cvttps_epi32(wraps)), _mm_loadu_ps(wrap + i)));
+        t = _mm_min_ps(_mm_max_ps(t, zero), _mm_loadu_ps(limit + i));
+        _mm_storeu_ps(time + i, t);
+
+        __m128 steps = _mm_min_ps(_mm_mul_ps(t, _mm_loadu_ps(inv_frame_duration + i)), max_steps);
+        __m128i local = _mm_cvttps_epi32(steps);
+        __m128i last = _mm_loadu_si128(reinterpret_cast<const __m128i*>(last_local + i));
+        __m128i over = _mm_cmpgt_epi32(local, last);  // SSE2 has no 32-bit integer min
+        local = _mm_or_si128(_mm_and_si128(over, last), _mm_andnot_si128(over, local));
+
+        __m128i first = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first_frame + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(frame + i), _mm_add_epi32(first, local));
+    }
+#elif defined(CAFE_SIMD_NEON)
+    const float32x4_t vdt = vdupq_n_f32(dt);
+    const float32x4_t zero = vdupq_n_f32(0.0f);
+    const float32x4_t max_steps = vdupq_n_f32(kMaxSteps);
+    for (; i + 4 <= count; i += 4) {
+        float32x4_t t = vaddq_f32(vld1q_f32(time + i), vmulq_f32(vdt, vld1q_f32(rate + i)));
+        float32x4_t wraps = vminq_f32(vmulq_f32(t, vld1q_f32(inv_wrap + i)), max_steps);
+        t = vsubq_f32(t, vmulq_f32(vcvtq_f32_s32(vcvtq_s32_f32(wraps)), vld1q_f32(wrap + i)));
+        t = vminq_f32(vmaxq_f32(t, zero), vld1q_f32(limit + i));
+        vst1q_f32(time + i, t);
+
+        float32x4_t steps = vminq_f32(vmulq_f32(t, vld1q_f32(inv_frame_duration + i)), max_steps);
+        int32x4_t local = vminq_s32(vcvtq_s32_f32(steps), vld1q_s32(last_local + i));
+        vst1q_s32(frame + i, vaddq_s32(vld1q_s32(first_frame + i), local));
+    }
+#endif
+
+    // Scalar version (remainder, or the whole array without SIMD)
+    for (; i < count; ++i) {
+        float t = time[i] + dt * rate[i];
+        t -= static_cast<float>(static_cast<int32_t>(std::min(t * inv_wrap[i], kMaxSteps))) * wrap[i];
+        t = std::min(std::max(t, 0.0f), limit[i]);
+        time[i] = t;
+
+        int32_t local = static_cast<int32_t>(std::min(t * inv_frame_duration[i], kMaxSteps));
+        frame[i] = first_frame[i] + std::min(local, last_local[i]);
+    }
+}
+
+// ============================================================================
+// AnimationSystem - State
+// ============================================================================
+
+AnimationHandle AnimationSystem::animation(AnimatorID id) const {
+    uint32_t s = slot(id);
+    return s != NO_SLOT ? animation_[s] : INVALID_ANIMATION;
+}
+
+float AnimationSystem::elapsed(AnimatorID id) const {
+    uint32_t s = slot(id);
+    return s != NO_SLOT ? time_[s] : 0.0f;
+}
+
+bool AnimationSystem::is_playing(AnimatorID id) const {
+    uint32_t s = slot(id);
+    return s != NO_SLOT && playing_[s] && !is_finished(id);
+}
+
+bool AnimationSystem::is_finished(AnimatorID id) const {
+    uint32_t s = slot(id);
+    if (s == NO_SLOT || animation_[s] == INVALID_ANIMATION) return true;
+    return limit_[s] != FLT_MAX && time_[s] >= limit_[s];  // Looping clips never finish
+}
+
+int32_t AnimationSystem::frame(AnimatorID id) const {
+    uint32_t s = slot(id);
+    return s != NO_SLOT ? frame_[s] : 0;
+}
+
+const TextureRegion& AnimationSystem::region(AnimatorID id) const {
+    uint32_t s = slot(id);
+    if (s == NO_SLOT || !table_) return kBlankRegion;
+    return table_->region(frame_[s]);
+}
+
+} // namespace cafe
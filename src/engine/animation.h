@@ -0,0 +1,226 @@
+#ifndef CAFE_ANIMATION_H
+#define CAFE_ANIMATION_H
+
+#include "../renderer/renderer.h"
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace cafe {
+
+class SpriteSheet;
+
+// ============================================================================
+// Animation Handles
+// ============================================================================
+
+// Index of a compiled animation in an AnimationTable
+using AnimationHandle = uint32_t;
+constexpr AnimationHandle INVALID_ANIMATION = 0;  // Entry 0: one blank frame
+
+// One animated object in an AnimationSystem
+using AnimatorID = uint32_t;
+constexpr AnimatorID INVALID_ANIMATOR = 0;
+
+// ============================================================================
+// AnimationClip - A compiled animation (no strings, no lookups)
+// ============================================================================
+
+struct AnimationClip {
+    int32_t first_frame = 0;         // Index into AnimationTable::regions()
+    int32_t frame_count = 1;
+    float frame_duration = 0.0f;     // Seconds per frame
+    float inv_frame_duration = 0.0f; // 1 / frame_duration (0 = hold frame 0)
+    float total_duration = 0.0f;
+    bool looping = true;
+};
+
+// ============================================================================
+// AnimationTable - Flat frame tables for every animation
+// ============================================================================
+//
+// SpriteSheet stores animations by name, and each one points at frames by
+// index. That is convenient for authoring, but the per-frame cost adds up:
+// hash the name, find the Animation, divide to get the frame number, then
+// index the frame list for the UV rect.
+//
+// AnimationTable compiles animations once, at load time:
+//
+//   clips_    [ idle | walk | sit | ... ]          one AnimationClip each
+//   regions_  [ i0 | w0 w1 w2 w3 | s0 s1 | ... ]   UV rects, back to back
+//
+// An AnimationHandle is the clip index. A playing animation's current UV
+// rect is then regions_[clip.first_frame + frame_number] - two array
+// reads, no hashing, no division (the reciprocal duration is stored).
+//
+// Usage:
+//   AnimationTable table;
+//   table.add_all(customer_sheet, "customer/");   // "customer/walk", ...
+//   AnimationHandle walk = table.find("customer/walk");  // Once, at setup
+//
+// ============================================================================
+
+class AnimationTable {
+public:
+    AnimationTable();
+
+    // Compile one animation from a sheet (registered as prefix + name)
+    // Returns INVALID_ANIMATION if the sheet has no such animation
+    AnimationHandle add(const SpriteSheet& sheet, const std::string& name,
+                        const std::string& prefix = "");
+
+    // Compile every animation in a sheet; returns how many were added
+    int add_all(const SpriteSheet& sheet, const std::string& prefix = "");
+
+    // Load-time lookup (INVALID_ANIMATION if not found)
+    AnimationHandle find(const std::string& name) const;
+
+    const AnimationClip& clip(AnimationHandle handle) const {
+        return clips_[handle < clips_.size() ? handle : INVALID_ANIMATION];
+    }
+    int size() const { return static_cast<int>(clips_.size()); }
+
+    // UV rects of every compiled frame
+    const TextureRegion& region(int32_t frame) const { return regions_[frame]; }
+    const std::vector<TextureRegion>& regions() const { return regions_; }
+
+    // Frame (index into regions()) shown `time` seconds into an animation
+    // Same rules as SpriteSheet::animation_frame_index()
+    int32_t frame_at(AnimationHandle handle, float time) const;
+
+    // Remove everything except the blank entry
+    void clear();
+
+private:
+    std::vector<AnimationClip> clips_;
+    std::vector<TextureRegion> regions_;
+    std::unordered_map<std::string, AnimationHandle> by_name_;
+};
+
+// ============================================================================
+// AnimationSystem - Batched animator updates (structure of arrays)
+// ============================================================================
+//
+// One Animator component per customer means one heap object per customer,
+// reached through its entity, doing a name lookup every update.
+// AnimationSystem instead keeps every animator's state in parallel arrays:
+//
+//   time_[i]  rate_[i]  inv_frame_duration_[i]  first_frame_[i]  ...
+//
+// play() copies the clip's parameters into the animator's slot, so
+// update_all() is one straight loop over contiguous floats and ints with
+// no lookups and no branches - the kind of loop the compiler turns into
+// SIMD code. Looping and one-shot animations share the same arithmetic:
+//
+//   t      = time + dt * rate                 (rate = 0 while paused)
+//   t     -= trunc(t * inv_wrap) * wrap       (wrap = 0 for one-shots)
+//   t      = clamp(t, 0, limit)               (limit = duration for one-shots)
+//   frame  = first_frame + min(int(t * inv_frame_duration), last_local)
+//
+// Animators are addressed by AnimatorID. IDs stay valid until destroy();
+// internally the arrays are kept dense by moving the last animator into
+// the freed slot.
+//
+// Usage:
+//   AnimationSystem animators(&table);
+//   AnimatorID id = animators.create(walk);
+//   ...
+//   animators.update_all(dt);                   // Once per frame
+//   sprite.region = animators.region(id);
+//
+// ============================================================================
+
+class AnimationSystem {
+public:
+    AnimationSystem() = default;
+    explicit AnimationSystem(const AnimationTable* table);
+
+    // The table must outlive the system; changing it resets nothing, so
+    // set it before creating animators
+    void set_table(const AnimationTable* table) { table_ = table; }
+    const AnimationTable* table() const { return table_; }
+
+    // ========================================================================
+    // Animators
+    // ========================================================================
+
+    // Create an animator, optionally already playing an animation
+    AnimatorID create(AnimationHandle animation = INVALID_ANIMATION, float speed = 1.0f);
+    void destroy(AnimatorID id);
+    bool is_valid(AnimatorID id) const;
+
+    void reserve(size_t count);
+    size_t size() const { return time_.size(); }
+    void clear();
+
+    // ========================================================================
+    // Playback
+    // ========================================================================
+
+    // Play from the start (does nothing if already playing it unless force=true)
+    void play(AnimatorID id, AnimationHandle animation, bool force = false);
+    void stop(AnimatorID id);
+    void pause(AnimatorID id);
+    void resume(AnimatorID id);
+    void set_speed(AnimatorID id, float speed);
+
+    // Advance every animator
+    void update_all(float dt);
+
+    // ========================================================================
+    // State (as of the last update_all / play)
+    // ========================================================================
+
+    AnimationHandle animation(AnimatorID id) const;
+    float elapsed(AnimatorID id) const;
+    bool is_playing(AnimatorID id) const;
+    bool is_finished(AnimatorID id) const;  // One-shot animation completed
+
+    // Current frame (index into the table's regions) and its UV rect
+    int32_t frame(AnimatorID id) const;
+    const TextureRegion& region(AnimatorID id) const;
+
+    // Dense arrays for batch consumers (sprite batching, culling, ...)
+    // frames()[i] belongs to animator ids()[i]
+    const std::vector<int32_t>& frames() const { return frame_; }
+    const std::vector<AnimatorID>& ids() const { return id_of_; }
+
+private:
+    static constexpr uint32_t NO_SLOT = 0xFFFFFFFFu;
+
+    // Dense index of a live animator (NO_SLOT if invalid)
+    uint32_t slot(AnimatorID id) const {
+        return id < slot_of_.size() ? slot_of_[id] : NO_SLOT;
+    }
+
+    // Copy clip parameters into a slot
+    void load_clip(uint32_t slot, AnimationHandle animation);
+    void refresh_rate(uint32_t slot);
+    void refresh_frame(uint32_t slot);
+
+    const AnimationTable* table_ = nullptr;
+
+    // Hot: read and written by update_all()
+    std::vector<float> time_;
+    std::vector<float> rate_;                // speed, or 0 while paused
+    std::vector<float> wrap_;                // Clip duration if looping, else 0
+    std::vector<float> inv_wrap_;            // 1 / wrap_ (0 for one-shots)
+    std::vector<float> limit_;               // Clip duration for one-shots, FLT_MAX if looping
+    std::vector<float> inv_frame_duration_;
+    std::vector<int32_t> first_frame_;
+    std::vector<int32_t> last_local_;        // frame_count - 1
+    std::vector<int32_t> frame_;             // Output: index into regions()
+
+    // Cold: only touched by play/pause/queries
+    std::vector<AnimationHandle> animation_;
+    std::vector<float> speed_;
+    std::vector<uint8_t> playing_;
+    std::vector<AnimatorID> id_of_;          // Dense slot -> id
+    std::vector<uint32_t> slot_of_;          // Id -> dense slot
+    std::vector<AnimatorID> free_ids_;
+};
+
+} // namespace cafe
+
+#endif // CAFE_ANIMATION_H
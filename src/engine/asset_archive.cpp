@@ -0,0 +1,429 @@
+#include "asset_archive.h"
+#include "lz4_block.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+
+namespace cafe {
+
+// ============================================================================
+// Archive File Format
+// ============================================================================
+
+namespace {
+
+constexpr char kArchiveMagic[4] = {'C', 'P', 'A', 'K'};
+constexpr uint64_t kPayloadAlignment = 64;
+constexpr uint8_t kStored = 0;
+constexpr uint8_t kLZ4 = 1;
+
+// Give up on a displacement search after this many tries and reseed
+constexpr uint32_t kMaxDisplacement = 1u << 16;
+
+struct ArchiveHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t entry_count;
+    uint32_t seed;
+    uint64_t names_offset;
+    uint32_t names_size;
+    uint32_t reserved;
+};
+static_assert(sizeof(ArchiveHeader) == 32, "archive header must be 32 bytes");
+
+uint64_t align_up(uint64_t value, uint64_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+// FNV-1a, seeded per displacement, with a final mix so `% n` sees
+// well-distributed low bits
+uint64_t path_hash(const std::string& path, uint32_t seed, uint32_t displacement) {
+    uint64_t h = 14695981039346656037ull ^
+                 (((static_cast<uint64_t>(seed) << 32) | displacement) * 0x9E3779B97F4A7C15ull);
+    for (unsigned char c : path) {
+        h ^= c;
+        h *= 1099511628211ull;
+    }
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDull;
+    h ^= h >> 33;
+    h *= 0xC4CEB9FE1A85EC53ull;
+    h ^= h >> 33;
+    return h;
+}
+
+bool read_file(const std::string& path, std::vector<uint8_t>& out) {
+    FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) return false;
+
+    bool ok = std::fseek(file, 0, SEEK_END) == 0;
+    long size = ok ? std::ftell(file) : -1;
+    ok = ok && size >= 0 && std::fseek(file, 0, SEEK_SET) == 0;
+    if (ok) {
+        out.resize(static_cast<size_t>(size));
+        ok = out.empty() || std::fread(out.data(), 1, out.size(), file) == out.size();
+    }
+    std::fclose(file);
+    return ok;
+}
+
+// Zero bytes until the file position reaches `offset`
+bool pad_to(FILE* file, uint64_t& position, uint64_t offset) {
+    static const char zeros[kPayloadAlignment] = {};
+    while (position < offset) {
+        size_t n = static_cast<size_t>(std::min<uint64_t>(offset - position, sizeof(zeros)));
+        if (std::fwrite(zeros, 1, n, file) != n) return false;
+        position += n;
+    }
+    return true;
+}
+
+// Minimal perfect hash: slot for every key, displacement per bucket
+// Returns false if no displacement was found (caller reseeds)
+bool build_perfect_hash(const std::vector<std::string>& keys, uint32_t seed,
+                        std::vector<int32_t>& displacement, std::vector<int>& slot_of) {
+    size_t n = keys.size();
+    std::vector<std::vector<int>> buckets(n);
+    for (size_t i = 0; i < n; ++i) {
+        buckets[path_hash(keys[i], seed, 0) % n].push_back(static_cast<int>(i));
+    }
+
+    // Largest buckets first, while most slots are still free
+    std::vector<size_t> order(n);
+    for (size_t b = 0; b < n; ++b) order[b] = b;
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return buckets[a].size() > buckets[b].size();
+    });
+
+    displacement.assign(n, 0);
+    slot_of.assign(n, -1);
+    std::vector<bool> used(n, false);
+    std::vector<size_t> slots;
+
+    size_t next_free = 0;
+    for (size_t b : order) {
+        const std::vector<int>& bucket = buckets[b];
+        if (bucket.empty()) break;
+
+        if (bucket.size() == 1) {
+            // Single keys take any free slot directly (encoded as -slot - 1)
+            while (used[next_free]) ++next_free;
+            used[next_free] = true;
+            slot_of[bucket[0]] = static_cast<int>(next_free);
+            displacement[b] = -static_cast<int32_t>(next_free) - 1;
+            continue;
+        }
+
+        bool placed = false;
+        for (uint32_t d = 1; d < kMaxDisplacement && !placed; ++d) {
+            slots.clear();
+            placed = true;
+            for (int key : bucket) {
+                size_t slot = path_hash(keys[key], seed, d) % n;
+                if (used[slot] || std::find(slots.begin(), slots.end(), slot) != slots.end()) {
+                    placed = false;
+                    break;
+                }
+                slots.push_back(slot);
+            }
+            if (placed) {
+                for (size_t k = 0; k < bucket.size(); ++k) {
+                    used[slots[k]] = true;
+                    slot_of[bucket[k]] = static_cast<int>(slots[k]);
+                }
+                displacement[b] = static_cast<int32_t>(d);
+            }
+        }
+        if (!placed) return false;
+    }
+    return true;
+}
+
+} // namespace
+
+// ============================================================================
+// Packing
+// ============================================================================
+
+std::string AssetArchive::normalize_path(const std::string& path) {
+    std::string result = path;
+    std::replace(result.begin(), result.end(), '\\', '/');
+    while (result.compare(0, 2, "./") == 0) {
+        result.erase(0, 2);
+    }
+    while (!result.empty() && result[0] == '/') {
+        result.erase(0, 1);
+    }
+    return result;
+}
+
+std::vector<ArchiveInput> AssetArchive::list_directory(const std::string& directory) {
+    std::vector<ArchiveInput> inputs;
+    std::error_code error;
+    for (const auto& entry : std::filesystem::recursive_directory_iterator(directory, error)) {
+        if (!entry.is_regular_file()) continue;
+        ArchiveInput input;
+        input.source_path = entry.path().string();
+        input.path = normalize_path(
+            std::filesystem::relative(entry.path(), directory, error).generic_string());
+        inputs.push_back(std::move(input));
+    }
+    if (error) {
+        std::cerr << "AssetArchive: Failed to list directory: " << directory << "\n";
+    }
+
+    std::sort(inputs.begin(), inputs.end(), [](const ArchiveInput& a, const ArchiveInput& b) {
+        return a.path < b.path;
+    });
+    return inputs;
+}
+
+bool AssetArchive::pack(const std::string& archive_path, const std::vector<ArchiveInput>& inputs,
+                        const PackOptions& options) {
+    size_t n = inputs.size();
+    std::vector<std::string> keys(n);
+    for (size_t i = 0; i < n; ++i) {
+        keys[i] = normalize_path(inputs[i].path);
+        if (keys[i].empty() || keys[i].size() > 0xFFFF) {
+            std::cerr << "AssetArchive: Invalid path: '" << inputs[i].path << "'\n";
+            return false;
+        }
+    }
+
+    std::vector<std::string> sorted = keys;
+    std::sort(sorted.begin(), sorted.end());
+    auto duplicate = std::adjacent_find(sorted.begin(), sorted.end());
+    if (duplicate != sorted.end()) {
+        std::cerr << "AssetArchive: Duplicate path: " << *duplicate << "\n";
+        return false;
+    }
+
+    // Perfect hash (reseed in the unlikely case a bucket cannot be placed)
+    uint32_t seed = 0;
+    std::vector<int32_t> displacement;
+    std::vector<int> slot_of;
+    while (!build_perfect_hash(keys, seed, displacement, slot_of)) {
+        seed++;
+    }
+
+    ArchiveHeader header;
+    std::memcpy(header.magic, kArchiveMagic, sizeof(header.magic));
+    header.version = VERSION;
+    header.entry_count = static_cast<uint32_t>(n);
+    header.seed = seed;
+    header.reserved = 0;
+
+    std::vector<Entry> entries(n);
+    std::string names;
+    for (size_t i = 0; i < n; ++i) {
+        Entry& e = entries[slot_of[i]];
+        e = Entry{};
+        e.hash = path_hash(keys[i], seed, 0);
+        e.name_offset = static_cast<uint32_t>(names.size());
+        e.name_length = static_cast<uint16_t>(keys[i].size());
+        names += keys[i];
+    }
+
+    uint64_t entries_offset = align_up(sizeof(header) + n * sizeof(int32_t), 8);
+    header.names_offset = entries_offset + n * sizeof(Entry);
+    header.names_size = static_cast<uint32_t>(names.size());
+
+    FILE* file = std::fopen(archive_path.c_str(), "wb");
+    if (!file) {
+        std::cerr << "AssetArchive: Failed to create archive: " << archive_path << "\n";
+        return false;
+    }
+
+    // Payloads first (in input order, so related files stay together);
+    // header and tables are written at the end, once offsets are known
+    uint64_t position = 0;
+    bool ok = pad_to(file, position, align_up(header.names_offset + names.size(), kPayloadAlignment));
+
+    std::vector<uint8_t> data;
+    std::vector<uint8_t> packed;
+    for (size_t i = 0; ok && i < n; ++i) {
+        if (!read_file(inputs[i].source_path, data)) {
+            std::cerr << "AssetArchive: Failed to read: " << inputs[i].source_path << "\n";
+            ok = false;
+            break;
+        }
+        if (data.size() > 0xFFFFFFFFu) {
+            std::cerr << "AssetArchive: File too large: " << inputs[i].source_path << "\n";
+            ok = false;
+            break;
+        }
+
+        Entry& e = entries[slot_of[i]];
+        e.offset = position;
+        e.size = static_cast<uint32_t>(data.size());
+        e.compression = kStored;
+
+        const std::vector<uint8_t>* payload = &data;
+        if (options.compress && !data.empty()) {
+            packed.resize(lz4::compress_bound(data.size()));
+            size_t bytes = lz4::compress(data.data(), data.size(), packed.data(), packed.size());
+            if (bytes > 0 && bytes <= data.size() - data.size() / 16) {
+                packed.resize(bytes);
+                payload = &packed;
+                e.compression = kLZ4;
+            }
+        }
+        e.stored_size = static_cast<uint32_t>(payload->size());
+
+        ok = payload->empty() ||
+             std::fwrite(payload->data(), 1, payload->size(), file) == payload->size();
+        position += payload->size();
+        ok = ok && pad_to(file, position, align_up(position, kPayloadAlignment));
+    }
+
+    uint64_t table_position = 0;
+    ok = ok && std::fseek(file, 0, SEEK_SET) == 0;
+    ok = ok && std::fwrite(&header, sizeof(header), 1, file) == 1;
+    ok = ok && (n == 0 || std::fwrite(displacement.data(), sizeof(int32_t), n, file) == n);
+    table_position = sizeof(header) + n * sizeof(int32_t);
+    ok = ok && pad_to(file, table_position, entries_offset);
+    ok = ok && (n == 0 || std::fwrite(entries.data(), sizeof(Entry), n, file) == n);
+    ok = ok && (names.empty() || std::fwrite(names.data(), 1, names.size(), file) == names.size());
+    ok = (std::fclose(file) == 0) && ok;
+
+    if (!ok) {
+        std::cerr << "AssetArchive: Failed to write archive: " << archive_path << "\n";
+        std::remove(archive_path.c_str());
+    }
+    return ok;
+}
+
+// ============================================================================
+// Reading
+// ============================================================================
+
+bool AssetArchive::open(const std::string& path) {
+    close();
+
+    if (!file_.open(path)) {
+        return false;
+    }
+
+    const uint8_t* data = file_.data();
+    size_t size = file_.size();
+
+    ArchiveHeader header;
+    if (size < sizeof(header)) {
+        std::cerr << "AssetArchive: File too small: " << path << "\n";
+        close();
+        return false;
+    }
+    std::memcpy(&header, data, sizeof(header));
+
+    if (std::memcmp(header.magic, kArchiveMagic, sizeof(header.magic)) != 0 ||
+        header.version != VERSION) {
+        std::cerr << "AssetArchive: Not a version " << VERSION << " archive: " << path << "\n";
+        close();
+        return false;
+    }
+
+    size_t n = header.entry_count;
+    uint64_t entries_offset = align_up(sizeof(header) + n * sizeof(int32_t), 8);
+    if (header.names_offset != entries_offset + n * sizeof(Entry) ||
+        header.names_offset > size || header.names_size > size - header.names_offset) {
+        std::cerr << "AssetArchive: Corrupt table of contents: " << path << "\n";
+        close();
+        return false;
+    }
+
+    seed_ = header.seed;
+    displacement_.resize(n);
+    entries_.resize(n);
+    if (n > 0) {
+        std::memcpy(displacement_.data(), data + sizeof(header), n * sizeof(int32_t));
+        std::memcpy(entries_.data(), data + entries_offset, n * sizeof(Entry));
+    }
+    names_ = reinterpret_cast<const char*>(data + header.names_offset);
+
+    for (size_t i = 0; i < n; ++i) {
+        const Entry& e = entries_[i];
+        int32_t d = displacement_[i];
+        bool bad_entry = e.offset > size || e.stored_size > size - e.offset ||
+                         static_cast<uint64_t>(e.name_offset) + e.name_length > header.names_size ||
+                         e.compression > kLZ4 ||
+                         (e.compression == kStored && e.stored_size != e.size);
+        bool bad_displacement = d < 0 && static_cast<size_t>(-(static_cast<int64_t>(d) + 1)) >= n;
+        if (bad_entry || bad_displacement) {
+            std::cerr << "AssetArchive: Corrupt entry " << i << ": " << path << "\n";
+            close();
+            return false;
+        }
+    }
+    return true;
+}
+
+void AssetArchive::close() {
+    file_.close();
+    seed_ = 0;
+    displacement_.clear();
+    entries_.clear();
+    names_ = nullptr;
+}
+
+int AssetArchive::find(const std::string& path) const {
+    size_t n = entries_.size();
+    if (n == 0) {
+        return -1;
+    }
+
+    std::string key = normalize_path(path);
+    uint64_t hash = path_hash(key, seed_, 0);
+    int32_t d = displacement_[hash % n];
+    size_t slot = d < 0 ? static_cast<size_t>(-(static_cast<int64_t>(d) + 1))
+                        : path_hash(key, seed_, static_cast<uint32_t>(d)) % n;
+
+    // Paths not in the archive land on some slot too: confirm
+    const Entry& e = entries_[slot];
+    if (e.hash != hash || e.name_length != key.size() ||
+        std::memcmp(names_ + e.name_offset, key.data(), key.size()) != 0) {
+        return -1;
+    }
+    return static_cast<int>(slot);
+}
+
+bool AssetArchive::contains(const std::string& path) const {
+    return find(path) >= 0;
+}
+
+size_t AssetArchive::entry_size(const std::string& path) const {
+    int slot = find(path);
+    return slot >= 0 ? entries_[slot].size : 0;
+}
+
+AssetBytes AssetArchive::load(const std::string& path) const {
+    int slot = find(path);
+    if (slot < 0) {
+        return AssetBytes();
+    }
+
+    const Entry& e = entries_[slot];
+    const uint8_t* stored = file_.data() + e.offset;
+    if (e.compression == kStored) {
+        return AssetBytes(stored, e.size);  // Zero-copy
+    }
+
+    std::vector<uint8_t> data(e.size);
+    if (!lz4::decompress(stored, e.stored_size, data.data(), data.size())) {
+        std::cerr << "AssetArchive: Corrupt LZ4 data for " << path << ": " << file_.path() << "\n";
+        return AssetBytes();
+    }
+    return AssetBytes(std::move(data));
+}
+
+std::vector<std::string> AssetArchive::paths() const {
+    std::vector<std::string> result;
+    result.reserve(entries_.size());
+    for (const Entry& e : entries_) {
+        result.emplace_back(names_ + e.name_offset, e.name_length);
+    }
+    return result;
+}
+
+} // namespace cafe
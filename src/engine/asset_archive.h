@@ -0,0 +1,169 @@
+#ifndef CAFE_ASSET_ARCHIVE_H
+#define CAFE_ASSET_ARCHIVE_H
+
+#include "mapped_file.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace cafe {
+
+// ============================================================================
+// AssetBytes - An archive entry's contents
+// ============================================================================
+//
+// Points straight into the archive mapping for stored entries; owns a
+// decompressed copy for compressed ones. Either way data() stays valid
+// while the AssetBytes and its archive are alive.
+//
+// ============================================================================
+
+class AssetBytes {
+public:
+    AssetBytes() = default;
+    AssetBytes(const uint8_t* data, size_t size) : data_(data), size_(size) {}
+    explicit AssetBytes(std::vector<uint8_t>&& owned)
+        : owned_(std::move(owned)), data_(owned_.data()), size_(owned_.size()) {}
+
+    // Movable only (a copy would point into the original's buffer)
+    AssetBytes(const AssetBytes&) = delete;
+    AssetBytes& operator=(const AssetBytes&) = delete;
+    AssetBytes(AssetBytes&&) = default;
+    AssetBytes& operator=(AssetBytes&&) = default;
+
+    const uint8_t* data() const { return data_; }
+    size_t size() const { return size_; }
+    bool is_valid() const { return data_ != nullptr; }
+    explicit operator bool() const { return is_valid(); }
+
+private:
+    std::vector<uint8_t> owned_;   // Heap buffer: data_ survives moves
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+// ============================================================================
+// AssetArchive - Packed asset file (.cpak) with a perfect-hash index
+// ============================================================================
+//
+// Hundreds of small fopen/fread calls are slow on spinning disks and
+// worse in the web build, where each one can be a separate fetch. An
+// archive is one file, mapped once, with every asset inside it.
+//
+// File layout (little-endian):
+//
+//   Header        magic "CPAK", version, entry count, hash seed
+//   Displacement  one int32 per slot (see below)
+//   Entries       one per slot: path hash, payload offset, sizes,
+//                 compression, path offset in the name table
+//   Names         every path, back to back (for listing and verification)
+//   Payloads      64-byte aligned, stored as-is or as one LZ4 block
+//
+// Lookups use a minimal perfect hash ("hash and displace"): the packer
+// groups paths into buckets by hash(0, path) and searches each bucket for
+// a displacement d that sends all of its paths to free slots via
+// hash(d, path). At runtime a lookup is two hashes and two array reads:
+//
+//   d    = displacement[hash(0, path) % n]
+//   slot = d < 0 ? -d - 1 : hash(d, path) % n
+//
+// then the entry's stored full hash and path confirm it is really there.
+// Paths use '/' and are relative to the packed directory
+// ("sprites/barista.png").
+//
+// Usage:
+//   AssetArchive::pack("game.cpak", AssetArchive::list_directory("assets"));
+//
+//   AssetArchive archive;
+//   archive.open("game.cpak");
+//   AssetBytes png = archive.load("sprites/barista.png");
+//   auto image = Image::load_from_memory(png.data(), png.size());
+//
+// ============================================================================
+
+// One file going into an archive
+struct ArchiveInput {
+    std::string path;         // Path inside the archive
+    std::string source_path;  // File on disk to read
+};
+
+struct PackOptions {
+    bool compress = false;    // LZ4 entries that shrink by at least 1/16
+};
+
+class AssetArchive {
+public:
+    static constexpr uint32_t VERSION = 1;
+
+    AssetArchive() = default;
+
+    // Non-copyable, movable
+    AssetArchive(const AssetArchive&) = delete;
+    AssetArchive& operator=(const AssetArchive&) = delete;
+    AssetArchive(AssetArchive&&) = default;
+    AssetArchive& operator=(AssetArchive&&) = default;
+
+    // ========================================================================
+    // Packing (offline)
+    // ========================================================================
+
+    static bool pack(const std::string& archive_path, const std::vector<ArchiveInput>& inputs,
+                     const PackOptions& options = PackOptions());
+
+    // Every regular file under a directory, paths relative to it (sorted)
+    static std::vector<ArchiveInput> list_directory(const std::string& directory);
+
+    // "./sprites\\a.png" -> "sprites/a.png"
+    static std::string normalize_path(const std::string& path);
+
+    // ========================================================================
+    // Reading
+    // ========================================================================
+
+    bool open(const std::string& path);
+    void close();
+
+    bool is_open() const { return file_.is_open(); }
+    const std::string& path() const { return file_.path(); }
+    int entry_count() const { return static_cast<int>(entries_.size()); }
+
+    bool contains(const std::string& path) const;
+
+    // Entry contents (invalid if missing or corrupt)
+    // Stored entries are zero-copy views of the mapping
+    AssetBytes load(const std::string& path) const;
+
+    // Uncompressed size (0 if missing)
+    size_t entry_size(const std::string& path) const;
+
+    // Every path in the archive, in slot order
+    std::vector<std::string> paths() const;
+
+private:
+    // On-disk entry (32 bytes)
+    struct Entry {
+        uint64_t hash;          // hash(seed, 0, path), confirms a lookup
+        uint64_t offset;        // Payload position in the file
+        uint32_t stored_size;   // Bytes in the file
+        uint32_t size;          // Bytes after decompression
+        uint32_t name_offset;   // Path position in the name table
+        uint16_t name_length;
+        uint8_t compression;    // 0 = stored, 1 = LZ4
+        uint8_t reserved;
+    };
+    static_assert(sizeof(Entry) == 32, "archive entry must be 32 bytes");
+
+    // Slot index of a path, or -1
+    int find(const std::string& path) const;
+
+    MappedFile file_;
+    uint32_t seed_ = 0;
+    std::vector<int32_t> displacement_;
+    std::vector<Entry> entries_;
+    const char* names_ = nullptr;   // Into the mapping
+};
+
+} // namespace cafe
+
+#endif // CAFE_ASSET_ARCHIVE_H
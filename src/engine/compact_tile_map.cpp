@@ -0,0 +1,206 @@
+#include "compact_tile_map.h"
+#include <algorithm>
+
+namespace cafe {
+
+// ============================================================================
+// Construction
+// ============================================================================
+
+CompactTileMap::CompactTileMap(int width, int height) {
+    resize(width, height);
+}
+
+CompactTileMap::CompactTileMap(const TileMap& map) {
+    resize(map.width(), map.height());
+    for (int y = 0; y < height_; ++y) {
+        for (int x = 0; x < width_; ++x) {
+            store(index_of(x, y), map.at(x, y));
+        }
+    }
+}
+
+void CompactTileMap::resize(int width, int height) {
+    width_ = std::max(width, 0);
+    height_ = std::max(height, 0);
+
+    // Round up to whole chunks
+    chunks_x_ = static_cast<size_t>((width_ + CHUNK_SIZE - 1) >> CHUNK_SHIFT);
+    chunks_y_ = static_cast<size_t>((height_ + CHUNK_SIZE - 1) >> CHUNK_SHIFT);
+    size_t tile_count = chunks_x_ * chunks_y_ * CHUNK_TILES + 1;  // +1 scratch slot
+
+    ids_.assign(tile_count, 0);
+    heights_.assign(tile_count, 0);
+    for (auto& plane : flag_planes_) {
+        plane.assign((tile_count + 63) / 64, 0);
+    }
+    used_flags_ = 0;
+}
+
+// ============================================================================
+// Tile Access
+// ============================================================================
+
+CompactTileMap::TileRef CompactTileMap::at(int x, int y) {
+    if (ids_.empty()) {
+        resize(0, 0);  // Always keep the scratch slot
+    }
+    if (!in_bounds(x, y)) {
+        // Return empty tile for out-of-bounds access
+        size_t scratch = scratch_index();
+        store(scratch, Tile{});
+        return TileRef(this, scratch);
+    }
+    return TileRef(this, index_of(x, y));
+}
+
+Tile CompactTileMap::at(int x, int y) const {
+    if (!in_bounds(x, y)) {
+        return Tile{};
+    }
+    return load(index_of(x, y));
+}
+
+uint8_t CompactTileMap::tile_flags(int x, int y) const {
+    return in_bounds(x, y) ? load(index_of(x, y)).flags : 0;
+}
+
+int CompactTileMap::get_field(size_t index, int field) const {
+    switch (field) {
+        case 0: return ids_[index];
+        case 1: return heights_[index];
+        default: return load(index).flags;
+    }
+}
+
+void CompactTileMap::set_field(size_t index, int field, int value) {
+    Tile tile = load(index);
+    switch (field) {
+        case 0: tile.tile_id = value; break;
+        case 1: tile.height = value; break;
+        default: tile.flags = static_cast<uint8_t>(value); break;
+    }
+    store(index, tile);
+}
+
+void CompactTileMap::store(size_t index, const Tile& tile) {
+    ids_[index] = static_cast<uint16_t>(std::clamp(tile.tile_id, 0, MAX_TILE_ID));
+    heights_[index] = static_cast<uint8_t>(std::clamp(tile.height, 0, MAX_HEIGHT));
+
+    uint64_t mask = uint64_t(1) << (index & 63);
+    size_t word = index >> 6;
+    for (int bit = 0; bit < FLAG_BITS; ++bit) {
+        if (tile.flags & (1u << bit)) {
+            flag_planes_[bit][word] |= mask;
+        } else {
+            flag_planes_[bit][word] &= ~mask;
+        }
+    }
+    used_flags_ |= tile.flags;
+}
+
+// ============================================================================
+// Flag Planes
+// ============================================================================
+
+bool CompactTileMap::flag(int x, int y, int bit) const {
+    if (!in_bounds(x, y) || bit < 0 || bit >= FLAG_BITS) return false;
+    size_t index = index_of(x, y);
+    return (flag_planes_[bit][index >> 6] >> (index & 63)) & 1u;
+}
+
+void CompactTileMap::set_flag(int x, int y, int bit, bool value) {
+    if (!in_bounds(x, y) || bit < 0 || bit >= FLAG_BITS) return;
+    size_t index = index_of(x, y);
+    uint64_t mask = uint64_t(1) << (index & 63);
+    if (value) {
+        flag_planes_[bit][index >> 6] |= mask;
+        used_flags_ |= static_cast<uint8_t>(1u << bit);
+    } else {
+        flag_planes_[bit][index >> 6] &= ~mask;
+    }
+}
+
+size_t CompactTileMap::count_flag(int bit) const {
+    if (bit < 0 || bit >= FLAG_BITS || ids_.empty()) return 0;
+
+    // Padding tiles are never set; the scratch slot might be
+    size_t count = 0;
+    for (uint64_t word : flag_planes_[bit]) {
+        count += static_cast<size_t>(std::popcount(word));
+    }
+    size_t scratch = scratch_index();
+    count -= (flag_planes_[bit][scratch >> 6] >> (scratch & 63)) & 1u;
+    return count;
+}
+
+void CompactTileMap::fill(const Tile& tile) {
+    if (ids_.empty()) return;
+
+    // Fill padding too: it is never visible and keeps the planes uniform
+    std::fill(ids_.begin(), ids_.end(), static_cast<uint16_t>(std::clamp(tile.tile_id, 0, MAX_TILE_ID)));
+    std::fill(heights_.begin(), heights_.end(), static_cast<uint8_t>(std::clamp(tile.height, 0, MAX_HEIGHT)));
+    size_t tail_bits = ids_.size() & 63;
+    for (int bit = 0; bit < FLAG_BITS; ++bit) {
+        uint64_t value = (tile.flags & (1u << bit)) ? ~uint64_t(0) : 0;
+        std::fill(flag_planes_[bit].begin(), flag_planes_[bit].end(), value);
+        if (tail_bits != 0) {
+            flag_planes_[bit].back() &= (uint64_t(1) << tail_bits) - 1;  // Bits past the last tile
+        }
+    }
+    used_flags_ |= tile.flags;
+
+    // Padding must not count as set flags or real tiles
+    int padded_width = static_cast<int>(chunks_x_) * CHUNK_SIZE;
+    int padded_height = static_cast<int>(chunks_y_) * CHUNK_SIZE;
+    for (int y = 0; y < padded_height; ++y) {
+        for (int x = (y < height_ ? width_ : 0); x < padded_width; ++x) {
+            store(index_of(x, y), Tile{});
+        }
+    }
+    store(scratch_index(), Tile{});
+}
+
+// ============================================================================
+// Rendering
+// ============================================================================
+
+int CompactTileMap::count_visible(const Rect& viewport) const {
+    DiagonalRange diagonals = visible_diagonals(width_, height_, viewport);
+
+    int count = 0;
+    for (int d = diagonals.first; d <= diagonals.last; ++d) {
+        DiagonalSpan span = visible_span(width_, height_, viewport, d);
+        for (int x = span.x_begin; x <= span.x_end; ++x) {
+            if (ids_[index_of(x, d - x)] != 0) {
+                ++count;
+            }
+        }
+    }
+    return count;
+}
+
+void CompactTileMap::render(Renderer* renderer, const Rect& viewport) const {
+    if (!tileset_ || !renderer) return;
+
+    renderer->begin_batch();
+
+    for_each_visible_diagonal(viewport, [&](int, int, const Tile& tile, float screen_x, float screen_y) {
+        Sprite sprite;
+        if (make_tile_sprite(*tileset_, tile, screen_x, screen_y, sprite)) {
+            renderer->draw_sprite(sprite);
+        }
+    });
+
+    renderer->end_batch();
+}
+
+size_t CompactTileMap::memory_bytes() const {
+    size_t bytes = ids_.capacity() * sizeof(uint16_t) + heights_.capacity() * sizeof(uint8_t);
+    for (const auto& plane : flag_planes_) {
+        bytes += plane.capacity() * sizeof(uint64_t);
+    }
+    return bytes;
+}
+
+} // namespace cafe
@@ -0,0 +1,240 @@
+#ifndef CAFE_COMPACT_TILE_MAP_H
+#define CAFE_COMPACT_TILE_MAP_H
+
+#include "isometric.h"
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <vector>
+
+namespace cafe {
+
+// ============================================================================
+// CompactTileMap - Bit-packed tile storage for very large maps
+// ============================================================================
+//
+// Same grid as TileMap, stored as separate planes instead of an array of
+// 12-byte Tile structs:
+//
+//   tile ids   16 bits per tile   (ids above 65535 are clamped)
+//   heights     8 bits per tile   (clamped to 0..255)
+//   flags       1 bit per tile per flag bit, one plane per bit
+//
+// That is 4 bytes per tile instead of 12 (a 4096x4096 map drops from 192 MB
+// to 64 MB). Flag planes also make bulk queries cheap, e.g. counting
+// walkable tiles is a popcount over one plane.
+//
+// Layout: the grid is split into 16x16 chunks stored row-major, and tiles
+// inside a chunk are stored in Morton (Z-order). Neighbours in any direction
+// - grid rows, columns, or the screen-space diagonals walked by the
+// isometric renderer - mostly share cache lines.
+//
+//   chunk (cx, cy) -> chunk_index = cy * chunks_x + cx
+//   tile (lx, ly)  -> morton(lx, ly) = interleave bits of lx and ly
+//   storage index  = chunk_index * 256 + morton(lx, ly)
+//
+// The Tile& style API is kept through TileRef, a proxy that reads and
+// writes the packed planes:
+//
+//   map.at(x, y).tile_id = 3;          // Works like TileMap
+//   Tile t = map.at(x, y);             // Unpack to a plain Tile
+//
+// ============================================================================
+
+class CompactTileMap {
+public:
+    static constexpr int CHUNK_SHIFT = 4;
+    static constexpr int CHUNK_SIZE = 1 << CHUNK_SHIFT;        // 16 tiles
+    static constexpr int CHUNK_TILES = CHUNK_SIZE * CHUNK_SIZE;  // 256 tiles
+    static constexpr int FLAG_BITS = 8;                        // Tile::flags is uint8_t
+    static constexpr int MAX_TILE_ID = 0xFFFF;
+    static constexpr int MAX_HEIGHT = 0xFF;
+
+    // ========================================================================
+    // TileRef - Proxy standing in for Tile&
+    // ========================================================================
+
+    class TileRef {
+    public:
+        // Field proxies so `ref.tile_id = 3` and `int id = ref.tile_id` work
+        template<int Field>
+        class FieldRef {
+        public:
+            FieldRef(CompactTileMap* map, size_t index) : map_(map), index_(index) {}
+
+            operator int() const { return map_->get_field(index_, Field); }
+            FieldRef& operator=(int value) {
+                map_->set_field(index_, Field, value);
+                return *this;
+            }
+            FieldRef& operator=(const FieldRef& other) { return *this = static_cast<int>(other); }
+            FieldRef(const FieldRef&) = default;
+
+        private:
+            CompactTileMap* map_;
+            size_t index_;
+        };
+
+        TileRef(CompactTileMap* map, size_t index)
+            : tile_id(map, index), height(map, index), flags(map, index),
+              map_(map), index_(index) {}
+        TileRef(const TileRef&) = default;
+
+        FieldRef<0> tile_id;
+        FieldRef<1> height;
+        FieldRef<2> flags;
+
+        // Unpack / pack the whole tile
+        operator Tile() const { return map_->load(index_); }
+        TileRef& operator=(const Tile& tile) {
+            map_->store(index_, tile);
+            return *this;
+        }
+        TileRef& operator=(const TileRef& other) { return *this = static_cast<Tile>(other); }
+
+        bool is_empty() const { return map_->ids_[index_] == 0; }
+
+    private:
+        CompactTileMap* map_;
+        size_t index_;
+    };
+
+    CompactTileMap() = default;
+    CompactTileMap(int width, int height);
+
+    // Copy a TileMap into compact storage
+    explicit CompactTileMap(const TileMap& map);
+
+    // Resize the map (clears existing data)
+    void resize(int width, int height);
+
+    // Dimensions
+    int width() const { return width_; }
+    int height() const { return height_; }
+
+    // Tile access
+    // Out-of-bounds access goes to a scratch slot that reads back empty
+    TileRef at(int x, int y);
+    Tile at(int x, int y) const;
+
+    // Direct field access (no proxy)
+    int tile_id(int x, int y) const { return in_bounds(x, y) ? ids_[index_of(x, y)] : 0; }
+    int tile_height(int x, int y) const { return in_bounds(x, y) ? heights_[index_of(x, y)] : 0; }
+    uint8_t tile_flags(int x, int y) const;
+
+    // Flag planes
+    bool flag(int x, int y, int bit) const;
+    void set_flag(int x, int y, int bit, bool value);
+    size_t count_flag(int bit) const;
+
+    // Raw plane for bulk queries (one bit per tile, storage order)
+    const std::vector<uint64_t>& flag_plane(int bit) const { return flag_planes_[bit]; }
+
+    // Check bounds
+    bool in_bounds(int x, int y) const {
+        return x >= 0 && x < width_ && y >= 0 && y < height_;
+    }
+
+    // Fill entire map with a tile
+    void fill(const Tile& tile);
+
+    // Set tileset (sprite sheet containing tile graphics)
+    void set_tileset(SpriteSheet* tileset) { tileset_ = tileset; }
+    SpriteSheet* tileset() const { return tileset_; }
+
+    // Render all visible tiles in diagonal order
+    void render(Renderer* renderer, const Rect& viewport) const;
+
+    // Same contract as TileMap::for_each_visible_diagonal()
+    // The Tile passed to the callback is unpacked into a temporary
+    template<typename Fn>
+    void for_each_visible_diagonal(const Rect& viewport, Fn&& callback) const;
+
+    // Number of non-empty visible tiles
+    int count_visible(const Rect& viewport) const;
+
+    // Storage index for an in-bounds tile (chunked Morton order)
+    size_t index_of(int x, int y) const {
+        size_t chunk = static_cast<size_t>(y >> CHUNK_SHIFT) * chunks_x_ + (x >> CHUNK_SHIFT);
+        return (chunk << (2 * CHUNK_SHIFT)) |
+               kMortonSpread[x & (CHUNK_SIZE - 1)] |
+               (kMortonSpread[y & (CHUNK_SIZE - 1)] << 1);
+    }
+
+    // Memory used by tile storage
+    size_t memory_bytes() const;
+
+private:
+    // Bits 0-3 spread to even positions: 0b1111 -> 0b01010101
+    static constexpr std::array<uint16_t, CHUNK_SIZE> kMortonSpread = {
+        0x00, 0x01, 0x04, 0x05, 0x10, 0x11, 0x14, 0x15,
+        0x40, 0x41, 0x44, 0x45, 0x50, 0x51, 0x54, 0x55,
+    };
+
+    int get_field(size_t index, int field) const;
+    void set_field(size_t index, int field, int value);
+    Tile load(size_t index) const;
+    void store(size_t index, const Tile& tile);
+    size_t scratch_index() const { return ids_.size() - 1; }
+
+    int width_ = 0;
+    int height_ = 0;
+    size_t chunks_x_ = 0;
+    size_t chunks_y_ = 0;
+
+    // One extra slot at the end is the out-of-bounds scratch tile
+    std::vector<uint16_t> ids_;
+    std::vector<uint8_t> heights_;
+    std::array<std::vector<uint64_t>, FLAG_BITS> flag_planes_;
+    uint8_t used_flags_ = 0;  // Planes that have ever had a bit set
+
+    SpriteSheet* tileset_ = nullptr;
+};
+
+// ============================================================================
+// CompactTileMap Inline / Template Implementation
+// ============================================================================
+
+inline Tile CompactTileMap::load(size_t index) const {
+    Tile tile;
+    tile.tile_id = ids_[index];
+    tile.height = heights_[index];
+
+    // Only visit planes that have ever been written
+    uint8_t flags = 0;
+    for (unsigned bits = used_flags_; bits != 0; bits &= bits - 1) {
+        int bit = std::countr_zero(bits);
+        uint64_t word = flag_planes_[bit][index >> 6];
+        flags |= static_cast<uint8_t>(((word >> (index & 63)) & 1u) << bit);
+    }
+    tile.flags = flags;
+    return tile;
+}
+
+template<typename Fn>
+void CompactTileMap::for_each_visible_diagonal(const Rect& viewport, Fn&& callback) const {
+    DiagonalRange diagonals = visible_diagonals(width_, height_, viewport);
+
+    const float half_width = Isometric::tile_width() * 0.5f;
+    const float half_height = Isometric::tile_height() * 0.5f;
+    const Vec2 cam = Isometric::camera();
+
+    for (int d = diagonals.first; d <= diagonals.last; ++d) {
+        DiagonalSpan span = visible_span(width_, height_, viewport, d);
+        float screen_y = static_cast<float>(d) * half_height - cam.y;
+
+        for (int x = span.x_begin; x <= span.x_end; ++x) {
+            int y = d - x;
+            size_t index = index_of(x, y);
+            if (ids_[index] == 0) continue;
+
+            Tile tile = load(index);
+            float screen_x = static_cast<float>(x - y) * half_width - cam.x;
+            callback(x, y, static_cast<const Tile&>(tile), screen_x, screen_y);
+        }
+    }
+}
+
+} // namespace cafe
+
+#endif // CAFE_COMPACT_TILE_MAP_H
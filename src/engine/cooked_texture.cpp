@@ -0,0 +1,358 @@
+#include "cooked_texture.h"
+#include "image.h"
+#include "image_ops.h"
+#include "lz4_block.h"
+#include "mip_chain.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+namespace cafe {
+
+// ============================================================================
+// Cooked Texture File Format
+// ============================================================================
+
+namespace {
+
+constexpr char kCookedMagic[4] = {'C', 'T', 'E', 'X'};
+
+// Levels start on cache-line boundaries (the mapping itself is page aligned)
+constexpr uint64_t kLevelAlignment = 64;
+
+// Largest texture a cooked file may describe (16384^2 RGBA8 = 1 GB)
+constexpr uint32_t kMaxDimension = 16384;
+
+struct CookedHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t width;
+    uint32_t height;
+    uint16_t mip_count;
+    uint8_t format;
+    uint8_t compression;
+    uint32_t reserved[3];
+};
+static_assert(sizeof(CookedHeader) == 32, "cooked texture header must be 32 bytes");
+
+struct CookedMipEntry {
+    uint64_t offset;
+    uint32_t stored_bytes;
+    uint32_t pixel_bytes;
+};
+static_assert(sizeof(CookedMipEntry) == 16, "cooked mip entry must be 16 bytes");
+
+uint64_t align_up(uint64_t value, uint64_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+int level_size(int size, int level) {
+    return std::max(1, size >> level);
+}
+
+} // namespace
+
+// ============================================================================
+// Cooking
+// ============================================================================
+
+std::string CookedTexture::cooked_path(const std::string& source_path) {
+    size_t slash = source_path.find_last_of("/\\");
+    size_t dot = source_path.find_last_of('.');
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) {
+        return source_path + EXTENSION;
+    }
+    return source_path.substr(0, dot) + EXTENSION;
+}
+
+bool CookedTexture::cook(const Image& image, const std::string& path,
+                         const CookOptions& options) {
+    if (!image.is_valid() || image.channels() != 4 ||
+        image.width() > static_cast<int>(kMaxDimension) ||
+        image.height() > static_cast<int>(kMaxDimension)) {
+        std::cerr << "CookedTexture: Need an RGBA image up to "
+                  << kMaxDimension << " pixels: " << path << "\n";
+        return false;
+    }
+
+    // Build every level in memory first
+    std::vector<std::vector<uint8_t>> levels;
+    levels.emplace_back(image.data(), image.data() + static_cast<size_t>(image.width()) * image.height() * 4);
+    if (options.premultiply) {
+        image_ops::premultiply_alpha(levels[0].data(), levels[0].size() / 4);
+    }
+
+    if (options.mipmaps) {
+        MipOptions mip_options;
+        mip_options.gamma_correct = options.gamma_correct;
+        MipChain chain;
+        chain.build(levels[0].data(), image.width(), image.height(), mip_options);
+        for (int level = 1; level < chain.count(); ++level) {
+            const uint8_t* pixels = chain.level(level);
+            levels.emplace_back(pixels, pixels + static_cast<size_t>(chain.width(level)) * chain.height(level) * 4);
+        }
+    }
+
+    // Compress levels that shrink; keep the rest raw
+    std::vector<std::vector<uint8_t>> stored(levels.size());
+    bool any_compressed = false;
+    if (options.compress) {
+        for (size_t i = 0; i < levels.size(); ++i) {
+            std::vector<uint8_t> packed(lz4::compress_bound(levels[i].size()));
+            size_t bytes = lz4::compress(levels[i].data(), levels[i].size(),
+                                         packed.data(), packed.size());
+            if (bytes > 0 && bytes < levels[i].size()) {
+                packed.resize(bytes);
+                stored[i] = std::move(packed);
+                any_compressed = true;
+            }
+        }
+    }
+
+    CookedHeader header;
+    std::memcpy(header.magic, kCookedMagic, sizeof(header.magic));
+    header.version = VERSION;
+    header.width = static_cast<uint32_t>(image.width());
+    header.height = static_cast<uint32_t>(image.height());
+    header.mip_count = static_cast<uint16_t>(levels.size());
+    header.format = static_cast<uint8_t>(options.premultiply ? CookedFormat::RGBA8Premultiplied
+                                                             : CookedFormat::RGBA8);
+    header.compression = static_cast<uint8_t>(any_compressed ? CookedCompression::LZ4
+                                                             : CookedCompression::None);
+    std::memset(header.reserved, 0, sizeof(header.reserved));
+
+    std::vector<CookedMipEntry> table(levels.size());
+    uint64_t offset = align_up(sizeof(header) + table.size() * sizeof(CookedMipEntry), kLevelAlignment);
+    for (size_t i = 0; i < levels.size(); ++i) {
+        const std::vector<uint8_t>& bytes = stored[i].empty() ? levels[i] : stored[i];
+        table[i].offset = offset;
+        table[i].stored_bytes = static_cast<uint32_t>(bytes.size());
+        table[i].pixel_bytes = static_cast<uint32_t>(levels[i].size());
+        offset = align_up(offset + bytes.size(), kLevelAlignment);
+    }
+
+    FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        std::cerr << "CookedTexture: Failed to create file: " << path << "\n";
+        return false;
+    }
+
+    static const uint8_t zeros[kLevelAlignment] = {};
+    uint64_t position = sizeof(header) + table.size() * sizeof(CookedMipEntry);
+    bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1;
+    ok = ok && std::fwrite(table.data(), sizeof(CookedMipEntry), table.size(), file) == table.size();
+
+    for (size_t i = 0; ok && i < levels.size(); ++i) {
+        size_t padding = static_cast<size_t>(table[i].offset - position);
+        ok = std::fwrite(zeros, 1, padding, file) == padding;
+
+        const std::vector<uint8_t>& bytes = stored[i].empty() ? levels[i] : stored[i];
+        ok = ok && std::fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size();
+        position = table[i].offset + bytes.size();
+    }
+    ok = (std::fclose(file) == 0) && ok;
+
+    if (!ok) {
+        std::cerr << "CookedTexture: Failed to write file: " << path << "\n";
+        std::remove(path.c_str());
+    }
+    return ok;
+}
+
+bool CookedTexture::cook_file(const std::string& source_path, const std::string& path,
+                              const CookOptions& options) {
+    auto image = Image::load_from_file(source_path);
+    if (!image) {
+        std::cerr << "CookedTexture: Failed to load image: " << source_path << "\n";
+        return false;
+    }
+    return cook(*image, path, options);
+}
+
+// ============================================================================
+// Loading
+// ============================================================================
+
+bool CookedTexture::open(const std::string& path) {
+    close();
+
+    if (!file_.open(path)) {
+        return false;
+    }
+    data_ = file_.data();
+    size_ = file_.size();
+    path_ = path;
+    return parse();
+}
+
+bool CookedTexture::open_memory(const uint8_t* data, size_t size, const std::string& name) {
+    close();
+
+    if (!data) {
+        return false;
+    }
+    data_ = data;
+    size_ = size;
+    path_ = name;
+    return parse();
+}
+
+bool CookedTexture::parse() {
+    CookedHeader header;
+    if (size_ < sizeof(header)) {
+        std::cerr << "CookedTexture: File too small: " << path_ << "\n";
+        close();
+        return false;
+    }
+    std::memcpy(&header, data_, sizeof(header));
+
+    if (std::memcmp(header.magic, kCookedMagic, sizeof(header.magic)) != 0 ||
+        header.version != VERSION) {
+        std::cerr << "CookedTexture: Not a version " << VERSION << " cooked texture: " << path_ << "\n";
+        close();
+        return false;
+    }
+    if (header.width == 0 || header.height == 0 ||
+        header.width > kMaxDimension || header.height > kMaxDimension ||
+        header.mip_count == 0 || header.mip_count > 32 ||
+        header.format > static_cast<uint8_t>(CookedFormat::RGBA8Premultiplied)) {
+        std::cerr << "CookedTexture: Corrupt header: " << path_ << "\n";
+        close();
+        return false;
+    }
+
+    size_t table_end = sizeof(header) + header.mip_count * sizeof(CookedMipEntry);
+    if (size_ < table_end) {
+        std::cerr << "CookedTexture: Truncated mip table: " << path_ << "\n";
+        close();
+        return false;
+    }
+
+    width_ = static_cast<int>(header.width);
+    height_ = static_cast<int>(header.height);
+    format_ = static_cast<CookedFormat>(header.format);
+
+    mips_.resize(header.mip_count);
+    for (int level = 0; level < header.mip_count; ++level) {
+        CookedMipEntry entry;
+        std::memcpy(&entry, data_ + sizeof(header) + level * sizeof(CookedMipEntry), sizeof(entry));
+
+        size_t expected = static_cast<size_t>(mip_width(level)) * mip_height(level) * 4;
+        if (entry.pixel_bytes != expected || entry.stored_bytes > entry.pixel_bytes ||
+            entry.offset > size_ || entry.stored_bytes > size_ - entry.offset) {
+            std::cerr << "CookedTexture: Corrupt mip " << level << ": " << path_ << "\n";
+            close();
+            return false;
+        }
+        mips_[level] = MipEntry{entry.offset, entry.stored_bytes, entry.pixel_bytes};
+    }
+
+    decompressed_.resize(mips_.size());
+    return true;
+}
+
+void CookedTexture::close() {
+    file_.close();
+    data_ = nullptr;
+    size_ = 0;
+    path_.clear();
+    width_ = 0;
+    height_ = 0;
+    format_ = CookedFormat::RGBA8;
+    mips_.clear();
+    decompressed_.clear();
+}
+
+int CookedTexture::mip_width(int level) const {
+    return level_size(width_, level);
+}
+
+int CookedTexture::mip_height(int level) const {
+    return level_size(height_, level);
+}
+
+bool CookedTexture::compressed(int level) const {
+    return level >= 0 && level < mip_count() &&
+           mips_[level].stored_bytes < mips_[level].pixel_bytes;
+}
+
+const uint8_t* CookedTexture::pixels(int level) {
+    if (level < 0 || level >= mip_count()) {
+        return nullptr;
+    }
+
+    const MipEntry& mip = mips_[level];
+    const uint8_t* stored = data_ + mip.offset;
+    if (!compressed(level)) {
+        return stored;  // Zero-copy: straight out of the mapping
+    }
+
+    std::vector<uint8_t>& buffer = decompressed_[level];
+    if (buffer.empty()) {
+        buffer.resize(mip.pixel_bytes);
+        if (!lz4::decompress(stored, mip.stored_bytes, buffer.data(), buffer.size())) {
+            std::cerr << "CookedTexture: Corrupt LZ4 data in mip " << level << ": "
+                      << path_ << "\n";
+            buffer.clear();
+            return nullptr;
+        }
+        // The compressed bytes are not needed again
+        if (file_.is_open()) {
+            file_.release(mip.offset, mip.stored_bytes);
+        }
+    }
+    return buffer.data();
+}
+
+void CookedTexture::prefault(int level) {
+    if (level < 0 || level >= mip_count()) {
+        return;
+    }
+    if (compressed(level)) {
+        pixels(level);  // Decompressing reads every page anyway
+        return;
+    }
+
+    const MipEntry& mip = mips_[level];
+    if (file_.is_open()) {
+        file_.will_need(mip.offset, mip.stored_bytes);
+    }
+
+    const volatile uint8_t* bytes = data_ + mip.offset;
+    uint8_t sum = 0;
+    for (size_t i = 0; i < mip.stored_bytes; i += 4096) {
+        sum = static_cast<uint8_t>(sum + bytes[i]);
+    }
+    (void)sum;
+}
+
+TextureHandle CookedTexture::create_texture(Renderer* renderer, TextureFilter filter,
+                                            bool mipmaps, MipFilter mip_filter) {
+    if (!renderer || !is_open()) {
+        return INVALID_TEXTURE;
+    }
+
+    int count = mipmaps ? mip_count() : 1;
+    std::vector<const uint8_t*> levels(static_cast<size_t>(count));
+    for (int level = 0; level < count; ++level) {
+        levels[level] = pixels(level);
+        if (!levels[level]) {
+            return INVALID_TEXTURE;
+        }
+    }
+
+    TextureInfo info;
+    info.width = width_;
+    info.height = height_;
+    info.filter = filter;
+    info.wrap = TextureWrap::Clamp;
+    info.mip_count = count;
+    info.mip_filter = mip_filter;
+    if (count == 1) {
+        return renderer->create_texture(levels[0], info);
+    }
+    return renderer->create_texture_mipmapped(levels.data(), info);
+}
+
+} // namespace cafe
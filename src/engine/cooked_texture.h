@@ -0,0 +1,159 @@
+#ifndef CAFE_COOKED_TEXTURE_H
+#define CAFE_COOKED_TEXTURE_H
+
+#include "../renderer/renderer.h"
+#include "mapped_file.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace cafe {
+
+class Image;
+
+// ============================================================================
+// CookedTexture - GPU-ready texture container (.ctex)
+// ============================================================================
+//
+// A PNG has to be inflated and unfiltered every time it is loaded. A
+// cooked texture is the result of doing that once, offline: the RGBA8
+// pixels exactly as create_texture() wants them, plus the mip chain.
+//
+// File layout (little-endian):
+//
+//   Header      magic "CTEX", version, width, height, mip count,
+//               pixel format, compression
+//   Mip table   one entry per level: byte offset, stored size, pixel size
+//   Payload     one block per level, 64-byte aligned. A level is either
+//               raw RGBA8 (stored size == pixel size) or one LZ4 block
+//
+// Loading maps the file (MappedFile) and, for raw levels, hands the
+// renderer a pointer straight into the mapping: no decode, no copy. LZ4
+// levels are decompressed once into a buffer on first access - still far
+// cheaper than inflate, and the files are smaller on disk.
+//
+// Cook offline with cafe_cook (tools/cook_textures.cpp) or cook()/cook_file().
+// ResourceManager picks up "name.ctex" next to "name.png" automatically.
+//
+// Usage:
+//   CookedTexture::cook_file("assets/floor.png", "assets/floor.ctex");
+//
+//   CookedTexture texture;
+//   if (texture.open("assets/floor.ctex")) {
+//       TextureHandle handle = texture.create_texture(renderer);
+//   }
+//
+// ============================================================================
+
+enum class CookedFormat : uint8_t {
+    RGBA8 = 0,               // Straight alpha (what the renderers blend)
+    RGBA8Premultiplied = 1   // Color already multiplied by alpha
+};
+
+enum class CookedCompression : uint8_t {
+    None = 0,
+    LZ4 = 1
+};
+
+struct CookOptions {
+    bool mipmaps = true;      // Store the full chain down to 1x1
+    bool gamma_correct = true; // Build mips in linear light (see MipChain)
+    bool premultiply = false; // Premultiply alpha at cook time
+    bool compress = false;    // LZ4 each level (kept raw if it does not shrink)
+};
+
+class CookedTexture {
+public:
+    static constexpr uint32_t VERSION = 1;
+    static constexpr const char* EXTENSION = ".ctex";
+
+    CookedTexture() = default;
+
+    // Non-copyable, movable
+    CookedTexture(const CookedTexture&) = delete;
+    CookedTexture& operator=(const CookedTexture&) = delete;
+    CookedTexture(CookedTexture&&) = default;
+    CookedTexture& operator=(CookedTexture&&) = default;
+
+    // ========================================================================
+    // Cooking (offline)
+    // ========================================================================
+
+    // Write an RGBA image as a cooked texture
+    static bool cook(const Image& image, const std::string& path,
+                     const CookOptions& options = CookOptions());
+
+    // Decode a source image (PNG, ...) and cook it
+    static bool cook_file(const std::string& source_path, const std::string& path,
+                          const CookOptions& options = CookOptions());
+
+    // "assets/floor.png" -> "assets/floor.ctex"
+    static std::string cooked_path(const std::string& source_path);
+
+    // ========================================================================
+    // Loading
+    // ========================================================================
+
+    bool open(const std::string& path);
+
+    // Read from bytes already in memory (e.g. an AssetArchive entry)
+    // The bytes must stay valid until close(); `name` is for messages
+    bool open_memory(const uint8_t* data, size_t size, const std::string& name);
+
+    void close();
+
+    bool is_open() const { return data_ != nullptr; }
+    const std::string& path() const { return path_; }
+
+    int width() const { return width_; }
+    int height() const { return height_; }
+    int mip_count() const { return static_cast<int>(mips_.size()); }
+    int mip_width(int level) const;
+    int mip_height(int level) const;
+
+    CookedFormat format() const { return format_; }
+    bool premultiplied() const { return format_ == CookedFormat::RGBA8Premultiplied; }
+    bool compressed(int level) const;
+
+    // RGBA8 pixels of a mip level (nullptr if corrupt)
+    // Raw levels point into the mapping; LZ4 levels decompress on first call
+    const uint8_t* pixels(int level = 0);
+
+    // Touch every page of a level so create_texture() does not stall on
+    // disk reads (call from a loader thread)
+    void prefault(int level = 0);
+
+    // Create a renderer texture from level 0, plus the stored mip chain
+    // when `mipmaps` is set
+    TextureHandle create_texture(Renderer* renderer,
+                                 TextureFilter filter = TextureFilter::Nearest,
+                                 bool mipmaps = false,
+                                 MipFilter mip_filter = MipFilter::Nearest);
+
+    // Bytes of the cooked file
+    size_t file_size() const { return size_; }
+
+private:
+    struct MipEntry {
+        uint64_t offset = 0;
+        uint32_t stored_bytes = 0;
+        uint32_t pixel_bytes = 0;
+    };
+
+    // Validate the header and mip table of data_
+    bool parse();
+
+    MappedFile file_;                 // Only when opened from a file
+    const uint8_t* data_ = nullptr;   // Whole cooked file
+    size_t size_ = 0;
+    std::string path_;
+    int width_ = 0;
+    int height_ = 0;
+    CookedFormat format_ = CookedFormat::RGBA8;
+    std::vector<MipEntry> mips_;
+    std::vector<std::vector<uint8_t>> decompressed_;  // Per level, LZ4 only
+};
+
+} // namespace cafe
+
+#endif // CAFE_COOKED_TEXTURE_H
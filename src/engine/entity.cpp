@@ -11,18 +11,30 @@ void Animator::play(const std::string& animation, bool force) {
     if (!force && playing_ && current_anim_ == animation) {
         return;
     }
-    current_anim_ = animation;
+    if (current_anim_ != animation) {
+        current_anim_ = animation;
+        anim_ = nullptr;
+    }
     elapsed_ = 0.0f;
     playing_ = true;
 }
 
+const Animation* Animator::current() const {
+    if (!sheet_ || current_anim_.empty()) return nullptr;
+    if (anim_revision_ != sheet_->animation_revision() || !anim_) {
+        anim_ = sheet_->animation(current_anim_);
+        anim_revision_ = sheet_->animation_revision();
+    }
+    return anim_;
+}
+
 void Animator::update(float dt) {
     if (!playing_ || !sheet_) return;
 
     elapsed_ += dt * speed;
 
     // Check if non-looping animation finished
-    const Animation* anim = sheet_->animation(current_anim_);
+    const Animation* anim = current();
     if (anim && !anim->looping) {
         if (elapsed_ >= anim->total_duration()) {
             playing_ = false;
@@ -33,13 +45,14 @@ void Animator::update(float dt) {
 void Animator::stop() {
     playing_ = false;
     current_anim_.clear();
+    anim_ = nullptr;
     elapsed_ = 0.0f;
 }
 
 bool Animator::is_finished() const {
     if (!sheet_) return true;
 
-    const Animation* anim = sheet_->animation(current_anim_);
+    const Animation* anim = current();
     if (!anim) return true;
     if (anim->looping) return false;
 
@@ -48,7 +61,12 @@ bool Animator::is_finished() const {
 
 TextureRegion Animator::current_region() const {
     if (!sheet_) return TextureRegion();
-    return sheet_->animation_frame(current_anim_, elapsed_);
+    const Animation* anim = current();
+    if (anim) {
+        return sheet_->animation_frame(*anim, elapsed_);
+    }
+    const SpriteFrame* f = sheet_->frame(0);
+    return f ? f->region : TextureRegion(sheet_->texture());
 }
 
 // ============================================================================
@@ -69,6 +87,44 @@ Rect BoxCollider::get_bounds() const {
     );
 }
 
+// ============================================================================
+// AudioEmitter Implementation
+// ============================================================================
+
+Vec2 AudioEmitter::position() const {
+    const Transform* transform = owner_ ? owner_->transform() : nullptr;
+    return transform ? transform->position + offset : offset;
+}
+
+ChannelHandle AudioEmitter::play(AudioSystem& audio, SoundHandle sound, const AudioSystem::PlayOptions& options) {
+    Vec2 at = position();
+    ChannelHandle channel = audio.play_sound_at(sound, at.x, at.y, options);
+    if (channel != INVALID_CHANNEL) {
+        channels_.push_back(channel);
+    }
+    return channel;
+}
+
+void AudioEmitter::stop_all(AudioSystem& audio) {
+    for (ChannelHandle channel : channels_) {
+        audio.stop_channel(channel);
+    }
+    channels_.clear();
+}
+
+void AudioEmitter::update(AudioSystem& audio) {
+    Vec2 at = position();
+    for (size_t i = 0; i < channels_.size();) {
+        if (!audio.is_channel_playing(channels_[i])) {
+            channels_[i] = channels_.back();
+            channels_.pop_back();
+            continue;
+        }
+        audio.set_channel_position(channels_[i], at.x, at.y);
+        ++i;
+    }
+}
+
 // ============================================================================
 // Entity Implementation
 // ============================================================================
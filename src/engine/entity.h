@@ -2,6 +2,7 @@
 #define CAFE_ENTITY_H
 
 #include "../renderer/renderer.h"
+#include "../audio/audio.h"
 #include <string>
 #include <vector>
 #include <unordered_map>
@@ -14,6 +15,7 @@ namespace cafe {
 // Forward declarations
 class Entity;
 class EntityManager;
+struct Animation;
 
 // ============================================================================
 // Entity ID
@@ -79,7 +81,7 @@ struct SpriteRenderer : public Component {
 // Animator - Plays sprite animations
 class Animator : public Component {
 public:
-    void set_sprite_sheet(class SpriteSheet* sheet) { sheet_ = sheet; }
+    void set_sprite_sheet(class SpriteSheet* sheet) { sheet_ = sheet; anim_ = nullptr; }
     void play(const std::string& animation, bool force = false);
     void update(float dt);
     void pause() { playing_ = false; }
@@ -94,8 +96,13 @@ public:
     float speed = 1.0f;
 
 private:
+    // Resolve current_anim_ (cached until the sheet's animations change)
+    const Animation* current() const;
+
     class SpriteSheet* sheet_ = nullptr;
     std::string current_anim_;
+    mutable const Animation* anim_ = nullptr;
+    mutable uint32_t anim_revision_ = 0;
     float elapsed_ = 0.0f;
     bool playing_ = false;
 };
@@ -110,6 +117,29 @@ struct BoxCollider : public Component {
     Rect get_bounds() const;
 };
 
+// AudioEmitter - Positional sounds that follow the entity
+// Sounds play at the Transform position (plus offset) and are moved with
+// it by Scene::update_audio_emitters(). Loops outlive the entity unless
+// stopped, so call stop_all() before destroying it.
+class AudioEmitter : public Component {
+public:
+    ChannelHandle play(AudioSystem& audio, SoundHandle sound,
+                       const AudioSystem::PlayOptions& options = AudioSystem::PlayOptions());
+    void stop_all(AudioSystem& audio);
+
+    // Move playing sounds to the entity, forget finished ones
+    void update(AudioSystem& audio);
+
+    const std::vector<ChannelHandle>& channels() const { return channels_; }
+
+    Vec2 offset = {0, 0};
+
+private:
+    Vec2 position() const;
+
+    std::vector<ChannelHandle> channels_;
+};
+
 // Tag - Simple string tag for identification
 struct Tag : public Component {
     std::string value;
@@ -312,7 +342,7 @@ template<typename T>
 std::vector<Entity*> EntityManager::find_entities_with() {
     std::vector<Entity*> result;
     for (auto& [id, entity] : entities_) {
-        if (entity->has_component<T>()) {
+        if (entity->template has_component<T>()) {
             result.push_back(entity.get());
         }
     }
@@ -323,7 +353,7 @@ template<typename T>
 void EntityManager::for_each(const std::function<void(Entity*, T*)>& callback) {
     for (auto& [id, entity] : entities_) {
         if (entity->is_active()) {
-            T* component = entity->get_component<T>();
+            T* component = entity->template get_component<T>();
             if (component && component->is_enabled()) {
                 callback(entity.get(), component);
             }
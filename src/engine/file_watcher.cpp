@@ -0,0 +1,275 @@
+#include "file_watcher.h"
+#include <algorithm>
+#include <iostream>
+
+#if defined(__linux__)
+#define CAFE_FILE_WATCHER_INOTIFY 1
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace cafe {
+
+namespace {
+
+#if defined(CAFE_FILE_WATCHER_INOTIFY)
+// Editors save by writing in place or by renaming a new file over the old
+constexpr uint32_t kWatchEvents = IN_CLOSE_WRITE | IN_MODIFY | IN_MOVED_TO | IN_CREATE;
+#endif
+
+std::filesystem::file_time_type modification_time(const std::string& path) {
+    std::error_code error;
+    auto time = std::filesystem::last_write_time(path, error);
+    return error ? std::filesystem::file_time_type::min() : time;
+}
+
+} // namespace
+
+FileWatcher::~FileWatcher() {
+    stop();
+}
+
+const char* FileWatcher::backend_name() {
+#if defined(CAFE_FILE_WATCHER_INOTIFY)
+    return "inotify";
+#else
+    return "polling";
+#endif
+}
+
+std::string FileWatcher::normalize(const std::string& path) {
+    std::error_code error;
+    std::filesystem::path absolute = std::filesystem::absolute(path, error);
+    return (error ? std::filesystem::path(path) : absolute).lexically_normal().string();
+}
+
+std::string FileWatcher::parent_directory(const std::string& path) {
+    return std::filesystem::path(path).parent_path().string();
+}
+
+// ============================================================================
+// Start / Stop
+// ============================================================================
+
+bool FileWatcher::start(int debounce_ms) {
+    if (is_running()) {
+        return true;
+    }
+    debounce_ = std::chrono::milliseconds(std::max(0, debounce_ms));
+    stop_ = false;
+
+#if defined(CAFE_FILE_WATCHER_INOTIFY)
+    inotify_fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotify_fd_ < 0 || pipe(wake_pipe_) != 0) {
+        std::cerr << "FileWatcher: Failed to initialize inotify\n";
+        stop();
+        return false;
+    }
+
+    // Files watched before start()
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& [key, path] : watched_) {
+        std::string directory = parent_directory(key);
+        if (directory_watches_.count(directory) == 0) {
+            int wd = inotify_add_watch(inotify_fd_, directory.c_str(), kWatchEvents);
+            if (wd >= 0) {
+                directory_watches_[directory] = wd;
+                watch_directories_[wd] = directory;
+            }
+        }
+    }
+#endif
+
+    thread_ = std::thread([this] { run(); });
+    return true;
+}
+
+void FileWatcher::stop() {
+    if (thread_.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        wake_.notify_all();
+#if defined(CAFE_FILE_WATCHER_INOTIFY)
+        char byte = 0;
+        [[maybe_unused]] ssize_t written = write(wake_pipe_[1], &byte, 1);
+#endif
+        thread_.join();
+    }
+
+#if defined(CAFE_FILE_WATCHER_INOTIFY)
+    auto close_fd = [](int& fd) {
+        if (fd >= 0) {
+            close(fd);
+            fd = -1;
+        }
+    };
+    close_fd(inotify_fd_);
+    close_fd(wake_pipe_[0]);
+    close_fd(wake_pipe_[1]);
+#endif
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    directory_watches_.clear();
+    watch_directories_.clear();
+    pending_.clear();
+}
+
+// ============================================================================
+// Watch List
+// ============================================================================
+
+void FileWatcher::watch(const std::string& path) {
+    std::string key = normalize(path);
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!watched_.emplace(key, path).second) {
+        return;
+    }
+    mtimes_[key] = modification_time(key);
+
+#if defined(CAFE_FILE_WATCHER_INOTIFY)
+    std::string directory = parent_directory(key);
+    if (inotify_fd_ >= 0 && directory_watches_.count(directory) == 0) {
+        int wd = inotify_add_watch(inotify_fd_, directory.c_str(), kWatchEvents);
+        if (wd < 0) {
+            std::cerr << "FileWatcher: Cannot watch directory: " << directory << "\n";
+            return;
+        }
+        directory_watches_[directory] = wd;
+        watch_directories_[wd] = directory;
+    }
+#endif
+}
+
+void FileWatcher::unwatch(const std::string& path) {
+    std::string key = normalize(path);
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = watched_.find(key);
+    if (it == watched_.end()) {
+        return;
+    }
+    pending_.erase(it->second);
+    watched_.erase(it);
+    mtimes_.erase(key);
+
+#if defined(CAFE_FILE_WATCHER_INOTIFY)
+    // Drop the directory watch once none of its files are watched
+    std::string directory = parent_directory(key);
+    bool in_use = std::any_of(watched_.begin(), watched_.end(), [&](const auto& entry) {
+        return parent_directory(entry.first) == directory;
+    });
+    auto watch = directory_watches_.find(directory);
+    if (!in_use && watch != directory_watches_.end()) {
+        inotify_rm_watch(inotify_fd_, watch->second);
+        watch_directories_.erase(watch->second);
+        directory_watches_.erase(watch);
+    }
+#endif
+}
+
+size_t FileWatcher::watched_count() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return watched_.size();
+}
+
+std::vector<FileWatcher::Change> FileWatcher::poll() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<Change> changes;
+    changes.swap(ready_);
+    return changes;
+}
+
+// ============================================================================
+// Watch Thread
+// ============================================================================
+
+void FileWatcher::note_change(const std::string& path, Clock::time_point now) {
+    auto [it, inserted] = pending_.try_emplace(path);
+    if (inserted) {
+        it->second.first_seen = now;
+    }
+    it->second.last_event = now;
+}
+
+int FileWatcher::flush_settled(Clock::time_point now) {
+    auto next = Clock::duration::max();
+    for (auto it = pending_.begin(); it != pending_.end();) {
+        auto settles_at = it->second.last_event + debounce_;
+        if (settles_at <= now) {
+            ready_.push_back(Change{it->first, it->second.first_seen});
+            it = pending_.erase(it);
+        } else {
+            next = std::min(next, settles_at - now);
+            ++it;
+        }
+    }
+    std::sort(ready_.begin(), ready_.end(), [](const Change& a, const Change& b) {
+        return a.first_seen < b.first_seen;
+    });
+    if (next == Clock::duration::max()) {
+        return -1;
+    }
+    // Round up so the wait does not end just before the change settles
+    return static_cast<int>(std::chrono::ceil<std::chrono::milliseconds>(next).count());
+}
+
+#if defined(CAFE_FILE_WATCHER_INOTIFY)
+
+void FileWatcher::run() {
+    alignas(inotify_event) char buffer[16 * 1024];
+    int timeout_ms = -1;
+
+    while (true) {
+        pollfd fds[2] = {{inotify_fd_, POLLIN, 0}, {wake_pipe_[0], POLLIN, 0}};
+        ::poll(fds, 2, timeout_ms);
+        if (fds[1].revents & POLLIN) {
+            return;  // stop()
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto now = Clock::now();
+        ssize_t bytes;
+        while ((bytes = read(inotify_fd_, buffer, sizeof(buffer))) > 0) {
+            for (char* p = buffer; p < buffer + bytes;) {
+                auto* event = reinterpret_cast<inotify_event*>(p);
+                p += sizeof(inotify_event) + event->len;
+
+                auto directory = watch_directories_.find(event->wd);
+                if (event->len == 0 || directory == watch_directories_.end()) {
+                    continue;
+                }
+                auto file = watched_.find(directory->second + "/" + event->name);
+                if (file != watched_.end()) {
+                    note_change(file->second, now);
+                }
+            }
+        }
+        timeout_ms = flush_settled(now);
+    }
+}
+
+#else
+
+void FileWatcher::run() {
+    constexpr auto kPollInterval = std::chrono::milliseconds(50);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stop_) {
+        auto now = Clock::now();
+        for (auto& [key, time] : mtimes_) {
+            auto current = modification_time(key);
+            if (current != time) {
+                time = current;
+                note_change(watched_[key], now);
+            }
+        }
+        flush_settled(now);
+        wake_.wait_for(lock, kPollInterval, [this] { return stop_; });
+    }
+}
+
+#endif
+
+} // namespace cafe
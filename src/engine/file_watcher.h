@@ -0,0 +1,119 @@
+#ifndef CAFE_FILE_WATCHER_H
+#define CAFE_FILE_WATCHER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace cafe {
+
+// ============================================================================
+// FileWatcher - Notices when watched files change on disk (development)
+// ============================================================================
+//
+// A background thread waits for changes and reports each changed file
+// once it has been quiet for the debounce time. Saving a PNG is rarely a
+// single write: editors truncate, write in chunks, or write a temporary
+// file and rename it over the original. Without the debounce the game
+// would reload a half-written file, then reload it again. Changes to the
+// same file inside the window are coalesced into one.
+//
+// Backends:
+//   Linux    inotify on each watched file's directory (so rename-over
+//            saves, which replace the file, are still seen). The thread
+//            sleeps until the kernel reports an event.
+//   Others   polls every watched file's modification time every 50 ms.
+//
+// Usage:
+//   FileWatcher watcher;
+//   watcher.start();
+//   watcher.watch("assets/sprites/barista.png");
+//
+//   // Each frame
+//   for (const FileWatcher::Change& change : watcher.poll()) {
+//       reload(change.path);
+//   }
+//
+// ============================================================================
+
+class FileWatcher {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr int DEFAULT_DEBOUNCE_MS = 30;
+
+    struct Change {
+        std::string path;               // As passed to watch()
+        Clock::time_point first_seen;   // First event of the burst
+    };
+
+    FileWatcher() = default;
+    ~FileWatcher();
+
+    // Non-copyable, non-movable (the thread holds `this`)
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+    // Start the watch thread. Returns false if the OS facility failed.
+    bool start(int debounce_ms = DEFAULT_DEBOUNCE_MS);
+    void stop();
+    bool is_running() const { return thread_.joinable(); }
+
+    // Watch a file (it need not exist yet). Thread-safe.
+    void watch(const std::string& path);
+    void unwatch(const std::string& path);
+    size_t watched_count() const;
+
+    // Changed files that have settled, each once, oldest first. Thread-safe.
+    std::vector<Change> poll();
+
+    // "inotify" or "polling"
+    static const char* backend_name();
+
+private:
+    struct Pending {
+        Clock::time_point first_seen;
+        Clock::time_point last_event;
+    };
+
+    void run();
+
+    // Called on the watch thread, mutex_ held
+    void note_change(const std::string& path, Clock::time_point now);
+    // Move pending changes quiet for the debounce time to ready_; returns
+    // how long until the next one settles (or -1 if none are pending)
+    int flush_settled(Clock::time_point now);
+
+    // Absolute, normalized form used as the key
+    static std::string normalize(const std::string& path);
+    static std::string parent_directory(const std::string& path);
+
+    std::thread thread_;
+    std::chrono::milliseconds debounce_{DEFAULT_DEBOUNCE_MS};
+
+    mutable std::mutex mutex_;
+    std::condition_variable wake_;      // Polling backend: stop requested
+    bool stop_ = false;
+
+    std::unordered_map<std::string, std::string> watched_;   // normalized -> caller's path
+    std::unordered_map<std::string, Pending> pending_;       // By caller's path
+    std::vector<Change> ready_;
+
+    // inotify: one watch per directory, shared by its files
+    int inotify_fd_ = -1;
+    int wake_pipe_[2] = {-1, -1};
+    std::unordered_map<std::string, int> directory_watches_;   // Directory -> wd
+    std::unordered_map<int, std::string> watch_directories_;   // wd -> directory
+
+    // Polling: last seen modification time (min() = missing)
+    std::unordered_map<std::string, std::filesystem::file_time_type> mtimes_;
+};
+
+} // namespace cafe
+
+#endif // CAFE_FILE_WATCHER_H
@@ -0,0 +1,126 @@
+#include "frame_pacer.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <thread>
+
+namespace cafe {
+
+namespace {
+
+// Bounds for the spin margin: below this the spin is noise, above it the
+// sleep is not worth calling (Windows' default 15.6 ms tick hits it)
+constexpr double kMinMargin = 0.00005;
+constexpr double kMaxMargin = 0.02;
+
+// Share of the smoothing backlog paid back per frame
+constexpr double kDebtPayback = 0.1;
+
+// Frame times this close to a whole number of refreshes are snapped
+constexpr double kSnapTolerance = 0.05;
+
+} // namespace
+
+FramePacer::FramePacer() {
+    reset();
+}
+
+double FramePacer::now() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void FramePacer::set_rate(double hz) {
+    period_ = hz > 0.0 ? 1.0 / hz : 0.0;
+    reset();
+}
+
+void FramePacer::set_vsync(bool vsync, double hz) {
+    vsync_ = vsync;
+    if (hz > 0.0) {
+        refresh_period_ = 1.0 / hz;
+    }
+}
+
+void FramePacer::calibrate() {
+    // The worst of a few 1 ms sleeps is how late a wakeup can be
+    double worst = 0.0;
+    for (int i = 0; i < 10; ++i) {
+        double start = now();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        worst = std::max(worst, now() - start - 0.001);
+    }
+    margin_ = std::clamp(worst, kMinMargin, kMaxMargin);
+}
+
+void FramePacer::reset() {
+    origin_ = now();
+    slot_ = 1;
+    smoothed_dt_ = 0.0;
+    debt_ = 0.0;
+}
+
+double FramePacer::wait() {
+    if (period_ <= 0.0 || vsync_) {
+        return 0.0;
+    }
+
+    double start = now();
+    double deadline = origin_ + static_cast<double>(slot_) * period_;
+    if (start >= deadline) {
+        // Missed: restart the grid here rather than rush frames to catch up
+        ++missed_;
+        origin_ = start;
+        slot_ = 1;
+        return 0.0;
+    }
+
+    // Sleep most of the way, then learn from how late the wakeup was
+    double wake_at = spin_ ? deadline - margin_ : deadline;
+    if (wake_at > start) {
+        std::this_thread::sleep_for(std::chrono::duration<double>(wake_at - start));
+        double overshoot = now() - wake_at;
+        if (overshoot > margin_) {
+            margin_ = overshoot;
+        } else {
+            margin_ += (overshoot - margin_) * 0.02;
+        }
+        margin_ = std::clamp(margin_, kMinMargin, kMaxMargin);
+    }
+
+    // Spin the last stretch
+    if (spin_) {
+        while (now() < deadline) {
+            std::this_thread::yield();
+        }
+    }
+
+    ++slot_;
+    return now() - start;
+}
+
+double FramePacer::smooth(double frame_dt) {
+    if (smoothing_ >= 1.0) {
+        return frame_dt;
+    }
+
+    // With vsync, timer noise around whole refreshes is not real motion
+    double sample = frame_dt;
+    if (vsync_) {
+        double refreshes = std::round(frame_dt / refresh_period_);
+        if (refreshes >= 1.0 &&
+            std::abs(frame_dt - refreshes * refresh_period_) < kSnapTolerance * refresh_period_) {
+            sample = refreshes * refresh_period_;
+        }
+    }
+
+    smoothed_dt_ = smoothed_dt_ > 0.0 ? smoothed_dt_ + smoothing_ * (sample - smoothed_dt_) : sample;
+
+    // Hand out the filtered time plus a share of what is still owed
+    debt_ += frame_dt;
+    double dt = smoothed_dt_ + (debt_ - smoothed_dt_) * kDebtPayback;
+    dt = std::clamp(dt, 0.0, debt_ > 0.0 ? debt_ : 0.0);
+    debt_ -= dt;
+    return dt;
+}
+
+} // namespace cafe
@@ -0,0 +1,93 @@
+#ifndef CAFE_FRAME_PACER_H
+#define CAFE_FRAME_PACER_H
+
+#include <cstdint>
+
+namespace cafe {
+
+// ============================================================================
+// FramePacer - Sleep until the next frame deadline, precisely
+// ============================================================================
+//
+// Without pacing, a loop with no vsync renders as fast as it can: a full
+// core burnt to draw frames nobody sees. Sleeping the rest of the frame
+// fixes that, but an OS sleep wakes late - by ~0.1 ms on Linux, ~1 ms on
+// macOS, up to a 15.6 ms tick on Windows - and the late wakeups become
+// frame-time jitter. So wait() is a hybrid:
+//
+//   |----------- sleep -----------|-- spin --|
+//   now                  deadline - margin   deadline
+//
+// The margin is how late this machine's sleeps wake. calibrate() measures
+// it at startup (a few short sleeps), and every wait() measures again:
+// a late wakeup raises the margin at once, early ones lower it slowly.
+//
+// Deadlines sit on a fixed grid (origin + n * period), like vsync slots,
+// so small errors do not accumulate. A frame that misses its deadline
+// restarts the grid from there instead of rushing frames to catch up.
+//
+// With vsync on, the present call already blocks until the next refresh:
+// wait() does not sleep, and smooth() snaps frame times that are within
+// a few percent of a whole number of refreshes to exactly that (timer
+// noise otherwise shows up as stutter in animation).
+//
+// smooth() low-pass filters frame_dt. What the filter holds back is paid
+// out in later frames, so the simulation clock does not drift from real
+// time.
+//
+// ============================================================================
+
+class FramePacer {
+public:
+    FramePacer();
+
+    // Target frames per second (0 = unpaced: wait() returns at once)
+    void set_rate(double hz);
+    double rate() const { return period_ > 0.0 ? 1.0 / period_ : 0.0; }
+    bool is_enabled() const { return period_ > 0.0 || vsync_; }
+
+    // Presenting blocks on vsync at `hz` (the display refresh rate)
+    void set_vsync(bool vsync, double hz = 60.0);
+
+    // Low-pass factor for smooth(): 1 = off, 0.1 = heavy smoothing
+    void set_smoothing(double factor) { smoothing_ = factor; }
+
+    // Sleep only, no spin (to compare; costs precision)
+    void set_spin(bool spin) { spin_ = spin; }
+
+    // Measure how late sleeps wake on this machine (~20 ms)
+    void calibrate();
+
+    // Start the deadline grid at the current time
+    void reset();
+
+    // Block until the next deadline; returns the seconds spent waiting
+    double wait();
+
+    // Filtered frame time for the simulation clock
+    double smooth(double frame_dt);
+
+    double spin_margin() const { return margin_; }
+    uint64_t missed_deadlines() const { return missed_; }
+
+    static double now();                // Steady clock seconds
+
+private:
+    double period_ = 0.0;               // Seconds per frame (0 = unpaced)
+    double refresh_period_ = 1.0 / 60.0;
+    bool vsync_ = false;
+    bool spin_ = true;
+    double smoothing_ = 0.2;
+
+    double origin_ = 0.0;
+    uint64_t slot_ = 0;                 // Next deadline = origin_ + slot_ * period_
+    double margin_ = 0.002;             // Expected sleep overshoot
+    uint64_t missed_ = 0;
+
+    double smoothed_dt_ = 0.0;
+    double debt_ = 0.0;                 // Real time not yet given to smooth()
+};
+
+} // namespace cafe
+
+#endif // CAFE_FRAME_PACER_H
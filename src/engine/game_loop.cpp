@@ -1,8 +1,22 @@
 #include "game_loop.h"
+#include "input_recorder.h"
+#include "profiler.h"
+#include "snapshot_buffer.h"
 #include "../platform/platform.h"
+#include <chrono>
+#include <thread>
 
 namespace cafe {
 
+namespace {
+
+// Durations and latency (the platform clock schedules the simulation)
+double seconds_now() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
 GameLoop::GameLoop(Platform* platform, Window* window)
     : platform_(platform)
     , window_(window)
@@ -21,6 +35,30 @@ void GameLoop::set_max_frame_skip(int frames) {
     }
 }
 
+void GameLoop::set_lockstep(bool lockstep) {
+    lockstep_ = lockstep;
+}
+
+void GameLoop::set_input_recorder(InputRecorder* recorder) {
+    recorder_ = recorder;
+}
+
+void GameLoop::set_threaded(bool threaded) {
+    threaded_ = threaded;
+}
+
+void GameLoop::set_render_rate(double hz) {
+    pacer_.set_rate(hz);
+}
+
+void GameLoop::set_vsync(bool vsync, double refresh_hz) {
+    pacer_.set_vsync(vsync, refresh_hz);
+}
+
+void GameLoop::set_snapshot_buffer(SnapshotBufferBase* snapshots) {
+    snapshots_ = snapshots;
+}
+
 void GameLoop::set_update_callback(UpdateCallback callback) {
     update_callback_ = std::move(callback);
 }
@@ -33,29 +71,58 @@ void GameLoop::set_frame_callback(FrameCallback callback) {
     frame_callback_ = std::move(callback);
 }
 
+void GameLoop::set_timing_callback(TimingCallback callback) {
+    timing_callback_ = std::move(callback);
+}
+
 void GameLoop::run() {
+    if (threaded_ && !lockstep_) {
+        run_threaded();
+        return;
+    }
+
     running_ = true;
+    steps_ = 0;
+    fps_timer_ = 0.0;
+    frame_count_ = 0;
+    last_frame_start_ = 0.0;
+    if (pacer_.is_enabled() && !lockstep_) {
+        if (!pacer_calibrated_) {
+            pacer_.calibrate();
+            pacer_calibrated_ = true;
+        }
+        pacer_.reset();
+    }
+    last_step_published_ = seconds_now();
 
-    double previous_time = platform_->get_time();
+    double previous_time = lockstep_ ? 0.0 : platform_->get_time();
     double accumulator = 0.0;
 
-    // FPS tracking
-    double fps_timer = 0.0;
-    int frame_count = 0;
-
     while (running_ && window_->is_open()) {
+        CAFE_PROFILE_FRAME();
+
         // Poll platform events
-        platform_->poll_events();
+        if (platform_) {
+            CAFE_PROFILE_SCOPE("GameLoop::poll_events");
+            platform_->poll_events();
+        }
 
         // Check if window was closed during event processing
         if (!window_->is_open()) {
             break;
         }
 
-        // Calculate frame time
-        double current_time = platform_->get_time();
-        double frame_dt = current_time - previous_time;
-        previous_time = current_time;
+        // Calculate frame time (lockstep: exactly one step of simulated time)
+        double frame_start = seconds_now();
+        double frame_dt = fixed_dt_;
+        if (!lockstep_) {
+            double current_time = platform_->get_time();
+            frame_dt = current_time - previous_time;
+            previous_time = current_time;
+            if (pacer_.is_enabled()) {
+                frame_dt = pacer_.smooth(frame_dt);
+            }
+        }
 
         // Clamp frame time to avoid spiral of death
         // (e.g., if debugger pauses execution)
@@ -67,39 +134,227 @@ void GameLoop::run() {
         accumulator += frame_dt;
 
         // Fixed timestep updates
+        timing_ = LoopTiming();
+        int64_t busy_before = sim_busy_ns_.load();
         int updates = 0;
         while (accumulator >= fixed_dt_ && updates < max_frame_skip_) {
-            if (update_callback_) {
-                update_callback_(fixed_dt_);
-            }
+            input_.capture(*window_);
+            step(previous_time - accumulator + fixed_dt_);
             // Update input state after each fixed update
             window_->update_input();
             accumulator -= fixed_dt_;
             updates++;
         }
+        timing_.steps = updates;
+        timing_.sim_ms = static_cast<double>(sim_busy_ns_.load() - busy_before) * 1e-6;
 
         // Calculate interpolation alpha for smooth rendering
         float alpha = static_cast<float>(accumulator / fixed_dt_);
 
         // Render
+        double render_start = seconds_now();
+        timing_.latency_ms = (render_start - last_step_published_.load()) * 1000.0;
         if (render_callback_) {
+            CAFE_PROFILE_SCOPE("GameLoop::render");
             render_callback_(alpha);
         }
+        double render_end = seconds_now();
+        timing_.render_ms = (render_end - render_start) * 1000.0;
+        timing_.frame_ms = (render_end - frame_start) * 1000.0;
+
+        end_frame(frame_dt, frame_start);
+    }
+
+    running_ = false;
+}
+
+// ============================================================================
+// Threaded Mode
+// ============================================================================
+
+void GameLoop::run_threaded() {
+    running_ = true;
+    steps_ = 0;
+    fps_timer_ = 0.0;
+    frame_count_ = 0;
+    last_frame_start_ = 0.0;
+    if (pacer_.is_enabled() && !lockstep_) {
+        if (!pacer_calibrated_) {
+            pacer_.calibrate();
+            pacer_calibrated_ = true;
+        }
+        pacer_.reset();
+    }
+    sim_steps_ = 0;
+    sim_busy_ns_ = 0;
+    pending_input_ = InputSnapshot();
+    last_step_time_ = platform_->get_time();
+    last_step_published_ = seconds_now();
+
+    std::thread simulation([this] { simulate(); });
+
+    double previous_time = platform_->get_time();
+    int64_t busy_before = 0;
+    uint64_t steps_before = 0;
+
+    while (running_ && window_->is_open()) {
+        CAFE_PROFILE_FRAME();
+        double frame_start = seconds_now();
+        {
+            CAFE_PROFILE_SCOPE("GameLoop::poll_events");
+            platform_->poll_events();
+        }
+        if (!window_->is_open()) {
+            break;
+        }
 
-        // FPS tracking
-        frame_count++;
-        fps_timer += frame_dt;
-        if (fps_timer >= 1.0) {
-            current_fps_ = frame_count;
-            if (frame_callback_) {
-                frame_callback_(current_fps_, static_cast<float>(fps_timer / frame_count));
+        // Hand this frame's input to the simulation. Edges accumulate until
+        // a step takes them, so a tap between two steps is not lost.
+        InputSnapshot latest;
+        latest.capture(*window_);
+        {
+            std::lock_guard<std::mutex> lock(input_mutex_);
+            pending_input_.down = latest.down;
+            pending_input_.pressed |= latest.pressed;
+            pending_input_.released |= latest.released;
+            pending_input_.buttons = latest.buttons;
+            pending_input_.mouse_x = latest.mouse_x;
+            pending_input_.mouse_y = latest.mouse_y;
+        }
+        window_->update_input();
+
+        double current_time = platform_->get_time();
+        double frame_dt = current_time - previous_time;
+        previous_time = current_time;
+        if (pacer_.is_enabled()) {
+            frame_dt = pacer_.smooth(frame_dt);
+        }
+        frame_time_ = static_cast<float>(frame_dt);
+
+        // Newest simulation state: from the snapshot we will draw, if any
+        double newest_time = last_step_time_.load();
+        double newest_published = last_step_published_.load();
+        if (snapshots_) {
+            snapshots_->acquire();
+            if (snapshots_->has_frame()) {
+                newest_time = snapshots_->time();
+                newest_published = snapshots_->published_at();
             }
-            frame_count = 0;
-            fps_timer = 0.0;
         }
+        double alpha = (current_time - newest_time) / fixed_dt_;
+        alpha = alpha < 0.0 ? 0.0 : (alpha > 1.0 ? 1.0 : alpha);
+
+        // Render, measuring how much simulation finished meanwhile
+        timing_ = LoopTiming();
+        int64_t busy_at_render = sim_busy_ns_.load();
+        double render_start = seconds_now();
+        if (render_callback_) {
+            CAFE_PROFILE_SCOPE("GameLoop::render");
+            render_callback_(static_cast<float>(alpha));
+        }
+        double render_end = seconds_now();
+        int64_t busy_now = sim_busy_ns_.load();
+        uint64_t steps_now = sim_steps_.load();
+
+        timing_.frame_ms = (render_end - frame_start) * 1000.0;
+        timing_.render_ms = (render_end - render_start) * 1000.0;
+        timing_.sim_ms = static_cast<double>(busy_now - busy_before) * 1e-6;
+        timing_.overlap_ms = static_cast<double>(busy_now - busy_at_render) * 1e-6;
+        timing_.latency_ms = (render_start - newest_published) * 1000.0;
+        timing_.steps = static_cast<int>(steps_now - steps_before);
+        busy_before = busy_now;
+        steps_before = steps_now;
+
+        end_frame(frame_dt, frame_start);
     }
 
     running_ = false;
+    simulation.join();
+}
+
+void GameLoop::simulate() {
+    CAFE_PROFILE_THREAD("sim");
+
+    // Step n is due at origin + n * dt. The origin moves forward when the
+    // simulation falls too far behind (debugger, machine overloaded).
+    double origin = platform_->get_time();
+    uint64_t n = 0;
+
+    while (running_) {
+        double now = platform_->get_time();
+        double due = origin + static_cast<double>(n + 1) * fixed_dt_;
+        if (now < due) {
+            std::this_thread::sleep_for(std::chrono::duration<double>(due - now));
+            continue;
+        }
+        if (now - due > fixed_dt_ * max_frame_skip_) {
+            origin += now - due;
+            due = now;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(input_mutex_);
+            input_ = pending_input_;
+            pending_input_.pressed.reset();
+            pending_input_.released.reset();
+        }
+
+        ++n;
+        step(due);
+        last_step_time_ = due;
+    }
+}
+
+// ============================================================================
+// Shared
+// ============================================================================
+
+void GameLoop::step(double time) {
+    CAFE_PROFILE_SCOPE("GameLoop::update");
+    double start = seconds_now();
+    if (recorder_) {
+        recorder_->capture(input_);
+    }
+    if (update_callback_) {
+        update_callback_(fixed_dt_);
+    }
+    ++steps_;
+
+    double end = seconds_now();
+    if (snapshots_) {
+        snapshots_->publish(steps_, time, end);
+    }
+    last_step_published_ = end;
+    sim_busy_ns_ += static_cast<int64_t>((end - start) * 1e9);
+    sim_steps_ = steps_;
+}
+
+void GameLoop::end_frame(double frame_dt, double frame_start) {
+    // Sleep out the rest of the frame (returns at once when unpaced)
+    if (!lockstep_) {
+        CAFE_PROFILE_SCOPE("GameLoop::sleep");
+        timing_.sleep_ms = pacer_.wait() * 1000.0;
+    }
+    if (last_frame_start_ > 0.0) {
+        timing_.interval_ms = (frame_start - last_frame_start_) * 1000.0;
+    }
+    last_frame_start_ = frame_start;
+
+    if (timing_callback_) {
+        timing_callback_(timing_);
+    }
+
+    // FPS tracking
+    frame_count_++;
+    fps_timer_ += frame_dt;
+    if (fps_timer_ >= 1.0) {
+        current_fps_ = frame_count_;
+        if (frame_callback_) {
+            frame_callback_(current_fps_, static_cast<float>(fps_timer_ / frame_count_));
+        }
+        frame_count_ = 0;
+        fps_timer_ = 0.0;
+    }
 }
 
 void GameLoop::stop() {
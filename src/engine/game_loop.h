@@ -1,13 +1,19 @@
 #ifndef CAFE_GAME_LOOP_H
 #define CAFE_GAME_LOOP_H
 
+#include "frame_pacer.h"
+#include "input_recorder.h"
+#include <atomic>
+#include <cstdint>
 #include <functional>
+#include <mutex>
 
 namespace cafe {
 
 // Forward declarations
 class Platform;
 class Window;
+class SnapshotBufferBase;
 
 // ============================================================================
 // Fixed Timestep Game Loop
@@ -27,39 +33,102 @@ class Window;
 //   });
 //   loop.run();
 //
+// Lockstep mode drops the wall clock: every iteration runs exactly one
+// fixed update, as fast as the CPU allows. With a ReplayWindow that makes
+// a recorded session replay identically (see input_recorder.h).
+//
+// Threaded mode runs the fixed updates on a simulation thread of their
+// own, on the wall-clock schedule, while the calling thread polls events
+// and renders. A slow frame no longer delays the simulation, and the two
+// use separate cores:
+//
+//   main thread     poll_events -> input -> acquire snapshot -> render(alpha)
+//   sim thread      input() -> update(dt) -> publish snapshot -> sleep
+//
+// The update callback must not touch the Window or the renderer then:
+// it reads input from input() (captured by the main thread every frame,
+// pressed/released kept until a step sees them) and hands the renderer
+// an immutable snapshot through a SnapshotBuffer (snapshot_buffer.h).
+// alpha is how far the render clock is past the newest snapshot, in
+// steps, so render interpolates previous() -> current() as before.
+//
+// Pacing: set_render_rate() caps rendering at a rate of its own (the
+// fixed update rate stays what set_target_fps() says) and sleeps out the
+// rest of each frame with a FramePacer instead of spinning. With vsync,
+// set_vsync() lets the present block and only snaps frame times to whole
+// refreshes. Either way frame_dt is low-pass filtered (frame_pacer.h).
+//
+// Every frame reports a LoopTiming: render and simulation time, how much
+// simulation ran while the frame rendered (overlap) and how old the
+// snapshot on screen was (latency).
+//
 // ============================================================================
 
+// Per rendered frame, in milliseconds
+struct LoopTiming {
+    double frame_ms = 0.0;       // Poll events through the end of render
+    double interval_ms = 0.0;    // Since the previous frame started (unfiltered)
+    double sleep_ms = 0.0;       // Waiting for the pacing deadline
+    double render_ms = 0.0;      // In the render callback
+    double sim_ms = 0.0;         // In update callbacks that finished this frame
+    double overlap_ms = 0.0;     // Simulation finished while render ran (threaded)
+    double latency_ms = 0.0;     // Age of the newest state when render started
+    int steps = 0;               // Fixed updates that finished this frame
+};
+
 class GameLoop {
 public:
     // Callback types
     using UpdateCallback = std::function<void(float dt)>;       // Fixed timestep update
     using RenderCallback = std::function<void(float alpha)>;    // Render with interpolation
     using FrameCallback = std::function<void(int fps, float frame_time)>;  // FPS reporting
+    using TimingCallback = std::function<void(const LoopTiming& timing)>;
 
     GameLoop(Platform* platform, Window* window);
 
     // Configuration
     void set_target_fps(int fps);           // Target update rate (default: 60)
     void set_max_frame_skip(int frames);    // Max updates per frame (default: 5)
+    void set_lockstep(bool lockstep);       // One update per frame, no clock (platform may be null)
+    void set_input_recorder(InputRecorder* recorder);  // Captures input before each update
+    void set_threaded(bool threaded);       // Updates on a simulation thread (not with lockstep)
+    void set_render_rate(double hz);        // Pace rendering (0 = unpaced, default)
+    void set_vsync(bool vsync, double refresh_hz = 60.0);  // Present blocks on vsync
+    FramePacer& pacer() { return pacer_; }
+    void set_snapshot_buffer(SnapshotBufferBase* snapshots);  // Published after each update
 
     // Callbacks
     void set_update_callback(UpdateCallback callback);
     void set_render_callback(RenderCallback callback);
     void set_frame_callback(FrameCallback callback);  // Called once per second
+    void set_timing_callback(TimingCallback callback);  // Called every frame
 
     // Run the loop (blocks until window closes)
     void run();
 
-    // Loop control
+    // Loop control (stop() may be called from the update callback)
     void stop();
     bool is_running() const { return running_; }
 
+    // Input for the current fixed update (read it in the update callback)
+    const InputSnapshot& input() const { return input_; }
+
     // Timing info
     float fixed_delta_time() const { return fixed_dt_; }
     float frame_time() const { return frame_time_; }
     int current_fps() const { return current_fps_; }
+    const LoopTiming& last_timing() const { return timing_; }
 
 private:
+    void run_threaded();
+    void simulate();                       // Simulation thread body
+
+    // One fixed update: input, recorder, callback, snapshot
+    void step(double time);
+
+    // Frame bookkeeping shared by both modes: pace, report, count FPS
+    void end_frame(double frame_dt, double frame_start);
+
     Platform* platform_;
     Window* window_;
 
@@ -67,15 +136,36 @@ private:
     UpdateCallback update_callback_;
     RenderCallback render_callback_;
     FrameCallback frame_callback_;
+    TimingCallback timing_callback_;
 
     // Configuration
     float fixed_dt_ = 1.0f / 60.0f;  // Fixed timestep (60 Hz)
     int max_frame_skip_ = 5;          // Prevent spiral of death
+    bool lockstep_ = false;
+    bool threaded_ = false;
+    InputRecorder* recorder_ = nullptr;
+    SnapshotBufferBase* snapshots_ = nullptr;
+    FramePacer pacer_;
+    bool pacer_calibrated_ = false;
 
     // State
-    bool running_ = false;
+    std::atomic<bool> running_{false};
     float frame_time_ = 0.0f;
     int current_fps_ = 0;
+    double fps_timer_ = 0.0;
+    int frame_count_ = 0;
+    double last_frame_start_ = 0.0;
+    uint64_t steps_ = 0;                   // Fixed updates so far
+    InputSnapshot input_;                  // Seen by the update callback
+    LoopTiming timing_;
+
+    // Threaded mode
+    std::mutex input_mutex_;
+    InputSnapshot pending_input_;          // Main thread -> next step
+    std::atomic<uint64_t> sim_steps_{0};
+    std::atomic<int64_t> sim_busy_ns_{0};  // Total time in update callbacks
+    std::atomic<double> last_step_time_{0.0};
+    std::atomic<double> last_step_published_{0.0};
 };
 
 } // namespace cafe
@@ -1,10 +1,175 @@
 #include "image.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+
+namespace cafe {
+
+// ============================================================================
+// Pixel Buffer Pool
+// ============================================================================
+//
+// Every buffer carries a 16-byte header with its capacity and size class,
+// so free and realloc need no size from the caller (stb_image gives none).
+// Buffers of 4 KB to 64 MB round up to a power of two and return to a free
+// list for their class; smaller ones (stb_image's bookkeeping) and bigger
+// ones go straight to malloc.
+
+namespace {
+
+constexpr int kMinClassBits = 12;   // 4 KB
+constexpr int kMaxClassBits = 26;   // 64 MB
+constexpr int kClassCount = kMaxClassBits - kMinClassBits + 1;
+constexpr uint32_t kUnpooled = 0xFFFFFFFFu;
+
+struct alignas(16) BufferHeader {
+    size_t capacity;       // Usable bytes after the header
+    uint32_t size_class;   // kUnpooled = plain malloc
+};
+static_assert(sizeof(BufferHeader) == 16, "pixel buffers stay 16-byte aligned");
+
+class BufferPool {
+public:
+    void* allocate(size_t size) {
+        uint32_t size_class = class_for(size);
+        if (size_class != kUnpooled) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            std::vector<BufferHeader*>& list = free_[size_class];
+            if (!list.empty()) {
+                BufferHeader* header = list.back();
+                list.pop_back();
+                cached_bytes_ -= header->capacity;
+                reused_++;
+                return header + 1;
+            }
+            allocated_++;
+        }
 
+        size_t capacity = size_class == kUnpooled ? size : size_t(1) << (size_class + kMinClassBits);
+        auto* header = static_cast<BufferHeader*>(std::malloc(sizeof(BufferHeader) + capacity));
+        if (!header) {
+            return nullptr;
+        }
+        header->capacity = capacity;
+        header->size_class = size_class;
+        return header + 1;
+    }
+
+    void release(void* pointer) {
+        if (!pointer) {
+            return;
+        }
+        BufferHeader* header = static_cast<BufferHeader*>(pointer) - 1;
+        if (header->size_class != kUnpooled) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (cached_bytes_ + header->capacity <= cache_limit_) {
+                free_[header->size_class].push_back(header);
+                cached_bytes_ += header->capacity;
+                return;
+            }
+        }
+        std::free(header);
+    }
+
+    void* reallocate(void* pointer, size_t size) {
+        if (!pointer) {
+            return allocate(size);
+        }
+        BufferHeader* header = static_cast<BufferHeader*>(pointer) - 1;
+        if (size <= header->capacity && class_for(size) == header->size_class) {
+            return pointer;
+        }
+        void* grown = allocate(size);
+        if (grown) {
+            std::memcpy(grown, pointer, std::min(size, header->capacity));
+            release(pointer);
+        }
+        return grown;
+    }
+
+    void set_limit(size_t bytes) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        cache_limit_ = bytes;
+        trim_locked(bytes);
+    }
+
+    void trim() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        trim_locked(0);
+    }
+
+    ImageBufferStats stats() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ImageBufferStats stats;
+        stats.cached_bytes = cached_bytes_;
+        stats.cache_limit = cache_limit_;
+        stats.reused = reused_;
+        stats.allocated = allocated_;
+        return stats;
+    }
+
+private:
+    static uint32_t class_for(size_t size) {
+        if (size < (size_t(1) << kMinClassBits) || size > (size_t(1) << kMaxClassBits)) {
+            return kUnpooled;
+        }
+        uint32_t size_class = 0;
+        while ((size_t(1) << (size_class + kMinClassBits)) < size) {
+            ++size_class;
+        }
+        return size_class;
+    }
+
+    // Largest buffers first: they free the most per call
+    void trim_locked(size_t target) {
+        for (int size_class = kClassCount - 1; size_class >= 0 && cached_bytes_ > target; --size_class) {
+            std::vector<BufferHeader*>& list = free_[size_class];
+            while (!list.empty() && cached_bytes_ > target) {
+                cached_bytes_ -= list.back()->capacity;
+                std::free(list.back());
+                list.pop_back();
+            }
+        }
+    }
+
+    std::mutex mutex_;
+    std::vector<BufferHeader*> free_[kClassCount];
+    size_t cached_bytes_ = 0;
+    size_t cache_limit_ = 64 * 1024 * 1024;
+    uint64_t reused_ = 0;
+    uint64_t allocated_ = 0;
+};
+
+// Never destroyed: images in other static objects may be freed after it
+BufferPool& buffer_pool() {
+    static BufferPool* pool = new BufferPool();
+    return *pool;
+}
+
+void* pool_malloc(size_t size) { return buffer_pool().allocate(size); }
+void* pool_realloc(void* pointer, size_t size) { return buffer_pool().reallocate(pointer, size); }
+void pool_free(void* pointer) { buffer_pool().release(pointer); }
+
+// Decode threads for load_many(); the calling thread makes one more
+ThreadPool& decode_pool() {
+    static ThreadPool pool;
+    return pool;
+}
+
+} // namespace
+
+} // namespace cafe
+
+#define STBI_MALLOC(size) cafe::pool_malloc(size)
+#define STBI_REALLOC(pointer, size) cafe::pool_realloc(pointer, size)
+#define STBI_FREE(pointer) cafe::pool_free(pointer)
 #define STB_IMAGE_IMPLEMENTATION
 #include "../../third_party/stb/stb_image.h"
 
-#include <cstring>
-
 namespace cafe {
 
 Image::~Image() {
@@ -76,6 +241,69 @@ std::unique_ptr<Image> Image::load_from_memory(const uint8_t* data, size_t size)
     return image;
 }
 
+bool Image::read_size(const std::string& path, int& width, int& height) {
+    int channels = 0;
+    return stbi_info(path.c_str(), &width, &height, &channels) != 0;
+}
+
+std::vector<std::unique_ptr<Image>> Image::load_many(std::span<const std::string> paths,
+                                                    int threads) {
+    std::vector<std::unique_ptr<Image>> images(paths.size());
+    if (paths.empty()) {
+        return images;
+    }
+
+    ThreadPool& pool = decode_pool();
+    if (threads <= 0) {
+        threads = max_decode_threads();
+    }
+    int helpers = std::min({threads - 1, pool.thread_count(), static_cast<int>(paths.size()) - 1});
+
+    // Every thread takes the next undecoded file until none are left, so
+    // one large image does not hold up a whole share of the batch
+    std::atomic<size_t> next{0};
+    auto decode = [&] {
+        for (size_t i = next++; i < paths.size(); i = next++) {
+            images[i] = load_from_file(paths[i]);
+        }
+    };
+
+    std::mutex mutex;
+    std::condition_variable finished;
+    int running = helpers;
+    for (int i = 0; i < helpers; ++i) {
+        pool.submit([&] {
+            decode();
+            // Notify under the lock: the caller may return (destroying
+            // `finished`) as soon as it sees running == 0
+            std::lock_guard<std::mutex> lock(mutex);
+            --running;
+            finished.notify_one();
+        });
+    }
+
+    decode();
+    std::unique_lock<std::mutex> lock(mutex);
+    finished.wait(lock, [&] { return running == 0; });
+    return images;
+}
+
+int Image::max_decode_threads() {
+    return decode_pool().thread_count() + 1;
+}
+
+ImageBufferStats Image::buffer_stats() {
+    return buffer_pool().stats();
+}
+
+void Image::set_buffer_cache_limit(size_t bytes) {
+    buffer_pool().set_limit(bytes);
+}
+
+void Image::trim_buffer_cache() {
+    buffer_pool().trim();
+}
+
 std::unique_ptr<Image> Image::create(int width, int height, int channels) {
     auto image = std::make_unique<Image>();
 
@@ -85,7 +313,7 @@ std::unique_ptr<Image> Image::create(int width, int height, int channels) {
     image->owned_ = true;
 
     size_t size = static_cast<size_t>(width) * height * channels;
-    image->data_ = static_cast<uint8_t*>(malloc(size));
+    image->data_ = static_cast<uint8_t*>(pool_malloc(size));
 
     if (!image->data_) {
         return nullptr;
@@ -1,15 +1,41 @@
 #ifndef CAFE_IMAGE_H
 #define CAFE_IMAGE_H
 
+#include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <span>
 #include <string>
+#include <vector>
 
 namespace cafe {
 
 // ============================================================================
 // Image - Loaded image data in CPU memory
 // ============================================================================
+//
+// Pixel buffers (and stb_image's scratch buffers while decoding) come from
+// a pool of power-of-two size classes. Loading a scene's worth of sprites
+// allocates and frees the same few sizes over and over; the pool hands
+// the freed buffers back out instead of going to malloc each time.
+//
+// load_many() decodes a batch of files at once on a shared set of decode
+// threads. stb_image decodes one file on one thread, so a batch is the
+// only way to use more than one core.
+//
+// Usage:
+//   std::vector<std::string> paths = {"floor.png", "counter.png", "barista.png"};
+//   auto images = Image::load_many(paths);   // nullptr where a file failed
+//
+// ============================================================================
+
+// Pixel buffer pool counters
+struct ImageBufferStats {
+    size_t cached_bytes = 0;     // Free buffers kept for reuse
+    size_t cache_limit = 0;      // Most cached_bytes may reach
+    uint64_t reused = 0;         // Allocations served from the cache
+    uint64_t allocated = 0;      // Allocations that went to malloc
+};
 
 class Image {
 public:
@@ -28,6 +54,18 @@ public:
     // Load from memory
     static std::unique_ptr<Image> load_from_memory(const uint8_t* data, size_t size);
 
+    // Read only the header for the image size (no decode)
+    static bool read_size(const std::string& path, int& width, int& height);
+
+    // Decode several files concurrently. Returns one image per path, in
+    // order (nullptr for files that failed). `threads` counts the calling
+    // thread, which decodes too; 0 = one per hardware thread.
+    static std::vector<std::unique_ptr<Image>> load_many(std::span<const std::string> paths,
+                                                         int threads = 0);
+
+    // Most threads load_many() can use
+    static int max_decode_threads();
+
     // Create empty image (useful for procedural generation)
     static std::unique_ptr<Image> create(int width, int height, int channels = 4);
 
@@ -48,6 +86,11 @@ public:
     // Check if valid
     bool is_valid() const { return data_ != nullptr; }
 
+    // Buffer pool (shared by every Image, thread-safe)
+    static ImageBufferStats buffer_stats();
+    static void set_buffer_cache_limit(size_t bytes);   // Default 64 MB
+    static void trim_buffer_cache();                     // Free cached buffers
+
 private:
     uint8_t* data_ = nullptr;
     int width_ = 0;
@@ -0,0 +1,949 @@
+#include "image_ops.h"
+#include "image.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+// SSE2 is part of x86-64. AVX2 is compiled per function (target attribute)
+// and only called after the CPU reports it, so no -mavx2 is needed.
+#if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__)
+#define CAFE_SIMD_SSE2 1
+#include <emmintrin.h>
+#if defined(__GNUC__) || defined(__clang__)
+#define CAFE_SIMD_AVX2 1
+#define CAFE_TARGET_AVX2 __attribute__((target("avx2")))
+#include <immintrin.h>
+#endif
+#elif defined(__ARM_NEON)
+#define CAFE_SIMD_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace cafe {
+namespace image_ops {
+
+namespace {
+
+// ============================================================================
+// Shared arithmetic
+// ============================================================================
+//
+// Every level computes exactly these, so results match bit for bit:
+//
+//   mul255(x, a)   round(x * a / 255) as (t + (t >> 8)) >> 8, t = x * a + 128
+//                  (exact for 8-bit inputs, and fits in 16 bits)
+//   lerp(a, b, f)  a + ((b - a) * f >> 7), f in 0..127 (7-bit weights keep
+//                  the product inside a signed 16-bit lane)
+
+inline unsigned mul255(unsigned x, unsigned a) {
+    unsigned t = x * a + 128;
+    return (t + (t >> 8)) >> 8;
+}
+
+inline int lerp7(int a, int b, int f) {
+    return a + (((b - a) * f) >> 7);
+}
+
+// sRGB <-> linear light, for gamma-correct averaging. Linear values use
+// 12 bits: enough that every 8-bit sRGB value has its own linear value
+// (the smallest step, near black, is 1.24), so averaging four equal
+// pixels gives the same pixel back.
+struct SrgbTables {
+    uint16_t to_linear[256];     // sRGB byte -> linear 0..4095
+    uint8_t to_srgb[4096];       // linear -> nearest sRGB byte
+};
+
+double srgb_to_linear(double c) {
+    return c <= 0.04045 ? c / 12.92 : std::pow((c + 0.055) / 1.055, 2.4);
+}
+
+const SrgbTables& srgb_tables() {
+    static const SrgbTables tables = [] {
+        SrgbTables t;
+        double linear[256];
+        for (int v = 0; v < 256; ++v) {
+            linear[v] = srgb_to_linear(v / 255.0) * 4095.0;
+            t.to_linear[v] = static_cast<uint16_t>(std::lround(linear[v]));
+        }
+        // Inverse: the sRGB value whose exact linear value is closest
+        int v = 0;
+        for (int i = 0; i < 4096; ++i) {
+            while (v < 255 && std::abs(linear[v + 1] - i) <= std::abs(linear[v] - i)) {
+                ++v;
+            }
+            t.to_srgb[i] = static_cast<uint8_t>(v);
+        }
+        return t;
+    }();
+    return tables;
+}
+
+// Bilinear row inputs: byte offsets of the two source texels and the
+// weight of the second, per destination pixel
+struct BilinearColumns {
+    std::vector<int32_t> x0;
+    std::vector<int32_t> x1;
+    std::vector<int16_t> fx;
+};
+
+// ============================================================================
+// Scalar kernels
+// ============================================================================
+
+void premultiply_scalar(uint8_t* pixels, size_t count) {
+    for (size_t i = 0; i < count; ++i, pixels += 4) {
+        unsigned a = pixels[3];
+        pixels[0] = static_cast<uint8_t>(mul255(pixels[0], a));
+        pixels[1] = static_cast<uint8_t>(mul255(pixels[1], a));
+        pixels[2] = static_cast<uint8_t>(mul255(pixels[2], a));
+    }
+}
+
+void swizzle_scalar(uint8_t* dst, const uint8_t* src, size_t count) {
+    for (size_t i = 0; i < count; ++i, src += 4, dst += 4) {
+        uint8_t r = src[0];
+        uint8_t g = src[1];
+        uint8_t b = src[2];
+        uint8_t a = src[3];
+        dst[0] = b;
+        dst[1] = g;
+        dst[2] = r;
+        dst[3] = a;
+    }
+}
+
+void fill_scalar(uint8_t* pixels, size_t count, uint32_t color) {
+    for (size_t i = 0; i < count; ++i) {
+        std::memcpy(pixels + i * 4, &color, 4);
+    }
+}
+
+void palette_scalar(uint8_t* pixels, size_t count,
+                    const uint32_t* from, const uint32_t* to, size_t entries) {
+    for (size_t i = 0; i < count; ++i, pixels += 4) {
+        uint32_t pixel;
+        std::memcpy(&pixel, pixels, 4);
+        for (size_t e = 0; e < entries; ++e) {
+            if (pixel == from[e]) {
+                std::memcpy(pixels, &to[e], 4);
+                break;
+            }
+        }
+    }
+}
+
+void blend_scalar(uint8_t* dst, const uint8_t* src, size_t count) {
+    for (size_t i = 0; i < count; ++i, src += 4, dst += 4) {
+        unsigned a = src[3];
+        unsigned inv = 255 - a;
+        dst[0] = static_cast<uint8_t>(mul255(src[0], a) + mul255(dst[0], inv));
+        dst[1] = static_cast<uint8_t>(mul255(src[1], a) + mul255(dst[1], inv));
+        dst[2] = static_cast<uint8_t>(mul255(src[2], a) + mul255(dst[2], inv));
+        dst[3] = static_cast<uint8_t>(a + mul255(dst[3], inv));
+    }
+}
+
+// One output row from two full source rows (no edge clamping needed)
+void box_row_scalar(const uint8_t* row0, const uint8_t* row1, uint8_t* dst, int dst_width) {
+    for (int x = 0; x < dst_width; ++x, row0 += 8, row1 += 8, dst += 4) {
+        for (int c = 0; c < 4; ++c) {
+            dst[c] = static_cast<uint8_t>((row0[c] + row0[c + 4] + row1[c] + row1[c + 4] + 2) >> 2);
+        }
+    }
+}
+
+// Same, averaging color in linear light (alpha stays linear). Used at every
+// level: it is all table lookups, and an AVX2 gather version measured no
+// faster.
+void box_row_srgb_scalar(const uint8_t* row0, const uint8_t* row1, uint8_t* dst, int dst_width) {
+    const SrgbTables& tables = srgb_tables();
+    for (int x = 0; x < dst_width; ++x, row0 += 8, row1 += 8, dst += 4) {
+        for (int c = 0; c < 3; ++c) {
+            uint32_t sum = tables.to_linear[row0[c]] + tables.to_linear[row0[c + 4]] +
+                           tables.to_linear[row1[c]] + tables.to_linear[row1[c + 4]];
+            dst[c] = tables.to_srgb[(sum + 2) >> 2];
+        }
+        dst[3] = static_cast<uint8_t>((row0[3] + row0[7] + row1[3] + row1[7] + 2) >> 2);
+    }
+}
+
+void bilinear_row_scalar(const uint8_t* row0, const uint8_t* row1, int fy,
+                         const BilinearColumns& columns, int begin, int end, uint8_t* dst) {
+    for (int x = begin; x < end; ++x) {
+        const uint8_t* p00 = row0 + columns.x0[x];
+        const uint8_t* p01 = row0 + columns.x1[x];
+        const uint8_t* p10 = row1 + columns.x0[x];
+        const uint8_t* p11 = row1 + columns.x1[x];
+        int fx = columns.fx[x];
+        uint8_t* out = dst + static_cast<size_t>(x) * 4;
+        for (int c = 0; c < 4; ++c) {
+            int top = lerp7(p00[c], p01[c], fx);
+            int bottom = lerp7(p10[c], p11[c], fx);
+            out[c] = static_cast<uint8_t>(lerp7(top, bottom, fy));
+        }
+    }
+}
+
+void bilinear_row_scalar(const uint8_t* row0, const uint8_t* row1, int fy,
+                         const BilinearColumns& columns, int dst_width, uint8_t* dst) {
+    bilinear_row_scalar(row0, row1, fy, columns, 0, dst_width, dst);
+}
+
+// ============================================================================
+// SSE2 kernels (4 pixels per 128-bit register)
+// ============================================================================
+
+#if defined(CAFE_SIMD_SSE2)
+
+inline __m128i mul255_sse2(__m128i x, __m128i a) {
+    __m128i t = _mm_add_epi16(_mm_mullo_epi16(x, a), _mm_set1_epi16(128));
+    return _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+}
+
+// Each pixel's alpha in all four of its 16-bit lanes
+inline __m128i broadcast_alpha_sse2(__m128i pixels16) {
+    return _mm_shufflehi_epi16(_mm_shufflelo_epi16(pixels16, 0xFF), 0xFF);
+}
+
+void premultiply_sse2(uint8_t* pixels, size_t count) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i keep_alpha = _mm_set_epi16(255, 0, 0, 0, 255, 0, 0, 0);  // alpha * 255 / 255
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128i* p = reinterpret_cast<__m128i*>(pixels + i * 4);
+        __m128i v = _mm_loadu_si128(p);
+        __m128i lo = _mm_unpacklo_epi8(v, zero);
+        __m128i hi = _mm_unpackhi_epi8(v, zero);
+        lo = mul255_sse2(lo, _mm_or_si128(broadcast_alpha_sse2(lo), keep_alpha));
+        hi = mul255_sse2(hi, _mm_or_si128(broadcast_alpha_sse2(hi), keep_alpha));
+        _mm_storeu_si128(p, _mm_packus_epi16(lo, hi));
+    }
+    premultiply_scalar(pixels + i * 4, count - i);
+}
+
+void swizzle_sse2(uint8_t* dst, const uint8_t* src, size_t count) {
+    // SSE2 has no byte shuffle: move R and B with 32-bit shifts
+    const __m128i green_alpha = _mm_set1_epi32(static_cast<int>(0xFF00FF00u));
+    const __m128i low_byte = _mm_set1_epi32(0xFF);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 4));
+        __m128i r_to_b = _mm_slli_epi32(_mm_and_si128(v, low_byte), 16);
+        __m128i b_to_r = _mm_and_si128(_mm_srli_epi32(v, 16), low_byte);
+        v = _mm_or_si128(_mm_and_si128(v, green_alpha), _mm_or_si128(r_to_b, b_to_r));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 4), v);
+    }
+    swizzle_scalar(dst + i * 4, src + i * 4, count - i);
+}
+
+void fill_sse2(uint8_t* pixels, size_t count, uint32_t color) {
+    const __m128i v = _mm_set1_epi32(static_cast<int>(color));
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pixels + i * 4), v);
+    }
+    fill_scalar(pixels + i * 4, count - i, color);
+}
+
+void palette_sse2(uint8_t* pixels, size_t count,
+                  const uint32_t* from, const uint32_t* to, size_t entries) {
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128i* p = reinterpret_cast<__m128i*>(pixels + i * 4);
+        __m128i v = _mm_loadu_si128(p);
+        __m128i result = v;
+        __m128i done = _mm_setzero_si128();
+        for (size_t e = 0; e < entries; ++e) {
+            __m128i match = _mm_cmpeq_epi32(v, _mm_set1_epi32(static_cast<int>(from[e])));
+            match = _mm_andnot_si128(done, match);
+            result = _mm_or_si128(_mm_andnot_si128(match, result),
+                                  _mm_and_si128(match, _mm_set1_epi32(static_cast<int>(to[e]))));
+            done = _mm_or_si128(done, match);
+        }
+        _mm_storeu_si128(p, result);
+    }
+    palette_scalar(pixels + i * 4, count - i, from, to, entries);
+}
+
+void blend_sse2(uint8_t* dst, const uint8_t* src, size_t count) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i full = _mm_set1_epi16(255);
+    const __m128i alpha_lanes = _mm_set_epi16(255, 0, 0, 0, 255, 0, 0, 0);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 4));
+        __m128i* d = reinterpret_cast<__m128i*>(dst + i * 4);
+        __m128i dv = _mm_loadu_si128(d);
+
+        __m128i s_lo = _mm_unpacklo_epi8(s, zero);
+        __m128i s_hi = _mm_unpackhi_epi8(s, zero);
+        __m128i a_lo = broadcast_alpha_sse2(s_lo);
+        __m128i a_hi = broadcast_alpha_sse2(s_hi);
+
+        // Source alpha lane becomes 255 so alpha = a + dst_alpha * (1 - a)
+        s_lo = mul255_sse2(_mm_or_si128(s_lo, alpha_lanes), a_lo);
+        s_hi = mul255_sse2(_mm_or_si128(s_hi, alpha_lanes), a_hi);
+        __m128i d_lo = mul255_sse2(_mm_unpacklo_epi8(dv, zero), _mm_sub_epi16(full, a_lo));
+        __m128i d_hi = mul255_sse2(_mm_unpackhi_epi8(dv, zero), _mm_sub_epi16(full, a_hi));
+
+        _mm_storeu_si128(d, _mm_packus_epi16(_mm_add_epi16(s_lo, d_lo), _mm_add_epi16(s_hi, d_hi)));
+    }
+    blend_scalar(dst + i * 4, src + i * 4, count - i);
+}
+
+void box_row_sse2(const uint8_t* row0, const uint8_t* row1, uint8_t* dst, int dst_width) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i round = _mm_set1_epi16(2);
+    int x = 0;
+    for (; x + 2 <= dst_width; x += 2) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + x * 8));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + x * 8));
+
+        // Vertical sums of source pixels 0,1 and 2,3
+        __m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero));
+        __m128i hi = _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero));
+
+        // Horizontal pairs: low half of each register gets pixel 0+1 (2+3)
+        lo = _mm_add_epi16(lo, _mm_srli_si128(lo, 8));
+        hi = _mm_add_epi16(hi, _mm_srli_si128(hi, 8));
+
+        __m128i sum = _mm_srli_epi16(_mm_add_epi16(_mm_unpacklo_epi64(lo, hi), round), 2);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + x * 4), _mm_packus_epi16(sum, sum));
+    }
+    box_row_scalar(row0 + x * 8, row1 + x * 8, dst + x * 4, dst_width - x);
+}
+
+// Two destination pixels per iteration, widened to 16 bits
+void bilinear_row_sse2(const uint8_t* row0, const uint8_t* row1, int fy,
+                       const BilinearColumns& columns, int dst_width, uint8_t* dst) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i vfy = _mm_set1_epi16(static_cast<short>(fy));
+
+    auto load_pair = [&](const uint8_t* row, const int32_t* offsets, int x) {
+        uint32_t a;
+        uint32_t b;
+        std::memcpy(&a, row + offsets[x], 4);
+        std::memcpy(&b, row + offsets[x + 1], 4);
+        __m128i pair = _mm_unpacklo_epi32(_mm_cvtsi32_si128(static_cast<int>(a)),
+                                          _mm_cvtsi32_si128(static_cast<int>(b)));
+        return _mm_unpacklo_epi8(pair, zero);
+    };
+    auto lerp = [](__m128i a, __m128i b, __m128i f) {
+        return _mm_add_epi16(a, _mm_srai_epi16(_mm_mullo_epi16(_mm_sub_epi16(b, a), f), 7));
+    };
+
+    const int32_t* x0 = columns.x0.data();
+    const int32_t* x1 = columns.x1.data();
+    int x = 0;
+    for (; x + 2 <= dst_width; x += 2) {
+        short fa = columns.fx[x];
+        short fb = columns.fx[x + 1];
+        __m128i vfx = _mm_set_epi16(fb, fb, fb, fb, fa, fa, fa, fa);
+
+        __m128i top = lerp(load_pair(row0, x0, x), load_pair(row0, x1, x), vfx);
+        __m128i bottom = lerp(load_pair(row1, x0, x), load_pair(row1, x1, x), vfx);
+        __m128i result = lerp(top, bottom, vfy);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + static_cast<size_t>(x) * 4),
+                         _mm_packus_epi16(result, result));
+    }
+    bilinear_row_scalar(row0, row1, fy, columns, x, dst_width, dst);
+}
+
+#endif // CAFE_SIMD_SSE2
+
+// ============================================================================
+// AVX2 kernels (8 pixels per 256-bit register)
+// ============================================================================
+//
+// 256-bit unpack/pack instructions work on each 128-bit half separately,
+// so the SSE2 code carries over lane for lane. Bilinear sampling is
+// limited by its per-pixel loads, not arithmetic, and uses the SSE2 version.
+
+#if defined(CAFE_SIMD_AVX2)
+
+CAFE_TARGET_AVX2 inline __m256i mul255_avx2(__m256i x, __m256i a) {
+    __m256i t = _mm256_add_epi16(_mm256_mullo_epi16(x, a), _mm256_set1_epi16(128));
+    return _mm256_srli_epi16(_mm256_add_epi16(t, _mm256_srli_epi16(t, 8)), 8);
+}
+
+CAFE_TARGET_AVX2 inline __m256i broadcast_alpha_avx2(__m256i pixels16) {
+    return _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(pixels16, 0xFF), 0xFF);
+}
+
+CAFE_TARGET_AVX2 void premultiply_avx2(uint8_t* pixels, size_t count) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i keep_alpha = _mm256_set_epi16(255, 0, 0, 0, 255, 0, 0, 0,
+                                                255, 0, 0, 0, 255, 0, 0, 0);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i* p = reinterpret_cast<__m256i*>(pixels + i * 4);
+        __m256i v = _mm256_loadu_si256(p);
+        __m256i lo = _mm256_unpacklo_epi8(v, zero);
+        __m256i hi = _mm256_unpackhi_epi8(v, zero);
+        lo = mul255_avx2(lo, _mm256_or_si256(broadcast_alpha_avx2(lo), keep_alpha));
+        hi = mul255_avx2(hi, _mm256_or_si256(broadcast_alpha_avx2(hi), keep_alpha));
+        _mm256_storeu_si256(p, _mm256_packus_epi16(lo, hi));
+    }
+    premultiply_sse2(pixels + i * 4, count - i);
+}
+
+CAFE_TARGET_AVX2 void swizzle_avx2(uint8_t* dst, const uint8_t* src, size_t count) {
+    const __m256i order = _mm256_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15,
+                                           2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i * 4));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i * 4), _mm256_shuffle_epi8(v, order));
+    }
+    swizzle_sse2(dst + i * 4, src + i * 4, count - i);
+}
+
+CAFE_TARGET_AVX2 void fill_avx2(uint8_t* pixels, size_t count, uint32_t color) {
+    const __m256i v = _mm256_set1_epi32(static_cast<int>(color));
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(pixels + i * 4), v);
+    }
+    fill_sse2(pixels + i * 4, count - i, color);
+}
+
+CAFE_TARGET_AVX2 void palette_avx2(uint8_t* pixels, size_t count,
+                                   const uint32_t* from, const uint32_t* to, size_t entries) {
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i* p = reinterpret_cast<__m256i*>(pixels + i * 4);
+        __m256i v = _mm256_loadu_si256(p);
+        __m256i result = v;
+        __m256i done = _mm256_setzero_si256();
+        for (size_t e = 0; e < entries; ++e) {
+            __m256i match = _mm256_cmpeq_epi32(v, _mm256_set1_epi32(static_cast<int>(from[e])));
+            match = _mm256_andnot_si256(done, match);
+            result = _mm256_blendv_epi8(result, _mm256_set1_epi32(static_cast<int>(to[e])), match);
+            done = _mm256_or_si256(done, match);
+        }
+        _mm256_storeu_si256(p, result);
+    }
+    palette_sse2(pixels + i * 4, count - i, from, to, entries);
+}
+
+CAFE_TARGET_AVX2 void blend_avx2(uint8_t* dst, const uint8_t* src, size_t count) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i full = _mm256_set1_epi16(255);
+    const __m256i alpha_lanes = _mm256_set_epi16(255, 0, 0, 0, 255, 0, 0, 0,
+                                                 255, 0, 0, 0, 255, 0, 0, 0);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i * 4));
+        __m256i* d = reinterpret_cast<__m256i*>(dst + i * 4);
+        __m256i dv = _mm256_loadu_si256(d);
+
+        __m256i s_lo = _mm256_unpacklo_epi8(s, zero);
+        __m256i s_hi = _mm256_unpackhi_epi8(s, zero);
+        __m256i a_lo = broadcast_alpha_avx2(s_lo);
+        __m256i a_hi = broadcast_alpha_avx2(s_hi);
+
+        s_lo = mul255_avx2(_mm256_or_si256(s_lo, alpha_lanes), a_lo);
+        s_hi = mul255_avx2(_mm256_or_si256(s_hi, alpha_lanes), a_hi);
+        __m256i d_lo = mul255_avx2(_mm256_unpacklo_epi8(dv, zero), _mm256_sub_epi16(full, a_lo));
+        __m256i d_hi = mul255_avx2(_mm256_unpackhi_epi8(dv, zero), _mm256_sub_epi16(full, a_hi));
+
+        _mm256_storeu_si256(d, _mm256_packus_epi16(_mm256_add_epi16(s_lo, d_lo),
+                                                   _mm256_add_epi16(s_hi, d_hi)));
+    }
+    blend_sse2(dst + i * 4, src + i * 4, count - i);
+}
+
+CAFE_TARGET_AVX2 void box_row_avx2(const uint8_t* row0, const uint8_t* row1,
+                                   uint8_t* dst, int dst_width) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i round = _mm256_set1_epi16(2);
+    int x = 0;
+    for (; x + 4 <= dst_width; x += 4) {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row0 + x * 8));
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row1 + x * 8));
+
+        __m256i lo = _mm256_add_epi16(_mm256_unpacklo_epi8(a, zero), _mm256_unpacklo_epi8(b, zero));
+        __m256i hi = _mm256_add_epi16(_mm256_unpackhi_epi8(a, zero), _mm256_unpackhi_epi8(b, zero));
+        lo = _mm256_add_epi16(lo, _mm256_srli_si256(lo, 8));
+        hi = _mm256_add_epi16(hi, _mm256_srli_si256(hi, 8));
+
+        // Halves hold outputs 0,1 and 2,3; gather their low 64 bits
+        __m256i sum = _mm256_srli_epi16(_mm256_add_epi16(_mm256_unpacklo_epi64(lo, hi), round), 2);
+        __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(sum, sum), 0xD8);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x * 4), _mm256_castsi256_si128(packed));
+    }
+    box_row_sse2(row0 + x * 8, row1 + x * 8, dst + x * 4, dst_width - x);
+}
+
+#endif // CAFE_SIMD_AVX2
+
+// ============================================================================
+// NEON kernels (16 pixels per de-interleaving load)
+// ============================================================================
+
+#if defined(CAFE_SIMD_NEON)
+
+// vraddhn(t, (t + 128) >> 8) is the same rounding as mul255()
+inline uint8x8_t mul255_neon(uint8x8_t x, uint8x8_t a) {
+    uint16x8_t t = vmull_u8(x, a);
+    return vraddhn_u16(t, vrshrq_n_u16(t, 8));
+}
+
+inline uint8x16_t mul255q_neon(uint8x16_t x, uint8x16_t a) {
+    return vcombine_u8(mul255_neon(vget_low_u8(x), vget_low_u8(a)),
+                       mul255_neon(vget_high_u8(x), vget_high_u8(a)));
+}
+
+void premultiply_neon(uint8_t* pixels, size_t count) {
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        uint8x16x4_t v = vld4q_u8(pixels + i * 4);
+        v.val[0] = mul255q_neon(v.val[0], v.val[3]);
+        v.val[1] = mul255q_neon(v.val[1], v.val[3]);
+        v.val[2] = mul255q_neon(v.val[2], v.val[3]);
+        vst4q_u8(pixels + i * 4, v);
+    }
+    premultiply_scalar(pixels + i * 4, count - i);
+}
+
+void swizzle_neon(uint8_t* dst, const uint8_t* src, size_t count) {
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        uint8x16x4_t v = vld4q_u8(src + i * 4);
+        uint8x16_t r = v.val[0];
+        v.val[0] = v.val[2];
+        v.val[2] = r;
+        vst4q_u8(dst + i * 4, v);
+    }
+    swizzle_scalar(dst + i * 4, src + i * 4, count - i);
+}
+
+void fill_neon(uint8_t* pixels, size_t count, uint32_t color) {
+    const uint8x16_t v = vreinterpretq_u8_u32(vdupq_n_u32(color));
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        vst1q_u8(pixels + i * 4, v);
+    }
+    fill_scalar(pixels + i * 4, count - i, color);
+}
+
+void palette_neon(uint8_t* pixels, size_t count,
+                  const uint32_t* from, const uint32_t* to, size_t entries) {
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        uint32x4_t v = vreinterpretq_u32_u8(vld1q_u8(pixels + i * 4));
+        uint32x4_t result = v;
+        uint32x4_t done = vdupq_n_u32(0);
+        for (size_t e = 0; e < entries; ++e) {
+            uint32x4_t match = vbicq_u32(vceqq_u32(v, vdupq_n_u32(from[e])), done);
+            result = vbslq_u32(match, vdupq_n_u32(to[e]), result);
+            done = vorrq_u32(done, match);
+        }
+        vst1q_u8(pixels + i * 4, vreinterpretq_u8_u32(result));
+    }
+    palette_scalar(pixels + i * 4, count - i, from, to, entries);
+}
+
+void blend_neon(uint8_t* dst, const uint8_t* src, size_t count) {
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        uint8x16x4_t s = vld4q_u8(src + i * 4);
+        uint8x16x4_t d = vld4q_u8(dst + i * 4);
+        uint8x16_t a = s.val[3];
+        uint8x16_t inv = vmvnq_u8(a);
+        for (int c = 0; c < 3; ++c) {
+            d.val[c] = vaddq_u8(mul255q_neon(s.val[c], a), mul255q_neon(d.val[c], inv));
+        }
+        d.val[3] = vaddq_u8(a, mul255q_neon(d.val[3], inv));
+        vst4q_u8(dst + i * 4, d);
+    }
+    blend_scalar(dst + i * 4, src + i * 4, count - i);
+}
+
+void box_row_neon(const uint8_t* row0, const uint8_t* row1, uint8_t* dst, int dst_width) {
+    int x = 0;
+    for (; x + 8 <= dst_width; x += 8) {
+        uint8x16x4_t a = vld4q_u8(row0 + x * 8);
+        uint8x16x4_t b = vld4q_u8(row1 + x * 8);
+        uint8x8x4_t out;
+        for (int c = 0; c < 4; ++c) {
+            // Pairwise add neighbours, add the row below, (sum + 2) >> 2
+            uint16x8_t sum = vaddq_u16(vpaddlq_u8(a.val[c]), vpaddlq_u8(b.val[c]));
+            out.val[c] = vrshrn_n_u16(sum, 2);
+        }
+        vst4_u8(dst + x * 4, out);
+    }
+    box_row_scalar(row0 + x * 8, row1 + x * 8, dst + x * 4, dst_width - x);
+}
+
+void bilinear_row_neon(const uint8_t* row0, const uint8_t* row1, int fy,
+                       const BilinearColumns& columns, int dst_width, uint8_t* dst) {
+    const int16x8_t vfy = vdupq_n_s16(static_cast<int16_t>(fy));
+
+    auto load_pair = [](const uint8_t* row, const int32_t* offsets, int x) {
+        uint32_t a;
+        uint32_t b;
+        std::memcpy(&a, row + offsets[x], 4);
+        std::memcpy(&b, row + offsets[x + 1], 4);
+        uint8x8_t pair = vcreate_u8(static_cast<uint64_t>(a) | (static_cast<uint64_t>(b) << 32));
+        return vreinterpretq_s16_u16(vmovl_u8(pair));
+    };
+    auto lerp = [](int16x8_t a, int16x8_t b, int16x8_t f) {
+        return vaddq_s16(a, vshrq_n_s16(vmulq_s16(vsubq_s16(b, a), f), 7));
+    };
+
+    const int32_t* x0 = columns.x0.data();
+    const int32_t* x1 = columns.x1.data();
+    int x = 0;
+    for (; x + 2 <= dst_width; x += 2) {
+        int16x8_t vfx = vcombine_s16(vdup_n_s16(columns.fx[x]), vdup_n_s16(columns.fx[x + 1]));
+        int16x8_t top = lerp(load_pair(row0, x0, x), load_pair(row0, x1, x), vfx);
+        int16x8_t bottom = lerp(load_pair(row1, x0, x), load_pair(row1, x1, x), vfx);
+        vst1_u8(dst + static_cast<size_t>(x) * 4, vqmovun_s16(lerp(top, bottom, vfy)));
+    }
+    bilinear_row_scalar(row0, row1, fy, columns, x, dst_width, dst);
+}
+
+#endif // CAFE_SIMD_NEON
+
+// ============================================================================
+// Dispatch tables
+// ============================================================================
+
+struct Kernels {
+    SimdLevel level;
+    void (*premultiply)(uint8_t*, size_t);
+    void (*swizzle)(uint8_t*, const uint8_t*, size_t);
+    void (*fill)(uint8_t*, size_t, uint32_t);
+    void (*palette)(uint8_t*, size_t, const uint32_t*, const uint32_t*, size_t);
+    void (*blend)(uint8_t*, const uint8_t*, size_t);
+    void (*box_row)(const uint8_t*, const uint8_t*, uint8_t*, int);
+    void (*bilinear_row)(const uint8_t*, const uint8_t*, int, const BilinearColumns&, int, uint8_t*);
+};
+
+const Kernels kScalarKernels = {
+    SimdLevel::Scalar, premultiply_scalar, swizzle_scalar, fill_scalar, palette_scalar,
+    blend_scalar, box_row_scalar, bilinear_row_scalar
+};
+
+#if defined(CAFE_SIMD_SSE2)
+const Kernels kSse2Kernels = {
+    SimdLevel::SSE2, premultiply_sse2, swizzle_sse2, fill_sse2, palette_sse2,
+    blend_sse2, box_row_sse2, bilinear_row_sse2
+};
+#endif
+
+#if defined(CAFE_SIMD_AVX2)
+const Kernels kAvx2Kernels = {
+    SimdLevel::AVX2, premultiply_avx2, swizzle_avx2, fill_avx2, palette_avx2,
+    blend_avx2, box_row_avx2, bilinear_row_sse2
+};
+#endif
+
+#if defined(CAFE_SIMD_NEON)
+const Kernels kNeonKernels = {
+    SimdLevel::NEON, premultiply_neon, swizzle_neon, fill_neon, palette_neon,
+    blend_neon, box_row_neon, bilinear_row_neon
+};
+#endif
+
+// nullptr if this build or CPU cannot run the level
+const Kernels* kernels_for(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::Scalar:
+            return &kScalarKernels;
+#if defined(CAFE_SIMD_SSE2)
+        case SimdLevel::SSE2:
+            return &kSse2Kernels;
+#endif
+#if defined(CAFE_SIMD_AVX2)
+        case SimdLevel::AVX2:
+            return detected_simd_level() == SimdLevel::AVX2 ? &kAvx2Kernels : nullptr;
+#endif
+#if defined(CAFE_SIMD_NEON)
+        case SimdLevel::NEON:
+            return &kNeonKernels;
+#endif
+        default:
+            return nullptr;
+    }
+}
+
+std::atomic<const Kernels*> g_kernels{nullptr};
+
+const Kernels& kernels() {
+    const Kernels* active = g_kernels.load(std::memory_order_acquire);
+    if (!active) {
+        active = kernels_for(detected_simd_level());
+        g_kernels.store(active, std::memory_order_release);
+    }
+    return *active;
+}
+
+bool is_rgba(const Image& image) {
+    if (!image.is_valid() || image.channels() != 4) {
+        std::cerr << "ImageOps: Expected an RGBA image\n";
+        return false;
+    }
+    return true;
+}
+
+size_t pixel_count(const Image& image) {
+    return static_cast<size_t>(image.width()) * static_cast<size_t>(image.height());
+}
+
+} // namespace
+
+// ============================================================================
+// Dispatch
+// ============================================================================
+
+SimdLevel detected_simd_level() {
+    static const SimdLevel level = [] {
+#if defined(CAFE_SIMD_AVX2)
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) {
+            return SimdLevel::AVX2;
+        }
+#endif
+#if defined(CAFE_SIMD_SSE2)
+        return SimdLevel::SSE2;
+#elif defined(CAFE_SIMD_NEON)
+        return SimdLevel::NEON;
+#else
+        return SimdLevel::Scalar;
+#endif
+    }();
+    return level;
+}
+
+SimdLevel simd_level() {
+    return kernels().level;
+}
+
+SimdLevel set_simd_level(SimdLevel level) {
+    const Kernels* selected = kernels_for(level);
+    if (!selected) {
+        selected = kernels_for(detected_simd_level());
+    }
+    g_kernels.store(selected, std::memory_order_release);
+    return selected->level;
+}
+
+const char* simd_level_name(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::Scalar: return "Scalar";
+        case SimdLevel::SSE2: return "SSE2";
+        case SimdLevel::AVX2: return "AVX2";
+        case SimdLevel::NEON: return "NEON";
+    }
+    return "Unknown";
+}
+
+uint32_t rgba(uint8_t r, uint8_t g, uint8_t b, uint8_t a) {
+    const uint8_t bytes[4] = {r, g, b, a};
+    uint32_t color;
+    std::memcpy(&color, bytes, 4);
+    return color;
+}
+
+// ============================================================================
+// Span kernels
+// ============================================================================
+
+void premultiply_alpha(uint8_t* pixels, size_t count) {
+    kernels().premultiply(pixels, count);
+}
+
+void swizzle_rb(uint8_t* dst, const uint8_t* src, size_t count) {
+    kernels().swizzle(dst, src, count);
+}
+
+void fill(uint8_t* pixels, size_t count, uint32_t color) {
+    kernels().fill(pixels, count, color);
+}
+
+void palette_swap(uint8_t* pixels, size_t count,
+                  const uint32_t* from, const uint32_t* to, size_t entries) {
+    if (entries > 0) {
+        kernels().palette(pixels, count, from, to, entries);
+    }
+}
+
+void blend(uint8_t* dst, const uint8_t* src, size_t count) {
+    kernels().blend(dst, src, count);
+}
+
+namespace {
+
+void downscale_box(const uint8_t* src, int width, int height, uint8_t* dst, bool srgb) {
+    int dst_width = std::max(1, width / 2);
+    int dst_height = std::max(1, height / 2);
+    size_t src_stride = static_cast<size_t>(width) * 4;
+
+    const Kernels& k = kernels();
+    auto row_kernel = srgb ? box_row_srgb_scalar : k.box_row;
+
+    if (width >= 2 && height >= 2) {
+        // Both rows and columns pair up exactly (a trailing odd one is dropped)
+        for (int y = 0; y < dst_height; ++y) {
+            const uint8_t* row0 = src + static_cast<size_t>(y) * 2 * src_stride;
+            row_kernel(row0, row0 + src_stride, dst + static_cast<size_t>(y) * dst_width * 4, dst_width);
+        }
+        return;
+    }
+
+    // 1-pixel-wide or tall: the missing neighbour repeats the edge. Each
+    // 2x2 block is gathered into two short rows for the row kernel.
+    uint8_t top[8];
+    uint8_t bottom[8];
+    for (int y = 0; y < dst_height; ++y) {
+        int y0 = std::min(y * 2, height - 1);
+        int y1 = std::min(y * 2 + 1, height - 1);
+        for (int x = 0; x < dst_width; ++x) {
+            int x0 = std::min(x * 2, width - 1);
+            int x1 = std::min(x * 2 + 1, width - 1);
+            std::memcpy(top, src + y0 * src_stride + x0 * 4, 4);
+            std::memcpy(top + 4, src + y0 * src_stride + x1 * 4, 4);
+            std::memcpy(bottom, src + y1 * src_stride + x0 * 4, 4);
+            std::memcpy(bottom + 4, src + y1 * src_stride + x1 * 4, 4);
+            row_kernel(top, bottom, dst + (static_cast<size_t>(y) * dst_width + x) * 4, 1);
+        }
+    }
+}
+
+} // namespace
+
+void downscale_box(const uint8_t* src, int width, int height, uint8_t* dst) {
+    downscale_box(src, width, height, dst, false);
+}
+
+void downscale_box_srgb(const uint8_t* src, int width, int height, uint8_t* dst) {
+    downscale_box(src, width, height, dst, true);
+}
+
+namespace {
+
+// Source position of a destination texel center, in 1/128 pixels,
+// clamped to the image
+int32_t sample_position(int dst, int dst_size, int src_size) {
+    int64_t position = ((2 * static_cast<int64_t>(dst) + 1) * src_size * 128) / (2 * dst_size) - 64;
+    return static_cast<int32_t>(std::clamp<int64_t>(position, 0, (src_size - 1) * int64_t(128)));
+}
+
+} // namespace
+
+void downscale_bilinear(const uint8_t* src, int width, int height,
+                        uint8_t* dst, int dst_width, int dst_height) {
+    if (width <= 0 || height <= 0 || dst_width <= 0 || dst_height <= 0) {
+        return;
+    }
+
+    BilinearColumns columns;
+    columns.x0.resize(dst_width);
+    columns.x1.resize(dst_width);
+    columns.fx.resize(dst_width);
+    for (int x = 0; x < dst_width; ++x) {
+        int32_t position = sample_position(x, dst_width, width);
+        int x0 = position >> 7;
+        columns.x0[x] = x0 * 4;
+        columns.x1[x] = std::min(x0 + 1, width - 1) * 4;
+        columns.fx[x] = static_cast<int16_t>(position & 127);
+    }
+
+    const Kernels& k = kernels();
+    size_t src_stride = static_cast<size_t>(width) * 4;
+    for (int y = 0; y < dst_height; ++y) {
+        int32_t position = sample_position(y, dst_height, height);
+        int y0 = position >> 7;
+        int y1 = std::min(y0 + 1, height - 1);
+        k.bilinear_row(src + y0 * src_stride, src + y1 * src_stride, position & 127, columns,
+                       dst_width, dst + static_cast<size_t>(y) * dst_width * 4);
+    }
+}
+
+// ============================================================================
+// Image helpers
+// ============================================================================
+
+bool premultiply_alpha(Image& image) {
+    if (!is_rgba(image)) return false;
+    premultiply_alpha(image.data(), pixel_count(image));
+    return true;
+}
+
+bool swizzle_rb(Image& image) {
+    if (!is_rgba(image)) return false;
+    swizzle_rb(image.data(), image.data(), pixel_count(image));
+    return true;
+}
+
+bool fill(Image& image, uint32_t color) {
+    if (!is_rgba(image)) return false;
+    fill(image.data(), pixel_count(image), color);
+    return true;
+}
+
+bool palette_swap(Image& image, const Palette& palette) {
+    if (!is_rgba(image)) return false;
+    size_t entries = std::min(palette.from.size(), palette.to.size());
+    palette_swap(image.data(), pixel_count(image), palette.from.data(), palette.to.data(), entries);
+    return true;
+}
+
+bool fill_rect(Image& image, int x, int y, int width, int height, uint32_t color) {
+    if (!is_rgba(image)) return false;
+
+    int x0 = std::max(x, 0);
+    int y0 = std::max(y, 0);
+    int x1 = std::min(x + width, image.width());
+    int y1 = std::min(y + height, image.height());
+    for (int row = y0; row < y1 && x0 < x1; ++row) {
+        fill(image.pixel_at(x0, row), static_cast<size_t>(x1 - x0), color);
+    }
+    return true;
+}
+
+bool blit(Image& dst, const Image& src, int x, int y) {
+    if (!is_rgba(dst) || !is_rgba(src)) return false;
+
+    // Clip the source rectangle to the destination
+    int src_x = std::max(0, -x);
+    int src_y = std::max(0, -y);
+    int dst_x = std::max(0, x);
+    int dst_y = std::max(0, y);
+    int width = std::min(src.width() - src_x, dst.width() - dst_x);
+    int height = std::min(src.height() - src_y, dst.height() - dst_y);
+
+    for (int row = 0; row < height && width > 0; ++row) {
+        blend(dst.pixel_at(dst_x, dst_y + row), src.pixel_at(src_x, src_y + row),
+              static_cast<size_t>(width));
+    }
+    return true;
+}
+
+std::unique_ptr<Image> downscale_box(const Image& image) {
+    if (!is_rgba(image)) return nullptr;
+
+    auto result = Image::create(std::max(1, image.width() / 2), std::max(1, image.height() / 2));
+    if (result) {
+        downscale_box(image.data(), image.width(), image.height(), result->data());
+    }
+    return result;
+}
+
+std::unique_ptr<Image> downscale_bilinear(const Image& image, int width, int height) {
+    if (!is_rgba(image) || width <= 0 || height <= 0) return nullptr;
+
+    auto result = Image::create(width, height);
+    if (result) {
+        downscale_bilinear(image.data(), image.width(), image.height(),
+                           result->data(), width, height);
+    }
+    return result;
+}
+
+} // namespace image_ops
+} // namespace cafe
@@ -0,0 +1,143 @@
+#ifndef CAFE_IMAGE_OPS_H
+#define CAFE_IMAGE_OPS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace cafe {
+
+class Image;
+
+// ============================================================================
+// ImageOps - Bulk pixel kernels for RGBA8 images
+// ============================================================================
+//
+// Image only offers pixel_at()/set_pixel(), which is fine for drawing a
+// few pixels and slow for whole images. These kernels work on spans of
+// RGBA8 pixels and come in several versions:
+//
+//   Scalar   plain C++, always available (and the web build's path)
+//   SSE2     every x86-64 CPU
+//   AVX2     x86-64 CPUs from ~2013 on, 8 pixels per instruction
+//   NEON     every ARM64 CPU (Apple silicon, iOS)
+//
+// The best level the CPU supports is detected on first use and every call
+// goes through a table of function pointers for it. All levels produce
+// bit-identical results, so set_simd_level(SimdLevel::Scalar) is a safe
+// way to rule the SIMD code out when debugging, and benchmarks compare
+// against it.
+//
+// Pixels are 4 bytes in memory order R, G, B, A. A packed uint32_t color
+// (rgba()) holds the same 4 bytes, so it can be compared and stored as a
+// whole pixel.
+//
+// Usage:
+//   image_ops::fill(*image, image_ops::rgba(0, 0, 0, 0));
+//   image_ops::blit(*image, *hat, 12, 4);          // Alpha blended
+//
+//   image_ops::Palette shirt;
+//   shirt.add(image_ops::rgba(200, 40, 40), image_ops::rgba(40, 90, 200));
+//   image_ops::palette_swap(*customer, shirt);     // Red shirt -> blue
+//
+// ============================================================================
+
+enum class SimdLevel : uint8_t {
+    Scalar = 0,
+    SSE2 = 1,
+    AVX2 = 2,
+    NEON = 3
+};
+
+namespace image_ops {
+
+// ========================================================================
+// Dispatch
+// ========================================================================
+
+// Best level this CPU supports
+SimdLevel detected_simd_level();
+
+// Level the kernels currently use
+SimdLevel simd_level();
+
+// Use a lower level (benchmarks, debugging). A level the CPU cannot run
+// falls back to the detected one. Returns the level now in use.
+// Not synchronized with kernels running on other threads.
+SimdLevel set_simd_level(SimdLevel level);
+
+const char* simd_level_name(SimdLevel level);
+
+// Pack a pixel: the 4 bytes R, G, B, A in memory order
+uint32_t rgba(uint8_t r, uint8_t g, uint8_t b, uint8_t a = 255);
+
+// ========================================================================
+// Span kernels (count = pixels, 4 bytes each)
+// ========================================================================
+
+// color = color * alpha / 255 (rounded)
+void premultiply_alpha(uint8_t* pixels, size_t count);
+
+// RGBA <-> BGRA (dst may equal src)
+void swizzle_rb(uint8_t* dst, const uint8_t* src, size_t count);
+
+void fill(uint8_t* pixels, size_t count, uint32_t color);
+
+// Replace every pixel equal to from[i] with to[i] (first match wins)
+void palette_swap(uint8_t* pixels, size_t count,
+                  const uint32_t* from, const uint32_t* to, size_t entries);
+
+// Draw src over dst (straight alpha): color = src * a + dst * (1 - a),
+// alpha = a + dst_alpha * (1 - a). Exact "over" for opaque destinations.
+void blend(uint8_t* dst, const uint8_t* src, size_t count);
+
+// 2x2 box filter to max(1, width / 2) x max(1, height / 2), the mipmap
+// convention (odd edges repeat the last row/column)
+void downscale_box(const uint8_t* src, int width, int height, uint8_t* dst);
+
+// Same, averaging the color channels in linear light. Art is authored in
+// sRGB, where a plain average comes out too dark (a black and white
+// checkerboard averages to 128, which displays as ~22% brightness rather
+// than 50%), so mipmaps built this way keep their brightness when zoomed
+// out. Alpha is coverage and is averaged as is.
+void downscale_box_srgb(const uint8_t* src, int width, int height, uint8_t* dst);
+
+// Bilinear resample to any smaller (or larger) size, texel centers aligned
+void downscale_bilinear(const uint8_t* src, int width, int height,
+                        uint8_t* dst, int dst_width, int dst_height);
+
+// ========================================================================
+// Image helpers (RGBA images only; others are rejected)
+// ========================================================================
+
+// Color replacements for palette_swap()
+struct Palette {
+    std::vector<uint32_t> from;
+    std::vector<uint32_t> to;
+
+    void add(uint32_t from_color, uint32_t to_color) {
+        from.push_back(from_color);
+        to.push_back(to_color);
+    }
+    size_t size() const { return from.size(); }
+};
+
+bool premultiply_alpha(Image& image);
+bool swizzle_rb(Image& image);
+bool fill(Image& image, uint32_t color);
+bool palette_swap(Image& image, const Palette& palette);
+
+// Fill / blend a rectangle, clipped to the image
+bool fill_rect(Image& image, int x, int y, int width, int height, uint32_t color);
+bool blit(Image& dst, const Image& src, int x, int y);
+
+// New, smaller images (nullptr if the source is not RGBA)
+std::unique_ptr<Image> downscale_box(const Image& image);
+std::unique_ptr<Image> downscale_bilinear(const Image& image, int width, int height);
+
+} // namespace image_ops
+
+} // namespace cafe
+
+#endif // CAFE_IMAGE_OPS_H
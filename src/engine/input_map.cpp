@@ -1,4 +1,5 @@
 #include "input_map.h"
+#include <algorithm>
 #include <cmath>
 
 namespace cafe {
@@ -7,27 +8,81 @@ namespace cafe {
 // Action Management
 // ============================================================================
 
+namespace {
+
+void set_bit(std::vector<uint64_t>& bits, ActionID id, bool value) {
+    const uint64_t mask = uint64_t{1} << (id % 64);
+    if (value) {
+        bits[id / 64] |= mask;
+    } else {
+        bits[id / 64] &= ~mask;
+    }
+}
+
+} // namespace
+
 InputAction& InputMap::define_action(const std::string& name) {
-    auto& action = actions_[name];
-    action.name = name;
-    return action;
+    auto it = action_ids_.find(name);
+    dirty_ = true;  // The caller may edit the bindings through the reference
+    if (it != action_ids_.end()) {
+        return actions_[it->second];
+    }
+
+    if (actions_.empty()) {
+        actions_.emplace_back();  // Slot 0 is INVALID_ACTION
+    }
+
+    ActionID id;
+    if (!free_ids_.empty()) {
+        id = free_ids_.back();
+        free_ids_.pop_back();
+        actions_[id] = InputAction(name);
+    } else {
+        id = static_cast<ActionID>(actions_.size());
+        actions_.emplace_back(name);
+    }
+    action_ids_.emplace(name, id);
+
+    if (pressed_callbacks_.size() < actions_.size()) {
+        pressed_callbacks_.resize(actions_.size());
+        released_callbacks_.resize(actions_.size());
+    }
+    return actions_[id];
 }
 
 InputAction* InputMap::get_action(const std::string& name) {
-    auto it = actions_.find(name);
-    return it != actions_.end() ? &it->second : nullptr;
+    ActionID id = action_id(name);
+    if (id == INVALID_ACTION) return nullptr;
+    dirty_ = true;
+    return &actions_[id];
 }
 
 const InputAction* InputMap::get_action(const std::string& name) const {
-    auto it = actions_.find(name);
-    return it != actions_.end() ? &it->second : nullptr;
+    ActionID id = action_id(name);
+    return id != INVALID_ACTION ? &actions_[id] : nullptr;
 }
 
 void InputMap::remove_action(const std::string& name) {
-    actions_.erase(name);
-    pressed_callbacks_.erase(name);
-    released_callbacks_.erase(name);
-    prev_action_state_.erase(name);
+    auto it = action_ids_.find(name);
+    if (it == action_ids_.end()) return;
+
+    ActionID id = it->second;
+    action_ids_.erase(it);
+    actions_[id] = InputAction();
+    pressed_callbacks_[id].clear();
+    released_callbacks_[id].clear();
+    if (id / 64 < held_.size()) {
+        set_bit(held_, id, false);
+        set_bit(pressed_, id, false);
+        set_bit(released_, id, false);
+    }
+    free_ids_.push_back(id);
+    dirty_ = true;
+}
+
+ActionID InputMap::action_id(const std::string& name) const {
+    auto it = action_ids_.find(name);
+    return it != action_ids_.end() ? it->second : INVALID_ACTION;
 }
 
 // ============================================================================
@@ -58,72 +113,16 @@ void InputMap::remove_axis(const std::string& name) {
 // Input Queries
 // ============================================================================
 
-bool InputMap::is_binding_active(const InputBinding& binding) const {
-    if (!window_) return false;
-
-    if (binding.is_mouse) {
-        return window_->is_mouse_button_down(binding.mouse_button);
-    } else {
-        return window_->is_key_down(binding.key);
-    }
-}
-
-bool InputMap::was_binding_just_pressed(const InputBinding& binding) const {
-    if (!window_) return false;
-
-    if (binding.is_mouse) {
-        // Note: Window doesn't have is_mouse_button_pressed yet
-        // For now, just use is_mouse_button_down
-        return window_->is_mouse_button_down(binding.mouse_button);
-    } else {
-        return window_->is_key_pressed(binding.key);
-    }
-}
-
-bool InputMap::was_binding_just_released(const InputBinding& binding) const {
-    if (!window_) return false;
-
-    if (binding.is_mouse) {
-        return false;  // Not implemented
-    } else {
-        return window_->is_key_released(binding.key);
-    }
-}
-
 bool InputMap::is_action_held(const std::string& name) const {
-    const InputAction* action = get_action(name);
-    if (!action) return false;
-
-    for (const auto& binding : action->bindings) {
-        if (is_binding_active(binding)) {
-            return true;
-        }
-    }
-    return false;
+    return is_action_held(action_id(name));
 }
 
 bool InputMap::is_action_pressed(const std::string& name) const {
-    const InputAction* action = get_action(name);
-    if (!action) return false;
-
-    for (const auto& binding : action->bindings) {
-        if (was_binding_just_pressed(binding)) {
-            return true;
-        }
-    }
-    return false;
+    return is_action_pressed(action_id(name));
 }
 
 bool InputMap::is_action_released(const std::string& name) const {
-    const InputAction* action = get_action(name);
-    if (!action) return false;
-
-    for (const auto& binding : action->bindings) {
-        if (was_binding_just_released(binding)) {
-            return true;
-        }
-    }
-    return false;
+    return is_action_released(action_id(name));
 }
 
 float InputMap::get_axis_value(const std::string& name) const {
@@ -229,40 +228,163 @@ void InputMap::add_standard_movement() {
 // ============================================================================
 
 void InputMap::on_action_pressed(const std::string& name, ActionCallback callback) {
-    pressed_callbacks_[name].push_back(std::move(callback));
+    ActionID id = action_id(name);
+    if (id == INVALID_ACTION) {
+        define_action(name);
+        id = action_id(name);
+    }
+    pressed_callbacks_[id].push_back(std::move(callback));
 }
 
 void InputMap::on_action_released(const std::string& name, ActionCallback callback) {
-    released_callbacks_[name].push_back(std::move(callback));
+    ActionID id = action_id(name);
+    if (id == INVALID_ACTION) {
+        define_action(name);
+        id = action_id(name);
+    }
+    released_callbacks_[id].push_back(std::move(callback));
 }
 
-void InputMap::update() {
-    // Check for action state changes and fire callbacks
-    for (const auto& [name, action] : actions_) {
-        bool current_state = is_action_held(name);
-        bool prev_state = prev_action_state_[name];
-
-        // Just pressed
-        if (current_state && !prev_state) {
-            auto it = pressed_callbacks_.find(name);
-            if (it != pressed_callbacks_.end()) {
-                for (const auto& callback : it->second) {
-                    callback();
-                }
+// ============================================================================
+// Compiled Update
+// ============================================================================
+
+int InputMap::input_index(const InputBinding& binding) {
+    if (binding.is_mouse) {
+        return static_cast<int>(Key::KeyCount) + static_cast<int>(binding.mouse_button);
+    }
+    return binding.key != Key::Unknown ? static_cast<int>(binding.key) : -1;
+}
+
+void InputMap::compile() {
+    const size_t count = actions_.size();
+
+    // Action -> inputs (a key bound twice counts once)
+    binding_offsets_.assign(count + 1, 0);
+    bindings_.clear();
+    input_action_offsets_.assign(INPUT_COUNT + 1, 0);
+    for (size_t id = 0; id < count; ++id) {
+        const size_t first = bindings_.size();
+        binding_offsets_[id] = static_cast<uint32_t>(first);
+        for (const InputBinding& binding : actions_[id].bindings) {
+            int input = input_index(binding);
+            if (input < 0) continue;
+            bool seen = false;
+            for (size_t i = first; i < bindings_.size(); ++i) {
+                seen = seen || bindings_[i] == input;
             }
+            if (seen) continue;
+            bindings_.push_back(static_cast<uint16_t>(input));
+            ++input_action_offsets_[input + 1];
+        }
+    }
+    binding_offsets_[count] = static_cast<uint32_t>(bindings_.size());
+
+    // Input -> actions: count per input (above), prefix sum, then scatter
+    for (int input = 0; input < INPUT_COUNT; ++input) {
+        input_action_offsets_[input + 1] += input_action_offsets_[input];
+    }
+    input_actions_.resize(bindings_.size());
+    std::vector<uint32_t> cursor(input_action_offsets_.begin(), input_action_offsets_.end() - 1);
+    for (size_t id = 0; id < count; ++id) {
+        for (uint32_t i = binding_offsets_[id]; i < binding_offsets_[id + 1]; ++i) {
+            input_actions_[cursor[bindings_[i]]++] = static_cast<ActionID>(id);
+        }
+    }
+
+    const size_t words = (count + 63) / 64;
+    held_.resize(words, 0);
+    pressed_.resize(words, 0);
+    released_.resize(words, 0);
+
+    dirty_ = false;
+}
+
+void InputMap::evaluate(ActionID id) {
+    bool held = false;
+    bool tapped = false;
+    for (uint32_t i = binding_offsets_[id]; i < binding_offsets_[id + 1]; ++i) {
+        held = held || inputs_down_.test(bindings_[i]);
+        tapped = tapped || inputs_pressed_.test(bindings_[i]);
+    }
+
+    const bool was_held = test(held_, id);
+    if (held == was_held) {
+        // Pressed and released between two updates: both edges, no hold
+        if (held || !tapped) return;
+        set_bit(pressed_, id, true);
+        set_bit(released_, id, true);
+        changed_.push_back(id);
+        return;
+    }
+
+    set_bit(held_, id, held);
+    set_bit(held ? pressed_ : released_, id, true);
+    changed_.push_back(id);
+}
+
+void InputMap::fire(const std::vector<std::vector<ActionCallback>>& callbacks, ActionID id) {
+    if (callbacks[id].empty()) return;
+
+    // A copy: a callback may register callbacks, which can reallocate the
+    // list (and destroy the std::function that is running)
+    const std::vector<ActionCallback> listeners = callbacks[id];
+    for (const ActionCallback& callback : listeners) {
+        callback();
+    }
+}
+
+void InputMap::update() {
+    const bool recompiled = dirty_;
+    if (dirty_) {
+        compile();
+    }
+
+    // Edges only last one frame
+    std::fill(pressed_.begin(), pressed_.end(), 0);
+    std::fill(released_.begin(), released_.end(), 0);
+    changed_.clear();
+
+    // Snapshot every key and button once, with the key edges the window
+    // saw: a key pressed and released within one frame is never down here
+    InputBits down;
+    InputBits edges;
+    inputs_pressed_.reset();
+    if (window_) {
+        for (int key = 1; key < static_cast<int>(Key::KeyCount); ++key) {
+            Key k = static_cast<Key>(key);
+            down[key] = window_->is_key_down(k);
+            inputs_pressed_[key] = window_->is_key_pressed(k);
+            edges[key] = inputs_pressed_[key] || window_->is_key_released(k);
+        }
+        for (int button = 0; button < static_cast<int>(MouseButton::ButtonCount); ++button) {
+            down[static_cast<int>(Key::KeyCount) + button] =
+                window_->is_mouse_button_down(static_cast<MouseButton>(button));
         }
+    }
+    const InputBits changed = (down ^ inputs_down_) | edges;
+    inputs_down_ = down;
 
-        // Just released
-        if (!current_state && prev_state) {
-            auto it = released_callbacks_.find(name);
-            if (it != released_callbacks_.end()) {
-                for (const auto& callback : it->second) {
-                    callback();
-                }
+    if (recompiled) {
+        // Bindings may have changed anywhere: evaluate everything once
+        for (ActionID id = 1; id < actions_.size(); ++id) {
+            evaluate(id);
+        }
+    } else if (changed.any()) {
+        // Only the actions bound to an input that changed
+        for (int input = 0; input < INPUT_COUNT; ++input) {
+            if (!changed.test(input)) continue;
+            for (uint32_t i = input_action_offsets_[input]; i < input_action_offsets_[input + 1]; ++i) {
+                evaluate(input_actions_[i]);
             }
         }
+    }
 
-        prev_action_state_[name] = current_state;
+    // Callbacks last, so they see this frame's state
+    for (size_t i = 0; i < changed_.size(); ++i) {
+        ActionID id = changed_[i];
+        if (test(pressed_, id)) fire(pressed_callbacks_, id);
+        if (test(released_, id)) fire(released_callbacks_, id);
     }
 }
 
@@ -3,6 +3,9 @@
 
 #include "../platform/platform.h"
 #include "../renderer/renderer.h"  // For Vec2
+#include <bitset>
+#include <cstdint>
+#include <deque>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -10,6 +13,10 @@
 
 namespace cafe {
 
+// Dense index of a defined action (stable until the action is removed)
+using ActionID = uint32_t;
+constexpr ActionID INVALID_ACTION = 0;
+
 // ============================================================================
 // Input Action - Named input that can be triggered by multiple keys/buttons
 // ============================================================================
@@ -74,6 +81,34 @@ struct InputAxis {
 // ============================================================================
 // Input Map - Manages actions and axes
 // ============================================================================
+//
+// Actions are compiled into flat tables the first update() after they
+// change:
+//
+//   bindings_       each action's inputs, back to back (an input is a key,
+//                   or KeyCount + mouse button)
+//   input_actions_  the reverse: each input's actions, back to back
+//
+// update() reads every key and button once into a bitset and compares it
+// with the last frame's. Only the actions bound to an input that changed
+// are evaluated again, so a frame where nothing was touched costs the
+// same with 5 actions or 500. Held, pressed and released states are
+// bitsets indexed by ActionID, and queries read one bit.
+//
+// Key edges come from the window too: a key pressed and released between
+// two updates (a tap shorter than a frame) is never seen down, but its
+// actions still report pressed and released that frame, and fire both
+// callbacks, without being held.
+//
+// Queries report the state as of the last update(): call it once per
+// frame, after Platform::poll_events(). Look an ActionID up once, at
+// setup, to skip the name hash on every query:
+//
+//   ActionID jump = input.action_id("jump");
+//   ...
+//   if (input.is_action_pressed(jump)) { ... }
+//
+// ============================================================================
 
 class InputMap {
 public:
@@ -96,6 +131,10 @@ public:
     // Remove action
     void remove_action(const std::string& name);
 
+    // ID of a defined action (INVALID_ACTION if not found)
+    ActionID action_id(const std::string& name) const;
+    size_t action_count() const { return action_ids_.size(); }
+
     // ========================================================================
     // Axis Management
     // ========================================================================
@@ -116,12 +155,15 @@ public:
 
     // Check if action is currently held
     bool is_action_held(const std::string& name) const;
+    bool is_action_held(ActionID id) const { return test(held_, id); }
 
     // Check if action was just pressed this frame
     bool is_action_pressed(const std::string& name) const;
+    bool is_action_pressed(ActionID id) const { return test(pressed_, id); }
 
     // Check if action was just released this frame
     bool is_action_released(const std::string& name) const;
+    bool is_action_released(ActionID id) const { return test(released_, id); }
 
     // Get axis value (-1.0 to 1.0)
     float get_axis_value(const std::string& name) const;
@@ -153,12 +195,13 @@ public:
     // Callbacks
     // ========================================================================
 
-    // Register callback for when action is pressed
+    // Register callback for when action is pressed (defines the action
+    // if it does not exist yet)
     using ActionCallback = std::function<void()>;
     void on_action_pressed(const std::string& name, ActionCallback callback);
     void on_action_released(const std::string& name, ActionCallback callback);
 
-    // Update (call each frame to trigger callbacks)
+    // Update action states and fire callbacks (call once per frame)
     void update();
 
     // ========================================================================
@@ -168,22 +211,53 @@ public:
     // TODO: Add save/load functionality for user preferences
 
 private:
-    Window* window_ = nullptr;
+    static constexpr int INPUT_COUNT =
+        static_cast<int>(Key::KeyCount) + static_cast<int>(MouseButton::ButtonCount);
+    using InputBits = std::bitset<INPUT_COUNT>;
 
-    std::unordered_map<std::string, InputAction> actions_;
-    std::unordered_map<std::string, InputAxis> axes_;
+    static bool test(const std::vector<uint64_t>& bits, ActionID id) {
+        return id / 64 < bits.size() && ((bits[id / 64] >> (id % 64)) & 1) != 0;
+    }
 
-    // Callbacks
-    std::unordered_map<std::string, std::vector<ActionCallback>> pressed_callbacks_;
-    std::unordered_map<std::string, std::vector<ActionCallback>> released_callbacks_;
+    // Key, or KeyCount + mouse button (-1 for Key::Unknown)
+    static int input_index(const InputBinding& binding);
+
+    // Rebuild the binding tables and size the state bitsets
+    void compile();
+    // Evaluate one action against inputs_down_ and inputs_pressed_;
+    // record an edge in pressed_ / released_ / changed_
+    void evaluate(ActionID id);
+    void fire(const std::vector<std::vector<ActionCallback>>& callbacks, ActionID id);
 
-    // Previous frame state for press/release detection
-    std::unordered_map<std::string, bool> prev_action_state_;
+    Window* window_ = nullptr;
+
+    // Action definitions, indexed by ActionID (slot 0 unused). A deque so
+    // references from define_action() survive later definitions.
+    std::deque<InputAction> actions_;
+    std::unordered_map<std::string, ActionID> action_ids_;
+    std::vector<ActionID> free_ids_;
+    std::unordered_map<std::string, InputAxis> axes_;
 
-    // Helper to check if a binding is active
-    bool is_binding_active(const InputBinding& binding) const;
-    bool was_binding_just_pressed(const InputBinding& binding) const;
-    bool was_binding_just_released(const InputBinding& binding) const;
+    // Callbacks, indexed by ActionID
+    std::vector<std::vector<ActionCallback>> pressed_callbacks_;
+    std::vector<std::vector<ActionCallback>> released_callbacks_;
+
+    // Compiled tables (CSR: the entries of row i are [offsets[i], offsets[i + 1]))
+    // Rebuilt when definitions may have changed: define_action() and
+    // get_action() hand out references the caller may edit
+    bool dirty_ = true;
+    std::vector<uint32_t> binding_offsets_;        // Per action
+    std::vector<uint16_t> bindings_;               // Input indices
+    std::vector<uint32_t> input_action_offsets_;   // Per input
+    std::vector<ActionID> input_actions_;
+
+    // State
+    InputBits inputs_down_;
+    InputBits inputs_pressed_;                     // Key press edges this frame
+    std::vector<uint64_t> held_;
+    std::vector<uint64_t> pressed_;                // This frame only
+    std::vector<uint64_t> released_;
+    std::vector<ActionID> changed_;                // Edges to fire callbacks for
 };
 
 } // namespace cafe
@@ -0,0 +1,353 @@
+#include "input_recorder.h"
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+namespace cafe {
+
+// ============================================================================
+// File Format
+// ============================================================================
+
+namespace {
+
+constexpr char kInputMagic[4] = {'C', 'I', 'N', 'P'};
+
+struct InputHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t step_count;
+    float fixed_dt;
+    int32_t width;
+    int32_t height;
+    uint32_t data_bytes;            // Encoded steps after the header
+    uint32_t reserved;
+};
+static_assert(sizeof(InputHeader) == 32, "input log header must be 32 bytes");
+
+// Step flags
+constexpr uint8_t kStepKeys = 1 << 0;
+constexpr uint8_t kStepButtons = 1 << 1;
+constexpr uint8_t kStepMouse = 1 << 2;
+constexpr uint8_t kStepEdges = 1 << 3;
+constexpr uint8_t kStepIdle = 1 << 4;
+
+// Edge record bits
+constexpr uint8_t kEdgePressed = 1 << 0;
+constexpr uint8_t kEdgeReleased = 1 << 1;
+
+void put_varint(std::vector<uint8_t>& out, uint32_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+void put_float(std::vector<uint8_t>& out, float value) {
+    uint8_t bytes[4];
+    std::memcpy(bytes, &value, 4);
+    out.insert(out.end(), bytes, bytes + 4);
+}
+
+bool same_bits(float a, float b) {
+    return std::memcmp(&a, &b, sizeof(float)) == 0;
+}
+
+// Bounds-checked reads; false once the data runs out
+struct Reader {
+    const std::vector<uint8_t>& data;
+    size_t& cursor;
+
+    bool byte(uint8_t& value) {
+        if (cursor >= data.size()) return false;
+        value = data[cursor++];
+        return true;
+    }
+
+    bool varint(uint32_t& value) {
+        value = 0;
+        for (int shift = 0; shift < 35; shift += 7) {
+            uint8_t b;
+            if (!byte(b)) return false;
+            value |= static_cast<uint32_t>(b & 0x7F) << shift;
+            if ((b & 0x80) == 0) return true;
+        }
+        return false;
+    }
+
+    bool real(float& value) {
+        if (data.size() - cursor < 4) return false;
+        std::memcpy(&value, data.data() + cursor, 4);
+        cursor += 4;
+        return true;
+    }
+};
+
+} // namespace
+
+// ============================================================================
+// InputSnapshot
+// ============================================================================
+
+void InputSnapshot::capture(const Window& window) {
+    for (int key = 1; key < KEY_COUNT; ++key) {
+        Key k = static_cast<Key>(key);
+        down[key] = window.is_key_down(k);
+        pressed[key] = window.is_key_pressed(k);
+        released[key] = window.is_key_released(k);
+    }
+    buttons = 0;
+    for (int button = 0; button < static_cast<int>(MouseButton::ButtonCount); ++button) {
+        if (window.is_mouse_button_down(static_cast<MouseButton>(button))) {
+            buttons |= static_cast<uint8_t>(1 << button);
+        }
+    }
+    mouse_x = window.mouse_x();
+    mouse_y = window.mouse_y();
+}
+
+// ============================================================================
+// InputRecorder
+// ============================================================================
+
+void InputRecorder::begin(float fixed_dt, int width, int height) {
+    data_.clear();
+    last_ = InputSnapshot();
+    step_count_ = 0;
+    idle_run_ = 0;
+    fixed_dt_ = fixed_dt;
+    width_ = width;
+    height_ = height;
+}
+
+void InputRecorder::capture(const Window& window) {
+    InputSnapshot snapshot;
+    snapshot.capture(window);
+    capture(snapshot);
+}
+
+void InputRecorder::capture(const InputSnapshot& snapshot) {
+    ++step_count_;
+
+    // Edges the down flips imply; only the exceptions are stored
+    const auto flips = snapshot.down ^ last_.down;
+    const auto edges = (snapshot.pressed ^ (flips & snapshot.down)) |
+                       (snapshot.released ^ (flips & ~snapshot.down));
+    const bool moved = !same_bits(snapshot.mouse_x, last_.mouse_x) ||
+                       !same_bits(snapshot.mouse_y, last_.mouse_y);
+
+    uint8_t flags = 0;
+    if (flips.any()) flags |= kStepKeys;
+    if (snapshot.buttons != last_.buttons) flags |= kStepButtons;
+    if (moved) flags |= kStepMouse;
+    if (edges.any()) flags |= kStepEdges;
+
+    last_ = snapshot;
+    if (flags == 0) {
+        ++idle_run_;
+        return;
+    }
+
+    flush_idle();
+    data_.push_back(flags);
+    if (flags & kStepKeys) {
+        data_.push_back(static_cast<uint8_t>(flips.count()));
+        for (int key = 0; key < InputSnapshot::KEY_COUNT; ++key) {
+            if (flips[key]) data_.push_back(static_cast<uint8_t>(key));
+        }
+    }
+    if (flags & kStepButtons) {
+        data_.push_back(snapshot.buttons);
+    }
+    if (flags & kStepMouse) {
+        put_float(data_, snapshot.mouse_x);
+        put_float(data_, snapshot.mouse_y);
+    }
+    if (flags & kStepEdges) {
+        data_.push_back(static_cast<uint8_t>(edges.count()));
+        for (int key = 0; key < InputSnapshot::KEY_COUNT; ++key) {
+            if (!edges[key]) continue;
+            data_.push_back(static_cast<uint8_t>(key));
+            data_.push_back(static_cast<uint8_t>((snapshot.pressed[key] ? kEdgePressed : 0) |
+                                                 (snapshot.released[key] ? kEdgeReleased : 0)));
+        }
+    }
+}
+
+void InputRecorder::flush_idle() {
+    if (idle_run_ == 0) return;
+    data_.push_back(kStepIdle);
+    put_varint(data_, idle_run_);
+    idle_run_ = 0;
+}
+
+bool InputRecorder::save(const std::string& path) {
+    flush_idle();
+
+    InputHeader header;
+    std::memcpy(header.magic, kInputMagic, 4);
+    header.version = VERSION;
+    header.step_count = step_count_;
+    header.fixed_dt = fixed_dt_;
+    header.width = width_;
+    header.height = height_;
+    header.data_bytes = static_cast<uint32_t>(data_.size());
+    header.reserved = 0;
+
+    FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        std::cerr << "InputRecorder: Failed to create file: " << path << "\n";
+        return false;
+    }
+    bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1;
+    ok = ok && (data_.empty() || std::fwrite(data_.data(), 1, data_.size(), file) == data_.size());
+    ok = (std::fclose(file) == 0) && ok;
+
+    if (!ok) {
+        std::cerr << "InputRecorder: Failed to write file: " << path << "\n";
+        std::remove(path.c_str());
+    }
+    return ok;
+}
+
+// ============================================================================
+// ReplayWindow
+// ============================================================================
+
+bool ReplayWindow::open(const std::string& path) {
+    FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) {
+        std::cerr << "ReplayWindow: Failed to open file: " << path << "\n";
+        return false;
+    }
+
+    std::vector<uint8_t> bytes;
+    uint8_t chunk[4096];
+    size_t n;
+    while ((n = std::fread(chunk, 1, sizeof(chunk), file)) > 0) {
+        bytes.insert(bytes.end(), chunk, chunk + n);
+    }
+    std::fclose(file);
+
+    if (!open(std::move(bytes))) {
+        std::cerr << "ReplayWindow: Not a valid input log: " << path << "\n";
+        return false;
+    }
+    return true;
+}
+
+bool ReplayWindow::open(std::vector<uint8_t> bytes) {
+    data_.clear();
+    step_count_ = 0;
+
+    InputHeader header;
+    if (bytes.size() < sizeof(header)) return false;
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    if (std::memcmp(header.magic, kInputMagic, 4) != 0 ||
+        header.version != InputRecorder::VERSION ||
+        header.data_bytes != bytes.size() - sizeof(header) ||
+        !(header.fixed_dt > 0.0f)) {
+        return false;
+    }
+
+    data_ = std::move(bytes);
+    steps_offset_ = sizeof(header);
+    step_count_ = header.step_count;
+    fixed_dt_ = header.fixed_dt;
+    width_ = header.width;
+    height_ = header.height;
+    rewind();
+    return true;
+}
+
+void ReplayWindow::rewind() {
+    cursor_ = steps_offset_;
+    current_ = InputSnapshot();
+    idle_left_ = 0;
+    step_ = 0;
+    closed_ = false;
+    if (step_count_ > 0 && !decode_step()) {
+        std::cerr << "ReplayWindow: Corrupt input log at step 0\n";
+        step_count_ = 0;
+    }
+}
+
+void ReplayWindow::update_input() {
+    if (step_ >= step_count_) return;
+    ++step_;
+    if (step_ < step_count_ && !decode_step()) {
+        std::cerr << "ReplayWindow: Corrupt input log at step " << step_ << "\n";
+        step_count_ = step_;  // Stop here
+    }
+}
+
+bool ReplayWindow::decode_step() {
+    // Edges last one step
+    current_.pressed.reset();
+    current_.released.reset();
+
+    if (idle_left_ > 0) {
+        --idle_left_;
+        return true;
+    }
+
+    Reader in{data_, cursor_};
+    uint8_t flags;
+    if (!in.byte(flags)) return false;
+
+    if (flags & kStepIdle) {
+        uint32_t run;
+        if (!in.varint(run) || run == 0) return false;
+        idle_left_ = run - 1;
+        return true;
+    }
+
+    if (flags & kStepKeys) {
+        uint8_t count;
+        if (!in.byte(count)) return false;
+        for (uint8_t i = 0; i < count; ++i) {
+            uint8_t key;
+            if (!in.byte(key) || key >= InputSnapshot::KEY_COUNT) return false;
+            current_.down.flip(key);
+            (current_.down[key] ? current_.pressed : current_.released).set(key);
+        }
+    }
+    if ((flags & kStepButtons) && !in.byte(current_.buttons)) return false;
+    if ((flags & kStepMouse) && !(in.real(current_.mouse_x) && in.real(current_.mouse_y))) {
+        return false;
+    }
+    if (flags & kStepEdges) {
+        uint8_t count;
+        if (!in.byte(count)) return false;
+        for (uint8_t i = 0; i < count; ++i) {
+            uint8_t key, bits;
+            if (!in.byte(key) || !in.byte(bits) || key >= InputSnapshot::KEY_COUNT) return false;
+            current_.pressed[key] = (bits & kEdgePressed) != 0;
+            current_.released[key] = (bits & kEdgeReleased) != 0;
+        }
+    }
+    return true;
+}
+
+bool ReplayWindow::is_key_down(Key key) const {
+    int index = static_cast<int>(key);
+    return index >= 0 && index < InputSnapshot::KEY_COUNT && current_.down[index];
+}
+
+bool ReplayWindow::is_key_pressed(Key key) const {
+    int index = static_cast<int>(key);
+    return index >= 0 && index < InputSnapshot::KEY_COUNT && current_.pressed[index];
+}
+
+bool ReplayWindow::is_key_released(Key key) const {
+    int index = static_cast<int>(key);
+    return index >= 0 && index < InputSnapshot::KEY_COUNT && current_.released[index];
+}
+
+bool ReplayWindow::is_mouse_button_down(MouseButton button) const {
+    int index = static_cast<int>(button);
+    return index >= 0 && index < 8 && (current_.buttons >> index) & 1;
+}
+
+} // namespace cafe
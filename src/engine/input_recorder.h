@@ -0,0 +1,156 @@
+#ifndef CAFE_INPUT_RECORDER_H
+#define CAFE_INPUT_RECORDER_H
+
+#include "../platform/platform.h"
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace cafe {
+
+// ============================================================================
+// Input Recording and Replay (.cinput)
+// ============================================================================
+//
+// A Window answers input queries from live OS state, so a play session
+// can't be run twice. InputRecorder captures what the game saw at every
+// fixed step; ReplayWindow plays it back as a Window with no OS behind
+// it. With GameLoop's lockstep mode the replay runs one step per loop
+// iteration, as fast as the CPU allows, and every run sees exactly the
+// same input: an A/B profile of a heavy session, or a regression run.
+//
+// Steps are delta-encoded against the previous one (little-endian):
+//
+//   Header   magic "CINP", version, step count, fixed dt, window size
+//   Steps    one flags byte, then only what changed:
+//              KEYS     key count, indices whose down state flipped
+//              BUTTONS  new mouse button mask
+//              MOUSE    x, y (raw floats: replays match bit for bit)
+//              EDGES    keys whose pressed/released flags are not what
+//                       the down flips imply (tapped within one step)
+//              IDLE     count of unchanged steps
+//
+// A step where nothing changed costs nothing on its own: runs of them
+// share one IDLE record (a minute of idle at 60 Hz is 3 bytes).
+//
+// Usage:
+//   InputRecorder recorder;
+//   recorder.begin(loop.fixed_delta_time(), window->width(), window->height());
+//   loop.set_input_recorder(&recorder);  // Captures before each update
+//   loop.run();
+//   recorder.save("session.cinput");
+//
+//   ReplayWindow replay;
+//   replay.open("session.cinput");
+//   GameLoop loop(nullptr, &replay);
+//   loop.set_lockstep(true);              // No wall clock, one step per frame
+//   loop.run();                           // Ends when the log does
+//
+// ============================================================================
+
+// Input state at one fixed step
+struct InputSnapshot {
+    static constexpr int KEY_COUNT = static_cast<int>(Key::KeyCount);
+
+    std::bitset<KEY_COUNT> down;
+    std::bitset<KEY_COUNT> pressed;     // Just pressed this step
+    std::bitset<KEY_COUNT> released;    // Just released this step
+    uint8_t buttons = 0;                // Bit per MouseButton
+    float mouse_x = 0.0f;
+    float mouse_y = 0.0f;
+
+    // Read everything a Window reports
+    void capture(const Window& window);
+};
+
+class InputRecorder {
+public:
+    static constexpr uint32_t VERSION = 1;
+    static constexpr const char* EXTENSION = ".cinput";
+
+    // Start a new log (discards the current one)
+    void begin(float fixed_dt, int width, int height);
+
+    // Record the window's input for the next fixed step
+    void capture(const Window& window);
+    void capture(const InputSnapshot& snapshot);
+
+    bool save(const std::string& path);
+
+    uint32_t step_count() const { return step_count_; }
+    size_t byte_size() const { return data_.size() + (idle_run_ > 0 ? 6 : 0); }
+
+private:
+    void flush_idle();
+
+    std::vector<uint8_t> data_;     // Encoded steps
+    InputSnapshot last_;
+    uint32_t step_count_ = 0;
+    uint32_t idle_run_ = 0;         // Unchanged steps not yet written
+    float fixed_dt_ = 1.0f / 60.0f;
+    int32_t width_ = 0;
+    int32_t height_ = 0;
+};
+
+// ============================================================================
+// ReplayWindow - A Window that plays back a recorded log
+// ============================================================================
+//
+// The first step is current after open(); update_input() (called by
+// GameLoop after each fixed update) moves to the next. is_open() turns
+// false after the last step, which ends GameLoop::run().
+
+class ReplayWindow : public Window {
+public:
+    bool open(const std::string& path);
+
+    // Decode from memory (the bytes a .cinput file holds)
+    bool open(std::vector<uint8_t> bytes);
+
+    // Back to the first step
+    void rewind();
+
+    uint32_t step() const { return step_; }
+    uint32_t step_count() const { return step_count_; }
+    float fixed_delta_time() const { return fixed_dt_; }
+
+    // Window
+    bool is_open() const override { return !closed_ && step_ < step_count_; }
+    void close() override { closed_ = true; }
+    int width() const override { return width_; }
+    int height() const override { return height_; }
+    float scale_factor() const override { return 1.0f; }
+    void set_title(const std::string&) override {}
+    void* native_handle() override { return nullptr; }
+
+    bool is_key_down(Key key) const override;
+    bool is_key_pressed(Key key) const override;
+    bool is_key_released(Key key) const override;
+    bool is_mouse_button_down(MouseButton button) const override;
+    float mouse_x() const override { return current_.mouse_x; }
+    float mouse_y() const override { return current_.mouse_y; }
+
+    void update_input() override;
+
+private:
+    // Decode the step at cursor_ into current_ (false on corrupt data)
+    bool decode_step();
+
+    std::vector<uint8_t> data_;
+    size_t cursor_ = 0;
+    size_t steps_offset_ = 0;
+    InputSnapshot current_;
+    uint32_t idle_left_ = 0;        // Steps still to repeat current_
+    uint32_t step_ = 0;
+    uint32_t step_count_ = 0;
+    float fixed_dt_ = 1.0f / 60.0f;
+    int32_t width_ = 0;
+    int32_t height_ = 0;
+    bool closed_ = false;
+};
+
+} // namespace cafe
+
+#endif // CAFE_INPUT_RECORDER_H
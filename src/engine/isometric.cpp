@@ -1,4 +1,5 @@
 #include "isometric.h"
+#include "profiler.h"
 #include "sprite_sheet.h"
 #include <algorithm>
 #include <cmath>
@@ -124,22 +125,47 @@ void TileMap::set_tileset(SpriteSheet* tileset) {
     tileset_ = tileset;
 }
 
+namespace {
+
+// A tile is visible when its anchor lies in the viewport grown by these
+// margins (tiles extend past their anchor point). Shared by both visible
+// tile walks so they always agree on the tile set.
+struct VisibleArea {
+    float left, right, top, bottom;
+
+    explicit VisibleArea(const Rect& viewport) {
+        float margin_x = Isometric::tile_width();
+        float margin_y = Isometric::tile_height() * 2;
+        left = viewport.x - margin_x;
+        right = viewport.x + viewport.width + margin_x;
+        top = viewport.y - margin_y;
+        bottom = viewport.y + viewport.height + margin_y;
+    }
+
+    bool contains_x(float screen_x) const { return screen_x >= left && screen_x <= right; }
+    bool contains_y(float screen_y) const { return screen_y >= top && screen_y <= bottom; }
+    bool contains(const Vec2& screen) const { return contains_x(screen.x) && contains_y(screen.y); }
+};
+
+} // namespace
+
 void TileMap::for_each_visible(const Rect& viewport, const TileCallback& callback) const {
-    // viewport is in SCREEN coordinates (0,0 to width,height)
-    // screen_to_tile converts screen coords to tile coords using camera
-
-    // Calculate tile bounds from viewport corners
-    Vec2 top_left = Isometric::screen_to_tile(viewport.x, viewport.y);
-    Vec2 top_right = Isometric::screen_to_tile(viewport.x + viewport.width, viewport.y);
-    Vec2 bottom_left = Isometric::screen_to_tile(viewport.x, viewport.y + viewport.height);
-    Vec2 bottom_right = Isometric::screen_to_tile(viewport.x + viewport.width,
-                                                   viewport.y + viewport.height);
-
-    // Find bounding box of visible tiles (with margin for partially visible tiles)
-    int min_x = static_cast<int>(std::floor(std::min({top_left.x, bottom_left.x, top_right.x, bottom_right.x}))) - 2;
-    int max_x = static_cast<int>(std::ceil(std::max({top_left.x, bottom_left.x, top_right.x, bottom_right.x}))) + 2;
-    int min_y = static_cast<int>(std::floor(std::min({top_left.y, bottom_left.y, top_right.y, bottom_right.y}))) - 2;
-    int max_y = static_cast<int>(std::ceil(std::max({top_left.y, bottom_left.y, top_right.y, bottom_right.y}))) + 2;
+    CAFE_PROFILE_SCOPE("TileMap::for_each_visible");
+
+    // viewport is in SCREEN coordinates; screen_to_tile applies the camera
+    VisibleArea area(viewport);
+
+    // Calculate tile bounds from the corners of the visible area. The area
+    // already includes the margins, so one extra tile only absorbs rounding.
+    Vec2 top_left = Isometric::screen_to_tile(area.left, area.top);
+    Vec2 top_right = Isometric::screen_to_tile(area.right, area.top);
+    Vec2 bottom_left = Isometric::screen_to_tile(area.left, area.bottom);
+    Vec2 bottom_right = Isometric::screen_to_tile(area.right, area.bottom);
+
+    int min_x = static_cast<int>(std::floor(std::min({top_left.x, bottom_left.x, top_right.x, bottom_right.x}))) - 1;
+    int max_x = static_cast<int>(std::ceil(std::max({top_left.x, bottom_left.x, top_right.x, bottom_right.x}))) + 1;
+    int min_y = static_cast<int>(std::floor(std::min({top_left.y, bottom_left.y, top_right.y, bottom_right.y}))) - 1;
+    int max_y = static_cast<int>(std::ceil(std::max({top_left.y, bottom_left.y, top_right.y, bottom_right.y}))) + 1;
 
     // Clamp to map bounds
     min_x = std::max(0, min_x);
@@ -172,13 +198,7 @@ void TileMap::for_each_visible(const Rect& viewport, const TileCallback& callbac
             Vec2 screen = Isometric::tile_to_screen(tx, ty);
 
             // Check if actually visible on screen
-            float margin_x = Isometric::tile_width();
-            float margin_y = Isometric::tile_height() * 2;
-
-            if (screen.x >= -margin_x &&
-                screen.x <= viewport.width + margin_x &&
-                screen.y >= -margin_y &&
-                screen.y <= viewport.height + margin_y) {
+            if (area.contains(screen)) {
 
                 visible_tiles.push_back({
                     tx, ty,
@@ -202,33 +222,136 @@ void TileMap::for_each_visible(const Rect& viewport, const TileCallback& callbac
     }
 }
 
+int TileMap::count_visible(const Rect& viewport) const {
+    int count = 0;
+    for_each_visible_diagonal(viewport, [&](int, int, const Tile&, float, float) {
+        ++count;
+    });
+    return count;
+}
+
 void TileMap::render(Renderer* renderer, const Rect& viewport) {
     if (!tileset_ || !renderer) return;
+    CAFE_PROFILE_SCOPE("TileMap::render");
 
     renderer->begin_batch();
 
-    for_each_visible(viewport, [&](int, int, const Tile& tile, float screen_x, float screen_y) {
-        // Get sprite frame for this tile
-        const SpriteFrame* frame = tileset_->frame(tile.tile_id - 1);  // tile_id 1-based
-        if (!frame) return;
-
-        // Adjust Y position for tile height (tiles are drawn from their base)
-        float adjusted_y = screen_y - static_cast<float>(tile.height) * Isometric::tile_height();
-
+    for_each_visible_diagonal(viewport, [&](int, int, const Tile& tile, float screen_x, float screen_y) {
         Sprite sprite;
-        sprite.position = {screen_x, adjusted_y};
-        sprite.size = {static_cast<float>(frame->width), static_cast<float>(frame->height)};
-        sprite.region = frame->region;
-        sprite.tint = Color::white();
-        sprite.rotation = 0.0f;
-        sprite.origin = {0.5f, 1.0f};  // Bottom-center origin for isometric tiles
-
-        renderer->draw_sprite(sprite);
+        if (make_tile_sprite(*tileset_, tile, screen_x, screen_y, sprite)) {
+            renderer->draw_sprite(sprite);
+        }
     });
 
     renderer->end_batch();
 }
 
+// ============================================================================
+// Diagonal Visibility
+// ============================================================================
+//
+// The diagonal and x ranges are solved analytically, then nudged by the exact
+// per-tile test (VisibleArea) so floating point rounding never disagrees with
+// TileMap::for_each_visible(), which applies the same test to every tile.
+
+namespace {
+
+// Convert to int without overflow when the viewport is huge
+int clamp_to_int(float value, int lo, int hi) {
+    if (!(value >= static_cast<float>(lo))) return lo;  // Also catches NaN
+    if (value >= static_cast<float>(hi)) return hi;
+    return static_cast<int>(value);
+}
+
+float diagonal_screen_y(int d) {
+    return static_cast<float>(d) * (Isometric::tile_height() * 0.5f) - Isometric::camera().y;
+}
+
+float diagonal_screen_x(int x, int d) {
+    return static_cast<float>(2 * x - d) * (Isometric::tile_width() * 0.5f) - Isometric::camera().x;
+}
+
+} // namespace
+
+DiagonalRange visible_diagonals(int map_width, int map_height, const Rect& viewport) {
+    DiagonalRange range;
+    if (map_width <= 0 || map_height <= 0) return range;
+
+    float half_height = Isometric::tile_height() * 0.5f;
+    if (half_height <= 0.0f) return range;
+
+    VisibleArea area(viewport);
+    float cam_y = Isometric::camera().y;
+    int max_d = map_width + map_height - 2;
+
+    // Analytic estimate (clamped one past the map so the fix-up can settle)
+    int first = clamp_to_int(std::ceil((area.top + cam_y) / half_height), -1, max_d + 1);
+    int last = clamp_to_int(std::floor((area.bottom + cam_y) / half_height), -1, max_d + 1);
+    first = std::max(first, 0);
+    last = std::min(last, max_d);
+
+    // Exact fix-up against the per-tile test
+    while (first <= last && !area.contains_y(diagonal_screen_y(first))) ++first;
+    while (last >= first && !area.contains_y(diagonal_screen_y(last))) --last;
+    if (first > last) return range;
+    while (first > 0 && area.contains_y(diagonal_screen_y(first - 1))) --first;
+    while (last < max_d && area.contains_y(diagonal_screen_y(last + 1))) ++last;
+
+    range.first = first;
+    range.last = last;
+    return range;
+}
+
+DiagonalSpan visible_span(int map_width, int map_height, const Rect& viewport, int d) {
+    DiagonalSpan span;
+    if (map_width <= 0 || map_height <= 0) return span;
+
+    float half_width = Isometric::tile_width() * 0.5f;
+    if (half_width <= 0.0f) return span;
+
+    VisibleArea area(viewport);
+    if (!area.contains_y(diagonal_screen_y(d))) return span;
+
+    // Cells of this diagonal that lie inside the map
+    int map_begin = std::max(0, d - (map_height - 1));
+    int map_end = std::min(map_width - 1, d);
+    if (map_begin > map_end) return span;
+
+    // Solve left <= (2x - d) * half_width - cam_x <= right for x
+    float cam_x = Isometric::camera().x;
+    float lo = ((area.left + cam_x) / half_width + static_cast<float>(d)) * 0.5f;
+    float hi = ((area.right + cam_x) / half_width + static_cast<float>(d)) * 0.5f;
+    int x_begin = std::max(map_begin, clamp_to_int(std::ceil(lo), map_begin - 1, map_end + 1));
+    int x_end = std::min(map_end, clamp_to_int(std::floor(hi), map_begin - 1, map_end + 1));
+
+    while (x_begin <= x_end && !area.contains_x(diagonal_screen_x(x_begin, d))) ++x_begin;
+    while (x_end >= x_begin && !area.contains_x(diagonal_screen_x(x_end, d))) --x_end;
+    if (x_begin > x_end) return span;
+    while (x_begin > map_begin && area.contains_x(diagonal_screen_x(x_begin - 1, d))) --x_begin;
+    while (x_end < map_end && area.contains_x(diagonal_screen_x(x_end + 1, d))) ++x_end;
+
+    span.x_begin = x_begin;
+    span.x_end = x_end;
+    return span;
+}
+
+bool make_tile_sprite(const SpriteSheet& tileset, const Tile& tile,
+                      float screen_x, float screen_y, Sprite& sprite) {
+    const SpriteFrame* frame = tileset.frame(tile.tile_id - 1);  // tile_id 1-based
+    if (!frame) return false;
+
+    // Adjust Y position for tile height (tiles are drawn from their base)
+    float adjusted_y = screen_y - static_cast<float>(tile.height) * Isometric::tile_height();
+
+    sprite.position = {screen_x, adjusted_y};
+    sprite.size = {static_cast<float>(frame->width), static_cast<float>(frame->height)};
+    sprite.region = frame->region;
+    sprite.tint = Color::white();
+    sprite.rotation = 0.0f;
+    sprite.origin = {0.5f, 1.0f};  // Bottom-center origin for isometric tiles
+    return true;
+}
+
 // ============================================================================
 // TileMapRenderer Implementation
 // ============================================================================
@@ -243,6 +366,7 @@ void TileMapRenderer::set_renderer(Renderer* renderer) {
 
 void TileMapRenderer::render(const Rect& viewport) {
     if (!map_ || !renderer_) return;
+    CAFE_PROFILE_SCOPE("TileMapRenderer::render");
 
     tiles_rendered_ = 0;
 
@@ -251,22 +375,12 @@ void TileMapRenderer::render(const Rect& viewport) {
 
     renderer_->begin_batch();
 
-    map_->for_each_visible(viewport, [&](int, int, const Tile& tile, float screen_x, float screen_y) {
-        const SpriteFrame* frame = tileset->frame(tile.tile_id - 1);
-        if (!frame) return;
-
-        float adjusted_y = screen_y - static_cast<float>(tile.height) * Isometric::tile_height();
-
+    map_->for_each_visible_diagonal(viewport, [&](int, int, const Tile& tile, float screen_x, float screen_y) {
         Sprite sprite;
-        sprite.position = {screen_x, adjusted_y};
-        sprite.size = {static_cast<float>(frame->width), static_cast<float>(frame->height)};
-        sprite.region = frame->region;
-        sprite.tint = Color::white();
-        sprite.rotation = 0.0f;
-        sprite.origin = {0.5f, 1.0f};
-
-        renderer_->draw_sprite(sprite);
-        ++tiles_rendered_;
+        if (make_tile_sprite(*tileset, tile, screen_x, screen_y, sprite)) {
+            renderer_->draw_sprite(sprite);
+            ++tiles_rendered_;
+        }
     });
 
     renderer_->end_batch();
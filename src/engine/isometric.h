@@ -18,15 +18,13 @@ struct SpriteFrame;
 // Isometric projection converts 3D tile coordinates (tile_x, tile_y) to
 // 2D screen coordinates. The classic isometric ratio is 2:1 (width:height).
 //
-//     Screen Y
-//        ^
-//        |     (0,0)
-//        |    /     \
-//        |   (1,0)   (0,1)
-//        |  /     \ /     \
-//        | (2,0)  (1,1)   (0,2)
-//        |
-//        +-----------------------> Screen X
+//     +------------------------------> Screen X
+//     |              (0,0)
+//     |    +tile_y  /     \  +tile_x
+//     |          (0,1)   (1,0)
+//     |      (0,2)   (1,1)   (2,0)
+//     v
+//  Screen Y
 //
 // Tile coordinates: (x, y) where x increases right-down, y increases left-down
 // Screen coordinates: standard 2D pixel position
@@ -82,6 +80,43 @@ struct Tile {
     bool is_empty() const { return tile_id == 0; }
 };
 
+// ============================================================================
+// Diagonal Visibility (shared by all tile map storage types)
+// ============================================================================
+//
+// For tile (x, y) on anti-diagonal d = x + y:
+//   screen_y = d * (tile_height / 2) - camera_y        (constant per diagonal)
+//   screen_x = (2x - d) * (tile_width / 2) - camera_x  (linear in x)
+//
+// So the visible set of a viewport is a range of diagonals, each with a
+// contiguous range of x. Walking it back to front is already draw order.
+
+// Visible range of one anti-diagonal (all tiles with x + y == d)
+struct DiagonalSpan {
+    int x_begin = 0;  // First visible x on the diagonal (inclusive)
+    int x_end = -1;   // Last visible x on the diagonal (inclusive)
+
+    bool empty() const { return x_begin > x_end; }
+    int size() const { return empty() ? 0 : x_end - x_begin + 1; }
+};
+
+// Diagonals (x + y) that intersect the viewport, clamped to the map
+struct DiagonalRange {
+    int first = 0;
+    int last = -1;
+};
+
+// Visible diagonals of a map_width x map_height grid
+DiagonalRange visible_diagonals(int map_width, int map_height, const Rect& viewport);
+
+// Visible cells of one diagonal (empty if the diagonal is off screen)
+DiagonalSpan visible_span(int map_width, int map_height, const Rect& viewport, int diagonal);
+
+// Build the sprite for a tile anchored at (screen_x, screen_y)
+// Returns false if the tileset has no frame for the tile
+bool make_tile_sprite(const SpriteSheet& tileset, const Tile& tile,
+                      float screen_x, float screen_y, Sprite& sprite);
+
 // ============================================================================
 // TileMap - 2D grid of tiles with isometric rendering
 // ============================================================================
@@ -121,6 +156,28 @@ public:
     using TileCallback = std::function<void(int, int, const Tile&, float, float)>;
     void for_each_visible(const Rect& viewport, const TileCallback& callback) const;
 
+    // Diagonal-order iteration (no sort, no temporary storage)
+    //
+    // Depth only depends on x + y, so sweeping the anti-diagonals from back
+    // to front already yields tiles in draw order. Each diagonal is clipped
+    // against the viewport exactly, so only on-screen cells are touched.
+    // Within a diagonal tiles are emitted with increasing x. The tile set is
+    // the same as for_each_visible(); only the order can differ.
+    //
+    // Unlike for_each_visible(), tile height does not reorder tiles: a raised
+    // tile is drawn with its diagonal, which is the correct painter's order
+    // for a height map (tiles only extend upward on screen).
+    //
+    // Callback receives the same arguments as TileCallback.
+    template<typename Fn>
+    void for_each_visible_diagonal(const Rect& viewport, Fn&& callback) const;
+
+    // Number of non-empty tiles for_each_visible_diagonal() would emit
+    int count_visible(const Rect& viewport) const;
+
+    // Memory used by tile storage
+    size_t memory_bytes() const { return tiles_.capacity() * sizeof(Tile); }
+
 private:
     int width_ = 0;
     int height_ = 0;
@@ -130,6 +187,33 @@ private:
     static const Tile empty_tile_;
 };
 
+// ============================================================================
+// TileMap Template Implementation
+// ============================================================================
+
+template<typename Fn>
+void TileMap::for_each_visible_diagonal(const Rect& viewport, Fn&& callback) const {
+    DiagonalRange diagonals = visible_diagonals(width_, height_, viewport);
+
+    const float half_width = Isometric::tile_width() * 0.5f;
+    const float half_height = Isometric::tile_height() * 0.5f;
+    const Vec2 cam = Isometric::camera();
+
+    for (int d = diagonals.first; d <= diagonals.last; ++d) {
+        DiagonalSpan span = visible_span(width_, height_, viewport, d);
+        float screen_y = static_cast<float>(d) * half_height - cam.y;
+
+        for (int x = span.x_begin; x <= span.x_end; ++x) {
+            int y = d - x;
+            const Tile& tile = tiles_[static_cast<size_t>(y) * width_ + x];
+            if (tile.is_empty()) continue;
+
+            float screen_x = static_cast<float>(x - y) * half_width - cam.x;
+            callback(x, y, tile, screen_x, screen_y);
+        }
+    }
+}
+
 // ============================================================================
 // TileMapRenderer - Efficient batched tile rendering
 // ============================================================================
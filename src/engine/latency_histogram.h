@@ -0,0 +1,75 @@
+#ifndef CAFE_LATENCY_HISTOGRAM_H
+#define CAFE_LATENCY_HISTOGRAM_H
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+namespace cafe {
+
+// ============================================================================
+// LatencyHistogram - Power-of-two buckets of microsecond timings
+// ============================================================================
+//
+// Bucket i counts samples in [2^(i-1), 2^i) microseconds (bucket 0 is
+// under 1 us), so 32 buckets cover everything up to ~35 minutes with a
+// fixed 256 bytes and an O(1) record(). Percentiles are reported as the
+// upper edge of the bucket they fall in - coarse, but enough to tell a
+// 2 ms decode from a 30 ms one.
+//
+// Not thread-safe: record from one thread, or copy under a lock.
+//
+// ============================================================================
+
+class LatencyHistogram {
+public:
+    static constexpr int BUCKETS = 32;
+
+    void record(double microseconds) {
+        uint64_t us = microseconds > 0.0 ? static_cast<uint64_t>(microseconds) : 0;
+        int bucket = 0;
+        while (us != 0 && bucket < BUCKETS - 1) {
+            us >>= 1;
+            ++bucket;
+        }
+        ++buckets_[bucket];
+        ++count_;
+        total_us_ += microseconds;
+        max_us_ = std::max(max_us_, microseconds);
+    }
+
+    void reset() { *this = LatencyHistogram(); }
+
+    uint64_t count() const { return count_; }
+    double mean_us() const { return count_ ? total_us_ / static_cast<double>(count_) : 0.0; }
+    double max_us() const { return max_us_; }
+
+    // Upper bound of the bucket holding the p-th percentile (p in [0, 1])
+    double percentile_us(double p) const {
+        if (count_ == 0) {
+            return 0.0;
+        }
+        uint64_t rank = static_cast<uint64_t>(p * static_cast<double>(count_ - 1)) + 1;
+        uint64_t seen = 0;
+        for (int i = 0; i < BUCKETS; ++i) {
+            seen += buckets_[i];
+            if (seen >= rank) {
+                return std::min(bucket_upper_us(i), max_us_);
+            }
+        }
+        return max_us_;
+    }
+
+    uint64_t bucket(int i) const { return buckets_[i]; }
+    static double bucket_upper_us(int i) { return static_cast<double>(uint64_t(1) << i); }
+
+private:
+    std::array<uint64_t, BUCKETS> buckets_{};
+    uint64_t count_ = 0;
+    double total_us_ = 0.0;
+    double max_us_ = 0.0;
+};
+
+} // namespace cafe
+
+#endif // CAFE_LATENCY_HISTOGRAM_H
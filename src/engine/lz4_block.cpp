@@ -0,0 +1,186 @@
+#include "lz4_block.h"
+#include <cstring>
+#include <vector>
+
+namespace cafe {
+namespace lz4 {
+
+namespace {
+
+constexpr size_t MIN_MATCH = 4;
+constexpr size_t LAST_LITERALS = 5;   // The last 5 bytes are always literals
+constexpr size_t MF_LIMIT = 12;       // No match may start in the last 12 bytes
+constexpr size_t MAX_OFFSET = 65535;
+constexpr int HASH_LOG = 14;
+
+uint32_t read32(const uint8_t* p) {
+    uint32_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+uint32_t hash(uint32_t sequence) {
+    return (sequence * 2654435761u) >> (32 - HASH_LOG);
+}
+
+// Length continuation bytes: 255, 255, ..., remainder
+uint8_t* write_length(uint8_t* out, size_t length) {
+    while (length >= 255) {
+        *out++ = 255;
+        length -= 255;
+    }
+    *out++ = static_cast<uint8_t>(length);
+    return out;
+}
+
+uint8_t* write_sequence(uint8_t* out, const uint8_t* literals, size_t literal_count,
+                        size_t offset, size_t match_length) {
+    uint8_t* token = out++;
+    *token = static_cast<uint8_t>((literal_count < 15 ? literal_count : 15) << 4);
+    if (literal_count >= 15) {
+        out = write_length(out, literal_count - 15);
+    }
+
+    if (literal_count > 0) {
+        std::memcpy(out, literals, literal_count);
+        out += literal_count;
+    }
+
+    if (match_length == 0) {
+        return out;  // Last sequence: literals only
+    }
+
+    *out++ = static_cast<uint8_t>(offset & 0xFF);
+    *out++ = static_cast<uint8_t>(offset >> 8);
+
+    size_t extra = match_length - MIN_MATCH;
+    *token |= static_cast<uint8_t>(extra < 15 ? extra : 15);
+    if (extra >= 15) {
+        out = write_length(out, extra - 15);
+    }
+    return out;
+}
+
+// Read a length continuation; false if it runs off the end
+bool read_length(const uint8_t*& in, const uint8_t* end, size_t& length) {
+    uint8_t byte;
+    do {
+        if (in >= end) {
+            return false;
+        }
+        byte = *in++;
+        length += byte;
+    } while (byte == 255);
+    return true;
+}
+
+} // namespace
+
+size_t compress_bound(size_t size) {
+    return size + size / 255 + 16;
+}
+
+size_t compress(const uint8_t* src, size_t size, uint8_t* dst, size_t capacity) {
+    if (capacity < compress_bound(size)) {
+        return 0;
+    }
+
+    uint8_t* out = dst;
+    size_t anchor = 0;   // First byte not yet emitted
+
+    if (size > MF_LIMIT) {
+        std::vector<int32_t> table(size_t(1) << HASH_LOG, -1);
+        const size_t match_start_limit = size - MF_LIMIT;
+        const size_t match_end_limit = size - LAST_LITERALS;
+
+        size_t pos = 0;
+        while (pos < match_start_limit) {
+            uint32_t sequence = read32(src + pos);
+            uint32_t h = hash(sequence);
+            int32_t candidate = table[h];
+            table[h] = static_cast<int32_t>(pos);
+
+            if (candidate < 0 || pos - candidate > MAX_OFFSET ||
+                read32(src + candidate) != sequence) {
+                // Skip faster through incompressible runs
+                pos += 1 + ((pos - anchor) >> 6);
+                continue;
+            }
+
+            size_t length = MIN_MATCH;
+            while (pos + length < match_end_limit && src[candidate + length] == src[pos + length]) {
+                length++;
+            }
+
+            out = write_sequence(out, src + anchor, pos - anchor, pos - candidate, length);
+            pos += length;
+            anchor = pos;
+        }
+    }
+
+    out = write_sequence(out, src + anchor, size - anchor, 0, 0);
+    return static_cast<size_t>(out - dst);
+}
+
+bool decompress(const uint8_t* src, size_t size, uint8_t* dst, size_t decompressed_size) {
+    const uint8_t* in = src;
+    const uint8_t* in_end = src + size;
+    uint8_t* out = dst;
+    uint8_t* out_end = dst + decompressed_size;
+
+    while (in < in_end) {
+        uint8_t token = *in++;
+
+        size_t literal_count = token >> 4;
+        if (literal_count == 15 && !read_length(in, in_end, literal_count)) {
+            return false;
+        }
+        if (literal_count > static_cast<size_t>(in_end - in) ||
+            literal_count > static_cast<size_t>(out_end - out)) {
+            return false;
+        }
+        if (literal_count > 0) {
+            std::memcpy(out, in, literal_count);
+            in += literal_count;
+            out += literal_count;
+        }
+
+        if (in == in_end) {
+            break;  // Last sequence has no match
+        }
+
+        if (in_end - in < 2) {
+            return false;
+        }
+        size_t offset = in[0] | (in[1] << 8);
+        in += 2;
+        if (offset == 0 || offset > static_cast<size_t>(out - dst)) {
+            return false;
+        }
+
+        size_t match_length = token & 15;
+        if (match_length == 15 && !read_length(in, in_end, match_length)) {
+            return false;
+        }
+        match_length += MIN_MATCH;
+        if (match_length > static_cast<size_t>(out_end - out)) {
+            return false;
+        }
+
+        const uint8_t* match = out - offset;
+        if (offset >= match_length) {
+            std::memcpy(out, match, match_length);
+            out += match_length;
+        } else {
+            // Overlapping copy repeats the last `offset` bytes (runs)
+            for (size_t i = 0; i < match_length; ++i) {
+                *out++ = match[i];
+            }
+        }
+    }
+
+    return out == out_end;
+}
+
+} // namespace lz4
+} // namespace cafe
@@ -0,0 +1,46 @@
+#ifndef CAFE_LZ4_BLOCK_H
+#define CAFE_LZ4_BLOCK_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace cafe {
+namespace lz4 {
+
+// ============================================================================
+// LZ4 block format - Fast lossless compression for cooked assets
+// ============================================================================
+//
+// A self-contained codec for the LZ4 *block* format (no frame header, no
+// checksums), compatible with LZ4_compress_default / LZ4_decompress_safe.
+// A block is a list of sequences:
+//
+//   token       high 4 bits: literal count, low 4 bits: match length - 4
+//               (15 = more length bytes follow, each 255 = keep reading)
+//   literals    copied to the output as-is
+//   offset      2 bytes, how far back the match starts
+//
+// The compressor is the simple greedy one (a single hash table of recent
+// 4-byte sequences); decompression is a few memcpys per sequence and runs
+// at memory speed, which is what matters at load time.
+//
+// The caller stores the uncompressed size: decompress() needs it.
+//
+// ============================================================================
+
+// Worst-case compressed size of `size` bytes (incompressible data grows
+// slightly)
+size_t compress_bound(size_t size);
+
+// Compress src into dst (capacity must be at least compress_bound(size))
+// Returns the compressed size, or 0 if dst is too small
+size_t compress(const uint8_t* src, size_t size, uint8_t* dst, size_t capacity);
+
+// Decompress exactly `decompressed_size` bytes
+// Returns false on corrupt input (never reads or writes out of bounds)
+bool decompress(const uint8_t* src, size_t size, uint8_t* dst, size_t decompressed_size);
+
+} // namespace lz4
+} // namespace cafe
+
+#endif // CAFE_LZ4_BLOCK_H
@@ -0,0 +1,156 @@
+#include "mapped_file.h"
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define CAFE_HAS_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#define CAFE_HAS_MMAP 0
+#endif
+
+namespace cafe {
+
+// ============================================================================
+// Lifetime
+// ============================================================================
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept {
+    *this = std::move(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        close();
+        data_ = std::exchange(other.data_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+        path_ = std::move(other.path_);
+        mapped_ = std::exchange(other.mapped_, false);
+        buffer_ = std::move(other.buffer_);
+    }
+    return *this;
+}
+
+bool MappedFile::open(const std::string& path) {
+    close();
+
+#if CAFE_HAS_MMAP
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "MappedFile: Failed to open: " << path << "\n";
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        ::close(fd);
+        std::cerr << "MappedFile: Empty or unreadable file: " << path << "\n";
+        return false;
+    }
+
+    size_t size = static_cast<size_t>(st.st_size);
+    void* address = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);  // The mapping keeps its own reference to the file
+
+    if (address == MAP_FAILED) {
+        std::cerr << "MappedFile: mmap failed: " << path << "\n";
+        return false;
+    }
+
+    data_ = static_cast<const uint8_t*>(address);
+    size_ = size;
+    mapped_ = true;
+#else
+    FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) {
+        std::cerr << "MappedFile: Failed to open: " << path << "\n";
+        return false;
+    }
+    std::fseek(file, 0, SEEK_END);
+    long size = std::ftell(file);
+    std::fseek(file, 0, SEEK_SET);
+    if (size <= 0) {
+        std::fclose(file);
+        std::cerr << "MappedFile: Empty or unreadable file: " << path << "\n";
+        return false;
+    }
+    buffer_.resize(static_cast<size_t>(size));
+    size_t read = std::fread(buffer_.data(), 1, buffer_.size(), file);
+    std::fclose(file);
+    if (read != buffer_.size()) {
+        buffer_.clear();
+        std::cerr << "MappedFile: Failed to read: " << path << "\n";
+        return false;
+    }
+    data_ = buffer_.data();
+    size_ = buffer_.size();
+#endif
+
+    path_ = path;
+    return true;
+}
+
+void MappedFile::close() {
+#if CAFE_HAS_MMAP
+    if (mapped_ && data_) {
+        munmap(const_cast<uint8_t*>(data_), size_);
+    }
+#endif
+    data_ = nullptr;
+    size_ = 0;
+    mapped_ = false;
+    buffer_.clear();
+    buffer_.shrink_to_fit();
+    path_.clear();
+}
+
+// ============================================================================
+// Paging Hints
+// ============================================================================
+
+#if CAFE_HAS_MMAP
+namespace {
+
+// madvise() needs a page-aligned start address
+void advise(const uint8_t* base, size_t size, size_t offset, size_t length, int advice) {
+    if (!base || offset >= size) return;
+    length = std::min(length, size - offset);
+
+    static const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    size_t begin = offset / page * page;
+    size_t end = offset + length;
+    madvise(const_cast<uint8_t*>(base) + begin, end - begin, advice);
+}
+
+} // namespace
+#endif
+
+void MappedFile::will_need(size_t offset, size_t length) const {
+#if CAFE_HAS_MMAP
+    if (mapped_) advise(data_, size_, offset, length, MADV_WILLNEED);
+#else
+    (void)offset;
+    (void)length;
+#endif
+}
+
+void MappedFile::release(size_t offset, size_t length) const {
+#if CAFE_HAS_MMAP
+    // Read-only private mapping: dropped pages are re-read from the file
+    if (mapped_) advise(data_, size_, offset, length, MADV_DONTNEED);
+#else
+    (void)offset;
+    (void)length;
+#endif
+}
+
+} // namespace cafe
@@ -0,0 +1,69 @@
+#ifndef CAFE_MAPPED_FILE_H
+#define CAFE_MAPPED_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace cafe {
+
+// ============================================================================
+// MappedFile - Read-only memory-mapped file
+// ============================================================================
+//
+// Maps a whole file into the address space with mmap(). Nothing is read up
+// front: the OS pages data in on first touch and can drop clean pages under
+// memory pressure, so a multi-gigabyte file costs only what is accessed.
+//
+// On platforms without mmap the file is read into a heap buffer instead;
+// the interface is the same, only the memory behaviour differs.
+//
+// Usage:
+//   MappedFile file;
+//   if (file.open("assets/city.tiles")) {
+//       const uint8_t* bytes = file.data();
+//       ...
+//       file.release(offset, size);   // Done with this range for now
+//   }
+//
+// ============================================================================
+
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    // Non-copyable, movable (owns the mapping)
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    // Map a file (closes any previous mapping)
+    bool open(const std::string& path);
+    void close();
+
+    bool is_open() const { return data_ != nullptr; }
+    const uint8_t* data() const { return data_; }
+    size_t size() const { return size_; }
+    const std::string& path() const { return path_; }
+
+    // Hint that a byte range will be read soon (starts read-ahead)
+    void will_need(size_t offset, size_t length) const;
+
+    // Drop a byte range from this process's resident set
+    // The data stays valid: it is paged in again on the next access
+    void release(size_t offset, size_t length) const;
+
+private:
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+    std::string path_;
+    bool mapped_ = false;           // false = heap fallback
+    std::vector<uint8_t> buffer_;   // Heap fallback storage
+};
+
+} // namespace cafe
+
+#endif // CAFE_MAPPED_FILE_H
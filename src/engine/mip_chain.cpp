@@ -0,0 +1,88 @@
+#include "mip_chain.h"
+#include "image_ops.h"
+#include "../renderer/renderer.h"
+#include <algorithm>
+#include <iostream>
+
+namespace cafe {
+
+int MipChain::build(const uint8_t* pixels, int width, int height, const MipOptions& options) {
+    clear();
+    if (!pixels || width <= 0 || height <= 0) {
+        std::cerr << "MipChain: Invalid image " << width << "x" << height << "\n";
+        return 0;
+    }
+
+    width_ = width;
+    height_ = height;
+
+    int count = max_mip_count(width, height);
+    if (options.max_levels > 0) {
+        count = std::min(count, options.max_levels);
+    }
+
+    levels_.resize(static_cast<size_t>(count - 1));
+    const uint8_t* previous = pixels;
+    for (int level = 1; level < count; ++level) {
+        std::vector<uint8_t>& next = levels_[static_cast<size_t>(level - 1)];
+        next.resize(static_cast<size_t>(mip_size(width, level)) * mip_size(height, level) * 4);
+        if (options.gamma_correct) {
+            image_ops::downscale_box_srgb(previous, mip_size(width, level - 1),
+                                          mip_size(height, level - 1), next.data());
+        } else {
+            image_ops::downscale_box(previous, mip_size(width, level - 1),
+                                     mip_size(height, level - 1), next.data());
+        }
+        previous = next.data();
+    }
+    return this->count();
+}
+
+void MipChain::clear() {
+    width_ = 0;
+    height_ = 0;
+    levels_.clear();
+}
+
+int MipChain::width(int level) const {
+    return mip_size(width_, level);
+}
+
+int MipChain::height(int level) const {
+    return mip_size(height_, level);
+}
+
+const uint8_t* MipChain::level(int level) const {
+    if (level < 1 || level >= count()) {
+        return nullptr;
+    }
+    return levels_[static_cast<size_t>(level - 1)].data();
+}
+
+std::vector<const uint8_t*> MipChain::levels(const uint8_t* base) const {
+    std::vector<const uint8_t*> result;
+    result.reserve(static_cast<size_t>(count()));
+    result.push_back(base);
+    for (const std::vector<uint8_t>& pixels : levels_) {
+        result.push_back(pixels.data());
+    }
+    return result;
+}
+
+size_t MipChain::bytes() const {
+    size_t total = 0;
+    for (const std::vector<uint8_t>& pixels : levels_) {
+        total += pixels.size();
+    }
+    return total;
+}
+
+size_t MipChain::chain_bytes(int width, int height, int count) {
+    size_t total = 0;
+    for (int level = 0; level < count; ++level) {
+        total += static_cast<size_t>(mip_size(width, level)) * mip_size(height, level) * 4;
+    }
+    return total;
+}
+
+} // namespace cafe
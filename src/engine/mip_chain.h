@@ -0,0 +1,85 @@
+#ifndef CAFE_MIP_CHAIN_H
+#define CAFE_MIP_CHAIN_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace cafe {
+
+// ============================================================================
+// MipChain - Pre-shrunk copies of a texture for zoomed-out views
+// ============================================================================
+//
+// Zoomed out, one screen pixel covers several texels. Sampling only the
+// nearest texel then skips most of the image: the café floor shimmers as
+// the camera moves and fine sprite detail turns to noise. A mip chain
+// stores the texture at 1/2, 1/4, ... down to 1x1, each level a 2x2 box
+// average of the one above; the GPU picks the level whose texels are about
+// screen-pixel sized (MipFilter in renderer.h).
+//
+// The chain costs one third more memory than the texture itself
+// (1/4 + 1/16 + ... = 1/3).
+//
+// Levels are averaged in linear light by default (image_ops::
+// downscale_box_srgb), so zoomed-out art keeps its brightness; a plain
+// sRGB average darkens anything with contrast.
+//
+// The chain owns levels 1 and up; level 0 stays wherever the caller keeps
+// it (an Image, a cooked file mapping).
+//
+// Usage:
+//   MipChain mips;
+//   mips.build(image->data(), image->width(), image->height());
+//
+//   TextureInfo info;
+//   info.width = image->width();
+//   info.height = image->height();
+//   info.mip_count = mips.count();
+//   renderer->create_texture_mipmapped(mips.levels(image->data()).data(), info);
+//
+// ============================================================================
+
+struct MipOptions {
+    bool gamma_correct = true;   // Average in linear light (see above)
+    int max_levels = 0;          // Including level 0; 0 = down to 1x1
+};
+
+class MipChain {
+public:
+    // Build levels 1.. from RGBA8 pixels. Returns the level count
+    // (including level 0), or 0 if the size is invalid.
+    int build(const uint8_t* pixels, int width, int height,
+              const MipOptions& options = MipOptions());
+
+    void clear();
+
+    // Levels including level 0 (1 = no chain built)
+    int count() const { return static_cast<int>(levels_.size()) + 1; }
+    bool empty() const { return levels_.empty(); }
+
+    int width(int level) const;
+    int height(int level) const;
+
+    // Pixels of level 1..count()-1 (nullptr otherwise)
+    const uint8_t* level(int level) const;
+
+    // Pointers to every level, with `base` as level 0 - the layout
+    // Renderer::create_texture_mipmapped() takes
+    std::vector<const uint8_t*> levels(const uint8_t* base) const;
+
+    // Bytes held (levels 1 and up)
+    size_t bytes() const;
+
+    // Bytes of `count` levels starting at width x height, level 0 included
+    static size_t chain_bytes(int width, int height, int count);
+
+private:
+    int width_ = 0;
+    int height_ = 0;
+    std::vector<std::vector<uint8_t>> levels_;   // levels_[i] is level i + 1
+};
+
+} // namespace cafe
+
+#endif // CAFE_MIP_CHAIN_H
@@ -0,0 +1,604 @@
+#include "paged_tile_map.h"
+#include "sprite_sheet.h"
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <limits>
+
+namespace cafe {
+
+// ============================================================================
+// Chunk File Format
+// ============================================================================
+
+namespace {
+
+constexpr char kChunkFileMagic[4] = {'C', 'T', 'C', 'H'};
+constexpr uint32_t kChunkFileVersion = 1;
+
+// Payloads start on page boundaries so a chunk can be released on its own
+constexpr uint64_t kPayloadAlignment = 4096;
+
+struct ChunkFileHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t width;
+    uint32_t height;
+    uint32_t chunk_size;
+    uint32_t chunks_x;
+    uint32_t chunks_y;
+    uint32_t reserved;
+};
+static_assert(sizeof(ChunkFileHeader) == 32, "chunk file header must be 32 bytes");
+
+// On-disk tile: 4 bytes instead of the 12-byte Tile struct
+struct PackedTile {
+    uint16_t tile_id;
+    uint8_t height;
+    uint8_t flags;
+};
+static_assert(sizeof(PackedTile) == 4, "packed tile must be 4 bytes");
+
+uint64_t align_up(uint64_t value, uint64_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+// Zero bytes until the file position reaches `offset`
+bool pad_to(FILE* file, uint64_t& position, uint64_t offset) {
+    static const char zeros[4096] = {};
+    while (position < offset) {
+        size_t n = static_cast<size_t>(std::min<uint64_t>(offset - position, sizeof(zeros)));
+        if (std::fwrite(zeros, 1, n, file) != n) return false;
+        position += n;
+    }
+    return true;
+}
+
+double elapsed_us(std::chrono::steady_clock::time_point start) {
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::micro>(elapsed).count();
+}
+
+// Keep a few decode buffers around for the prefetch thread
+constexpr size_t kMaxSpareBuffers = 8;
+
+} // namespace
+
+bool PagedTileMap::write_chunk_file(const std::string& path, int width, int height,
+                                    const TileGenerator& generator, int chunk_size) {
+    if (width <= 0 || height <= 0 || !generator) {
+        std::cerr << "PagedTileMap: Invalid chunk file parameters: " << path << "\n";
+        return false;
+    }
+
+    int size = MIN_CHUNK_SIZE;
+    while (size < chunk_size && size < MAX_CHUNK_SIZE) {
+        size <<= 1;
+    }
+
+    ChunkFileHeader header;
+    std::memcpy(header.magic, kChunkFileMagic, sizeof(header.magic));
+    header.version = kChunkFileVersion;
+    header.width = static_cast<uint32_t>(width);
+    header.height = static_cast<uint32_t>(height);
+    header.chunk_size = static_cast<uint32_t>(size);
+    header.chunks_x = static_cast<uint32_t>((width + size - 1) / size);
+    header.chunks_y = static_cast<uint32_t>((height + size - 1) / size);
+    header.reserved = 0;
+
+    size_t chunk_count = static_cast<size_t>(header.chunks_x) * header.chunks_y;
+    std::vector<ChunkEntry> table(chunk_count, ChunkEntry{0, 0, 0});
+
+    FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        std::cerr << "PagedTileMap: Failed to create chunk file: " << path << "\n";
+        return false;
+    }
+
+    // Header and table are rewritten at the end, once offsets are known
+    uint64_t position = 0;
+    uint64_t table_end = sizeof(header) + chunk_count * sizeof(ChunkEntry);
+    bool ok = pad_to(file, position, align_up(table_end, kPayloadAlignment));
+
+    std::vector<PackedTile> packed(static_cast<size_t>(size) * size);
+    uint32_t chunk_bytes = static_cast<uint32_t>(packed.size() * sizeof(PackedTile));
+
+    for (int cy = 0; ok && cy < static_cast<int>(header.chunks_y); ++cy) {
+        for (int cx = 0; ok && cx < static_cast<int>(header.chunks_x); ++cx) {
+            bool any = false;
+            for (int ly = 0; ly < size; ++ly) {
+                for (int lx = 0; lx < size; ++lx) {
+                    int x = cx * size + lx;
+                    int y = cy * size + ly;
+                    Tile tile = (x < width && y < height) ? generator(x, y) : Tile{};
+
+                    PackedTile& p = packed[static_cast<size_t>(ly) * size + lx];
+                    p.tile_id = static_cast<uint16_t>(std::clamp(tile.tile_id, 0, 0xFFFF));
+                    p.height = static_cast<uint8_t>(std::clamp(tile.height, 0, 0xFF));
+                    p.flags = tile.flags;
+                    any |= p.tile_id != 0;
+                }
+            }
+            if (!any) continue;  // All-empty chunks are not stored
+
+            ChunkEntry& entry = table[static_cast<size_t>(cy) * header.chunks_x + cx];
+            entry.offset = position;
+            entry.bytes = chunk_bytes;
+
+            ok = std::fwrite(packed.data(), 1, chunk_bytes, file) == chunk_bytes;
+            position += chunk_bytes;
+            ok = ok && pad_to(file, position, align_up(position, kPayloadAlignment));
+        }
+    }
+
+    ok = ok && std::fseek(file, 0, SEEK_SET) == 0;
+    ok = ok && std::fwrite(&header, sizeof(header), 1, file) == 1;
+    ok = ok && std::fwrite(table.data(), sizeof(ChunkEntry), table.size(), file) == table.size();
+    ok = (std::fclose(file) == 0) && ok;
+
+    if (!ok) {
+        std::cerr << "PagedTileMap: Failed to write chunk file: " << path << "\n";
+    }
+    return ok;
+}
+
+bool PagedTileMap::write_chunk_file(const std::string& path, const TileMap& map, int chunk_size) {
+    return write_chunk_file(path, map.width(), map.height(),
+                            [&map](int x, int y) { return map.at(x, y); }, chunk_size);
+}
+
+// ============================================================================
+// Open / Close
+// ============================================================================
+
+PagedTileMap::~PagedTileMap() {
+    close();
+}
+
+bool PagedTileMap::open(const std::string& path) {
+    close();
+    if (!file_.open(path)) {
+        return false;
+    }
+
+    auto invalid = [&](const char* reason) {
+        std::cerr << "PagedTileMap: Invalid chunk file (" << reason << "): " << path << "\n";
+        file_.close();
+        return false;
+    };
+
+    ChunkFileHeader header;
+    if (file_.size() < sizeof(header)) return invalid("truncated header");
+    std::memcpy(&header, file_.data(), sizeof(header));
+
+    if (std::memcmp(header.magic, kChunkFileMagic, sizeof(header.magic)) != 0) return invalid("bad magic");
+    if (header.version != kChunkFileVersion) return invalid("unsupported version");
+    if (header.width == 0 || header.height == 0 ||
+        header.width > static_cast<uint32_t>(std::numeric_limits<int>::max()) ||
+        header.height > static_cast<uint32_t>(std::numeric_limits<int>::max())) {
+        return invalid("bad dimensions");
+    }
+    if (!std::has_single_bit(header.chunk_size) ||
+        header.chunk_size < MIN_CHUNK_SIZE || header.chunk_size > MAX_CHUNK_SIZE) {
+        return invalid("bad chunk size");
+    }
+    if (header.chunks_x != (header.width + header.chunk_size - 1) / header.chunk_size ||
+        header.chunks_y != (header.height + header.chunk_size - 1) / header.chunk_size) {
+        return invalid("bad chunk grid");
+    }
+
+    size_t chunk_count = static_cast<size_t>(header.chunks_x) * header.chunks_y;
+    if (file_.size() < sizeof(header) + chunk_count * sizeof(ChunkEntry)) return invalid("truncated table");
+    table_ = reinterpret_cast<const ChunkEntry*>(file_.data() + sizeof(header));
+
+    uint64_t chunk_bytes = uint64_t(header.chunk_size) * header.chunk_size * sizeof(PackedTile);
+    for (size_t i = 0; i < chunk_count; ++i) {
+        const ChunkEntry& entry = table_[i];
+        if (entry.bytes == 0) continue;
+        if (entry.bytes != chunk_bytes || entry.offset % alignof(PackedTile) != 0 ||
+            entry.offset > file_.size() || file_.size() - entry.offset < entry.bytes) {
+            table_ = nullptr;
+            return invalid("bad chunk table");
+        }
+    }
+
+    width_ = static_cast<int>(header.width);
+    height_ = static_cast<int>(header.height);
+    chunk_size_ = static_cast<int>(header.chunk_size);
+    chunk_shift_ = std::countr_zero(header.chunk_size);
+    chunks_x_ = static_cast<int>(header.chunks_x);
+    chunks_y_ = static_cast<int>(header.chunks_y);
+
+    slot_of_.assign(chunk_count, NOT_RESIDENT);
+    for (size_t i = 0; i < chunk_count; ++i) {
+        if (table_[i].bytes == 0) slot_of_[i] = EMPTY_CHUNK;
+    }
+    requested_.assign(chunk_count, 0);
+    visit_stamp_.assign(chunk_count, 0);
+    stamp_ = 0;
+    frame_ = 1;
+    has_last_camera_ = false;
+    velocity_ = Vec2();
+    stats_ = Stats();
+    set_memory_budget(memory_budget_);
+
+    stopping_ = false;
+    worker_ = std::thread(&PagedTileMap::worker_loop, this);
+    return true;
+}
+
+void PagedTileMap::close() {
+    stop_worker();
+
+    slots_.clear();
+    free_slots_.clear();
+    slot_of_.clear();
+    requested_.clear();
+    visit_stamp_.clear();
+    finished_.clear();
+    spare_buffers_.clear();
+
+    table_ = nullptr;
+    file_.close();
+    width_ = height_ = 0;
+    chunk_size_ = chunk_shift_ = 0;
+    chunks_x_ = chunks_y_ = 0;
+}
+
+// ============================================================================
+// Paging
+// ============================================================================
+
+void PagedTileMap::set_memory_budget(size_t bytes) {
+    memory_budget_ = bytes;
+    size_t chunk_bytes = static_cast<size_t>(chunk_size_) * chunk_size_ * sizeof(Tile);
+    budget_chunks_ = chunk_bytes > 0 ? static_cast<int>(std::max<size_t>(bytes / chunk_bytes, 1)) : 1;
+}
+
+void PagedTileMap::update(const Rect& viewport, float dt) {
+    if (!is_open()) return;
+    ++frame_;
+
+    // A frame that saw more chunks than fit went over budget: trim back
+    while (resident_count() > budget_chunks_) {
+        int victim = lru_slot(frame_);
+        if (victim < 0) break;
+        evict(victim);
+        std::vector<Tile>().swap(slots_[victim].tiles);
+    }
+
+    install_prefetched();
+
+    // Smoothed camera velocity in screen pixels per second
+    Vec2 camera = Isometric::camera();
+    if (has_last_camera_ && dt > 0.0f) {
+        float vx = (camera.x - last_camera_.x) / dt;
+        float vy = (camera.y - last_camera_.y) / dt;
+        velocity_.x = velocity_.x * 0.5f + vx * 0.5f;
+        velocity_.y = velocity_.y * 0.5f + vy * 0.5f;
+    }
+    last_camera_ = camera;
+    has_last_camera_ = true;
+
+    if (prefetch_enabled_) {
+        queue_prefetch(viewport);
+    }
+}
+
+bool PagedTileMap::is_resident(int chunk_x, int chunk_y) const {
+    if (chunk_x < 0 || chunk_x >= chunks_x_ || chunk_y < 0 || chunk_y >= chunks_y_) return false;
+    return slot_of_[static_cast<size_t>(chunk_y) * chunks_x_ + chunk_x] != NOT_RESIDENT;
+}
+
+const PagedTileMap::Stats& PagedTileMap::stats() const {
+    stats_.resident_chunks = resident_count();
+    stats_.budget_chunks = budget_chunks_;
+    stats_.resident_bytes = static_cast<size_t>(resident_count()) * chunk_size_ * chunk_size_ * sizeof(Tile);
+    return stats_;
+}
+
+void PagedTileMap::reset_stats() {
+    stats_ = Stats();
+}
+
+const Tile* PagedTileMap::fault(int chunk) const {
+    auto start = std::chrono::steady_clock::now();
+
+    int slot = claim_slot(true);
+    Slot& s = slots_[slot];
+    decode_chunk(chunk, s.tiles);
+    s.chunk = chunk;
+    s.last_used = frame_;
+    slot_of_[chunk] = slot;
+
+    double us = elapsed_us(start);
+    ++stats_.page_faults;
+    stats_.fault_stall_us += us;
+    record_load(us);
+    return s.tiles.data();
+}
+
+void PagedTileMap::decode_chunk(int chunk, std::vector<Tile>& tiles) const {
+    const ChunkEntry& entry = table_[chunk];
+    const auto* packed = reinterpret_cast<const PackedTile*>(file_.data() + entry.offset);
+
+    tiles.resize(static_cast<size_t>(chunk_size_) * chunk_size_);
+    for (size_t i = 0; i < tiles.size(); ++i) {
+        tiles[i].tile_id = packed[i].tile_id;
+        tiles[i].height = packed[i].height;
+        tiles[i].flags = packed[i].flags;
+    }
+
+    // The decoded copy is what we keep; drop the mapped pages
+    file_.release(entry.offset, entry.bytes);
+}
+
+void PagedTileMap::record_load(double us) const {
+    ++stats_.loads;
+    stats_.load_us_total += us;
+    stats_.load_us_max = std::max(stats_.load_us_max, us);
+}
+
+int PagedTileMap::lru_slot(uint64_t used_before) const {
+    int victim = -1;
+    uint64_t oldest = std::numeric_limits<uint64_t>::max();
+    for (size_t i = 0; i < slots_.size(); ++i) {
+        const Slot& s = slots_[i];
+        if (s.chunk >= 0 && s.last_used < used_before && s.last_used < oldest) {
+            oldest = s.last_used;
+            victim = static_cast<int>(i);
+        }
+    }
+    return victim;
+}
+
+int PagedTileMap::claim_slot(bool demand) const {
+    if (!free_slots_.empty()) {
+        int slot = free_slots_.back();
+        free_slots_.pop_back();
+        return slot;
+    }
+    if (resident_count() < budget_chunks_) {
+        slots_.emplace_back();
+        return static_cast<int>(slots_.size()) - 1;
+    }
+
+    // Page faults may evict anything not drawn this frame; prefetches must
+    // also leave last frame's chunks alone (they are about to be drawn)
+    int victim = lru_slot(demand ? frame_ : frame_ - 1);
+    if (victim >= 0) {
+        evict(victim);
+        free_slots_.pop_back();
+        return victim;
+    }
+
+    if (!demand) return -1;
+
+    // Everything resident is on screen: go over budget until the next update
+    slots_.emplace_back();
+    return static_cast<int>(slots_.size()) - 1;
+}
+
+void PagedTileMap::evict(int slot) const {
+    Slot& s = slots_[slot];
+    slot_of_[s.chunk] = NOT_RESIDENT;
+    s.chunk = -1;
+    free_slots_.push_back(slot);
+    ++stats_.evictions;
+}
+
+// ============================================================================
+// Prefetching
+// ============================================================================
+
+void PagedTileMap::collect_chunks(const Rect& area, std::vector<int>& chunks, bool record) const {
+    DiagonalRange diagonals = visible_diagonals(width_, height_, area);
+
+    for (int d = diagonals.first; d <= diagonals.last; ++d) {
+        DiagonalSpan span = visible_span(width_, height_, area, d);
+
+        // Same chunk segments as for_each_visible_diagonal()
+        int x = span.x_begin;
+        while (x <= span.x_end) {
+            int chunk_x = x >> chunk_shift_;
+            int chunk_y = (d - x) >> chunk_shift_;
+            int segment_end = std::min({span.x_end,
+                                        ((chunk_x + 1) << chunk_shift_) - 1,
+                                        d - (chunk_y << chunk_shift_)});
+
+            int chunk = chunk_y * chunks_x_ + chunk_x;
+            if (visit_stamp_[chunk] != stamp_) {
+                visit_stamp_[chunk] = stamp_;
+                if (record) chunks.push_back(chunk);
+            }
+            x = segment_end + 1;
+        }
+    }
+}
+
+void PagedTileMap::queue_prefetch(const Rect& viewport) {
+    if (++stamp_ == 0) {
+        std::fill(visit_stamp_.begin(), visit_stamp_.end(), 0u);
+        stamp_ = 1;
+    }
+
+    // Chunks on screen now are paged in by the draw; mark them as seen
+    prefetch_candidates_.clear();
+    collect_chunks(viewport, prefetch_candidates_, false);
+
+    // Sweep from the current viewport to where the camera will be
+    float lead_x = std::clamp(velocity_.x * lookahead_, -viewport.width, viewport.width);
+    float lead_y = std::clamp(velocity_.y * lookahead_, -viewport.height, viewport.height);
+    if (std::abs(lead_x) >= 1.0f || std::abs(lead_y) >= 1.0f) {
+        Rect ahead(viewport.x + std::min(lead_x, 0.0f), viewport.y + std::min(lead_y, 0.0f),
+                   viewport.width + std::abs(lead_x), viewport.height + std::abs(lead_y));
+        collect_chunks(ahead, prefetch_candidates_, true);
+
+        // Chunks nearest the predicted view come first
+        float target_x = viewport.x + lead_x + viewport.width * 0.5f;
+        float target_y = viewport.y + lead_y + viewport.height * 0.5f;
+        float centre = static_cast<float>(chunk_size_) * 0.5f;
+        prefetch_order_.clear();
+        for (int chunk : prefetch_candidates_) {
+            Vec2 screen = Isometric::tile_to_screen(
+                static_cast<float>(chunk % chunks_x_) * chunk_size_ + centre,
+                static_cast<float>(chunk / chunks_x_) * chunk_size_ + centre);
+            float dx = screen.x - target_x;
+            float dy = screen.y - target_y;
+            prefetch_order_.push_back({dx * dx + dy * dy, chunk});
+        }
+        std::sort(prefetch_order_.begin(), prefetch_order_.end());
+        for (size_t i = 0; i < prefetch_order_.size(); ++i) {
+            prefetch_candidates_[i] = prefetch_order_[i].second;
+        }
+    }
+
+    {
+        // Replace requests the worker has not started: the camera moved on
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (int chunk : requests_) {
+            requested_[chunk] = 0;
+        }
+        requests_.clear();
+
+        for (int chunk : prefetch_candidates_) {
+            if (slot_of_[chunk] == NOT_RESIDENT && !requested_[chunk]) {
+                requested_[chunk] = 1;
+                requests_.push_back(chunk);
+            }
+        }
+        stats_.queued = static_cast<int>(requests_.size());
+    }
+    if (stats_.queued > 0) {
+        wake_.notify_one();
+    }
+}
+
+void PagedTileMap::install_prefetched() {
+    std::vector<LoadedChunk> done;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        done.swap(finished_);
+    }
+    if (done.empty()) return;
+
+    std::vector<std::vector<Tile>> recycled;
+    for (LoadedChunk& loaded : done) {
+        requested_[loaded.chunk] = 0;
+        record_load(loaded.load_us);
+
+        // A page fault may have beaten the prefetch thread to it
+        int slot = slot_of_[loaded.chunk] == NOT_RESIDENT ? claim_slot(false) : -1;
+        if (slot < 0) {
+            ++stats_.prefetch_dropped;
+            recycled.push_back(std::move(loaded.tiles));
+            continue;
+        }
+
+        Slot& s = slots_[slot];
+        std::swap(s.tiles, loaded.tiles);
+        s.chunk = loaded.chunk;
+        s.last_used = frame_;
+        slot_of_[loaded.chunk] = slot;
+        ++stats_.prefetched;
+
+        if (loaded.tiles.capacity() > 0) {
+            recycled.push_back(std::move(loaded.tiles));
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& buffer : recycled) {
+        if (spare_buffers_.size() >= kMaxSpareBuffers) break;
+        spare_buffers_.push_back(std::move(buffer));
+    }
+}
+
+void PagedTileMap::worker_loop() {
+    for (;;) {
+        int chunk;
+        std::vector<Tile> tiles;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait(lock, [this] { return stopping_ || !requests_.empty(); });
+            if (stopping_) return;
+
+            chunk = requests_.front();
+            requests_.pop_front();
+            if (!spare_buffers_.empty()) {
+                tiles = std::move(spare_buffers_.back());
+                spare_buffers_.pop_back();
+            }
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        decode_chunk(chunk, tiles);
+        double us = elapsed_us(start);
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        finished_.push_back({chunk, std::move(tiles), us});
+    }
+}
+
+void PagedTileMap::stop_worker() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+        requests_.clear();
+    }
+    wake_.notify_all();
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+}
+
+// ============================================================================
+// Tile Access / Rendering
+// ============================================================================
+
+Tile PagedTileMap::at(int x, int y) const {
+    if (!in_bounds(x, y)) {
+        return Tile{};
+    }
+    const Tile* tiles = acquire_chunk((y >> chunk_shift_) * chunks_x_ + (x >> chunk_shift_));
+    if (!tiles) {
+        return Tile{};
+    }
+    int local_mask = chunk_size_ - 1;
+    return tiles[((y & local_mask) << chunk_shift_) | (x & local_mask)];
+}
+
+void PagedTileMap::for_each_visible(const Rect& viewport, const TileCallback& callback) const {
+    for_each_visible_diagonal(viewport, callback);
+}
+
+void PagedTileMap::render(Renderer* renderer, const Rect& viewport) const {
+    if (!tileset_ || !renderer) return;
+
+    renderer->begin_batch();
+
+    for_each_visible_diagonal(viewport, [&](int, int, const Tile& tile, float screen_x, float screen_y) {
+        Sprite sprite;
+        if (make_tile_sprite(*tileset_, tile, screen_x, screen_y, sprite)) {
+            renderer->draw_sprite(sprite);
+        }
+    });
+
+    renderer->end_batch();
+}
+
+size_t PagedTileMap::memory_bytes() const {
+    size_t bytes = 0;
+    for (const Slot& s : slots_) {
+        bytes += s.tiles.capacity() * sizeof(Tile);
+    }
+    bytes += slot_of_.capacity() * sizeof(int32_t);
+    bytes += requested_.capacity() * sizeof(uint8_t);
+    bytes += visit_stamp_.capacity() * sizeof(uint32_t);
+    return bytes;
+}
+
+} // namespace cafe
@@ -0,0 +1,338 @@
+#ifndef CAFE_PAGED_TILE_MAP_H
+#define CAFE_PAGED_TILE_MAP_H
+
+#include "isometric.h"
+#include "mapped_file.h"
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace cafe {
+
+// ============================================================================
+// PagedTileMap - Streaming tile map for worlds larger than memory
+// ============================================================================
+//
+// TileMap::resize() allocates the whole grid. A city with hundreds of cafes
+// does not fit, so PagedTileMap keeps the map on disk and only holds the
+// chunks around the camera in memory:
+//
+//   disk    chunk file, memory-mapped (pages cost nothing until touched)
+//   memory  at most memory_budget() bytes of decoded chunks, LRU evicted
+//
+// Chunk file layout (little-endian):
+//
+//   Header      magic "CTCH", version, width, height, chunk size, chunks x/y
+//   Chunk table one entry per chunk: byte offset + byte size (0 = all empty)
+//   Payload     per stored chunk, chunk_size^2 packed tiles, row-major
+//               (16-bit id, 8-bit height, 8-bit flags), page aligned
+//
+// All-empty chunks (streets, empty lots) take no space in the file and
+// are never loaded.
+//
+// Loading a chunk happens two ways:
+//   - Page fault: a visible tile's chunk is not resident, so it is decoded
+//     synchronously inside for_each_visible(). This stalls the frame.
+//   - Prefetch: update() looks at how the camera moved and queues the chunks
+//     the viewport is heading towards. A background thread decodes them and
+//     the next update() installs them, so they are resident before they
+//     scroll into view.
+//
+// A well-tuned budget and lookahead keeps page faults near zero while
+// scrolling; stats() reports faults, prefetches, evictions and load times.
+//
+// Usage:
+//   PagedTileMap::write_chunk_file("city.tiles", 8192, 8192, generate_city);
+//
+//   PagedTileMap map;
+//   map.open("city.tiles");
+//   map.set_memory_budget(32 * 1024 * 1024);
+//
+//   // Each frame, after moving the camera:
+//   map.update(viewport, dt);
+//   map.render(renderer, viewport);
+//
+// Threading: all methods are called from one thread. The prefetch thread
+// only reads the mapped file and hands decoded chunks back through a queue.
+//
+// ============================================================================
+
+class PagedTileMap {
+public:
+    static constexpr int DEFAULT_CHUNK_SIZE = 64;  // 64x64 tiles, 16 KB on disk
+    static constexpr int MIN_CHUNK_SIZE = 8;
+    static constexpr int MAX_CHUNK_SIZE = 256;
+
+    // Paging statistics (accumulated until reset_stats())
+    struct Stats {
+        int resident_chunks = 0;       // Chunks decoded in memory
+        int budget_chunks = 0;         // Chunks that fit in the memory budget
+        size_t resident_bytes = 0;     // Memory used by resident chunks
+        int queued = 0;                // Prefetch requests waiting for the worker
+        uint64_t page_faults = 0;      // Chunks loaded synchronously on access
+        uint64_t prefetched = 0;       // Chunks installed by the prefetch thread
+        uint64_t prefetch_dropped = 0; // Prefetched chunks discarded (faulted first, or no room)
+        uint64_t evictions = 0;        // Chunks dropped to stay within budget
+        uint64_t loads = 0;            // Chunk decodes (faults + prefetches)
+        double load_us_total = 0;      // Time spent decoding chunks
+        double load_us_max = 0;        // Slowest single chunk decode
+        double fault_stall_us = 0;     // Time callers were blocked in page faults
+
+        double average_load_us() const {
+            return loads > 0 ? load_us_total / static_cast<double>(loads) : 0.0;
+        }
+    };
+
+    // Produces the tile at (x, y) when writing a chunk file
+    using TileGenerator = std::function<Tile(int x, int y)>;
+
+    // Same callback as TileMap::for_each_visible()
+    using TileCallback = TileMap::TileCallback;
+
+    PagedTileMap() = default;
+    ~PagedTileMap();
+
+    // Non-copyable (owns the mapping and the prefetch thread)
+    PagedTileMap(const PagedTileMap&) = delete;
+    PagedTileMap& operator=(const PagedTileMap&) = delete;
+
+    // ========================================================================
+    // Chunk Files
+    // ========================================================================
+
+    // Write a chunk file one chunk at a time (the map is never fully in memory)
+    // chunk_size is rounded up to a power of two in [8, 256]
+    static bool write_chunk_file(const std::string& path, int width, int height,
+                                 const TileGenerator& generator,
+                                 int chunk_size = DEFAULT_CHUNK_SIZE);
+
+    // Write an existing TileMap as a chunk file
+    static bool write_chunk_file(const std::string& path, const TileMap& map,
+                                 int chunk_size = DEFAULT_CHUNK_SIZE);
+
+    // Map a chunk file and start the prefetch thread
+    bool open(const std::string& path);
+    void close();
+    bool is_open() const { return file_.is_open(); }
+
+    // Dimensions
+    int width() const { return width_; }
+    int height() const { return height_; }
+    int chunk_size() const { return chunk_size_; }
+    int chunks_x() const { return chunks_x_; }
+    int chunks_y() const { return chunks_y_; }
+
+    bool in_bounds(int x, int y) const {
+        return x >= 0 && x < width_ && y >= 0 && y < height_;
+    }
+
+    // ========================================================================
+    // Paging
+    // ========================================================================
+
+    // Memory for decoded chunks (at least one chunk)
+    // The budget may be exceeded briefly when one frame sees more chunks
+    // than fit; the next update() trims back down.
+    void set_memory_budget(size_t bytes);
+    size_t memory_budget() const { return memory_budget_; }
+
+    // How far ahead (in seconds of camera movement) to prefetch
+    void set_prefetch_lookahead(float seconds) { lookahead_ = seconds; }
+    float prefetch_lookahead() const { return lookahead_; }
+
+    void set_prefetch_enabled(bool enabled) { prefetch_enabled_ = enabled; }
+    bool prefetch_enabled() const { return prefetch_enabled_; }
+
+    // Call once per frame before drawing: installs finished prefetches,
+    // trims to the budget and queues chunks ahead of the camera
+    void update(const Rect& viewport, float dt);
+
+    // Is chunk (cx, cy) in memory (or known to be empty)?
+    bool is_resident(int chunk_x, int chunk_y) const;
+
+    // Counters plus the current residency
+    const Stats& stats() const;
+    void reset_stats();
+
+    // ========================================================================
+    // Tile Access / Rendering
+    // ========================================================================
+
+    // Read a tile (pages its chunk in if needed)
+    // Out-of-bounds reads return an empty tile
+    Tile at(int x, int y) const;
+
+    // Set tileset (sprite sheet containing tile graphics)
+    void set_tileset(SpriteSheet* tileset) { tileset_ = tileset; }
+    SpriteSheet* tileset() const { return tileset_; }
+
+    // Render all visible tiles in diagonal order
+    void render(Renderer* renderer, const Rect& viewport) const;
+
+    // Visit visible tiles back to front, like TileMap::for_each_visible()
+    // Order is the diagonal sweep (see TileMap::for_each_visible_diagonal())
+    void for_each_visible(const Rect& viewport, const TileCallback& callback) const;
+
+    // Same contract as TileMap::for_each_visible_diagonal()
+    // Non-resident chunks are paged in on the way (counted as page faults)
+    template<typename Fn>
+    void for_each_visible_diagonal(const Rect& viewport, Fn&& callback) const;
+
+    // Resident chunk memory plus the per-chunk bookkeeping
+    size_t memory_bytes() const;
+
+private:
+    // On-disk chunk table entry
+    struct ChunkEntry {
+        uint64_t offset;
+        uint32_t bytes;    // 0 = every tile empty, nothing stored
+        uint32_t reserved;
+    };
+
+    // One resident chunk
+    struct Slot {
+        int chunk = -1;           // -1 = free
+        uint64_t last_used = 0;   // Frame of last access (LRU)
+        std::vector<Tile> tiles;  // chunk_size^2, row-major
+    };
+
+    // A chunk decoded by the prefetch thread, waiting to be installed
+    struct LoadedChunk {
+        int chunk;
+        std::vector<Tile> tiles;
+        double load_us;
+    };
+
+    static constexpr int32_t NOT_RESIDENT = -1;
+    static constexpr int32_t EMPTY_CHUNK = -2;
+
+    // Resident chunk tiles, or nullptr for an all-empty chunk
+    const Tile* acquire_chunk(int chunk) const;
+    const Tile* fault(int chunk) const;
+
+    // Decode a chunk from the mapping (safe on the prefetch thread)
+    void decode_chunk(int chunk, std::vector<Tile>& tiles) const;
+
+    // Find a slot for a new chunk; prefetches never evict recently used chunks
+    // Returns -1 if there is no room
+    int claim_slot(bool demand) const;
+    int lru_slot(uint64_t used_before) const;
+    void evict(int slot) const;
+    void record_load(double us) const;
+    int resident_count() const { return static_cast<int>(slots_.size() - free_slots_.size()); }
+
+    // Chunks overlapping the diagonals visible in `area`
+    void collect_chunks(const Rect& area, std::vector<int>& chunks, bool record) const;
+
+    void install_prefetched();
+    void queue_prefetch(const Rect& viewport);
+    void worker_loop();
+    void stop_worker();
+
+    MappedFile file_;
+    const ChunkEntry* table_ = nullptr;  // Points into the mapping
+
+    int width_ = 0;
+    int height_ = 0;
+    int chunk_size_ = 0;
+    int chunk_shift_ = 0;
+    int chunks_x_ = 0;
+    int chunks_y_ = 0;
+
+    size_t memory_budget_ = 64 * 1024 * 1024;
+    int budget_chunks_ = 1;
+    float lookahead_ = 0.5f;
+    bool prefetch_enabled_ = true;
+
+    // Camera motion (screen pixels per second, smoothed)
+    Vec2 last_camera_;
+    Vec2 velocity_;
+    bool has_last_camera_ = false;
+
+    // Paging state - main thread only. Paging is a cache, so reads through
+    // const methods may still load and evict chunks.
+    mutable std::vector<Slot> slots_;
+    mutable std::vector<int> free_slots_;
+    mutable std::vector<int32_t> slot_of_;    // Per chunk: slot, NOT_RESIDENT or EMPTY_CHUNK
+    std::vector<uint8_t> requested_;          // Per chunk: queued or being decoded
+    mutable std::vector<uint32_t> visit_stamp_;
+    std::vector<int> prefetch_candidates_;
+    std::vector<std::pair<float, int>> prefetch_order_;  // (distance, chunk)
+    mutable uint32_t stamp_ = 0;
+    mutable uint64_t frame_ = 1;
+    mutable Stats stats_;
+
+    // Shared with the prefetch thread (guarded by mutex_)
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::deque<int> requests_;
+    std::vector<LoadedChunk> finished_;
+    std::vector<std::vector<Tile>> spare_buffers_;
+    bool stopping_ = false;
+    std::thread worker_;
+
+    SpriteSheet* tileset_ = nullptr;
+};
+
+// ============================================================================
+// PagedTileMap Inline / Template Implementation
+// ============================================================================
+
+inline const Tile* PagedTileMap::acquire_chunk(int chunk) const {
+    int32_t slot = slot_of_[chunk];
+    if (slot >= 0) {
+        slots_[slot].last_used = frame_;
+        return slots_[slot].tiles.data();
+    }
+    return slot == EMPTY_CHUNK ? nullptr : fault(chunk);
+}
+
+template<typename Fn>
+void PagedTileMap::for_each_visible_diagonal(const Rect& viewport, Fn&& callback) const {
+    DiagonalRange diagonals = visible_diagonals(width_, height_, viewport);
+
+    const float half_width = Isometric::tile_width() * 0.5f;
+    const float half_height = Isometric::tile_height() * 0.5f;
+    const Vec2 cam = Isometric::camera();
+    const int local_mask = chunk_size_ - 1;
+
+    for (int d = diagonals.first; d <= diagonals.last; ++d) {
+        DiagonalSpan span = visible_span(width_, height_, viewport, d);
+        float screen_y = static_cast<float>(d) * half_height - cam.y;
+
+        // Walk the diagonal one chunk segment at a time: a segment stays in
+        // its chunk until x leaves the chunk column or y leaves the chunk row
+        int x = span.x_begin;
+        while (x <= span.x_end) {
+            int chunk_x = x >> chunk_shift_;
+            int chunk_y = (d - x) >> chunk_shift_;
+            int segment_end = std::min({span.x_end,
+                                        ((chunk_x + 1) << chunk_shift_) - 1,
+                                        d - (chunk_y << chunk_shift_)});
+
+            const Tile* tiles = acquire_chunk(chunk_y * chunks_x_ + chunk_x);
+            if (tiles) {
+                for (; x <= segment_end; ++x) {
+                    int y = d - x;
+                    const Tile& tile = tiles[((y & local_mask) << chunk_shift_) | (x & local_mask)];
+                    if (tile.is_empty()) continue;
+
+                    float screen_x = static_cast<float>(x - y) * half_width - cam.x;
+                    callback(x, y, tile, screen_x, screen_y);
+                }
+            }
+            x = segment_end + 1;
+        }
+    }
+}
+
+} // namespace cafe
+
+#endif // CAFE_PAGED_TILE_MAP_H
@@ -0,0 +1,580 @@
+#include "profiler.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace cafe {
+
+// ============================================================================
+// Per-thread Ring Buffers
+// ============================================================================
+
+namespace {
+
+constexpr size_t kDefaultCapacity = 1 << 16;   // 64K zones, 1.5 MB per thread
+constexpr size_t kMaxFrameMarks = 1 << 20;
+
+// One zone. The fields are relaxed atomics so a capture reading a slot the
+// owner is overwriting is well defined; such zones are dropped (below).
+// On x86 and ARM a relaxed store is a plain store.
+struct Slot {
+    std::atomic<const char*> name{nullptr};
+    std::atomic<uint64_t> start{0};
+    std::atomic<uint64_t> end{0};
+    std::atomic<uint32_t> depth{0};
+};
+
+struct ThreadBuffer {
+    std::unique_ptr<Slot[]> slots;
+    size_t capacity = 0;
+    std::atomic<uint64_t> head{0};      // Zones ever written (owner thread)
+    uint64_t drained = 0;               // Zones already captured (under registry lock)
+    std::string name;
+};
+
+struct Registry {
+    std::mutex mutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> threads;
+    size_t capacity = kDefaultCapacity;
+
+    std::vector<uint64_t> frames;
+
+    // Two (tick, steady ns) pairs give the tick rate
+    bool calibrated = false;
+    uint64_t base_tick = 0;
+    int64_t base_ns = 0;
+};
+
+// Buffers live until exit: a thread that ended still has zones to capture
+Registry& registry() {
+    static Registry* instance = new Registry();
+    return *instance;
+}
+
+thread_local ThreadBuffer* t_buffer = nullptr;
+thread_local std::string t_thread_name;
+
+int64_t steady_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+ThreadBuffer* register_thread() {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+
+    auto buffer = std::make_unique<ThreadBuffer>();
+    buffer->capacity = reg.capacity;
+    buffer->slots = std::make_unique<Slot[]>(buffer->capacity);
+    buffer->name = !t_thread_name.empty() ? t_thread_name
+                                          : "thread " + std::to_string(reg.threads.size());
+    reg.threads.push_back(std::move(buffer));
+    return reg.threads.back().get();
+}
+
+} // namespace
+
+// ============================================================================
+// Profiler
+// ============================================================================
+
+std::atomic<bool> Profiler::enabled_{false};
+
+void Profiler::set_enabled(bool enabled) {
+    if (enabled) {
+        Registry& reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        if (!reg.calibrated) {
+            reg.base_tick = now();
+            reg.base_ns = steady_ns();
+            reg.calibrated = true;
+        }
+    }
+    enabled_.store(enabled, std::memory_order_relaxed);
+}
+
+void Profiler::set_buffer_capacity(size_t events) {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    reg.capacity = std::max<size_t>(events, 64);
+}
+
+void Profiler::set_thread_name(const std::string& name) {
+    t_thread_name = name;
+    if (t_buffer) {
+        Registry& reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        t_buffer->name = name;
+    }
+}
+
+void Profiler::mark_frame() {
+    if (!is_enabled()) return;
+
+    uint64_t tick = now();
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    if (reg.frames.size() >= kMaxFrameMarks) {
+        reg.frames.erase(reg.frames.begin(), reg.frames.begin() + kMaxFrameMarks / 2);
+    }
+    reg.frames.push_back(tick);
+}
+
+void Profiler::record(const char* name, uint64_t start, uint64_t end, uint32_t depth) {
+    ThreadBuffer* buffer = t_buffer;
+    if (!buffer) {
+        buffer = t_buffer = register_thread();
+    }
+
+    // Single producer: only this thread moves head. The fence orders the
+    // previous head store before the slot stores, so a capture that sees
+    // a half-written slot also sees the head that marks it overwritten.
+    uint64_t head = buffer->head.load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    Slot& slot = buffer->slots[head % buffer->capacity];
+    slot.name.store(name, std::memory_order_relaxed);
+    slot.start.store(start, std::memory_order_relaxed);
+    slot.end.store(end, std::memory_order_relaxed);
+    slot.depth.store(depth, std::memory_order_relaxed);
+    buffer->head.store(head + 1, std::memory_order_release);
+}
+
+ProfileCapture Profiler::capture() {
+    ProfileCapture result;
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+
+#if CAFE_PROFILER_RDTSC
+    if (reg.calibrated) {
+        uint64_t ticks = now() - reg.base_tick;
+        int64_t ns = steady_ns() - reg.base_ns;
+        if (ticks > 0 && ns > 0) {
+            result.ns_per_tick = static_cast<double>(ns) / static_cast<double>(ticks);
+        }
+    }
+#endif
+
+    // Names are deduplicated by text: the same literal in two translation
+    // units can have two addresses
+    std::unordered_map<const char*, uint32_t> by_pointer;
+    std::unordered_map<std::string, uint32_t> by_text;
+    auto name_index = [&](const char* name) {
+        auto found = by_pointer.find(name);
+        if (found != by_pointer.end()) return found->second;
+        auto [it, added] = by_text.emplace(name, static_cast<uint32_t>(result.names.size()));
+        if (added) result.names.push_back(name);
+        by_pointer.emplace(name, it->second);
+        return it->second;
+    };
+
+    for (auto& buffer : reg.threads) {
+        uint64_t head = buffer->head.load(std::memory_order_acquire);
+        uint64_t first = std::max(buffer->drained,
+                                  head > buffer->capacity ? head - buffer->capacity : 0);
+
+        std::vector<ProfileCapture::Event> events;
+        events.reserve(static_cast<size_t>(head - first));
+        std::vector<const char*> names;
+        names.reserve(static_cast<size_t>(head - first));
+        for (uint64_t i = first; i < head; ++i) {
+            const Slot& slot = buffer->slots[i % buffer->capacity];
+            names.push_back(slot.name.load(std::memory_order_relaxed));
+            events.push_back({0, 0, slot.depth.load(std::memory_order_relaxed),
+                              slot.start.load(std::memory_order_relaxed),
+                              slot.end.load(std::memory_order_relaxed)});
+        }
+
+        // Zones the owner overwrote while we copied are torn: skip them
+        // (slot head_after may be mid-write, so its old zone goes too)
+        std::atomic_thread_fence(std::memory_order_acquire);
+        uint64_t head_after = buffer->head.load(std::memory_order_relaxed);
+        uint64_t valid_from = head_after + 1 > buffer->capacity ? head_after + 1 - buffer->capacity : 0;
+        size_t skip = valid_from > first ? static_cast<size_t>(std::min(valid_from, head) - first) : 0;
+        buffer->drained = head;
+
+        if (skip == events.size()) continue;
+        uint32_t thread = static_cast<uint32_t>(result.threads.size());
+        result.threads.push_back(buffer->name);
+        for (size_t i = skip; i < events.size(); ++i) {
+            ProfileCapture::Event event = events[i];
+            event.name = name_index(names[i]);
+            event.thread = thread;
+            result.events.push_back(event);
+        }
+    }
+
+    std::sort(result.events.begin(), result.events.end(),
+              [](const ProfileCapture::Event& a, const ProfileCapture::Event& b) {
+                  return a.start < b.start || (a.start == b.start && a.depth < b.depth);
+              });
+    result.frames.swap(reg.frames);
+
+    result.origin = result.events.empty() ? 0 : result.events.front().start;
+    if (!result.frames.empty()) {
+        result.origin = result.events.empty() ? result.frames.front()
+                                              : std::min(result.origin, result.frames.front());
+    }
+    return result;
+}
+
+void Profiler::clear() {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    for (auto& buffer : reg.threads) {
+        buffer->drained = buffer->head.load(std::memory_order_acquire);
+    }
+    reg.frames.clear();
+}
+
+// ============================================================================
+// Summary
+// ============================================================================
+
+std::vector<ProfileZoneStats> ProfileCapture::summarize() const {
+    // Frame i spans [frames[i], frames[i + 1]); zones outside complete
+    // frames are left out. No marks: the whole capture is one frame.
+    size_t frame_count = frames.size() >= 2 ? frames.size() - 1 : 1;
+    auto frame_of = [&](uint64_t tick) -> int64_t {
+        if (frames.size() < 2) return 0;
+        auto it = std::upper_bound(frames.begin(), frames.end(), tick);
+        if (it == frames.begin() || it == frames.end()) return -1;
+        return static_cast<int64_t>(it - frames.begin()) - 1;
+    };
+
+    // Per-frame tick totals, one row per zone
+    std::vector<std::vector<uint64_t>> totals(names.size(), std::vector<uint64_t>(frame_count, 0));
+    std::vector<uint64_t> calls(names.size(), 0);
+    for (const Event& event : events) {
+        int64_t frame = frame_of(event.start);
+        if (frame < 0) continue;
+        totals[event.name][static_cast<size_t>(frame)] += event.end - event.start;
+        ++calls[event.name];
+    }
+
+    std::vector<ProfileZoneStats> stats;
+    std::vector<double> per_frame;
+    for (size_t zone = 0; zone < names.size(); ++zone) {
+        per_frame.clear();
+        for (uint64_t total : totals[zone]) {
+            if (total > 0) per_frame.push_back(to_ms(total));
+        }
+        if (per_frame.empty()) continue;
+
+        std::sort(per_frame.begin(), per_frame.end());
+        ProfileZoneStats zone_stats;
+        zone_stats.name = names[zone];
+        zone_stats.calls = calls[zone];
+        zone_stats.frames = static_cast<int>(per_frame.size());
+        zone_stats.min_ms = per_frame.front();
+        zone_stats.max_ms = per_frame.back();
+        double sum = 0.0;
+        for (double ms : per_frame) sum += ms;
+        zone_stats.avg_ms = sum / static_cast<double>(per_frame.size());
+        zone_stats.p99_ms = per_frame[static_cast<size_t>(0.99 * static_cast<double>(per_frame.size() - 1))];
+        stats.push_back(std::move(zone_stats));
+    }
+
+    // Most total time first
+    std::sort(stats.begin(), stats.end(), [](const ProfileZoneStats& a, const ProfileZoneStats& b) {
+        return a.avg_ms * a.frames > b.avg_ms * b.frames;
+    });
+    return stats;
+}
+
+void ProfileCapture::print_summary(std::ostream& out) const {
+    std::vector<ProfileZoneStats> stats = summarize();
+    size_t frame_count = frames.size() >= 2 ? frames.size() - 1 : 1;
+
+    char line[256];
+    std::snprintf(line, sizeof(line), "%zu zones, %zu threads, %zu frames\n",
+                  events.size(), threads.size(), frame_count);
+    out << line;
+    std::snprintf(line, sizeof(line), "%-32s %8s %7s %9s %9s %9s %9s\n",
+                  "zone (ms per frame)", "calls/f", "frames", "min", "avg", "max", "p99");
+    out << line;
+    for (const ProfileZoneStats& zone : stats) {
+        std::snprintf(line, sizeof(line), "%-32.32s %8.1f %7d %9.3f %9.3f %9.3f %9.3f\n",
+                      zone.name.c_str(),
+                      static_cast<double>(zone.calls) / static_cast<double>(zone.frames),
+                      zone.frames, zone.min_ms, zone.avg_ms, zone.max_ms, zone.p99_ms);
+        out << line;
+    }
+}
+
+// ============================================================================
+// Chrome Trace Export
+// ============================================================================
+//
+// The Trace Event Format read by chrome://tracing and ui.perfetto.dev:
+// one complete ("X") event per zone with microsecond start and duration,
+// a metadata event naming each thread, and an instant event per frame.
+
+namespace {
+
+void write_json_string(std::ostream& out, const std::string& text) {
+    out << '"';
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            out << '\\' << c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            char escaped[8];
+            std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+            out << escaped;
+        } else {
+            out << c;
+        }
+    }
+    out << '"';
+}
+
+} // namespace
+
+void ProfileCapture::write_chrome_trace(std::ostream& out) const {
+    auto micros = [&](uint64_t ticks) {
+        char text[32];
+        std::snprintf(text, sizeof(text), "%.3f", static_cast<double>(ticks) * ns_per_tick * 1e-3);
+        return std::string(text);
+    };
+
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    bool first = true;
+    auto separator = [&]() {
+        if (!first) out << ",\n";
+        first = false;
+    };
+
+    for (size_t i = 0; i < threads.size(); ++i) {
+        separator();
+        out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << i << ",\"args\":{\"name\":";
+        write_json_string(out, threads[i]);
+        out << "}}";
+    }
+    for (uint64_t frame : frames) {
+        separator();
+        out << "{\"name\":\"Frame\",\"ph\":\"i\",\"s\":\"g\",\"pid\":1,\"tid\":0,\"ts\":"
+            << micros(frame - origin) << "}";
+    }
+    for (const Event& event : events) {
+        separator();
+        out << "{\"name\":";
+        write_json_string(out, names[event.name]);
+        out << ",\"cat\":\"cafe\",\"ph\":\"X\",\"pid\":1,\"tid\":" << event.thread
+            << ",\"ts\":" << micros(event.start - origin)
+            << ",\"dur\":" << micros(event.end - event.start) << "}";
+    }
+    out << "\n]}\n";
+}
+
+bool ProfileCapture::write_chrome_trace(const std::string& path) const {
+    std::ofstream file(path);
+    if (!file) {
+        std::cerr << "ProfileCapture: Failed to create file: " << path << "\n";
+        return false;
+    }
+    write_chrome_trace(file);
+    file.close();
+    if (!file) {
+        std::cerr << "ProfileCapture: Failed to write file: " << path << "\n";
+        return false;
+    }
+    return true;
+}
+
+// ============================================================================
+// Binary Format
+// ============================================================================
+//
+// Header, then varints: strings as length + bytes, events sorted by start
+// with starts delta-coded, so a zone is typically 6-8 bytes instead of
+// the 28 of a ProfileCapture::Event.
+//
+//   names    count, { length, bytes }
+//   threads  count, { length, bytes }
+//   events   count, { start - previous start, end - start, name, thread, depth }
+//   frames   count, { tick - previous tick }
+
+namespace {
+
+constexpr char kProfileMagic[4] = {'C', 'P', 'R', 'F'};
+
+struct ProfileHeader {
+    char magic[4];
+    uint32_t version;
+    double ns_per_tick;
+    uint64_t origin;
+    uint64_t data_bytes;            // Encoded tables after the header
+};
+static_assert(sizeof(ProfileHeader) == 32, "profile header must be 32 bytes");
+
+void put_varint(std::vector<uint8_t>& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+void put_string(std::vector<uint8_t>& out, const std::string& text) {
+    put_varint(out, text.size());
+    out.insert(out.end(), text.begin(), text.end());
+}
+
+// Bounds-checked reads; false once the data runs out
+struct Reader {
+    const std::vector<uint8_t>& data;
+    size_t cursor = 0;
+
+    bool varint(uint64_t& value) {
+        value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (cursor >= data.size()) return false;
+            uint8_t b = data[cursor++];
+            value |= static_cast<uint64_t>(b & 0x7F) << shift;
+            if ((b & 0x80) == 0) return true;
+        }
+        return false;
+    }
+
+    bool string(std::string& text) {
+        uint64_t length;
+        if (!varint(length) || length > data.size() - cursor) return false;
+        text.assign(reinterpret_cast<const char*>(data.data() + cursor), static_cast<size_t>(length));
+        cursor += static_cast<size_t>(length);
+        return true;
+    }
+
+    // A count that cannot exceed the bytes left (each entry takes one or more)
+    bool count(uint64_t& value) {
+        return varint(value) && value <= data.size() - cursor;
+    }
+};
+
+} // namespace
+
+bool ProfileCapture::save(const std::string& path) const {
+    std::vector<uint8_t> data;
+    put_varint(data, names.size());
+    for (const std::string& name : names) put_string(data, name);
+    put_varint(data, threads.size());
+    for (const std::string& thread : threads) put_string(data, thread);
+
+    put_varint(data, events.size());
+    uint64_t previous = origin;
+    for (const Event& event : events) {
+        put_varint(data, event.start - previous);
+        put_varint(data, event.end - event.start);
+        put_varint(data, event.name);
+        put_varint(data, event.thread);
+        put_varint(data, event.depth);
+        previous = event.start;
+    }
+
+    put_varint(data, frames.size());
+    previous = origin;
+    for (uint64_t frame : frames) {
+        put_varint(data, frame - previous);
+        previous = frame;
+    }
+
+    ProfileHeader header;
+    std::memcpy(header.magic, kProfileMagic, 4);
+    header.version = VERSION;
+    header.ns_per_tick = ns_per_tick;
+    header.origin = origin;
+    header.data_bytes = data.size();
+
+    FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        std::cerr << "ProfileCapture: Failed to create file: " << path << "\n";
+        return false;
+    }
+    bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1;
+    ok = ok && std::fwrite(data.data(), 1, data.size(), file) == data.size();
+    ok = (std::fclose(file) == 0) && ok;
+
+    if (!ok) {
+        std::cerr << "ProfileCapture: Failed to write file: " << path << "\n";
+        std::remove(path.c_str());
+    }
+    return ok;
+}
+
+bool ProfileCapture::load(const std::string& path) {
+    FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) {
+        std::cerr << "ProfileCapture: Failed to open file: " << path << "\n";
+        return false;
+    }
+
+    ProfileHeader header;
+    bool ok = std::fread(&header, sizeof(header), 1, file) == 1 &&
+              std::memcmp(header.magic, kProfileMagic, 4) == 0 &&
+              header.version == VERSION &&
+              header.data_bytes < (uint64_t(1) << 32);
+    std::vector<uint8_t> data;
+    if (ok) {
+        data.resize(static_cast<size_t>(header.data_bytes));
+        ok = data.empty() || std::fread(data.data(), 1, data.size(), file) == data.size();
+    }
+    std::fclose(file);
+
+    ProfileCapture loaded;
+    Reader in{data};
+    uint64_t count = 0;
+    if (ok) {
+        loaded.ns_per_tick = header.ns_per_tick;
+        loaded.origin = header.origin;
+
+        ok = in.count(count);
+        for (uint64_t i = 0; ok && i < count; ++i) {
+            loaded.names.emplace_back();
+            ok = in.string(loaded.names.back());
+        }
+        ok = ok && in.count(count);
+        for (uint64_t i = 0; ok && i < count; ++i) {
+            loaded.threads.emplace_back();
+            ok = in.string(loaded.threads.back());
+        }
+
+        ok = ok && in.count(count);
+        uint64_t previous = loaded.origin;
+        for (uint64_t i = 0; ok && i < count; ++i) {
+            uint64_t delta, duration, name, thread, depth;
+            ok = in.varint(delta) && in.varint(duration) && in.varint(name) &&
+                 in.varint(thread) && in.varint(depth) &&
+                 name < loaded.names.size() && thread < loaded.threads.size();
+            if (!ok) break;
+            Event event;
+            event.start = previous + delta;
+            event.end = event.start + duration;
+            event.name = static_cast<uint32_t>(name);
+            event.thread = static_cast<uint32_t>(thread);
+            event.depth = static_cast<uint32_t>(depth);
+            loaded.events.push_back(event);
+            previous = event.start;
+        }
+
+        ok = ok && in.count(count);
+        previous = loaded.origin;
+        for (uint64_t i = 0; ok && i < count; ++i) {
+            uint64_t delta;
+            ok = in.varint(delta);
+            previous += delta;
+            loaded.frames.push_back(previous);
+        }
+    }
+
+    if (!ok) {
+        std::cerr << "ProfileCapture: Not a valid profile: " << path << "\n";
+        return false;
+    }
+    *this = std::move(loaded);
+    return true;
+}
+
+} // namespace cafe
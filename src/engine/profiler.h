@@ -0,0 +1,186 @@
+#ifndef CAFE_PROFILER_H
+#define CAFE_PROFILER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <x86intrin.h>
+#define CAFE_PROFILER_RDTSC 1
+#endif
+
+// Build switch (CMake option CAFE_PROFILER). Off: every macro below
+// expands to nothing, so instrumented code costs nothing.
+#ifndef CAFE_PROFILER
+#define CAFE_PROFILER 0
+#endif
+
+namespace cafe {
+
+// ============================================================================
+// Profiler - Scoped CPU zones, per-thread ring buffers, trace export
+// ============================================================================
+//
+// Mark code with a zone; the name must be a string literal:
+//
+//   void TileMap::render(...) {
+//       CAFE_PROFILE_SCOPE("TileMap::render");
+//       ...
+//   }
+//
+// A zone is two timestamps (rdtsc on x86-64, steady_clock elsewhere)
+// written into the calling thread's ring buffer when the scope ends. No
+// locks and no allocation on that path: each thread owns its buffer, and
+// only a thread's first zone registers it with the profiler. A full ring
+// overwrites its oldest zones, so a capture holds the most recent ones.
+//
+// Zones are recorded only while the profiler is enabled; otherwise a
+// zone costs one relaxed atomic load. GameLoop calls CAFE_PROFILE_FRAME()
+// at the start of every frame so captures can be cut into frames, and
+// CAFE_PROFILE_THREAD("sim") labels a thread.
+//
+//   Profiler::set_enabled(true);
+//   ... run some frames ...
+//   ProfileCapture capture = Profiler::capture();
+//   capture.write_chrome_trace("frame.json");   // chrome://tracing, Perfetto
+//   capture.save("frame.cprof");                // Compact binary
+//   capture.print_summary(std::cout);           // Per-zone min/avg/max/p99
+//
+// tools/profile_trace.cpp turns a .cprof into trace JSON and a summary.
+//
+// ============================================================================
+
+// Per-zone timing over the frames a capture spans
+struct ProfileZoneStats {
+    std::string name;
+    uint64_t calls = 0;
+    int frames = 0;                 // Frames the zone ran in
+    double min_ms = 0.0;            // Of per-frame totals
+    double avg_ms = 0.0;
+    double max_ms = 0.0;
+    double p99_ms = 0.0;
+};
+
+// Zones drained from every thread, independent of the live profiler
+class ProfileCapture {
+public:
+    static constexpr uint32_t VERSION = 1;
+    static constexpr const char* EXTENSION = ".cprof";
+
+    struct Event {
+        uint32_t name;              // Index into names
+        uint32_t thread;            // Index into threads
+        uint32_t depth;
+        uint64_t start;             // Ticks
+        uint64_t end;
+    };
+
+    std::vector<std::string> names;
+    std::vector<std::string> threads;
+    std::vector<Event> events;      // Sorted by start
+    std::vector<uint64_t> frames;   // Frame start ticks
+    double ns_per_tick = 1.0;
+    uint64_t origin = 0;            // Tick all times are relative to
+
+    double to_ms(uint64_t ticks) const { return static_cast<double>(ticks) * ns_per_tick * 1e-6; }
+
+    // Per zone, over complete frames (all frames if none were marked)
+    std::vector<ProfileZoneStats> summarize() const;
+    void print_summary(std::ostream& out) const;
+
+    bool write_chrome_trace(const std::string& path) const;
+    void write_chrome_trace(std::ostream& out) const;
+
+    bool save(const std::string& path) const;
+    bool load(const std::string& path);
+};
+
+class Profiler {
+public:
+    // Record zones from now on (off by default)
+    static void set_enabled(bool enabled);
+    static bool is_enabled() { return enabled_.load(std::memory_order_relaxed); }
+
+    // Zones kept per thread; applies to threads that have not recorded yet
+    static void set_buffer_capacity(size_t events);
+
+    // Label the calling thread in captures ("main", "sim", "worker 2")
+    static void set_thread_name(const std::string& name);
+
+    // Start a new frame (GameLoop calls this through CAFE_PROFILE_FRAME)
+    static void mark_frame();
+
+    // Drain every thread's zones (and the frame marks) into a capture
+    static ProfileCapture capture();
+
+    // Drop everything recorded so far
+    static void clear();
+
+    // Timestamp in ticks
+    static uint64_t now() {
+#if CAFE_PROFILER_RDTSC
+        return __rdtsc();
+#else
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+    }
+
+    // Called by ProfileScope
+    static void record(const char* name, uint64_t start, uint64_t end, uint32_t depth);
+
+private:
+    static std::atomic<bool> enabled_;
+};
+
+// Zone nesting depth of the calling thread
+inline thread_local uint32_t t_profile_depth = 0;
+
+// RAII zone (use CAFE_PROFILE_SCOPE)
+class ProfileScope {
+public:
+    explicit ProfileScope(const char* name) {
+        if (Profiler::is_enabled()) {
+            name_ = name;
+            depth_ = t_profile_depth++;
+            start_ = Profiler::now();
+        }
+    }
+
+    ~ProfileScope() {
+        if (name_) {
+            Profiler::record(name_, start_, Profiler::now(), depth_);
+            t_profile_depth = depth_;
+        }
+    }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    const char* name_ = nullptr;
+    uint64_t start_ = 0;
+    uint32_t depth_ = 0;
+};
+
+} // namespace cafe
+
+#define CAFE_PROFILE_CONCAT_INNER(a, b) a##b
+#define CAFE_PROFILE_CONCAT(a, b) CAFE_PROFILE_CONCAT_INNER(a, b)
+
+#if CAFE_PROFILER
+#define CAFE_PROFILE_SCOPE(name) \
+    ::cafe::ProfileScope CAFE_PROFILE_CONCAT(cafe_profile_scope_, __LINE__)(name)
+#define CAFE_PROFILE_FRAME() ::cafe::Profiler::mark_frame()
+#define CAFE_PROFILE_THREAD(name) ::cafe::Profiler::set_thread_name(name)
+#else
+#define CAFE_PROFILE_SCOPE(name) ((void)0)
+#define CAFE_PROFILE_FRAME() ((void)0)
+#define CAFE_PROFILE_THREAD(name) ((void)0)
+#endif
+
+#endif // CAFE_PROFILER_H
@@ -0,0 +1,143 @@
+#include "render_stats.h"
+#include <algorithm>
+#include <cinttypes>
+#include <iostream>
+
+namespace cafe {
+
+namespace {
+
+// Overlay layout (pixels at scale 1)
+constexpr float kBarWidth = 2.0f;
+constexpr float kGraphHeight = 60.0f;
+constexpr float kGraphGap = 6.0f;
+
+// Time graph range: 2x the 60 FPS budget
+constexpr double kBudgetMs = 1000.0 / 60.0;
+constexpr double kTimeRangeMs = 2.0 * kBudgetMs;
+
+const Color kBackground{0.0f, 0.0f, 0.0f, 0.6f};
+const Color kDrawColor{0.85f, 0.85f, 0.85f, 0.9f};
+const Color kTextureFlushColor{1.0f, 0.6f, 0.1f, 0.9f};
+const Color kCpuColor{0.3f, 0.55f, 1.0f, 0.9f};
+const Color kGpuColor{0.3f, 0.9f, 0.4f, 0.9f};
+const Color kBudgetColor{1.0f, 0.25f, 0.25f, 0.9f};
+
+// draw_quad() takes a center and a size
+void draw_rect(Renderer* renderer, float x, float y, float w, float h, const Color& color) {
+    renderer->draw_quad({x + w * 0.5f, y + h * 0.5f}, {w, h}, color);
+}
+
+} // namespace
+
+RenderStatsMonitor::RenderStatsMonitor(size_t history)
+    : history_(std::max<size_t>(history, 1)) {}
+
+RenderStatsMonitor::~RenderStatsMonitor() {
+    close_csv();
+}
+
+void RenderStatsMonitor::record(const RenderStats& frame) {
+    RenderStats stats = frame;
+    uint32_t overlay = std::min(overlay_quads_, stats.draw_calls);
+    stats.draw_calls -= overlay;
+    stats.vertices -= std::min(overlay * 6, stats.vertices);
+    overlay_quads_ = 0;
+
+    history_[next_] = stats;
+    next_ = (next_ + 1) % history_.size();
+    count_ = std::min(count_ + 1, history_.size());
+
+    if (csv_) {
+        std::fprintf(csv_, "%" PRIu64 ",%u,%u,%u,%u,%u,%u,%u,%u,%" PRIu64 ",%.3f,%.3f\n",
+                     stats.frame, stats.draw_calls, stats.batch_flushes, stats.texture_flushes,
+                     stats.full_flushes, stats.sprites, stats.vertices, stats.texture_binds,
+                     stats.texture_uploads, stats.upload_bytes, stats.cpu_ms, stats.gpu_ms);
+    }
+}
+
+bool RenderStatsMonitor::open_csv(const std::string& path) {
+    close_csv();
+    csv_ = std::fopen(path.c_str(), "w");
+    if (!csv_) {
+        std::cerr << "RenderStatsMonitor: Cannot open " << path << "\n";
+        return false;
+    }
+    std::fprintf(csv_, "frame,draw_calls,batch_flushes,texture_flushes,full_flushes,sprites,"
+                       "vertices,texture_binds,texture_uploads,upload_bytes,cpu_ms,gpu_ms\n");
+    return true;
+}
+
+void RenderStatsMonitor::close_csv() {
+    if (csv_) {
+        std::fclose(csv_);
+        csv_ = nullptr;
+    }
+}
+
+const RenderStats& RenderStatsMonitor::at(size_t age) const {
+    static const RenderStats empty;
+    if (age >= count_) return empty;
+    return history_[(next_ + history_.size() - 1 - age) % history_.size()];
+}
+
+void RenderStatsMonitor::draw(Renderer* renderer, Vec2 origin, float scale) {
+    if (!visible_ || !renderer || count_ == 0) return;
+
+    auto fill_rect = [&](float x, float y, float w, float h, const Color& color) {
+        draw_rect(renderer, x, y, w, h, color);
+        overlay_quads_++;
+    };
+
+    const float bar = kBarWidth * scale;
+    const float graph_h = kGraphHeight * scale;
+    const float width = bar * static_cast<float>(history_.size());
+    const float time_y = origin.y + graph_h + kGraphGap * scale;
+
+    fill_rect(origin.x, origin.y, width, graph_h, kBackground);
+    fill_rect(origin.x, time_y, width, graph_h, kBackground);
+
+    // Draw-call graph scales to the busiest frame shown
+    uint32_t max_draws = 1;
+    for (size_t age = 0; age < count_; ++age) {
+        max_draws = std::max(max_draws, at(age).draw_calls);
+    }
+
+    for (size_t age = 0; age < count_; ++age) {
+        const RenderStats& s = at(age);
+        float x = origin.x + width - bar * static_cast<float>(age + 1);
+
+        float draws_h = graph_h * static_cast<float>(s.draw_calls) / static_cast<float>(max_draws);
+        float texture_h = graph_h * static_cast<float>(s.texture_flushes) / static_cast<float>(max_draws);
+        fill_rect(x, origin.y + graph_h - draws_h, bar, draws_h, kDrawColor);
+        if (texture_h > 0.0f) {
+            fill_rect(x, origin.y + graph_h - texture_h, bar, texture_h, kTextureFlushColor);
+        }
+
+        // CPU and GPU side by side in one bar slot
+        auto time_bar = [&](double ms, float offset, const Color& color) {
+            float h = graph_h * static_cast<float>(std::min(ms, kTimeRangeMs) / kTimeRangeMs);
+            fill_rect(x + offset, time_y + graph_h - h, bar * 0.5f, h, color);
+        };
+        time_bar(s.cpu_ms, 0.0f, kCpuColor);
+        if (s.gpu_ms >= 0.0) {
+            time_bar(s.gpu_ms, bar * 0.5f, kGpuColor);
+        }
+    }
+
+    float budget_y = time_y + graph_h * static_cast<float>(1.0 - kBudgetMs / kTimeRangeMs);
+    fill_rect(origin.x, budget_y, width, scale, kBudgetColor);
+}
+
+std::string RenderStatsMonitor::summary() const {
+    const RenderStats& s = at(0);
+    char text[160];
+    int n = std::snprintf(text, sizeof(text), "draws %u (tex %u) | sprites %u | cpu %.2f ms",
+                          s.draw_calls, s.texture_flushes, s.sprites, s.cpu_ms);
+    if (s.gpu_ms >= 0.0 && n > 0 && static_cast<size_t>(n) < sizeof(text)) {
+        std::snprintf(text + n, sizeof(text) - n, " | gpu %.2f ms", s.gpu_ms);
+    }
+    return text;
+}
+
+} // namespace cafe
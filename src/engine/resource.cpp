@@ -1,5 +1,8 @@
 #include "resource.h"
+#include <algorithm>
+#include <filesystem>
 #include <iostream>
+#include <limits>
 
 namespace cafe {
 
@@ -30,7 +33,23 @@ void ResourceManager::initialize(Renderer* renderer) {
 }
 
 void ResourceManager::shutdown() {
+    // Stop the workers first so nothing is added to uploads_ afterwards
+    watcher_.reset();
+    loader_.reset();
+    {
+        std::lock_guard<std::mutex> lock(upload_mutex_);
+        uploads_.clear();
+        hot_reloads_.clear();
+    }
+    pending_textures_.clear();
+    pending_sheets_.clear();
+    failed_textures_.clear();
+    failed_sheets_.clear();
+    completions_.clear();
+    groups_.clear();
+
     unload_all();
+    unmount_archives();
     renderer_ = nullptr;
 }
 
@@ -43,11 +62,202 @@ void ResourceManager::set_base_path(const std::string& path) {
 }
 
 std::string ResourceManager::resolve_path(const std::string& path) const {
+    return resolve_path(base_path_, path);
+}
+
+std::string ResourceManager::resolve_path(const std::string& base_path, const std::string& path) {
     // If path is absolute or base_path is empty, use as-is
-    if (path.empty() || path[0] == '/' || base_path_.empty()) {
+    if (path.empty() || path[0] == '/' || base_path.empty()) {
         return path;
     }
-    return base_path_ + path;
+    return base_path + path;
+}
+
+ResourceManager::SourceOptions ResourceManager::source_options() const {
+    SourceOptions options;
+    options.base_path = base_path_;
+    options.prefer_cooked = prefer_cooked_;
+    options.generate_mipmaps = generate_mipmaps_;
+    options.loose_files = loose_files_;
+    return options;
+}
+
+// ============================================================================
+// Archives
+// ============================================================================
+
+bool ResourceManager::mount_archive(const std::string& path) {
+    auto archive = std::make_shared<AssetArchive>();
+    if (!archive->open(resolve_path(path))) {
+        std::cerr << "ResourceManager: Failed to mount archive: " << path << "\n";
+        return false;
+    }
+
+    // Copy on write: loaders keep reading the list they already hold
+    std::lock_guard<std::mutex> lock(archive_mutex_);
+    auto archives = std::make_shared<ArchiveList>(*archives_);
+    archives->push_back(std::move(archive));
+    archives_ = std::move(archives);
+    return true;
+}
+
+void ResourceManager::unmount_archives() {
+    std::lock_guard<std::mutex> lock(archive_mutex_);
+    archives_ = std::make_shared<const ArchiveList>();
+}
+
+std::shared_ptr<const ResourceManager::ArchiveList> ResourceManager::archive_list() const {
+    std::lock_guard<std::mutex> lock(archive_mutex_);
+    return archives_;
+}
+
+// ============================================================================
+// Texture Sources
+// ============================================================================
+
+ResourceManager::SourceImage ResourceManager::load_source(const std::string& path) const {
+    return load_source(path, source_options());
+}
+
+ResourceManager::SourceImage ResourceManager::load_source(const std::string& path,
+                                                          const SourceOptions& options) const {
+    SourceImage source;
+    if (!load_archived_source(path, options, source) && options.loose_files) {
+        load_loose_source(path, options, source);
+    }
+    build_mips(options, source);
+    return source;
+}
+
+bool ResourceManager::load_loose_source(const std::string& path, const SourceOptions& options,
+                                        SourceImage& source) const {
+    std::string full_path = resolve_path(options.base_path, path);
+    if (load_cooked_source(full_path, options, source)) {
+        return true;
+    }
+
+    source.image = Image::load_from_file(full_path);
+    if (source.image) {
+        source.path = full_path;
+        return true;
+    }
+    return false;
+}
+
+bool ResourceManager::load_cooked_source(const std::string& full_path, const SourceOptions& options,
+                                         SourceImage& source) const {
+    if (!options.prefer_cooked) {
+        return false;
+    }
+
+    // A cooked texture wins unless the source was edited after cooking
+    std::string cooked_path = CookedTexture::cooked_path(full_path);
+    std::error_code error;
+    auto cooked_time = std::filesystem::last_write_time(cooked_path, error);
+    if (error) {
+        return false;
+    }
+    auto source_time = std::filesystem::last_write_time(full_path, error);
+    if (!error && cooked_time < source_time) {
+        return false;
+    }
+
+    auto cooked = std::make_unique<CookedTexture>();
+    if (!cooked->open(cooked_path) || !cooked->pixels()) {
+        return false;
+    }
+    source.cooked = std::move(cooked);
+    source.path = cooked_path;
+    return true;
+}
+
+void ResourceManager::build_mips(const SourceOptions& options, SourceImage& source) const {
+    if (options.generate_mipmaps && source.image) {
+        source.mips.build(source.image->data(), source.image->width(), source.image->height());
+    }
+}
+
+bool ResourceManager::load_archived_source(const std::string& path, const SourceOptions& options,
+                                           SourceImage& source) const {
+    std::string cooked_path = CookedTexture::cooked_path(path);
+
+    std::shared_ptr<const ArchiveList> archives = archive_list();
+    for (auto it = archives->rbegin(); it != archives->rend(); ++it) {
+        const AssetArchive& archive = **it;
+
+        // The cooked texture reads from the entry in place
+        if (options.prefer_cooked) {
+            AssetBytes bytes = archive.load(cooked_path);
+            if (bytes) {
+                auto cooked = std::make_unique<CookedTexture>();
+                std::string name = archive.path() + ":" + cooked_path;
+                if (cooked->open_memory(bytes.data(), bytes.size(), name) && cooked->pixels()) {
+                    source.archive = *it;
+                    source.cooked = std::move(cooked);
+                    source.bytes = std::move(bytes);
+                    source.path = name;
+                    return true;
+                }
+            }
+        }
+
+        // stb_image decodes straight from the mapped bytes
+        AssetBytes bytes = archive.load(path);
+        if (bytes) {
+            source.image = Image::load_from_memory(bytes.data(), bytes.size());
+            if (source.image) {
+                source.path = archive.path() + ":" + AssetArchive::normalize_path(path);
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+std::vector<const uint8_t*> ResourceManager::source_levels(const SourceImage& source,
+                                                           TextureFilter filter,
+                                                           TextureInfo& info) const {
+    info = TextureInfo();
+    info.width = source.width();
+    info.height = source.height();
+    info.filter = filter;
+    info.wrap = TextureWrap::Clamp;
+
+    std::vector<const uint8_t*> levels;
+    const uint8_t* pixels = source.pixels();
+    if (!pixels) {
+        return levels;
+    }
+    if (!generate_mipmaps_ || source.mip_count() == 1) {
+        levels.push_back(pixels);
+        return levels;
+    }
+
+    info.mip_count = source.mip_count();
+    info.mip_filter = mip_filter_;
+    if (!source.cooked) {
+        return source.mips.levels(pixels);
+    }
+    for (int level = 0; level < info.mip_count; ++level) {
+        levels.push_back(source.cooked->pixels(level));
+        if (!levels.back()) {
+            levels.clear();  // Corrupt level (already reported)
+            break;
+        }
+    }
+    return levels;
+}
+
+TextureHandle ResourceManager::upload_source(const SourceImage& source, TextureFilter filter,
+                                             TextureInfo& info) {
+    std::vector<const uint8_t*> levels = source_levels(source, filter, info);
+    if (!renderer_ || levels.empty()) {
+        return INVALID_TEXTURE;
+    }
+    if (info.mip_count == 1) {
+        return renderer_->create_texture(levels[0], info);
+    }
+    return renderer_->create_texture_mipmapped(levels.data(), info);
 }
 
 // ============================================================================
@@ -64,8 +274,8 @@ TextureResource ResourceManager::load_texture(const std::string& id,
                                                const std::string& path,
                                                TextureFilter filter) {
     // Check if already loaded
-    if (has_texture(id)) {
-        return TextureResource(id);
+    if (is_loaded(AssetKind::Texture, id)) {
+        return find_texture(id);
     }
 
     if (!renderer_) {
@@ -73,35 +283,84 @@ TextureResource ResourceManager::load_texture(const std::string& id,
         return TextureResource();
     }
 
-    // Load image
+    // Load image (or its cooked texture)
+    return add_texture(id, path, load_source(path), filter);
+}
+
+int ResourceManager::preload(std::span<const std::string> paths, TextureFilter filter) {
+    if (!renderer_) {
+        std::cerr << "ResourceManager: No renderer set\n";
+        return 0;
+    }
+
+    // Archived and cooked textures only need mapping; the files that need
+    // a full decode are collected and decoded together
+    SourceOptions options = source_options();
+    std::vector<SourceImage> sources(paths.size());
+    std::vector<std::string> decode_paths;
+    std::vector<size_t> decode_indices;
+    for (size_t i = 0; i < paths.size(); ++i) {
+        if (is_loaded(AssetKind::Texture, paths[i]) ||
+            load_archived_source(paths[i], options, sources[i]) || !options.loose_files) {
+            continue;
+        }
+        std::string full_path = resolve_path(options.base_path, paths[i]);
+        if (!load_cooked_source(full_path, options, sources[i])) {
+            decode_paths.push_back(full_path);
+            decode_indices.push_back(i);
+        }
+    }
+
+    std::vector<std::unique_ptr<Image>> images = Image::load_many(decode_paths);
+    for (size_t k = 0; k < images.size(); ++k) {
+        SourceImage& source = sources[decode_indices[k]];
+        source.image = std::move(images[k]);
+        if (source.image) {
+            source.path = decode_paths[k];
+        }
+    }
+
+    // Uploads stay on this thread
+    int loaded = 0;
+    for (size_t i = 0; i < paths.size(); ++i) {
+        if (is_loaded(AssetKind::Texture, paths[i])) {
+            loaded++;
+            continue;
+        }
+        build_mips(options, sources[i]);
+        if (add_texture(paths[i], paths[i], std::move(sources[i]), filter).is_valid()) {
+            loaded++;
+        }
+    }
+    return loaded;
+}
+
+TextureResource ResourceManager::add_texture(const std::string& id, const std::string& path,
+                                             SourceImage source, TextureFilter filter) {
     std::string full_path = resolve_path(path);
-    auto image = Image::load_from_file(full_path);
-    if (!image) {
+    if (!source.is_valid()) {
         std::cerr << "ResourceManager: Failed to load image: " << full_path << "\n";
         return TextureResource();
     }
 
     // Create texture
     TextureInfo info;
-    info.width = image->width();
-    info.height = image->height();
-    info.filter = filter;
-    info.wrap = TextureWrap::Clamp;
-
-    TextureHandle handle = renderer_->create_texture(image->data(), info);
+    TextureHandle handle = upload_source(source, filter, info);
     if (handle == INVALID_TEXTURE) {
         std::cerr << "ResourceManager: Failed to create texture: " << id << "\n";
         return TextureResource();
     }
 
     // Store
-    TextureEntry entry;
-    entry.handle = handle;
-    entry.info = info;
+    uint32_t index = acquire_slot(AssetKind::Texture, id);
+    ResourceSlot& entry = slots_[index];
+    entry.path = path;
     entry.source_path = full_path;
-    textures_[id] = entry;
+    entry.filter = filter;
+    attach_texture(entry, handle, info);
+    failed_textures_.erase(id);
 
-    return TextureResource(id);
+    return make_handle<TextureHandle>(index);
 }
 
 TextureResource ResourceManager::create_texture(const std::string& id,
@@ -123,41 +382,86 @@ TextureResource ResourceManager::create_texture(const std::string& id,
     info.filter = filter;
     info.wrap = TextureWrap::Clamp;
 
-    TextureHandle handle = renderer_->create_texture(image.data(), info);
+    TextureHandle handle = INVALID_TEXTURE;
+    MipChain mips;
+    if (generate_mipmaps_ && image.channels() == 4 &&
+        mips.build(image.data(), image.width(), image.height()) > 1) {
+        info.mip_count = mips.count();
+        info.mip_filter = mip_filter_;
+        handle = renderer_->create_texture_mipmapped(mips.levels(image.data()).data(), info);
+    } else {
+        handle = renderer_->create_texture(image.data(), info);
+    }
     if (handle == INVALID_TEXTURE) {
         std::cerr << "ResourceManager: Failed to create texture: " << id << "\n";
         return TextureResource();
     }
 
-    TextureEntry entry;
-    entry.handle = handle;
-    entry.info = info;
-    entry.source_path = "";  // Procedurally generated
-    textures_[id] = entry;
+    uint32_t index = acquire_slot(AssetKind::Texture, id);
+    ResourceSlot& entry = slots_[index];
+    entry.path = "";  // Procedurally generated: never evicted
+    entry.source_path = "";
+    entry.filter = filter;
+    attach_texture(entry, handle, info);
+
+    return make_handle<TextureHandle>(index);
+}
 
-    return TextureResource(id);
+TextureHandle ResourceManager::get_texture(const TextureResource& handle) {
+    ResourceSlot* entry = slot(handle.index(), handle.generation());
+    if (entry && entry->kind == AssetKind::Texture && touch(*entry)) {
+        return entry->texture;
+    }
+    return INVALID_TEXTURE;
+}
+
+TextureHandle ResourceManager::get_texture(const std::string& id) {
+    ResourceSlot* entry = find_slot(AssetKind::Texture, id);
+    if (entry && touch(*entry)) {
+        entry->pinned = true;
+        return entry->texture;
+    }
+    return INVALID_TEXTURE;
 }
 
 TextureHandle ResourceManager::get_texture(const TextureResource& handle) const {
-    return get_texture(handle.id());
+    const ResourceSlot* entry = slot(handle.index(), handle.generation());
+    if (entry && entry->kind == AssetKind::Texture && entry->loaded) {
+        return entry->texture;
+    }
+    return INVALID_TEXTURE;
 }
 
 TextureHandle ResourceManager::get_texture(const std::string& id) const {
-    auto it = textures_.find(id);
-    if (it != textures_.end()) {
-        return it->second.handle;
+    const ResourceSlot* entry = find_slot(AssetKind::Texture, id);
+    if (entry && entry->loaded) {
+        return entry->texture;
     }
     return INVALID_TEXTURE;
 }
 
+void ResourceManager::unpin_texture(const std::string& id) {
+    if (ResourceSlot* entry = find_slot(AssetKind::Texture, id)) {
+        entry->pinned = false;
+    }
+}
+
 TextureInfo ResourceManager::get_texture_info(const TextureResource& handle) const {
-    auto it = textures_.find(handle.id());
-    if (it != textures_.end()) {
-        return it->second.info;
+    const ResourceSlot* entry = slot(handle.index(), handle.generation());
+    if (entry && entry->kind == AssetKind::Texture && entry->loaded) {
+        return entry->info;
     }
     return TextureInfo();
 }
 
+TextureResource ResourceManager::find_texture(const std::string& id) {
+    auto it = texture_ids_.find(id);
+    if (it != texture_ids_.end()) {
+        return make_handle<TextureHandle>(it->second);
+    }
+    return TextureResource();
+}
+
 // ============================================================================
 // Sprite Sheet Loading
 // ============================================================================
@@ -171,8 +475,8 @@ SpriteSheetResource ResourceManager::load_sprite_sheet(const std::string& id,
                                                         const std::string& path,
                                                         TextureFilter filter) {
     // Check if already loaded
-    if (has_sprite_sheet(id)) {
-        return SpriteSheetResource(id);
+    if (is_loaded(AssetKind::SpriteSheet, id)) {
+        return find_sprite_sheet(id);
     }
 
     if (!renderer_) {
@@ -181,88 +485,133 @@ SpriteSheetResource ResourceManager::load_sprite_sheet(const std::string& id,
     }
 
     // Create sprite sheet
-    auto sheet = std::make_unique<SpriteSheet>();
     std::string full_path = resolve_path(path);
+    SourceImage source = load_source(path);
 
-    if (!sheet->load(renderer_, full_path, filter)) {
+    TextureInfo info;
+    TextureHandle handle = source.is_valid() ? upload_source(source, filter, info) : INVALID_TEXTURE;
+    if (handle == INVALID_TEXTURE) {
         std::cerr << "ResourceManager: Failed to load sprite sheet: " << full_path << "\n";
         return SpriteSheetResource();
     }
 
-    sprite_sheets_[id] = std::move(sheet);
-    return SpriteSheetResource(id);
+    uint32_t index = acquire_slot(AssetKind::SpriteSheet, id);
+    ResourceSlot& entry = slots_[index];
+    entry.path = path;
+    entry.source_path = full_path;
+    entry.filter = filter;
+    attach_texture(entry, handle, info);
+    failed_sheets_.erase(id);
+
+    return make_handle<SpriteSheet>(index);
 }
 
-SpriteSheet* ResourceManager::get_sprite_sheet(const SpriteSheetResource& handle) {
-    return get_sprite_sheet(handle.id());
+int ResourceManager::load_sprite_manifest(const std::string& path, TextureFilter filter) {
+    std::string full_path = resolve_path(path);
+    SpriteManifest* manifest = nullptr;
+    for (const auto& open : manifests_) {
+        if (open->path() == full_path) {
+            manifest = open.get();
+        }
+    }
+    if (!manifest) {
+        auto opened = std::make_unique<SpriteManifest>();
+        if (!opened->open(full_path)) {
+            std::cerr << "ResourceManager: Failed to load sprite manifest: " << full_path << "\n";
+            return 0;
+        }
+        manifest = opened.get();
+        manifests_.push_back(std::move(opened));
+    }
+
+    std::filesystem::path directory = std::filesystem::path(path).parent_path();
+    int loaded = 0;
+    for (int i = 0; i < manifest->sheet_count(); ++i) {
+        const SpriteManifest::SheetRecord& record = manifest->sheet(i);
+        std::string id(manifest->name(record.name));
+        std::string image = (directory / manifest->name(record.image)).generic_string();
+
+        SpriteSheet* sheet = get_sprite_sheet(load_sprite_sheet(id, image, filter));
+        if (sheet && sheet->define_from(*manifest, i)) {
+            loaded++;
+        }
+    }
+    return loaded;
 }
 
-const SpriteSheet* ResourceManager::get_sprite_sheet(const SpriteSheetResource& handle) const {
-    auto it = sprite_sheets_.find(handle.id());
-    if (it != sprite_sheets_.end()) {
-        return it->second.get();
+SpriteSheet* ResourceManager::get_sprite_sheet(const SpriteSheetResource& handle) {
+    ResourceSlot* entry = slot(handle.index(), handle.generation());
+    if (entry && entry->kind == AssetKind::SpriteSheet && touch(*entry)) {
+        return entry->sheet.get();
     }
     return nullptr;
 }
 
 SpriteSheet* ResourceManager::get_sprite_sheet(const std::string& id) {
-    auto it = sprite_sheets_.find(id);
-    if (it != sprite_sheets_.end()) {
-        return it->second.get();
+    ResourceSlot* entry = find_slot(AssetKind::SpriteSheet, id);
+    if (entry && touch(*entry)) {
+        return entry->sheet.get();
     }
     return nullptr;
 }
 
+SpriteSheetResource ResourceManager::find_sprite_sheet(const std::string& id) {
+    auto it = sheet_ids_.find(id);
+    if (it != sheet_ids_.end()) {
+        return make_handle<SpriteSheet>(it->second);
+    }
+    return SpriteSheetResource();
+}
+
 // ============================================================================
 // Resource Management
 // ============================================================================
 
 bool ResourceManager::has_texture(const std::string& id) const {
-    return textures_.find(id) != textures_.end();
+    return is_loaded(AssetKind::Texture, id);
 }
 
 bool ResourceManager::has_sprite_sheet(const std::string& id) const {
-    return sprite_sheets_.find(id) != sprite_sheets_.end();
+    return is_loaded(AssetKind::SpriteSheet, id);
 }
 
 void ResourceManager::unload_texture(const std::string& id) {
-    auto it = textures_.find(id);
-    if (it != textures_.end()) {
-        if (renderer_ && it->second.handle != INVALID_TEXTURE) {
-            renderer_->destroy_texture(it->second.handle);
-        }
-        textures_.erase(it);
+    cancel_load(AssetKind::Texture, id);
+    failed_textures_.erase(id);
+
+    auto it = texture_ids_.find(id);
+    if (it != texture_ids_.end()) {
+        free_slot(it->second);
     }
 }
 
 void ResourceManager::unload_sprite_sheet(const std::string& id) {
-    auto it = sprite_sheets_.find(id);
-    if (it != sprite_sheets_.end()) {
-        if (renderer_) {
-            it->second->unload(renderer_);
-        }
-        sprite_sheets_.erase(it);
+    cancel_load(AssetKind::SpriteSheet, id);
+    failed_sheets_.erase(id);
+
+    auto it = sheet_ids_.find(id);
+    if (it != sheet_ids_.end()) {
+        free_slot(it->second);
     }
 }
 
 void ResourceManager::unload_all_textures() {
-    if (renderer_) {
-        for (auto& [id, entry] : textures_) {
-            if (entry.handle != INVALID_TEXTURE) {
-                renderer_->destroy_texture(entry.handle);
-            }
-        }
+    cancel_all_loads(AssetKind::Texture);
+    failed_textures_.clear();
+
+    while (!texture_ids_.empty()) {
+        free_slot(texture_ids_.begin()->second);
     }
-    textures_.clear();
 }
 
 void ResourceManager::unload_all_sprite_sheets() {
-    if (renderer_) {
-        for (auto& [id, sheet] : sprite_sheets_) {
-            sheet->unload(renderer_);
-        }
+    cancel_all_loads(AssetKind::SpriteSheet);
+    failed_sheets_.clear();
+
+    while (!sheet_ids_.empty()) {
+        free_slot(sheet_ids_.begin()->second);
     }
-    sprite_sheets_.clear();
+    manifests_.clear();
 }
 
 void ResourceManager::unload_all() {
@@ -270,4 +619,756 @@ void ResourceManager::unload_all() {
     unload_all_textures();
 }
 
+size_t ResourceManager::count_loaded(AssetKind kind) const {
+    size_t count = 0;
+    for (const auto& [id, index] : slot_ids(kind)) {
+        if (slots_[index].loaded) {
+            count++;
+        }
+    }
+    return count;
+}
+
+// ============================================================================
+// Resource Slots
+// ============================================================================
+
+ResourceManager::ResourceSlot* ResourceManager::slot(uint32_t index, uint32_t generation) {
+    if (index < slots_.size() && slots_[index].generation == generation &&
+        !slots_[index].id.empty()) {
+        return &slots_[index];
+    }
+    return nullptr;
+}
+
+const ResourceManager::ResourceSlot* ResourceManager::slot(uint32_t index,
+                                                           uint32_t generation) const {
+    return const_cast<ResourceManager*>(this)->slot(index, generation);
+}
+
+ResourceManager::ResourceSlot* ResourceManager::find_slot(AssetKind kind, const std::string& id) {
+    auto& ids = slot_ids(kind);
+    auto it = ids.find(id);
+    return it != ids.end() ? &slots_[it->second] : nullptr;
+}
+
+const ResourceManager::ResourceSlot* ResourceManager::find_slot(AssetKind kind,
+                                                                const std::string& id) const {
+    return const_cast<ResourceManager*>(this)->find_slot(kind, id);
+}
+
+uint32_t ResourceManager::acquire_slot(AssetKind kind, const std::string& id) {
+    auto& ids = slot_ids(kind);
+    auto it = ids.find(id);
+    if (it != ids.end()) {
+        return it->second;
+    }
+
+    uint32_t index;
+    if (!free_slots_.empty()) {
+        index = free_slots_.back();
+        free_slots_.pop_back();
+    } else {
+        index = static_cast<uint32_t>(slots_.size());
+        slots_.emplace_back();
+    }
+
+    ResourceSlot& entry = slots_[index];
+    entry.kind = kind;
+    entry.id = id;
+    ids[id] = index;
+    return index;
+}
+
+void ResourceManager::free_slot(uint32_t index) {
+    ResourceSlot& entry = slots_[index];
+    detach_texture(entry);
+    slot_ids(entry.kind).erase(entry.id);
+
+    // Outstanding handles keep the old generation and go stale
+    uint32_t generation = entry.generation + 1;
+    entry = ResourceSlot();
+    entry.generation = generation;
+    free_slots_.push_back(index);
+}
+
+void ResourceManager::retain(uint32_t index, uint32_t generation) {
+    if (ResourceSlot* entry = slot(index, generation)) {
+        entry->refs++;
+    }
+}
+
+void ResourceManager::release(uint32_t index, uint32_t generation) {
+    ResourceSlot* entry = slot(index, generation);
+    if (entry && entry->refs > 0) {
+        entry->refs--;
+    }
+}
+
+const std::string& ResourceManager::resource_id(uint32_t index, uint32_t generation) const {
+    static const std::string empty;
+    const ResourceSlot* entry = slot(index, generation);
+    return entry ? entry->id : empty;
+}
+
+void ResourceManager::attach_texture(ResourceSlot& entry, TextureHandle texture,
+                                     const TextureInfo& info) {
+    detach_texture(entry);
+    entry.texture = texture;
+    entry.info = info;
+    entry.bytes = texture_bytes(info);
+    entry.loaded = true;
+    entry.last_used = ++use_clock_;
+    resident_bytes_ += entry.bytes;
+    watch_source(entry);
+
+    if (entry.kind == AssetKind::SpriteSheet) {
+        // Frames defined before an eviction keep working after the reload
+        if (!entry.sheet) {
+            entry.sheet = std::make_unique<SpriteSheet>();
+        }
+        entry.sheet->set_texture(texture, info.width, info.height);
+    }
+}
+
+void ResourceManager::detach_texture(ResourceSlot& entry) {
+    if (entry.texture == INVALID_TEXTURE) {
+        return;
+    }
+    if (renderer_) {
+        renderer_->destroy_texture(entry.texture);
+    }
+    resident_bytes_ -= entry.bytes;
+    entry.bytes = 0;
+    entry.texture = INVALID_TEXTURE;
+    if (entry.sheet) {
+        entry.sheet->set_texture(INVALID_TEXTURE, entry.info.width, entry.info.height);
+    }
+}
+
+bool ResourceManager::touch(ResourceSlot& entry) {
+    if (!entry.loaded) {
+        return false;
+    }
+    entry.last_used = ++use_clock_;
+    return entry.texture != INVALID_TEXTURE || reload(entry);
+}
+
+bool ResourceManager::reload(ResourceSlot& entry) {
+    auto start = Clock::now();
+    SourceImage source = load_source(entry.path);
+
+    TextureInfo info;
+    TextureHandle texture = source.is_valid() ? upload_source(source, entry.filter, info)
+                                              : INVALID_TEXTURE;
+    if (texture == INVALID_TEXTURE) {
+        // Stop retrying on every access; a new load request tries again
+        std::cerr << "ResourceManager: Failed to reload: " << entry.id << "\n";
+        entry.loaded = false;
+        failed_loads(entry.kind).insert(entry.id);
+        return false;
+    }
+
+    attach_texture(entry, texture, info);
+    memory_stats_.reloads++;
+    memory_stats_.reload_ms +=
+        std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    return true;
+}
+
+// ============================================================================
+// Memory Budget
+// ============================================================================
+
+size_t ResourceManager::texture_bytes(const TextureInfo& info) {
+    return MipChain::chain_bytes(info.width, info.height, std::max(1, info.mip_count));
+}
+
+size_t ResourceManager::trim_memory(size_t target_bytes) {
+    if (resident_bytes_ <= target_bytes) {
+        return 0;
+    }
+
+    // Unreferenced, unpinned, reloadable and resident, oldest use first
+    std::vector<uint32_t> candidates;
+    for (uint32_t i = 0; i < slots_.size(); ++i) {
+        const ResourceSlot& entry = slots_[i];
+        if (entry.refs == 0 && !entry.pinned && entry.texture != INVALID_TEXTURE && !entry.path.empty()) {
+            candidates.push_back(i);
+        }
+    }
+    std::sort(candidates.begin(), candidates.end(), [this](uint32_t a, uint32_t b) {
+        return slots_[a].last_used < slots_[b].last_used;
+    });
+
+    size_t freed = 0;
+    for (uint32_t index : candidates) {
+        if (resident_bytes_ <= target_bytes) {
+            break;
+        }
+        ResourceSlot& entry = slots_[index];
+        freed += entry.bytes;
+        detach_texture(entry);
+        memory_stats_.evictions++;
+    }
+    return freed;
+}
+
+ResourceState ResourceManager::slot_state(const ResourceSlot* entry) const {
+    if (!entry) return ResourceState::Unloaded;
+    if (entry->loaded) {
+        return entry->texture != INVALID_TEXTURE ? ResourceState::Ready : ResourceState::Evicted;
+    }
+    if (pending_loads(entry->kind).count(entry->id)) return ResourceState::Pending;
+    if (failed_loads(entry->kind).count(entry->id)) return ResourceState::Failed;
+    return ResourceState::Unloaded;
+}
+
+ResourceState ResourceManager::resource_state(AssetKind kind, uint32_t index,
+                                              uint32_t generation) const {
+    const ResourceSlot* entry = slot(index, generation);
+    return slot_state(entry && entry->kind == kind ? entry : nullptr);
+}
+
+ResourceState ResourceManager::resource_state(const TextureResource& handle) const {
+    return resource_state(AssetKind::Texture, handle.index(), handle.generation());
+}
+
+ResourceState ResourceManager::resource_state(const SpriteSheetResource& handle) const {
+    return resource_state(AssetKind::SpriteSheet, handle.index(), handle.generation());
+}
+
+ResourceMemoryStats ResourceManager::memory_stats() const {
+    ResourceMemoryStats stats = memory_stats_;
+    stats.budget_bytes = memory_budget_;
+    stats.resident_bytes = resident_bytes_;
+    for (const ResourceSlot& entry : slots_) {
+        if (!entry.loaded) {
+            continue;
+        }
+        if (entry.texture == INVALID_TEXTURE) {
+            stats.evicted++;
+            continue;
+        }
+        stats.resident++;
+        if (entry.refs > 0) {
+            stats.referenced_bytes += entry.bytes;
+        }
+        stats.mip_bytes += entry.bytes - MipChain::chain_bytes(entry.info.width, entry.info.height, 1);
+    }
+    return stats;
+}
+
+void ResourceManager::reset_memory_stats() {
+    memory_stats_ = ResourceMemoryStats();
+}
+
+// ============================================================================
+// Asynchronous Loading
+// ============================================================================
+
+namespace {
+
+double elapsed_us(std::chrono::steady_clock::time_point start) {
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::micro>(elapsed).count();
+}
+
+} // namespace
+
+TextureResource ResourceManager::load_texture_async(const std::string& path,
+                                                     TextureFilter filter,
+                                                     LoadCallback callback,
+                                                     LoadGroupID group) {
+    return load_texture_async(path, path, filter, std::move(callback), group);
+}
+
+TextureResource ResourceManager::load_texture_async(const std::string& id,
+                                                     const std::string& path,
+                                                     TextureFilter filter,
+                                                     LoadCallback callback,
+                                                     LoadGroupID group) {
+    if (!request_load(AssetKind::Texture, id, path, filter, std::move(callback), group)) {
+        return TextureResource();
+    }
+    return find_texture(id);
+}
+
+SpriteSheetResource ResourceManager::load_sprite_sheet_async(const std::string& path,
+                                                              TextureFilter filter,
+                                                              LoadCallback callback,
+                                                              LoadGroupID group) {
+    return load_sprite_sheet_async(path, path, filter, std::move(callback), group);
+}
+
+SpriteSheetResource ResourceManager::load_sprite_sheet_async(const std::string& id,
+                                                              const std::string& path,
+                                                              TextureFilter filter,
+                                                              LoadCallback callback,
+                                                              LoadGroupID group) {
+    if (!request_load(AssetKind::SpriteSheet, id, path, filter, std::move(callback), group)) {
+        return SpriteSheetResource();
+    }
+    return find_sprite_sheet(id);
+}
+
+void ResourceManager::add_waiter(Waiters& waiters, LoadCallback callback, LoadGroupID group) {
+    if (callback) {
+        waiters.callbacks.push_back(std::move(callback));
+    }
+
+    auto it = groups_.find(group);
+    if (it != groups_.end()) {
+        waiters.groups.push_back(group);
+        it->second.progress.total++;
+        it->second.notified = false;
+    }
+}
+
+bool ResourceManager::request_load(AssetKind kind, const std::string& id,
+                                   const std::string& path, TextureFilter filter,
+                                   LoadCallback callback, LoadGroupID group) {
+    // Already loaded: complete on the next process_uploads()
+    // (an evicted resource is reloaded like a new one)
+    if (is_resident(kind, id)) {
+        Completion done;
+        done.id = id;
+        done.success = true;
+        add_waiter(done.waiters, std::move(callback), group);
+        completions_.push_back(std::move(done));
+        return true;
+    }
+
+    // Already in flight: wait for the same result
+    auto& pending = pending_loads(kind);
+    auto it = pending.find(id);
+    if (it != pending.end()) {
+        add_waiter(it->second.waiters, std::move(callback), group);
+        return true;
+    }
+
+    if (!renderer_) {
+        std::cerr << "ResourceManager: No renderer set\n";
+        Completion failed;
+        failed.id = id;
+        add_waiter(failed.waiters, std::move(callback), group);
+        completions_.push_back(std::move(failed));
+        return false;
+    }
+
+    failed_loads(kind).erase(id);
+
+    // The slot exists from now on, so the returned handle is usable
+    ResourceSlot& entry = slots_[acquire_slot(kind, id)];
+    entry.path = path;
+    entry.source_path = resolve_path(path);
+    entry.filter = filter;
+
+    PendingLoad& load = pending[id];
+    load.ticket = next_ticket_++;
+    load.filter = filter;
+    load.requested = Clock::now();
+    add_waiter(load.waiters, std::move(callback), group);
+
+    start_loader();
+
+    // The worker only reads the file; everything else waits for upload().
+    // It gets its own copy of the settings it reads.
+    loader_->submit([this, kind, id, path, ticket = load.ticket, full_path = resolve_path(path),
+                     options = source_options()] {
+        auto start = Clock::now();
+        DecodedImage decoded;
+        decoded.kind = kind;
+        decoded.id = id;
+        decoded.ticket = ticket;
+        decoded.source_path = full_path;
+        decoded.source = load_source(path, options);
+        if (decoded.source.cooked) {
+            // Page the pixels in here rather than inside create_texture()
+            int levels = options.generate_mipmaps ? decoded.source.cooked->mip_count() : 1;
+            for (int level = 0; level < levels; ++level) {
+                decoded.source.cooked->prefault(level);
+            }
+        }
+        decoded.decode_us = elapsed_us(start);
+
+        if (!decoded.source.is_valid()) {
+            std::cerr << "ResourceManager: Failed to load image: " << full_path << "\n";
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(upload_mutex_);
+            uploads_.push_back(std::move(decoded));
+        }
+        upload_ready_.notify_one();
+    });
+
+    return true;
+}
+
+void ResourceManager::start_loader() {
+    if (!loader_) {
+        loader_ = std::make_unique<ThreadPool>(loader_threads_);
+    }
+}
+
+double ResourceManager::estimate_upload_ms(const SourceImage& source) const {
+    double mpixels = static_cast<double>(source.width()) * source.height() / 1e6;
+    return mpixels * upload_ms_per_mpixel_;
+}
+
+int ResourceManager::process_uploads(double budget_ms) {
+    auto start = Clock::now();
+    int uploaded = 0;
+
+    // Development only, so outside the budget: an edit shows up right away
+    if (watcher_) {
+        queue_hot_reloads();
+        std::deque<DecodedImage> reloads;
+        {
+            std::lock_guard<std::mutex> lock(upload_mutex_);
+            reloads.swap(hot_reloads_);
+        }
+        for (DecodedImage& decoded : reloads) {
+            apply_hot_reload(decoded);
+        }
+    }
+
+    while (true) {
+        DecodedImage decoded;
+        {
+            std::lock_guard<std::mutex> lock(upload_mutex_);
+            if (uploads_.empty()) {
+                break;
+            }
+
+            // Stop before an upload that would overrun the budget
+            double spent_ms = elapsed_us(start) / 1000.0;
+            if (uploaded > 0 &&
+                spent_ms + estimate_upload_ms(uploads_.front().source) > budget_ms) {
+                break;
+            }
+
+            decoded = std::move(uploads_.front());
+            uploads_.pop_front();
+        }
+
+        upload(decoded);
+        uploaded++;
+
+        if (elapsed_us(start) / 1000.0 >= budget_ms) {
+            break;
+        }
+    }
+
+    // Nothing has been drawn with this frame's textures yet
+    if (memory_budget_ > 0) {
+        trim_memory(memory_budget_);
+    }
+
+    deliver_completions();
+
+    stats_.last_uploads = uploaded;
+    stats_.last_upload_ms = elapsed_us(start) / 1000.0;
+    return uploaded;
+}
+
+void ResourceManager::upload(DecodedImage& decoded) {
+    auto& pending = pending_loads(decoded.kind);
+    auto it = pending.find(decoded.id);
+    if (it == pending.end() || it->second.ticket != decoded.ticket) {
+        return;  // Cancelled or superseded: drop the image
+    }
+
+    PendingLoad load = std::move(it->second);
+    pending.erase(it);
+
+    bool success = false;
+    if (!decoded.source.is_valid()) {
+        // Worker already reported the error
+    } else if (is_resident(decoded.kind, decoded.id)) {
+        success = true;  // Loaded synchronously meanwhile
+    } else {
+        auto start = Clock::now();
+        TextureInfo info;
+        TextureHandle handle = upload_source(decoded.source, load.filter, info);
+        double upload_us = elapsed_us(start);
+        stats_.upload.record(upload_us);
+
+        // Running average cost, used to keep uploads inside the budget
+        double mpixels = static_cast<double>(info.width) * info.height / 1e6;
+        if (mpixels > 0.0) {
+            double sample = upload_us / 1000.0 / mpixels;
+            upload_ms_per_mpixel_ = upload_ms_per_mpixel_ == 0.0
+                ? sample
+                : upload_ms_per_mpixel_ * 0.875 + sample * 0.125;
+        }
+
+        if (handle == INVALID_TEXTURE) {
+            std::cerr << "ResourceManager: Failed to create texture: " << decoded.id << "\n";
+        } else {
+            // request_load() made the slot; unloading it cancelled this load
+            ResourceSlot& entry = slots_[acquire_slot(decoded.kind, decoded.id)];
+            if (entry.loaded) {
+                memory_stats_.reloads++;  // Requested again while evicted
+            }
+            entry.source_path = decoded.source_path;
+            attach_texture(entry, handle, info);
+            success = true;
+        }
+    }
+
+    stats_.decode.record(decoded.decode_us);
+    stats_.total.record(elapsed_us(load.requested));
+    if (success) {
+        stats_.completed++;
+    } else {
+        stats_.failed++;
+        failed_loads(decoded.kind).insert(decoded.id);
+    }
+
+    Completion done;
+    done.id = decoded.id;
+    done.success = success;
+    done.waiters = std::move(load.waiters);
+    completions_.push_back(std::move(done));
+}
+
+void ResourceManager::cancel_load(AssetKind kind, const std::string& id) {
+    auto& pending = pending_loads(kind);
+    auto it = pending.find(id);
+    if (it == pending.end()) {
+        return;
+    }
+
+    // The worker's result no longer matches a ticket and is dropped
+    Completion cancelled;
+    cancelled.id = id;
+    cancelled.waiters = std::move(it->second.waiters);
+    completions_.push_back(std::move(cancelled));
+    pending.erase(it);
+}
+
+void ResourceManager::cancel_all_loads(AssetKind kind) {
+    auto& pending = pending_loads(kind);
+    while (!pending.empty()) {
+        cancel_load(kind, pending.begin()->first);
+    }
+}
+
+void ResourceManager::deliver_completions() {
+    // Callbacks may start new loads, which can add to completions_
+    std::vector<Completion> completions;
+    completions.swap(completions_);
+
+    for (auto& done : completions) {
+        for (LoadGroupID group : done.waiters.groups) {
+            auto it = groups_.find(group);
+            if (it != groups_.end()) {
+                if (done.success) {
+                    it->second.progress.loaded++;
+                } else {
+                    it->second.progress.failed++;
+                }
+            }
+        }
+        for (auto& callback : done.waiters.callbacks) {
+            callback(done.id, done.success);
+        }
+    }
+
+    // Collect first: group callbacks may create or release groups
+    std::vector<std::pair<LoadGroupID, bool>> finished;
+    for (auto& [id, group] : groups_) {
+        if (!group.notified && group.progress.total > 0 && group.progress.complete()) {
+            group.notified = true;
+            finished.emplace_back(id, group.progress.failed == 0);
+        }
+    }
+    for (auto [id, all_succeeded] : finished) {
+        auto it = groups_.find(id);
+        if (it != groups_.end() && it->second.on_complete) {
+            LoadGroupCallback on_complete = it->second.on_complete;
+            on_complete(id, all_succeeded);
+        }
+    }
+}
+
+void ResourceManager::finish_loading() {
+    while (true) {
+        process_uploads(std::numeric_limits<double>::infinity());
+        if (pending_textures_.empty() && pending_sheets_.empty()) {
+            break;
+        }
+
+        // Every pending request has a job in flight that will push a result
+        std::unique_lock<std::mutex> lock(upload_mutex_);
+        upload_ready_.wait(lock, [this] { return !uploads_.empty(); });
+    }
+}
+
+bool ResourceManager::is_loading() const {
+    if (!pending_textures_.empty() || !pending_sheets_.empty() || !completions_.empty()) {
+        return true;
+    }
+    std::lock_guard<std::mutex> lock(upload_mutex_);
+    return !uploads_.empty();
+}
+
+ResourceState ResourceManager::texture_state(const std::string& id) const {
+    return slot_state(find_slot(AssetKind::Texture, id));
+}
+
+ResourceState ResourceManager::sprite_sheet_state(const std::string& id) const {
+    return slot_state(find_slot(AssetKind::SpriteSheet, id));
+}
+
+// ============================================================================
+// Load Groups
+// ============================================================================
+
+LoadGroupID ResourceManager::create_load_group(LoadGroupCallback on_complete) {
+    LoadGroupID id = next_group_++;
+    groups_[id].on_complete = std::move(on_complete);
+    return id;
+}
+
+LoadGroupProgress ResourceManager::load_group_progress(LoadGroupID group) const {
+    auto it = groups_.find(group);
+    if (it != groups_.end()) {
+        return it->second.progress;
+    }
+    return LoadGroupProgress();
+}
+
+bool ResourceManager::is_load_group_complete(LoadGroupID group) const {
+    return load_group_progress(group).complete();
+}
+
+void ResourceManager::release_load_group(LoadGroupID group) {
+    groups_.erase(group);
+}
+
+// ============================================================================
+// Hot Reload
+// ============================================================================
+
+void ResourceManager::set_hot_reload(bool enabled, int debounce_ms) {
+    if (!enabled) {
+        watcher_.reset();
+        return;
+    }
+    if (watcher_) {
+        return;
+    }
+
+    watcher_ = std::make_unique<FileWatcher>();
+    if (!watcher_->start(debounce_ms)) {
+        watcher_.reset();
+        return;
+    }
+    for (const ResourceSlot& entry : slots_) {
+        if (entry.loaded) {
+            watch_source(entry);
+        }
+    }
+}
+
+void ResourceManager::watch_source(const ResourceSlot& entry) {
+    // Archived assets often have no loose file; skip rather than warn
+    std::error_code error;
+    if (watcher_ && !entry.source_path.empty() &&
+        std::filesystem::is_regular_file(entry.source_path, error)) {
+        watcher_->watch(entry.source_path);
+    }
+}
+
+void ResourceManager::queue_hot_reloads() {
+    for (const FileWatcher::Change& change : watcher_->poll()) {
+        for (const ResourceSlot& entry : slots_) {
+            if (!entry.loaded || entry.source_path != change.path) {
+                continue;
+            }
+
+            start_loader();
+            loader_->submit([this, kind = entry.kind, id = entry.id, path = entry.path,
+                             changed = change.first_seen, options = source_options()] {
+                auto start = Clock::now();
+                DecodedImage decoded;
+                decoded.kind = kind;
+                decoded.id = id;
+                decoded.changed = changed;
+                // The edited file itself, not an archived copy
+                if (load_loose_source(path, options, decoded.source)) {
+                    build_mips(options, decoded.source);
+                } else {
+                    std::cerr << "ResourceManager: Hot reload failed to load: "
+                              << resolve_path(options.base_path, path) << "\n";
+                }
+                decoded.decode_us = elapsed_us(start);
+
+                std::lock_guard<std::mutex> lock(upload_mutex_);
+                hot_reloads_.push_back(std::move(decoded));
+            });
+        }
+    }
+}
+
+void ResourceManager::apply_hot_reload(DecodedImage& decoded) {
+    ResourceSlot* entry = find_slot(decoded.kind, decoded.id);
+    if (!entry || !decoded.source.is_valid() || !renderer_) {
+        return;
+    }
+    if (entry->texture == INVALID_TEXTURE) {
+        return;  // Evicted: the next access loads the new file anyway
+    }
+
+    TextureInfo info;
+    std::vector<const uint8_t*> levels = source_levels(decoded.source, entry->filter, info);
+    if (levels.empty()) {
+        return;
+    }
+
+    if (renderer_->update_texture(entry->texture, levels.data(), info)) {
+        resident_bytes_ -= entry->bytes;
+        entry->info = info;
+        entry->bytes = texture_bytes(info);
+        resident_bytes_ += entry->bytes;
+        if (entry->sheet) {
+            entry->sheet->set_texture(entry->texture, info.width, info.height);
+        }
+    } else {
+        TextureHandle handle = info.mip_count == 1
+            ? renderer_->create_texture(levels[0], info)
+            : renderer_->create_texture_mipmapped(levels.data(), info);
+        if (handle == INVALID_TEXTURE) {
+            std::cerr << "ResourceManager: Hot reload failed to create texture: " << decoded.id << "\n";
+            return;
+        }
+        attach_texture(*entry, handle, info);
+    }
+
+    stats_.hot_reloads++;
+    stats_.hot_reload.record(elapsed_us(decoded.changed));
+}
+
+// ============================================================================
+// Loader Statistics
+// ============================================================================
+
+LoaderStats ResourceManager::loader_stats() const {
+    LoaderStats stats = stats_;
+    stats.pending = pending_textures_.size() + pending_sheets_.size();
+    {
+        std::lock_guard<std::mutex> lock(upload_mutex_);
+        stats.upload_queue = uploads_.size();
+    }
+    stats.decode_queue = loader_ ? loader_->pending() : 0;
+    return stats;
+}
+
+void ResourceManager::reset_loader_stats() {
+    stats_ = LoaderStats();
+}
+
 } // namespace cafe
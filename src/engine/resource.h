@@ -2,47 +2,215 @@
 #define CAFE_RESOURCE_H
 
 #include "../renderer/renderer.h"
+#include "asset_archive.h"
+#include "cooked_texture.h"
+#include "file_watcher.h"
 #include "image.h"
+#include "latency_histogram.h"
+#include "mip_chain.h"
+#include "sprite_manifest.h"
 #include "sprite_sheet.h"
+#include "thread_pool.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <memory>
 #include <functional>
+#include <mutex>
+#include <span>
 #include <typeindex>
+#include <vector>
 
 namespace cafe {
 
+class ResourceManager;
+
+// ============================================================================
+// Resource Handle - Counted reference to a loaded resource
 // ============================================================================
-// Resource Handle - Type-safe reference to a loaded resource
+//
+// A slot index plus generation into ResourceManager's resource table, so
+// get_texture(handle) is an array index instead of a string hash lookup.
+//
+// Handles are reference counted: copying one adds a reference, destroying
+// one drops it. A resource with no handles left may be evicted when the
+// manager is over its memory budget (see set_memory_budget()). Unloading a
+// resource bumps its slot's generation, so old handles go stale - get_*()
+// return INVALID_TEXTURE / nullptr - rather than seeing whatever reuses
+// the slot.
+//
+// Handles must not outlive the ResourceManager that made them.
+//
 // ============================================================================
 
 template<typename T>
 class ResourceHandle {
 public:
     ResourceHandle() = default;
-    explicit ResourceHandle(const std::string& id) : id_(id) {}
+    ~ResourceHandle() { reset(); }
+
+    ResourceHandle(const ResourceHandle& other);
+    ResourceHandle& operator=(const ResourceHandle& other);
+    ResourceHandle(ResourceHandle&& other) noexcept;
+    ResourceHandle& operator=(ResourceHandle&& other) noexcept;
+
+    // Drop this reference (the handle becomes null)
+    void reset();
 
-    const std::string& id() const { return id_; }
-    bool is_valid() const { return !id_.empty(); }
+    uint32_t index() const { return index_; }
+    uint32_t generation() const { return generation_; }
+
+    // ID the resource was loaded as (empty if null or stale)
+    const std::string& id() const;
+
+    // Non-null (the resource may have been unloaded since)
+    bool is_valid() const { return manager_ != nullptr; }
     explicit operator bool() const { return is_valid(); }
 
-    bool operator==(const ResourceHandle& other) const { return id_ == other.id_; }
-    bool operator!=(const ResourceHandle& other) const { return id_ != other.id_; }
+    bool operator==(const ResourceHandle& other) const {
+        return manager_ == other.manager_ && index_ == other.index_ &&
+               generation_ == other.generation_;
+    }
+    bool operator!=(const ResourceHandle& other) const { return !(*this == other); }
 
 private:
-    std::string id_;
+    friend class ResourceManager;
+
+    // Adds a reference
+    ResourceHandle(ResourceManager* manager, uint32_t index, uint32_t generation);
+
+    ResourceManager* manager_ = nullptr;
+    uint32_t index_ = 0;
+    uint32_t generation_ = 0;
 };
 
 // Common handle types
 using TextureResource = ResourceHandle<TextureHandle>;
 using SpriteSheetResource = ResourceHandle<SpriteSheet>;
 
+// ============================================================================
+// Asynchronous Loading
+// ============================================================================
+
+// Where a resource is in its life cycle
+enum class ResourceState {
+    Unloaded,   // Never requested, or unloaded
+    Pending,    // Requested; decoding or waiting for upload
+    Ready,      // Texture created, usable
+    Evicted,    // Texture freed to stay under budget; reloads on next access
+    Failed      // File missing/corrupt or texture creation failed
+};
+
+// Called on the render thread (inside process_uploads()) when an async
+// load finishes, successfully or not
+using LoadCallback = std::function<void(const std::string& id, bool success)>;
+
+// A set of loads that completes together ("scene ready when all of these
+// are loaded")
+using LoadGroupID = uint32_t;
+constexpr LoadGroupID INVALID_LOAD_GROUP = 0;
+
+using LoadGroupCallback = std::function<void(LoadGroupID group, bool all_succeeded)>;
+
+struct LoadGroupProgress {
+    int total = 0;     // Loads added to the group
+    int loaded = 0;
+    int failed = 0;
+
+    bool complete() const { return loaded + failed == total; }
+    float fraction() const {
+        return total > 0 ? static_cast<float>(loaded + failed) / static_cast<float>(total) : 1.0f;
+    }
+};
+
+// Loader queues and timings (histograms accumulate until reset_loader_stats())
+struct LoaderStats {
+    size_t decode_queue = 0;        // Files queued for or being decoded
+    size_t upload_queue = 0;        // Decoded images waiting for process_uploads()
+    size_t pending = 0;             // Requests not yet completed
+    uint64_t completed = 0;         // Async loads that became Ready
+    uint64_t failed = 0;            // Async loads that Failed
+    int last_uploads = 0;           // Uploads done by the last process_uploads()
+    double last_upload_ms = 0.0;    // Time the last process_uploads() took
+
+    LatencyHistogram decode;        // Worker: read + decode one file
+    LatencyHistogram upload;        // Render thread: create_texture()
+    LatencyHistogram total;         // Request -> Ready/Failed
+
+    uint64_t hot_reloads = 0;       // Textures swapped by hot reload
+    LatencyHistogram hot_reload;    // File change seen -> new pixels in use
+};
+
+// Texture memory and eviction counters (counters accumulate until
+// reset_memory_stats())
+struct ResourceMemoryStats {
+    size_t budget_bytes = 0;        // 0 = unlimited
+    size_t resident_bytes = 0;      // Textures currently created
+    size_t referenced_bytes = 0;    // Part of resident_bytes held by handles
+    size_t mip_bytes = 0;           // Part of resident_bytes in mip levels 1+
+                                    // (resident_bytes - mip_bytes = no mips)
+    int resident = 0;               // Resources with a texture
+    int evicted = 0;                // Resources that reload on next access
+    uint64_t evictions = 0;
+    uint64_t reloads = 0;
+    double reload_ms = 0.0;         // Total time spent reloading
+};
+
 // ============================================================================
 // Resource Manager - Loads, caches, and manages game assets
 // ============================================================================
+//
+// load_texture() / load_sprite_sheet() block: the file is read and decoded
+// (stb_image) and uploaded before they return. For one logo that is fine;
+// for a scene's worth of art it is a visible hitch.
+//
+// The *_async() versions return a handle right away in the Pending state:
+//
+//   main thread         worker pool              main thread, each frame
+//   load_*_async() ---> read + decode file ---> process_uploads(budget)
+//   (Pending)           (no GPU calls)          create_texture() until the
+//                                               time budget is spent -> Ready
+//
+// Decoding happens on ThreadPool workers. Uploads stay on the render
+// thread, since renderers are not thread-safe, and are spread across frames
+// by process_uploads()'s millisecond budget. Callbacks and load group
+// completions also run inside process_uploads(), never on a worker.
+//
+// Usage:
+//   LoadGroupID scene = resources.create_load_group([&](LoadGroupID, bool ok) {
+//       if (ok) start_scene();
+//   });
+//   resources.load_texture_async("floor.png", TextureFilter::Nearest, nullptr, scene);
+//   resources.load_sprite_sheet_async("barista.png", TextureFilter::Nearest,
+//       [&](const std::string& id, bool ok) {
+//           if (ok) resources.get_sprite_sheet(id)->define_grid(32, 32);
+//       }, scene);
+//
+//   // Every frame, before rendering:
+//   resources.process_uploads(2.0);    // At most ~2 ms of texture uploads
+//
+// Memory budget: every texture's size (width * height * 4 bytes, plus its
+// mip levels, from its TextureInfo) counts against set_memory_budget(). When over it,
+// process_uploads() destroys textures nobody holds a handle to, least
+// recently used first. The resource keeps its slot, ID and path; the next
+// get_texture()/get_sprite_sheet() reloads it synchronously. Hold a handle
+// to anything that must never hitch on a reload. Textures made by
+// create_texture() from an Image have no file to reload from and are never
+// evicted. A raw TextureHandle from get_texture(handle) stays valid while
+// that handle is held; get_texture(id) has no handle to tie it to, so it
+// pins the texture: it is never evicted until unpin_texture(id) or
+// unload_texture(id). The const lookups never pin or reload.
+//
+// ============================================================================
 
 class ResourceManager {
 public:
+    static constexpr double DEFAULT_UPLOAD_BUDGET_MS = 2.0;
+
     ResourceManager() = default;
     ~ResourceManager();
 
@@ -69,18 +237,43 @@ public:
                                   const std::string& path,
                                   TextureFilter filter = TextureFilter::Nearest);
 
+    // Load many textures at once (cached by path, like load_texture(path)).
+    // Files that need decoding are decoded in parallel (Image::load_many);
+    // uploads happen here, on the calling thread. Returns how many of the
+    // textures are loaded afterwards. Use for loading screens; the
+    // textures hold no handle, so a memory budget may evict them.
+    int preload(std::span<const std::string> paths,
+                TextureFilter filter = TextureFilter::Nearest);
+
     // Create texture from image data
     TextureResource create_texture(const std::string& id,
                                     const Image& image,
                                     TextureFilter filter = TextureFilter::Nearest);
 
     // Get texture handle (returns INVALID_TEXTURE if not found)
+    // Marks the texture used and reloads it if it was evicted. By ID the
+    // texture is pinned, since no reference keeps the raw handle alive;
+    // use find_texture() and get_texture(handle) for evictable textures.
+    TextureHandle get_texture(const TextureResource& handle);
+    TextureHandle get_texture(const std::string& id);
+
+    // Lookup only: no reload and no pin (INVALID_TEXTURE while evicted).
+    // A raw handle from here is only safe until the next process_uploads()
+    // unless the texture is pinned or a handle to it is held.
     TextureHandle get_texture(const TextureResource& handle) const;
     TextureHandle get_texture(const std::string& id) const;
 
-    // Get texture info
+    // Release the pin get_texture(id) took. The texture becomes evictable
+    // again once no handle holds it; raw handles from get_texture(id) must
+    // not be used after that. Unloading the texture also drops the pin.
+    void unpin_texture(const std::string& id);
+
+    // Get texture info (also while evicted)
     TextureInfo get_texture_info(const TextureResource& handle) const;
 
+    // Counted handle for a texture loaded under `id` (null if none)
+    TextureResource find_texture(const std::string& id);
+
     // ========================================================================
     // Sprite Sheet Loading
     // ========================================================================
@@ -95,10 +288,87 @@ public:
                                            TextureFilter filter = TextureFilter::Nearest);
 
     // Get sprite sheet (returns nullptr if not found)
+    // Marks the sheet used and reloads its texture if it was evicted
     SpriteSheet* get_sprite_sheet(const SpriteSheetResource& handle);
-    const SpriteSheet* get_sprite_sheet(const SpriteSheetResource& handle) const;
     SpriteSheet* get_sprite_sheet(const std::string& id);
 
+    SpriteSheetResource find_sprite_sheet(const std::string& id);
+
+    // Load every sheet a sprite manifest describes (SpriteManifest: a
+    // .sheets text file, or its cooked .csheets) and define its frames and
+    // animations. A sheet's ID is its [name]; its image path is relative
+    // to the manifest. The manifest stays open until the sheets are all
+    // unloaded. Returns the number of sheets loaded.
+    int load_sprite_manifest(const std::string& path,
+                             TextureFilter filter = TextureFilter::Nearest);
+
+    // ========================================================================
+    // Asynchronous Loading
+    // ========================================================================
+
+    // Queue a load and return its handle immediately (Pending until a later
+    // process_uploads() uploads it). Requesting a Pending resource again
+    // adds the callback/group to the existing request; requesting a Ready
+    // one completes on the next process_uploads(). Failed loads are retried.
+    TextureResource load_texture_async(const std::string& path,
+                                        TextureFilter filter = TextureFilter::Nearest,
+                                        LoadCallback callback = nullptr,
+                                        LoadGroupID group = INVALID_LOAD_GROUP);
+
+    TextureResource load_texture_async(const std::string& id,
+                                        const std::string& path,
+                                        TextureFilter filter,
+                                        LoadCallback callback = nullptr,
+                                        LoadGroupID group = INVALID_LOAD_GROUP);
+
+    // The sheet's frames are defined by the caller once it is Ready
+    // (typically in the callback)
+    SpriteSheetResource load_sprite_sheet_async(const std::string& path,
+                                                 TextureFilter filter = TextureFilter::Nearest,
+                                                 LoadCallback callback = nullptr,
+                                                 LoadGroupID group = INVALID_LOAD_GROUP);
+
+    SpriteSheetResource load_sprite_sheet_async(const std::string& id,
+                                                 const std::string& path,
+                                                 TextureFilter filter,
+                                                 LoadCallback callback = nullptr,
+                                                 LoadGroupID group = INVALID_LOAD_GROUP);
+
+    // Upload decoded images until budget_ms has been spent, evict down to
+    // the memory budget, then run callbacks. Call once per frame on the
+    // render thread, before drawing. At least one upload is done per call
+    // so loading always makes progress.
+    // Returns the number of uploads done.
+    int process_uploads(double budget_ms = DEFAULT_UPLOAD_BUDGET_MS);
+
+    // Block until every pending load has completed (loading screens, tests)
+    void finish_loading();
+
+    bool is_loading() const;
+
+    ResourceState texture_state(const std::string& id) const;
+    ResourceState sprite_sheet_state(const std::string& id) const;
+
+    // Decode threads (0 = hardware threads - 1). Takes effect when the
+    // worker pool starts, on the first async load.
+    void set_loader_threads(int threads) { loader_threads_ = threads; }
+
+    // ========================================================================
+    // Load Groups
+    // ========================================================================
+
+    // on_complete runs from process_uploads() once every load added to the
+    // group has finished. Add all of a group's loads before the next
+    // process_uploads(), or it may complete early.
+    LoadGroupID create_load_group(LoadGroupCallback on_complete = nullptr);
+    LoadGroupProgress load_group_progress(LoadGroupID group) const;
+    bool is_load_group_complete(LoadGroupID group) const;
+    void release_load_group(LoadGroupID group);
+
+    // Loader queue depths and latency histograms
+    LoaderStats loader_stats() const;
+    void reset_loader_stats();
+
     // ========================================================================
     // Resource Management
     // ========================================================================
@@ -118,33 +388,421 @@ public:
     // Unload everything
     void unload_all();
 
-    // Get statistics
-    size_t texture_count() const { return textures_.size(); }
-    size_t sprite_sheet_count() const { return sprite_sheets_.size(); }
+    // Get statistics (loaded resources, evicted ones included)
+    size_t texture_count() const { return count_loaded(AssetKind::Texture); }
+    size_t sprite_sheet_count() const { return count_loaded(AssetKind::SpriteSheet); }
 
     // Set base path for asset loading (e.g., "assets/")
     void set_base_path(const std::string& path);
     const std::string& base_path() const { return base_path_; }
 
-private:
-    Renderer* renderer_ = nullptr;
-    std::string base_path_;
+    // Load "name.ctex" instead of "name.png" when a cooked texture sits
+    // next to the source and is not older than it (default: on)
+    void set_prefer_cooked(bool prefer) { prefer_cooked_ = prefer; }
+    bool prefer_cooked() const { return prefer_cooked_; }
+
+    // Give textures a mip chain, so zoomed-out views sample a pre-shrunk
+    // level instead of skipping texels (default: off). Cooked textures use
+    // their stored chain; other images get one built on the loader thread
+    // (gamma-correct, see MipChain). Costs a third more texture memory.
+    // Like the options above, this applies to loads requested after the
+    // call; loads already queued keep the settings they were queued with.
+    void set_generate_mipmaps(bool enabled) { generate_mipmaps_ = enabled; }
+    bool generate_mipmaps() const { return generate_mipmaps_; }
+
+    // How textures loaded from now on blend between levels
+    void set_mip_filter(MipFilter filter) { mip_filter_ = filter; }
+    MipFilter mip_filter() const { return mip_filter_; }
+
+    // ========================================================================
+    // Archives
+    // ========================================================================
+    //
+    // Assets are looked up by their load path ("sprites/barista.png") in
+    // mounted .cpak archives first, most recently mounted first, then as
+    // loose files under base_path(). Development builds run from loose
+    // files; shipping builds mount one archive and can turn loose files
+    // off. Mounting and unmounting are safe while loads or hot reloads
+    // run: each lookup works on a snapshot of the archive list, and an
+    // unmounted archive stays mapped until the last source read from it
+    // has been uploaded.
+
+    bool mount_archive(const std::string& path);
+    void unmount_archives();
+    size_t archive_count() const { return archive_list()->size(); }
+
+    // Fall back to loose files for assets not in any archive (default: on)
+    void set_loose_files(bool enabled) { loose_files_ = enabled; }
+    bool loose_files() const { return loose_files_; }
+
+    // ========================================================================
+    // Hot Reload (development)
+    // ========================================================================
+    //
+    // Watches the source file of every loaded texture and sprite sheet
+    // (FileWatcher). When an artist saves one, it is decoded again on a
+    // loader thread and the next process_uploads() swaps the new pixels in
+    // behind the same TextureHandle (Renderer::update_texture), so sprites,
+    // handles and SpriteSheet frames keep working without a restart.
+    // Backends that cannot update in place get a new texture, which handles
+    // and sprite sheets follow; TextureHandles copied out earlier do not.
+    //
+    // The loose file is read even when an archive holds the asset, and a
+    // cooked texture only wins if it is newer than the edit. Sprite sheet
+    // frames keep their UVs: redefine them if the image changed size.
+
+    void set_hot_reload(bool enabled, int debounce_ms = FileWatcher::DEFAULT_DEBOUNCE_MS);
+    bool hot_reload() const { return watcher_ != nullptr; }
+
+    // ========================================================================
+    // Memory Budget
+    // ========================================================================
+
+    // Texture bytes to stay under (0 = unlimited, the default). Enforced by
+    // process_uploads(); referenced textures are never evicted, so usage
+    // can stay above the budget while handles hold it there.
+    void set_memory_budget(size_t bytes) { memory_budget_ = bytes; }
+    size_t memory_budget() const { return memory_budget_; }
+
+    // Evict unreferenced textures, least recently used first, until at
+    // most target_bytes are resident (e.g. 0 on a low-memory warning).
+    // Only call between frames. Returns the bytes freed.
+    size_t trim_memory(size_t target_bytes);
+
+    ResourceState resource_state(const TextureResource& handle) const;
+    ResourceState resource_state(const SpriteSheetResource& handle) const;
 
-    // Texture storage
-    struct TextureEntry {
-        TextureHandle handle = INVALID_TEXTURE;
+    ResourceMemoryStats memory_stats() const;
+    void reset_memory_stats();
+
+    // Bytes a texture of this size occupies (all of its mip levels)
+    static size_t texture_bytes(const TextureInfo& info);
+
+private:
+    template<typename T> friend class ResourceHandle;
+
+    enum class AssetKind : uint8_t { Texture, SpriteSheet };
+
+    // One loaded (or loading) resource; handles index these
+    struct ResourceSlot {
+        AssetKind kind = AssetKind::Texture;
+        std::string id;                 // Empty = free slot
+        std::string path;               // Load path ("" = made from an Image)
+        std::string source_path;        // Resolved loose file
+        TextureFilter filter = TextureFilter::Nearest;
+        TextureHandle texture = INVALID_TEXTURE;   // Invalid while evicted
         TextureInfo info;
-        std::string source_path;
+        std::unique_ptr<SpriteSheet> sheet;
+        size_t bytes = 0;               // Texture memory while resident
+        uint64_t last_used = 0;         // use_clock_ at the last access
+        uint32_t generation = 1;
+        uint32_t refs = 0;              // Live handles
+        bool pinned = false;            // Raw handle handed out by ID: never evicted
+        bool loaded = false;            // Ready or Evicted
     };
-    std::unordered_map<std::string, TextureEntry> textures_;
 
-    // Sprite sheet storage
-    std::unordered_map<std::string, std::unique_ptr<SpriteSheet>> sprite_sheets_;
+    // Reference counting (called by ResourceHandle)
+    void retain(uint32_t index, uint32_t generation);
+    void release(uint32_t index, uint32_t generation);
+    const std::string& resource_id(uint32_t index, uint32_t generation) const;
+
+    ResourceSlot* slot(uint32_t index, uint32_t generation);
+    const ResourceSlot* slot(uint32_t index, uint32_t generation) const;
+    ResourceSlot* find_slot(AssetKind kind, const std::string& id);
+    const ResourceSlot* find_slot(AssetKind kind, const std::string& id) const;
+
+    // Existing slot for the ID, or a new empty one
+    uint32_t acquire_slot(AssetKind kind, const std::string& id);
+    void free_slot(uint32_t index);
+
+    std::unordered_map<std::string, uint32_t>& slot_ids(AssetKind kind) {
+        return kind == AssetKind::Texture ? texture_ids_ : sheet_ids_;
+    }
+    const std::unordered_map<std::string, uint32_t>& slot_ids(AssetKind kind) const {
+        return kind == AssetKind::Texture ? texture_ids_ : sheet_ids_;
+    }
+    size_t count_loaded(AssetKind kind) const;
+
+    // Give a slot its texture (Ready) / destroy it (Evicted or unloading)
+    void attach_texture(ResourceSlot& slot, TextureHandle texture, const TextureInfo& info);
+    void detach_texture(ResourceSlot& slot);
+
+    // Mark used; reload if evicted. Returns false if the resource is unusable
+    bool touch(ResourceSlot& slot);
+    bool reload(ResourceSlot& slot);
+
+    ResourceState slot_state(const ResourceSlot* slot) const;
+    ResourceState resource_state(AssetKind kind, uint32_t index, uint32_t generation) const;
+
+    template<typename T>
+    ResourceHandle<T> make_handle(uint32_t index) {
+        return ResourceHandle<T>(this, index, slots_[index].generation);
+    }
+
+    Renderer* renderer_ = nullptr;
+    std::string base_path_;
+    bool prefer_cooked_ = true;
+    bool generate_mipmaps_ = false;
+    MipFilter mip_filter_ = MipFilter::Nearest;
+    bool loose_files_ = true;
+
+    // Mounted archives, replaced (never modified) under archive_mutex_
+    using ArchiveList = std::vector<std::shared_ptr<const AssetArchive>>;
+    std::shared_ptr<const ArchiveList> archive_list() const;
+    mutable std::mutex archive_mutex_;
+    std::shared_ptr<const ArchiveList> archives_ = std::make_shared<const ArchiveList>();
+
+    std::vector<std::unique_ptr<SpriteManifest>> manifests_;   // Sheets point into these
+
+    // Resource table: slots are reused, IDs map into it
+    std::vector<ResourceSlot> slots_;
+    std::vector<uint32_t> free_slots_;
+    std::unordered_map<std::string, uint32_t> texture_ids_;
+    std::unordered_map<std::string, uint32_t> sheet_ids_;
+
+    size_t memory_budget_ = 0;
+    size_t resident_bytes_ = 0;
+    uint64_t use_clock_ = 0;
+    ResourceMemoryStats memory_stats_;    // Counters only
 
     // Helper to resolve path
     std::string resolve_path(const std::string& path) const;
+    static std::string resolve_path(const std::string& base_path, const std::string& path);
+
+    // Settings a source read depends on. Loader tasks get a copy when they
+    // are queued, so the setters never race with a worker thread.
+    struct SourceOptions {
+        std::string base_path;
+        bool prefer_cooked = true;
+        bool generate_mipmaps = false;
+        bool loose_files = true;
+    };
+    SourceOptions source_options() const;
+
+    // Pixels ready for create_texture(): a cooked texture or a decoded image
+    struct SourceImage {
+        std::shared_ptr<const AssetArchive> archive;   // Keeps `bytes` mapped
+        std::unique_ptr<CookedTexture> cooked;
+        std::unique_ptr<Image> image;
+        AssetBytes bytes;    // Archive entry the cooked texture reads from
+        MipChain mips;       // Built for `image` when mipmapping
+        std::string path;    // File actually loaded
+
+        bool is_valid() const { return cooked || image; }
+        int width() const { return cooked ? cooked->width() : image ? image->width() : 0; }
+        int height() const { return cooked ? cooked->height() : image ? image->height() : 0; }
+        const uint8_t* pixels() const { return cooked ? cooked->pixels() : image ? image->data() : nullptr; }
+        int mip_count() const { return cooked ? cooked->mip_count() : mips.count(); }
+    };
+
+    // Read a texture source from the archives or loose files, preferring
+    // its cooked version, and build its mips if needed. Thread-safe with
+    // explicit options; the one-argument form reads the current settings
+    // and is for the main thread only.
+    SourceImage load_source(const std::string& path) const;
+    SourceImage load_source(const std::string& path, const SourceOptions& options) const;
+    bool load_archived_source(const std::string& path, const SourceOptions& options,
+                              SourceImage& source) const;
+    bool load_loose_source(const std::string& path, const SourceOptions& options,
+                           SourceImage& source) const;
+    bool load_cooked_source(const std::string& full_path, const SourceOptions& options,
+                            SourceImage& source) const;
+    void build_mips(const SourceOptions& options, SourceImage& source) const;
+
+    // Upload a loaded source and register it under `id` (logs failures)
+    TextureResource add_texture(const std::string& id, const std::string& path,
+                                SourceImage source, TextureFilter filter);
+
+    // Describe a source as a texture and list its levels (empty if the
+    // pixels are bad)
+    std::vector<const uint8_t*> source_levels(const SourceImage& source, TextureFilter filter,
+                                              TextureInfo& info) const;
+
+    // Create a texture from a source (nullptr renderer or bad pixels -> INVALID_TEXTURE)
+    TextureHandle upload_source(const SourceImage& source, TextureFilter filter, TextureInfo& info);
+
+    // ========================================================================
+    // Asynchronous loading state
+    // ========================================================================
+
+    using Clock = std::chrono::steady_clock;
+
+    // Who to tell when a load finishes
+    struct Waiters {
+        std::vector<LoadCallback> callbacks;
+        std::vector<LoadGroupID> groups;
+    };
+
+    // A request in flight (main thread only)
+    struct PendingLoad {
+        uint64_t ticket = 0;            // Matches the worker's result
+        TextureFilter filter = TextureFilter::Nearest;
+        Clock::time_point requested;
+        Waiters waiters;
+    };
+
+    // A worker's result, waiting in uploads_
+    struct DecodedImage {
+        AssetKind kind = AssetKind::Texture;
+        std::string id;
+        uint64_t ticket = 0;
+        SourceImage source;             // Invalid if the file failed to load
+        std::string source_path;        // Requested file (before cooked lookup)
+        double decode_us = 0.0;
+        Clock::time_point changed;      // Hot reload: when the edit was seen
+    };
+
+    // A finished load whose callbacks have not run yet
+    struct Completion {
+        std::string id;
+        bool success = false;
+        Waiters waiters;
+    };
+
+    struct LoadGroup {
+        LoadGroupProgress progress;
+        LoadGroupCallback on_complete;
+        bool notified = false;
+    };
+
+    std::unordered_map<std::string, PendingLoad>& pending_loads(AssetKind kind) {
+        return kind == AssetKind::Texture ? pending_textures_ : pending_sheets_;
+    }
+    std::unordered_set<std::string>& failed_loads(AssetKind kind) {
+        return kind == AssetKind::Texture ? failed_textures_ : failed_sheets_;
+    }
+    const std::unordered_map<std::string, PendingLoad>& pending_loads(AssetKind kind) const {
+        return kind == AssetKind::Texture ? pending_textures_ : pending_sheets_;
+    }
+    const std::unordered_set<std::string>& failed_loads(AssetKind kind) const {
+        return kind == AssetKind::Texture ? failed_textures_ : failed_sheets_;
+    }
+    // Ready or Evicted
+    bool is_loaded(AssetKind kind, const std::string& id) const {
+        const ResourceSlot* entry = find_slot(kind, id);
+        return entry && entry->loaded;
+    }
+    // Ready (texture exists)
+    bool is_resident(AssetKind kind, const std::string& id) const {
+        const ResourceSlot* entry = find_slot(kind, id);
+        return entry && entry->texture != INVALID_TEXTURE;
+    }
+
+    // Shared body of load_texture_async / load_sprite_sheet_async
+    bool request_load(AssetKind kind, const std::string& id, const std::string& path,
+                      TextureFilter filter, LoadCallback callback, LoadGroupID group);
+    void add_waiter(Waiters& waiters, LoadCallback callback, LoadGroupID group);
+
+    // Render thread: create the texture for a decoded image
+    void upload(DecodedImage& decoded);
+
+    // Finish a pending request without uploading (unload, shutdown)
+    void cancel_load(AssetKind kind, const std::string& id);
+    void cancel_all_loads(AssetKind kind);
+
+    // Run queued callbacks and notify completed groups
+    void deliver_completions();
+
+    // Predicted create_texture() time for an image, from past uploads
+    double estimate_upload_ms(const SourceImage& source) const;
+
+    void start_loader();
+
+    // Hot reload: decode changed files on loader_, then swap the decoded
+    // pixels into their textures in process_uploads() (render thread)
+    void watch_source(const ResourceSlot& entry);
+    void queue_hot_reloads();
+    void apply_hot_reload(DecodedImage& decoded);
+
+    std::unique_ptr<ThreadPool> loader_;
+    std::unique_ptr<FileWatcher> watcher_;
+    int loader_threads_ = 0;
+    uint64_t next_ticket_ = 1;
+
+    std::unordered_map<std::string, PendingLoad> pending_textures_;
+    std::unordered_map<std::string, PendingLoad> pending_sheets_;
+    std::unordered_set<std::string> failed_textures_;
+    std::unordered_set<std::string> failed_sheets_;
+    std::vector<Completion> completions_;
+
+    LoadGroupID next_group_ = 1;
+    std::unordered_map<LoadGroupID, LoadGroup> groups_;
+
+    // Shared with the loader threads (guarded by upload_mutex_)
+    mutable std::mutex upload_mutex_;
+    std::condition_variable upload_ready_;
+    std::deque<DecodedImage> uploads_;
+    std::deque<DecodedImage> hot_reloads_;
+
+    LoaderStats stats_;
+    double upload_ms_per_mpixel_ = 0.0;   // Running average, 0 = no samples yet
 };
 
+// ============================================================================
+// ResourceHandle Implementation
+// ============================================================================
+
+template<typename T>
+ResourceHandle<T>::ResourceHandle(ResourceManager* manager, uint32_t index, uint32_t generation)
+    : manager_(manager), index_(index), generation_(generation) {
+    manager_->retain(index_, generation_);
+}
+
+template<typename T>
+ResourceHandle<T>::ResourceHandle(const ResourceHandle& other)
+    : manager_(other.manager_), index_(other.index_), generation_(other.generation_) {
+    if (manager_) {
+        manager_->retain(index_, generation_);
+    }
+}
+
+template<typename T>
+ResourceHandle<T>& ResourceHandle<T>::operator=(const ResourceHandle& other) {
+    if (this != &other) {
+        // Retain first: other may be the last reference to what we hold
+        if (other.manager_) {
+            other.manager_->retain(other.index_, other.generation_);
+        }
+        reset();
+        manager_ = other.manager_;
+        index_ = other.index_;
+        generation_ = other.generation_;
+    }
+    return *this;
+}
+
+template<typename T>
+ResourceHandle<T>::ResourceHandle(ResourceHandle&& other) noexcept
+    : manager_(other.manager_), index_(other.index_), generation_(other.generation_) {
+    other.manager_ = nullptr;
+}
+
+template<typename T>
+ResourceHandle<T>& ResourceHandle<T>::operator=(ResourceHandle&& other) noexcept {
+    if (this != &other) {
+        reset();
+        manager_ = other.manager_;
+        index_ = other.index_;
+        generation_ = other.generation_;
+        other.manager_ = nullptr;
+    }
+    return *this;
+}
+
+template<typename T>
+void ResourceHandle<T>::reset() {
+    if (manager_) {
+        manager_->release(index_, generation_);
+        manager_ = nullptr;
+    }
+}
+
+template<typename T>
+const std::string& ResourceHandle<T>::id() const {
+    static const std::string empty;
+    return manager_ ? manager_->resource_id(index_, generation_) : empty;
+}
+
 // ============================================================================
 // Global Resource Manager Access (optional convenience)
 // ============================================================================
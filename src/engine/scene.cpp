@@ -1,4 +1,5 @@
 #include "scene.h"
+#include "profiler.h"
 #include <algorithm>
 
 namespace cafe {
@@ -41,8 +42,15 @@ void Scene::update_animators(float dt) {
     });
 }
 
+void Scene::update_audio_emitters(AudioSystem& audio) {
+    entities_.for_each<AudioEmitter>([&audio](Entity*, AudioEmitter* emitter) {
+        emitter->update(audio);
+    });
+}
+
 void Scene::render_sprites(Renderer* renderer) {
     if (!renderer) return;
+    CAFE_PROFILE_SCOPE("Scene::render_sprites");
 
     // Collect all sprites with their transforms
     struct SpriteEntry {
@@ -192,6 +200,7 @@ void SceneManager::clear_scenes() {
 }
 
 void SceneManager::update(float dt) {
+    CAFE_PROFILE_SCOPE("SceneManager::update");
     Scene* scene = current_scene();
     if (scene && scene->is_active_) {
         scene->update(dt);
@@ -200,6 +209,7 @@ void SceneManager::update(float dt) {
 
 void SceneManager::render() {
     if (!renderer_) return;
+    CAFE_PROFILE_SCOPE("SceneManager::render");
 
     // Render all scenes from bottom to top
     // (useful for overlays/menus that don't fully cover screen)
@@ -41,6 +41,9 @@ public:
     virtual void update(float dt);
     virtual void render(Renderer* renderer);
 
+    // Move AudioEmitter sounds to their entities (call after moving them)
+    void update_audio_emitters(AudioSystem& audio);
+
     // Entity management
     EntityManager& entities() { return entities_; }
     const EntityManager& entities() const { return entities_; }
@@ -0,0 +1,146 @@
+#ifndef CAFE_SNAPSHOT_BUFFER_H
+#define CAFE_SNAPSHOT_BUFFER_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace cafe {
+
+// ============================================================================
+// TripleBuffer - Lock-free handoff of the latest value between two threads
+// ============================================================================
+//
+// Three slots: the writer fills `back`, the reader holds `front`, and the
+// third sits in the middle. publish() swaps back <-> middle, acquire()
+// swaps middle <-> front when the middle holds something new. Neither
+// side ever waits for the other, and the reader always gets the newest
+// complete value (values the reader never picked up are overwritten).
+//
+//   writer:  fill write_slot()  ->  publish()
+//   reader:  acquire()          ->  read read_slot() until the next acquire
+//
+// The middle index carries a "fresh" bit so the reader can tell whether
+// anything was published since its last acquire.
+//
+// ============================================================================
+
+template<typename T>
+class TripleBuffer {
+public:
+    // Writer thread
+    T& write_slot() { return slots_[back_]; }
+    void publish() {
+        back_ = middle_.exchange(static_cast<uint8_t>(back_ | FRESH), std::memory_order_acq_rel) & INDEX;
+    }
+
+    // Reader thread: true if a newer value is now in read_slot()
+    bool acquire() {
+        if ((middle_.load(std::memory_order_relaxed) & FRESH) == 0) return false;
+        front_ = middle_.exchange(front_, std::memory_order_acq_rel) & INDEX;
+        return true;
+    }
+    const T& read_slot() const { return slots_[front_]; }
+
+private:
+    static constexpr uint8_t INDEX = 0x3;
+    static constexpr uint8_t FRESH = 0x4;
+
+    std::array<T, 3> slots_{};
+    uint8_t back_ = 0;                      // Writer only
+    uint8_t front_ = 1;                     // Reader only
+    std::atomic<uint8_t> middle_{2};
+};
+
+// ============================================================================
+// SnapshotBuffer - Render snapshots from the simulation thread
+// ============================================================================
+//
+// In GameLoop's threaded mode the simulation publishes an immutable copy
+// of what the renderer needs after every fixed step, and the render
+// thread draws the newest pair, blending them with `alpha`:
+//
+//   struct Snapshot { std::vector<Sprite> sprites; Vec2 camera; };
+//   SnapshotBuffer<Snapshot> snapshots;
+//   loop.set_snapshot_buffer(&snapshots);
+//
+//   loop.set_update_callback([&](float dt) {       // Simulation thread
+//       world.update(dt, loop.input());
+//       world.build_snapshot(snapshots.write());   // Published by the loop
+//   });
+//   loop.set_render_callback([&](float alpha) {    // Render thread
+//       draw(snapshots.previous(), snapshots.current(), alpha);
+//   });
+//
+// A published frame holds the previous step's snapshot too, so the pair
+// always belongs to consecutive steps even when the renderer misses some.
+// The cost is two extra copies of T per step: publish() copies the kept
+// snapshot into the frame as `previous`, then keeps a copy of `current`
+// for the next step.
+//
+// ============================================================================
+
+// What GameLoop needs without knowing the snapshot type
+class SnapshotBufferBase {
+public:
+    virtual ~SnapshotBufferBase() = default;
+
+    // Simulation thread: publish what write() holds as the state at `time`
+    // (platform seconds) after `step` steps; `published_at` is when it
+    // became available (steady clock seconds, for latency)
+    virtual void publish(uint64_t step, double time, double published_at) = 0;
+
+    // Render thread: pick up the newest frame (false if nothing new)
+    virtual bool acquire() = 0;
+    virtual bool has_frame() const = 0;
+    virtual uint64_t step() const = 0;
+    virtual double time() const = 0;
+    virtual double published_at() const = 0;
+};
+
+template<typename T>
+class SnapshotBuffer : public SnapshotBufferBase {
+public:
+    // Simulation thread: the snapshot to fill for this step. Fill all of
+    // it: the slot still holds a snapshot from two publishes ago.
+    T& write() { return buffer_.write_slot().current; }
+
+    void publish(uint64_t step, double time, double published_at) override {
+        Frame& frame = buffer_.write_slot();
+        frame.previous = has_last_ ? last_ : frame.current;
+        last_ = frame.current;
+        has_last_ = true;
+        frame.step = step;
+        frame.time = time;
+        frame.published_at = published_at;
+        frame.valid = true;
+        buffer_.publish();
+    }
+
+    // Render thread
+    bool acquire() override { return buffer_.acquire(); }
+    bool has_frame() const override { return buffer_.read_slot().valid; }
+    const T& previous() const { return buffer_.read_slot().previous; }
+    const T& current() const { return buffer_.read_slot().current; }
+    uint64_t step() const override { return buffer_.read_slot().step; }
+    double time() const override { return buffer_.read_slot().time; }
+    double published_at() const override { return buffer_.read_slot().published_at; }
+
+private:
+    struct Frame {
+        T previous{};
+        T current{};
+        uint64_t step = 0;
+        double time = 0.0;
+        double published_at = 0.0;
+        bool valid = false;
+    };
+
+    TripleBuffer<Frame> buffer_;
+    T last_{};                              // Simulation thread only
+    bool has_last_ = false;
+};
+
+} // namespace cafe
+
+#endif // CAFE_SNAPSHOT_BUFFER_H
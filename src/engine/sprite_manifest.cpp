@@ -0,0 +1,808 @@
+#include "sprite_manifest.h"
+#include "image.h"
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+
+namespace cafe {
+
+// ============================================================================
+// Manifest File Format
+// ============================================================================
+
+namespace {
+
+constexpr char kManifestMagic[4] = {'C', 'S', 'H', 'T'};
+
+struct ManifestHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t sheet_count;
+    uint32_t sheet_slot_count;   // Sheet name table: the first slots
+    uint32_t frame_count;
+    uint32_t animation_count;
+    uint32_t index_count;
+    uint32_t slot_count;
+    uint32_t names_size;
+    uint32_t reserved[7];
+};
+static_assert(sizeof(ManifestHeader) == 64, "manifest header must be 64 bytes");
+static_assert(sizeof(SpriteManifest::SheetRecord) == 56, "sheet record must be 56 bytes");
+static_assert(sizeof(SpriteManifest::FrameRecord) == 32, "frame record must be 32 bytes");
+static_assert(sizeof(SpriteManifest::AnimationRecord) == 24, "animation record must be 24 bytes");
+
+// Tables follow the header in this order, each a multiple of 8 bytes
+// except the indices, which are padded to 8
+struct Layout {
+    uint64_t sheets, frames, animations, indices, slots, names, end;
+};
+
+uint64_t align8(uint64_t value) {
+    return (value + 7) & ~uint64_t(7);
+}
+
+Layout layout_for(const ManifestHeader& h) {
+    Layout l;
+    l.sheets = sizeof(ManifestHeader);
+    l.frames = l.sheets + uint64_t(h.sheet_count) * sizeof(SpriteManifest::SheetRecord);
+    l.animations = l.frames + uint64_t(h.frame_count) * sizeof(SpriteManifest::FrameRecord);
+    l.indices = l.animations + uint64_t(h.animation_count) * sizeof(SpriteManifest::AnimationRecord);
+    l.slots = align8(l.indices + uint64_t(h.index_count) * sizeof(int32_t));
+    l.names = l.slots + uint64_t(h.slot_count) * 8;
+    l.end = l.names + h.names_size;
+    return l;
+}
+
+// FNV-1a
+uint32_t name_hash(std::string_view name) {
+    uint32_t h = 2166136261u;
+    for (unsigned char c : name) {
+        h ^= c;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+// Power of two with load factor <= 1/2 (0 for an empty table)
+uint32_t table_size(size_t count) {
+    uint32_t size = count ? 2 : 0;
+    while (size < count * 2) {
+        size *= 2;
+    }
+    return size;
+}
+
+bool is_power_of_two_or_zero(uint32_t value) {
+    return (value & (value - 1)) == 0;
+}
+
+bool read_text(const std::string& path, std::string& out) {
+    FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) return false;
+
+    char chunk[16 * 1024];
+    size_t n;
+    out.clear();
+    while ((n = std::fread(chunk, 1, sizeof(chunk), file)) > 0) {
+        out.append(chunk, n);
+    }
+    bool ok = !std::ferror(file);
+    std::fclose(file);
+    return ok;
+}
+
+// ============================================================================
+// Manifest Compiler
+// ============================================================================
+//
+// Builds the sheets the way the SpriteSheet calls would: a grid replaces
+// every frame so far and names its cells frame_0, frame_1, ...; a frame
+// whose name is taken shadows the older one; a later animation replaces
+// one of the same name. Animation frame lists are resolved when the
+// sheet ends, so they may name frames defined below them.
+
+struct FrameDef {
+    std::string name;
+    int x = 0, y = 0, width = 0, height = 0;
+};
+
+struct AnimationDef {
+    std::string name;
+    std::vector<std::string> refs;   // Index, "a..b" range or frame name
+    float frame_duration = 0.1f;
+    bool looping = true;
+    int line = 0;
+};
+
+struct SheetDef {
+    std::string name;
+    std::string image;
+    int width = 0;
+    int height = 0;
+    std::vector<FrameDef> frames;
+    std::vector<AnimationDef> animations;
+    std::vector<std::vector<int32_t>> resolved;   // Per animation
+};
+
+class ManifestCompiler {
+public:
+    ManifestCompiler(const std::string& directory, const std::string& source)
+        : directory_(directory), source_(source) {}
+
+    bool parse(std::string_view text);
+    void emit(std::vector<uint8_t>& out) const;
+
+private:
+    bool fail(const std::string& message) {
+        std::cerr << "SpriteManifest: " << source_ << ":" << line_ << ": " << message << "\n";
+        return false;
+    }
+
+    bool parse_line(std::string_view line);
+    bool parse_grid(const std::vector<std::string_view>& args);
+    bool parse_frame(std::string_view name, const std::vector<std::string_view>& args);
+    bool parse_animation(std::string_view name, const std::vector<std::string_view>& args);
+    bool finish_sheet();
+    bool texture_size(int& width, int& height);
+
+    std::string directory_;
+    std::string source_;
+    int line_ = 0;
+    std::vector<SheetDef> sheets_;
+};
+
+std::string_view trim(std::string_view s) {
+    while (!s.empty() && (s.front() == ' ' || s.front() == '\t' || s.front() == '\r')) s.remove_prefix(1);
+    while (!s.empty() && (s.back() == ' ' || s.back() == '\t' || s.back() == '\r')) s.remove_suffix(1);
+    return s;
+}
+
+std::vector<std::string_view> split(std::string_view s) {
+    std::vector<std::string_view> tokens;
+    size_t i = 0;
+    while (i < s.size()) {
+        while (i < s.size() && (s[i] == ' ' || s[i] == '\t')) ++i;
+        size_t start = i;
+        while (i < s.size() && s[i] != ' ' && s[i] != '\t') ++i;
+        if (i > start) tokens.push_back(s.substr(start, i - start));
+    }
+    return tokens;
+}
+
+bool parse_int(std::string_view s, int& value) {
+    auto [end, error] = std::from_chars(s.data(), s.data() + s.size(), value);
+    return error == std::errc() && end == s.data() + s.size();
+}
+
+bool parse_float(std::string_view s, float& value) {
+    auto [end, error] = std::from_chars(s.data(), s.data() + s.size(), value);
+    return error == std::errc() && end == s.data() + s.size();
+}
+
+bool valid_name(std::string_view name) {
+    return !name.empty() && name.size() <= 0xFFFF &&
+           std::none_of(name.begin(), name.end(), [](char c) { return c == ' ' || c == '\t'; });
+}
+
+bool ManifestCompiler::parse(std::string_view text) {
+    while (!text.empty()) {
+        size_t end = text.find('\n');
+        std::string_view line = text.substr(0, end);
+        text.remove_prefix(end == std::string_view::npos ? text.size() : end + 1);
+        ++line_;
+
+        size_t comment = line.find('#');
+        if (comment != std::string_view::npos) {
+            line = line.substr(0, comment);
+        }
+        line = trim(line);
+        if (!line.empty() && !parse_line(line)) {
+            return false;
+        }
+    }
+    return finish_sheet();
+}
+
+bool ManifestCompiler::parse_line(std::string_view line) {
+    if (line.front() == '[') {
+        if (line.back() != ']') {
+            return fail("expected ']'");
+        }
+        std::string_view name = trim(line.substr(1, line.size() - 2));
+        if (!valid_name(name)) {
+            return fail("invalid sheet name");
+        }
+        if (!finish_sheet()) {
+            return false;
+        }
+        for (const SheetDef& sheet : sheets_) {
+            if (sheet.name == name) {
+                return fail("duplicate sheet: " + std::string(name));
+            }
+        }
+        sheets_.emplace_back();
+        sheets_.back().name = name;
+        return true;
+    }
+
+    size_t equals = line.find('=');
+    if (equals == std::string_view::npos) {
+        return fail("expected 'key = value'");
+    }
+    if (sheets_.empty()) {
+        return fail("definition before the first [sheet]");
+    }
+    std::string_view key = trim(line.substr(0, equals));
+    std::string_view value = trim(line.substr(equals + 1));
+    std::vector<std::string_view> args = split(value);
+    SheetDef& sheet = sheets_.back();
+
+    if (key == "image") {
+        if (value.size() >= 2 && value.front() == '"' && value.back() == '"') {
+            value = value.substr(1, value.size() - 2);
+        }
+        if (value.empty() || value.size() > 0xFFFF) {
+            return fail("invalid image path");
+        }
+        sheet.image = value;
+        return true;
+    }
+    if (key == "size") {
+        if (args.size() != 2 || !parse_int(args[0], sheet.width) || !parse_int(args[1], sheet.height) ||
+            sheet.width <= 0 || sheet.height <= 0) {
+            return fail("size takes a width and a height");
+        }
+        return true;
+    }
+    if (key == "grid") {
+        return parse_grid(args);
+    }
+    if (key.substr(0, 6) == "frame.") {
+        return parse_frame(key.substr(6), args);
+    }
+    if (key.substr(0, 5) == "anim.") {
+        return parse_animation(key.substr(5), args);
+    }
+    return fail("unknown key: " + std::string(key));
+}
+
+bool ManifestCompiler::texture_size(int& width, int& height) {
+    SheetDef& sheet = sheets_.back();
+    if (sheet.width == 0) {
+        if (sheet.image.empty()) {
+            return fail("set image (or size) before defining frames");
+        }
+        std::string path = (std::filesystem::path(directory_) / sheet.image).string();
+        if (!Image::read_size(path, sheet.width, sheet.height)) {
+            return fail("cannot read image size: " + path);
+        }
+    }
+    width = sheet.width;
+    height = sheet.height;
+    return true;
+}
+
+bool ManifestCompiler::parse_grid(const std::vector<std::string_view>& args) {
+    // cell_width cell_height [columns rows [padding [margin]]]
+    int values[6] = {0, 0, -1, -1, 0, 0};
+    if (args.size() < 2 || args.size() > 6 || args.size() == 3) {
+        return fail("grid takes cell width and height [columns rows [padding [margin]]]");
+    }
+    for (size_t i = 0; i < args.size(); ++i) {
+        if (!parse_int(args[i], values[i])) {
+            return fail("grid: not a number: " + std::string(args[i]));
+        }
+    }
+    auto [cell_width, cell_height, columns, rows, padding, margin] = values;
+    if (cell_width <= 0 || cell_height <= 0 || padding < 0 || margin < 0) {
+        return fail("grid: cell size must be positive");
+    }
+
+    int width, height;
+    if (!texture_size(width, height)) {
+        return false;
+    }
+    if (columns < 0) {
+        columns = (width - 2 * margin + padding) / (cell_width + padding);
+    }
+    if (rows < 0) {
+        rows = (height - 2 * margin + padding) / (cell_height + padding);
+    }
+    if (columns > 0 && rows > 0 &&
+        (margin + columns * (cell_width + padding) - padding > width ||
+         margin + rows * (cell_height + padding) - padding > height)) {
+        return fail("grid does not fit the texture");
+    }
+
+    SheetDef& sheet = sheets_.back();
+    sheet.frames.clear();
+    for (int row = 0; row < rows; ++row) {
+        for (int col = 0; col < columns; ++col) {
+            FrameDef frame;
+            frame.name = "frame_" + std::to_string(sheet.frames.size());
+            frame.x = margin + col * (cell_width + padding);
+            frame.y = margin + row * (cell_height + padding);
+            frame.width = cell_width;
+            frame.height = cell_height;
+            sheet.frames.push_back(std::move(frame));
+        }
+    }
+    return true;
+}
+
+bool ManifestCompiler::parse_frame(std::string_view name, const std::vector<std::string_view>& args) {
+    FrameDef frame;
+    frame.name = name;
+    if (!valid_name(name)) {
+        return fail("invalid frame name");
+    }
+    if (args.size() != 4 || !parse_int(args[0], frame.x) || !parse_int(args[1], frame.y) ||
+        !parse_int(args[2], frame.width) || !parse_int(args[3], frame.height)) {
+        return fail("frame takes x y width height");
+    }
+    int width, height;
+    if (!texture_size(width, height)) {
+        return false;
+    }
+    if (frame.x < 0 || frame.y < 0 || frame.width < 0 || frame.height < 0 ||
+        frame.x + frame.width > width || frame.y + frame.height > height) {
+        return fail("frame outside the texture: " + frame.name);
+    }
+    sheets_.back().frames.push_back(std::move(frame));
+    return true;
+}
+
+bool ManifestCompiler::parse_animation(std::string_view name, const std::vector<std::string_view>& args) {
+    // refs... [@ seconds] [once | loop]
+    AnimationDef anim;
+    anim.name = name;
+    anim.line = line_;
+    if (!valid_name(name)) {
+        return fail("invalid animation name");
+    }
+
+    size_t i = 0;
+    for (; i < args.size() && args[i] != "@" && args[i] != "once" && args[i] != "loop"; ++i) {
+        anim.refs.emplace_back(args[i]);
+    }
+    if (i < args.size() && args[i] == "@") {
+        if (i + 1 >= args.size() || !parse_float(args[i + 1], anim.frame_duration) ||
+            !(anim.frame_duration >= 0.0f)) {
+            return fail("'@' takes the seconds per frame");
+        }
+        i += 2;
+    }
+    if (i < args.size()) {
+        anim.looping = args[i] == "loop";
+        if (args[i] != "loop" && args[i] != "once") {
+            return fail("expected 'once' or 'loop', got: " + std::string(args[i]));
+        }
+        ++i;
+    }
+    if (i != args.size()) {
+        return fail("unexpected: " + std::string(args[i]));
+    }
+    if (anim.refs.empty()) {
+        return fail("animation has no frames");
+    }
+
+    std::vector<AnimationDef>& animations = sheets_.back().animations;
+    auto same = std::find_if(animations.begin(), animations.end(),
+                             [&](const AnimationDef& other) { return other.name == anim.name; });
+    if (same != animations.end()) {
+        *same = std::move(anim);
+    } else {
+        animations.push_back(std::move(anim));
+    }
+    return true;
+}
+
+bool ManifestCompiler::finish_sheet() {
+    if (sheets_.empty()) {
+        return true;
+    }
+    SheetDef& sheet = sheets_.back();
+    if (sheet.image.empty()) {
+        return fail("sheet has no image: " + sheet.name);
+    }
+    if (sheet.width == 0) {
+        int width, height;
+        if (!texture_size(width, height)) {
+            return false;
+        }
+    }
+    if (sheet.width > 0xFFFF || sheet.height > 0xFFFF) {
+        return fail("texture too large: " + sheet.name);
+    }
+
+    // Latest definition of each name wins, as in SpriteSheet
+    auto frame_index = [&](const std::string& name) {
+        for (size_t i = sheet.frames.size(); i-- > 0;) {
+            if (sheet.frames[i].name == name) return static_cast<int>(i);
+        }
+        return -1;
+    };
+
+    sheet.resolved.clear();
+    for (const AnimationDef& anim : sheet.animations) {
+        std::vector<int32_t> frames;
+        for (const std::string& ref : anim.refs) {
+            int first, last;
+            size_t dots = ref.find("..");
+            if (dots != std::string::npos && parse_int(std::string_view(ref).substr(0, dots), first) &&
+                parse_int(std::string_view(ref).substr(dots + 2), last)) {
+                // Ranges run either way: "7..4" plays backwards
+                for (int f = first;; f += first <= last ? 1 : -1) {
+                    if (f < 0 || f >= static_cast<int>(sheet.frames.size())) {
+                        line_ = anim.line;
+                        return fail("frame index out of range in " + anim.name + ": " + ref);
+                    }
+                    frames.push_back(f);
+                    if (f == last) break;
+                }
+                continue;
+            }
+            int index = -1;
+            if (!parse_int(ref, index)) {
+                index = frame_index(ref);
+            }
+            if (index < 0 || index >= static_cast<int>(sheet.frames.size())) {
+                line_ = anim.line;
+                return fail("unknown frame in " + anim.name + ": " + ref);
+            }
+            frames.push_back(index);
+        }
+        sheet.resolved.push_back(std::move(frames));
+    }
+    return true;
+}
+
+// Fill `count` slots starting at slots[first] for these names; a repeated
+// name keeps the last index
+void build_table(std::vector<uint64_t>& slots, const std::vector<std::string_view>& names,
+                 uint32_t& first, uint32_t& count) {
+    first = static_cast<uint32_t>(slots.size());
+    count = table_size(names.size());
+    std::vector<std::string_view> placed(count);
+    std::vector<uint32_t> hashes(count), indices(count, 0xFFFFFFFFu);
+
+    for (size_t i = 0; i < names.size(); ++i) {
+        uint32_t hash = name_hash(names[i]);
+        uint32_t slot = hash & (count - 1);
+        while (indices[slot] != 0xFFFFFFFFu && placed[slot] != names[i]) {
+            slot = (slot + 1) & (count - 1);
+        }
+        placed[slot] = names[i];
+        hashes[slot] = hash;
+        indices[slot] = static_cast<uint32_t>(i);
+    }
+    for (uint32_t s = 0; s < count; ++s) {
+        // Slot layout: hash in the low word, index in the high word
+        slots.push_back(uint64_t(hashes[s]) | (uint64_t(indices[s]) << 32));
+    }
+}
+
+void ManifestCompiler::emit(std::vector<uint8_t>& out) const {
+    std::string names;
+    auto add_name = [&](std::string_view name) {
+        SpriteManifest::NameRef ref{static_cast<uint32_t>(names.size()), static_cast<uint32_t>(name.size())};
+        names += name;
+        return ref;
+    };
+
+    std::vector<SpriteManifest::SheetRecord> sheets;
+    std::vector<SpriteManifest::FrameRecord> frames;
+    std::vector<SpriteManifest::AnimationRecord> animations;
+    std::vector<int32_t> indices;
+    std::vector<uint64_t> slots;
+
+    // Sheet name table first, so its slots start at 0
+    std::vector<std::string_view> keys;
+    for (const SheetDef& sheet : sheets_) {
+        keys.push_back(sheet.name);
+    }
+    uint32_t sheet_slots = 0, sheet_slot_count = 0;
+    build_table(slots, keys, sheet_slots, sheet_slot_count);
+
+    for (const SheetDef& sheet : sheets_) {
+        SpriteManifest::SheetRecord record{};
+        record.name = add_name(sheet.name);
+        record.image = add_name(sheet.image);
+        record.width = sheet.width;
+        record.height = sheet.height;
+        record.first_frame = static_cast<uint32_t>(frames.size());
+        record.frame_count = static_cast<uint32_t>(sheet.frames.size());
+        record.first_animation = static_cast<uint32_t>(animations.size());
+        record.animation_count = static_cast<uint32_t>(sheet.animations.size());
+
+        float tw = static_cast<float>(sheet.width);
+        float th = static_cast<float>(sheet.height);
+        keys.clear();
+        for (const FrameDef& def : sheet.frames) {
+            SpriteManifest::FrameRecord frame{};
+            frame.name = add_name(def.name);
+            frame.x = static_cast<uint16_t>(def.x);
+            frame.y = static_cast<uint16_t>(def.y);
+            frame.width = static_cast<uint16_t>(def.width);
+            frame.height = static_cast<uint16_t>(def.height);
+            // Same arithmetic as TextureRegion::from_pixels
+            frame.u0 = def.x / tw;
+            frame.v0 = def.y / th;
+            frame.u1 = (def.x + def.width) / tw;
+            frame.v1 = (def.y + def.height) / th;
+            frames.push_back(frame);
+            keys.push_back(def.name);
+        }
+        build_table(slots, keys, record.frame_slots, record.frame_slot_count);
+
+        keys.clear();
+        for (size_t a = 0; a < sheet.animations.size(); ++a) {
+            const AnimationDef& def = sheet.animations[a];
+            SpriteManifest::AnimationRecord anim{};
+            anim.name = add_name(def.name);
+            anim.first_index = static_cast<uint32_t>(indices.size());
+            anim.index_count = static_cast<uint32_t>(sheet.resolved[a].size());
+            anim.frame_duration = def.frame_duration;
+            anim.looping = def.looping ? 1 : 0;
+            indices.insert(indices.end(), sheet.resolved[a].begin(), sheet.resolved[a].end());
+            animations.push_back(anim);
+            keys.push_back(def.name);
+        }
+        build_table(slots, keys, record.animation_slots, record.animation_slot_count);
+
+        sheets.push_back(record);
+    }
+
+    ManifestHeader header{};
+    std::memcpy(header.magic, kManifestMagic, sizeof(header.magic));
+    header.version = SpriteManifest::VERSION;
+    header.sheet_count = static_cast<uint32_t>(sheets.size());
+    header.sheet_slot_count = sheet_slot_count;
+    header.frame_count = static_cast<uint32_t>(frames.size());
+    header.animation_count = static_cast<uint32_t>(animations.size());
+    header.index_count = static_cast<uint32_t>(indices.size());
+    header.slot_count = static_cast<uint32_t>(slots.size());
+    header.names_size = static_cast<uint32_t>(names.size());
+
+    Layout layout = layout_for(header);
+    out.assign(layout.end, 0);
+    auto put = [&](uint64_t offset, const void* data, size_t size) {
+        if (size) std::memcpy(out.data() + offset, data, size);
+    };
+    put(0, &header, sizeof(header));
+    put(layout.sheets, sheets.data(), sheets.size() * sizeof(sheets[0]));
+    put(layout.frames, frames.data(), frames.size() * sizeof(frames[0]));
+    put(layout.animations, animations.data(), animations.size() * sizeof(animations[0]));
+    put(layout.indices, indices.data(), indices.size() * sizeof(indices[0]));
+    put(layout.slots, slots.data(), slots.size() * sizeof(slots[0]));
+    put(layout.names, names.data(), names.size());
+}
+
+} // namespace
+
+// ============================================================================
+// Cooking
+// ============================================================================
+
+std::string SpriteManifest::cooked_path(const std::string& manifest_path) {
+    size_t slash = manifest_path.find_last_of("/\\");
+    size_t dot = manifest_path.find_last_of('.');
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) {
+        return manifest_path + EXTENSION;
+    }
+    return manifest_path.substr(0, dot) + EXTENSION;
+}
+
+bool SpriteManifest::compile(std::string_view text, const std::string& directory,
+                             std::vector<uint8_t>& out, const std::string& source_name) {
+    ManifestCompiler compiler(directory, source_name);
+    if (!compiler.parse(text)) {
+        return false;
+    }
+    compiler.emit(out);
+    return true;
+}
+
+bool SpriteManifest::cook_file(const std::string& manifest_path, const std::string& output_path) {
+    std::string text;
+    if (!read_text(manifest_path, text)) {
+        std::cerr << "SpriteManifest: Failed to read: " << manifest_path << "\n";
+        return false;
+    }
+
+    std::vector<uint8_t> blob;
+    std::string directory = std::filesystem::path(manifest_path).parent_path().string();
+    if (!compile(text, directory, blob, manifest_path)) {
+        return false;
+    }
+
+    FILE* file = std::fopen(output_path.c_str(), "wb");
+    bool ok = file && std::fwrite(blob.data(), 1, blob.size(), file) == blob.size();
+    ok = file && (std::fclose(file) == 0) && ok;
+    if (!ok) {
+        std::cerr << "SpriteManifest: Failed to write: " << output_path << "\n";
+        std::remove(output_path.c_str());
+    }
+    return ok;
+}
+
+// ============================================================================
+// Reading
+// ============================================================================
+
+bool SpriteManifest::open(const std::string& path) {
+    close();
+
+    std::filesystem::path fs_path(path);
+    std::error_code error;
+    std::string cooked = fs_path.extension() == EXTENSION ? path : cooked_path(path);
+    if (cooked != path) {
+        // Text manifest: its cooked copy wins unless the text is newer
+        auto cooked_time = std::filesystem::last_write_time(cooked, error);
+        auto text_time = error ? cooked_time : std::filesystem::last_write_time(path, error);
+        if (error || cooked_time < text_time) {
+            cooked.clear();
+        }
+    }
+
+    if (!cooked.empty()) {
+        if (!file_.open(cooked) || !attach(file_.data(), file_.size())) {
+            std::cerr << "SpriteManifest: Not a version " << VERSION << " manifest: " << cooked << "\n";
+            close();
+            return false;
+        }
+    } else {
+        std::string text;
+        if (!read_text(path, text)) {
+            std::cerr << "SpriteManifest: Failed to read: " << path << "\n";
+            return false;
+        }
+        if (!compile(text, fs_path.parent_path().string(), buffer_, path) ||
+            !attach(buffer_.data(), buffer_.size())) {
+            close();
+            return false;
+        }
+    }
+
+    path_ = path;
+    directory_ = fs_path.parent_path().string();
+    return true;
+}
+
+bool SpriteManifest::attach(const uint8_t* data, size_t size) {
+    ManifestHeader header;
+    if (size < sizeof(header)) {
+        return false;
+    }
+    std::memcpy(&header, data, sizeof(header));
+    if (std::memcmp(header.magic, kManifestMagic, sizeof(header.magic)) != 0 ||
+        header.version != VERSION) {
+        return false;
+    }
+
+    Layout layout = layout_for(header);
+    if (layout.end > size || header.sheet_slot_count > header.slot_count ||
+        !is_power_of_two_or_zero(header.sheet_slot_count) ||
+        (header.sheet_count > 0 && header.sheet_slot_count == 0)) {
+        return false;
+    }
+
+    sheets_ = {reinterpret_cast<const SheetRecord*>(data + layout.sheets), header.sheet_count};
+    frames_ = {reinterpret_cast<const FrameRecord*>(data + layout.frames), header.frame_count};
+    animations_ = {reinterpret_cast<const AnimationRecord*>(data + layout.animations), header.animation_count};
+    indices_ = {reinterpret_cast<const int32_t*>(data + layout.indices), header.index_count};
+    slots_ = {reinterpret_cast<const Slot*>(data + layout.slots), header.slot_count};
+    names_ = reinterpret_cast<const char*>(data + layout.names);
+    names_size_ = header.names_size;
+    sheet_slot_count_ = header.sheet_slot_count;
+
+    // The sheet table is small; check its ranges once so lookups need not
+    auto range_ok = [](uint64_t first, uint64_t count, uint64_t limit) {
+        return first + count <= limit;
+    };
+    for (const SheetRecord& sheet : sheets_) {
+        if (!range_ok(sheet.first_frame, sheet.frame_count, frames_.size()) ||
+            !range_ok(sheet.first_animation, sheet.animation_count, animations_.size()) ||
+            !range_ok(sheet.frame_slots, sheet.frame_slot_count, slots_.size()) ||
+            !range_ok(sheet.animation_slots, sheet.animation_slot_count, slots_.size()) ||
+            !is_power_of_two_or_zero(sheet.frame_slot_count) ||
+            !is_power_of_two_or_zero(sheet.animation_slot_count) ||
+            (sheet.frame_count > 0 && sheet.frame_slot_count == 0) ||
+            (sheet.animation_count > 0 && sheet.animation_slot_count == 0) ||
+            sheet.width <= 0 || sheet.height <= 0) {
+            return false;
+        }
+    }
+
+    data_ = data;
+    return true;
+}
+
+void SpriteManifest::close() {
+    file_.close();
+    buffer_.clear();
+    buffer_.shrink_to_fit();
+    data_ = nullptr;
+    path_.clear();
+    directory_.clear();
+    sheets_ = {};
+    frames_ = {};
+    animations_ = {};
+    indices_ = {};
+    slots_ = {};
+    sheet_slot_count_ = 0;
+    names_ = nullptr;
+    names_size_ = 0;
+}
+
+int SpriteManifest::lookup(uint32_t first, uint32_t count, std::string_view name,
+                           const void* records, size_t stride, size_t record_count) const {
+    if (count == 0) {
+        return -1;
+    }
+    uint32_t hash = name_hash(name);
+    const auto* bytes = static_cast<const uint8_t*>(records);
+    for (uint32_t probe = 0, slot = hash & (count - 1); probe < count; ++probe, slot = (slot + 1) & (count - 1)) {
+        const Slot& s = slots_[first + slot];
+        if (s.index == EMPTY_SLOT) {
+            return -1;
+        }
+        if (s.hash == hash && s.index < record_count) {
+            NameRef ref;
+            std::memcpy(&ref, bytes + s.index * stride, sizeof(ref));
+            if (this->name(ref) == name) {
+                return static_cast<int>(s.index);
+            }
+        }
+    }
+    return -1;
+}
+
+int SpriteManifest::find_sheet(std::string_view name) const {
+    return lookup(0, sheet_slot_count_, name, sheets_.data(), sizeof(SheetRecord), sheets_.size());
+}
+
+std::span<const SpriteManifest::FrameRecord> SpriteManifest::frames(int sheet) const {
+    const SheetRecord& s = sheets_[sheet];
+    return frames_.subspan(s.first_frame, s.frame_count);
+}
+
+std::span<const SpriteManifest::AnimationRecord> SpriteManifest::animations(int sheet) const {
+    const SheetRecord& s = sheets_[sheet];
+    return animations_.subspan(s.first_animation, s.animation_count);
+}
+
+std::span<const int32_t> SpriteManifest::indices(const AnimationRecord& animation) const {
+    if (uint64_t(animation.first_index) + animation.index_count > indices_.size()) {
+        return {};
+    }
+    return indices_.subspan(animation.first_index, animation.index_count);
+}
+
+int SpriteManifest::find_frame(int sheet, std::string_view name) const {
+    const SheetRecord& s = sheets_[sheet];
+    return lookup(s.frame_slots, s.frame_slot_count, name,
+                  frames_.data() + s.first_frame, sizeof(FrameRecord), s.frame_count);
+}
+
+int SpriteManifest::find_animation(int sheet, std::string_view name) const {
+    const SheetRecord& s = sheets_[sheet];
+    return lookup(s.animation_slots, s.animation_slot_count, name,
+                  animations_.data() + s.first_animation, sizeof(AnimationRecord), s.animation_count);
+}
+
+std::string_view SpriteManifest::name(NameRef ref) const {
+    if (uint64_t(ref.offset) + ref.length > names_size_) {
+        return {};
+    }
+    return std::string_view(names_ + ref.offset, ref.length);
+}
+
+std::string SpriteManifest::image_path(int sheet) const {
+    return (std::filesystem::path(directory_) / name(sheets_[sheet].image)).string();
+}
+
+} // namespace cafe
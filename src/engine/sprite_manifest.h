@@ -0,0 +1,190 @@
+#ifndef CAFE_SPRITE_MANIFEST_H
+#define CAFE_SPRITE_MANIFEST_H
+
+#include "mapped_file.h"
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace cafe {
+
+// ============================================================================
+// SpriteManifest - Sprite sheet definitions from data (.sheets / .csheets)
+// ============================================================================
+//
+// Frames and animations written out in code (define_grid, define_frame,
+// define_animation) rebuild the same strings and hash maps on every
+// launch, and changing an animation's timing means a recompile. A
+// manifest describes the sheets in a text file instead:
+//
+//   # sprites/cafe.sheets
+//   [barista]
+//   image = barista.png          # Relative to the manifest
+//   grid = 32 32                 # Cell size [columns rows [padding [margin]]]
+//   frame.cup = 0 224 16 16      # x y width height
+//   anim.idle = 0..3 @ 0.25      # Frames (indices, ranges, names) @ seconds
+//   anim.order = frame_4 frame_5 cup @ 0.15 once
+//
+// Frame names, animation frame lists and UV rects are worked out once,
+// when the manifest is cooked, into a flat little-endian blob:
+//
+//   Header      magic "CSHT", version, table sizes
+//   Sheets      name, image, texture size, ranges into the tables below
+//   Frames      pixel rect, UV rect, name (32 bytes each)
+//   Animations  frame range in Indices, seconds per frame, looping
+//   Indices     sheet-local frame index per animation frame
+//   Slots       open-addressed name hash tables (sheets, then per sheet
+//               its frames and its animations)
+//   Names       every name and image path, back to back
+//
+// open() maps the blob and checks the header and sheet table; nothing is
+// parsed and no per-frame string is built. SpriteSheet::define_from()
+// fills its frames from the records, and names stay views into the
+// mapping. A text manifest with no up-to-date .csheets next to it is
+// compiled into the same layout in memory.
+//
+// Usage:
+//   SpriteManifest::cook_file("sprites/cafe.sheets", "sprites/cafe.csheets");
+//
+//   SpriteManifest manifest;
+//   manifest.open("sprites/cafe.sheets");   // Uses cafe.csheets if fresh
+//   sheet.define_from(manifest, manifest.find_sheet("barista"));
+//
+// ============================================================================
+
+class SpriteManifest {
+public:
+    static constexpr uint32_t VERSION = 1;
+    static constexpr const char* EXTENSION = ".csheets";
+
+    // Offset and length in the name table
+    struct NameRef {
+        uint32_t offset;
+        uint32_t length;
+    };
+
+    // On-disk sheet (56 bytes)
+    struct SheetRecord {
+        NameRef name;
+        NameRef image;              // Relative to the manifest's directory
+        int32_t width;              // Texture size the UVs were cooked for
+        int32_t height;
+        uint32_t first_frame;
+        uint32_t frame_count;
+        uint32_t first_animation;
+        uint32_t animation_count;
+        uint32_t frame_slots;       // First slot of the frame name table
+        uint32_t frame_slot_count;  // Power of two (0 = no frames)
+        uint32_t animation_slots;
+        uint32_t animation_slot_count;
+    };
+
+    // On-disk frame (32 bytes)
+    struct FrameRecord {
+        NameRef name;
+        uint16_t x, y, width, height;
+        float u0, v0, u1, v1;
+    };
+
+    // On-disk animation (24 bytes)
+    struct AnimationRecord {
+        NameRef name;
+        uint32_t first_index;       // Into indices()
+        uint32_t index_count;
+        float frame_duration;       // Seconds per frame
+        uint32_t looping;           // 0 or 1
+    };
+
+    SpriteManifest() = default;
+
+    // Non-copyable, movable (sheets bound to it point into its data)
+    SpriteManifest(const SpriteManifest&) = delete;
+    SpriteManifest& operator=(const SpriteManifest&) = delete;
+    SpriteManifest(SpriteManifest&&) = default;
+    SpriteManifest& operator=(SpriteManifest&&) = default;
+
+    // ========================================================================
+    // Cooking (offline)
+    // ========================================================================
+
+    // Text manifest -> .csheets
+    static bool cook_file(const std::string& manifest_path, const std::string& output_path);
+
+    // Compile manifest text to the cooked layout. `directory` is where
+    // image paths are looked up when a grid needs the texture size.
+    // `source_name` only labels error messages.
+    static bool compile(std::string_view text, const std::string& directory,
+                        std::vector<uint8_t>& out, const std::string& source_name = "manifest");
+
+    // "sprites/cafe.sheets" -> "sprites/cafe.csheets"
+    static std::string cooked_path(const std::string& manifest_path);
+
+    // ========================================================================
+    // Reading
+    // ========================================================================
+
+    // A .csheets file is mapped. A text manifest uses its .csheets when
+    // that is at least as new, and is compiled in memory otherwise.
+    bool open(const std::string& path);
+    void close();
+
+    bool is_open() const { return data_ != nullptr; }
+    const std::string& path() const { return path_; }
+    bool is_cooked() const { return file_.is_open(); }
+
+    int sheet_count() const { return static_cast<int>(sheets_.size()); }
+    int find_sheet(std::string_view name) const;   // -1 if missing
+
+    const SheetRecord& sheet(int index) const { return sheets_[index]; }
+    std::span<const FrameRecord> frames(int sheet) const;
+    std::span<const AnimationRecord> animations(int sheet) const;
+    std::span<const int32_t> indices(const AnimationRecord& animation) const;
+
+    // Sheet-local index of a named frame / animation, or -1
+    int find_frame(int sheet, std::string_view name) const;
+    int find_animation(int sheet, std::string_view name) const;
+
+    // View into the manifest (empty if out of range)
+    std::string_view name(NameRef ref) const;
+
+    // Image path as written, joined to the manifest's directory
+    std::string image_path(int sheet) const;
+
+private:
+    struct Slot {
+        uint32_t hash;
+        uint32_t index;             // EMPTY_SLOT = free
+    };
+    static constexpr uint32_t EMPTY_SLOT = 0xFFFFFFFFu;
+
+    // Parse the header and point the tables into data_
+    bool attach(const uint8_t* data, size_t size);
+
+    // Index stored for `name` in slots [first, first + count), or -1.
+    // Every record type starts with its NameRef: `records`, `stride` and
+    // `record_count` locate a candidate's name for the compare.
+    int lookup(uint32_t first, uint32_t count, std::string_view name,
+               const void* records, size_t stride, size_t record_count) const;
+
+    MappedFile file_;                 // Cooked file
+    std::vector<uint8_t> buffer_;     // Compiled from text
+    const uint8_t* data_ = nullptr;
+    std::string path_;
+    std::string directory_;
+
+    std::span<const SheetRecord> sheets_;
+    std::span<const FrameRecord> frames_;
+    std::span<const AnimationRecord> animations_;
+    std::span<const int32_t> indices_;
+    std::span<const Slot> slots_;
+    uint32_t sheet_slot_count_ = 0;
+    const char* names_ = nullptr;
+    uint32_t names_size_ = 0;
+};
+
+} // namespace cafe
+
+#endif // CAFE_SPRITE_MANIFEST_H
@@ -1,5 +1,6 @@
 #include "sprite_sheet.h"
 #include "image.h"
+#include "sprite_manifest.h"
 #include <cmath>
 
 namespace cafe {
@@ -36,6 +37,11 @@ void SpriteSheet::set_texture(TextureHandle texture, int width, int height) {
     texture_ = texture;
     texture_width_ = width;
     texture_height_ = height;
+
+    // Frames already defined now refer to the new texture (a reloaded one)
+    for (SpriteFrame& frame : frames_) {
+        frame.region.texture = texture;
+    }
 }
 
 void SpriteSheet::define_grid(int cell_width, int cell_height,
@@ -56,6 +62,11 @@ void SpriteSheet::define_grid(int cell_width, int cell_height,
 
     frames_.clear();
     frame_by_name_.clear();
+    manifest_ = nullptr;
+    if (columns > 0 && rows > 0) {
+        frames_.reserve(static_cast<size_t>(columns) * rows);
+        frame_by_name_.reserve(static_cast<size_t>(columns) * rows);
+    }
 
     int frame_index = 0;
     for (int row = 0; row < rows; ++row) {
@@ -64,14 +75,15 @@ void SpriteSheet::define_grid(int cell_width, int cell_height,
             int y = margin + row * (cell_height + padding);
 
             SpriteFrame frame;
-            frame.name = "frame_" + std::to_string(frame_index);
+            auto named = frame_by_name_.insert_or_assign(
+                "frame_" + std::to_string(frame_index), static_cast<int>(frames_.size()));
+            frame.name = named.first->first;
             frame.width = cell_width;
             frame.height = cell_height;
             frame.region = TextureRegion::from_pixels(
                 texture_, texture_width_, texture_height_,
                 x, y, cell_width, cell_height);
 
-            frame_by_name_[frame.name] = static_cast<int>(frames_.size());
             frames_.push_back(frame);
             ++frame_index;
         }
@@ -81,18 +93,66 @@ void SpriteSheet::define_grid(int cell_width, int cell_height,
 void SpriteSheet::define_frame(const std::string& name, int x, int y, int width, int height) {
     if (texture_ == INVALID_TEXTURE) return;
 
+    // Map nodes never move, so the key can be the frame's name
+    auto named = frame_by_name_.insert_or_assign(name, static_cast<int>(frames_.size()));
+
     SpriteFrame frame;
-    frame.name = name;
+    frame.name = named.first->first;
     frame.width = width;
     frame.height = height;
     frame.region = TextureRegion::from_pixels(
         texture_, texture_width_, texture_height_,
         x, y, width, height);
 
-    frame_by_name_[name] = static_cast<int>(frames_.size());
     frames_.push_back(frame);
 }
 
+bool SpriteSheet::define_from(const SpriteManifest& manifest, int sheet) {
+    if (sheet < 0 || sheet >= manifest.sheet_count()) {
+        return false;
+    }
+    const SpriteManifest::SheetRecord& record = manifest.sheet(sheet);
+    std::span<const SpriteManifest::FrameRecord> records = manifest.frames(sheet);
+
+    frames_.clear();
+    frame_by_name_.clear();
+    animations_.clear();
+    ++animation_revision_;
+    manifest_ = &manifest;
+    manifest_sheet_ = sheet;
+
+    // One allocation for every frame; names point into the manifest
+    bool cooked_size = texture_width_ == record.width && texture_height_ == record.height;
+    frames_.resize(records.size());
+    for (size_t i = 0; i < records.size(); ++i) {
+        const SpriteManifest::FrameRecord& r = records[i];
+        SpriteFrame& frame = frames_[i];
+        frame.name = manifest.name(r.name);
+        frame.width = r.width;
+        frame.height = r.height;
+        frame.region = cooked_size
+            ? TextureRegion(texture_, r.u0, r.v0, r.u1, r.v1)
+            : TextureRegion::from_pixels(texture_, texture_width_, texture_height_,
+                                         r.x, r.y, r.width, r.height);
+    }
+
+    // Frame lists were resolved to indices when the manifest was cooked
+    for (const SpriteManifest::AnimationRecord& r : manifest.animations(sheet)) {
+        std::span<const int32_t> indices = manifest.indices(r);
+        Animation& anim = animations_[std::string(manifest.name(r.name))];
+        anim.name = manifest.name(r.name);
+        anim.frame_duration = r.frame_duration;
+        anim.looping = r.looping != 0;
+        anim.frame_indices.reserve(indices.size());
+        for (int32_t index : indices) {
+            if (index >= 0 && index < static_cast<int>(frames_.size())) {
+                anim.frame_indices.push_back(index);
+            }
+        }
+    }
+    return true;
+}
+
 void SpriteSheet::define_animation(const std::string& name,
                                     int start_frame, int end_frame,
                                     float frame_duration,
@@ -109,6 +169,7 @@ void SpriteSheet::define_animation(const std::string& name,
     }
 
     animations_[name] = anim;
+    ++animation_revision_;
 }
 
 void SpriteSheet::define_animation(const std::string& name,
@@ -128,6 +189,7 @@ void SpriteSheet::define_animation(const std::string& name,
     }
 
     animations_[name] = anim;
+    ++animation_revision_;
 }
 
 const SpriteFrame* SpriteSheet::frame(int index) const {
@@ -138,19 +200,17 @@ const SpriteFrame* SpriteSheet::frame(int index) const {
 }
 
 const SpriteFrame* SpriteSheet::frame(const std::string& name) const {
-    auto it = frame_by_name_.find(name);
-    if (it == frame_by_name_.end()) {
-        return nullptr;
-    }
-    return &frames_[it->second];
+    int index = frame_index(name);
+    return index >= 0 ? &frames_[index] : nullptr;
 }
 
 int SpriteSheet::frame_index(const std::string& name) const {
+    // Frames defined in code after define_from() shadow the manifest's
     auto it = frame_by_name_.find(name);
-    if (it == frame_by_name_.end()) {
-        return -1;
+    if (it != frame_by_name_.end()) {
+        return it->second;
     }
-    return it->second;
+    return manifest_ ? manifest_->find_frame(manifest_sheet_, name) : -1;
 }
 
 const Animation* SpriteSheet::animation(const std::string& name) const {
@@ -163,17 +223,21 @@ const Animation* SpriteSheet::animation(const std::string& name) const {
 
 int SpriteSheet::animation_frame_index(const std::string& anim_name, float time) const {
     const Animation* anim = animation(anim_name);
-    if (!anim || anim->frame_indices.empty()) {
+    return anim ? animation_frame_index(*anim, time) : 0;
+}
+
+int SpriteSheet::animation_frame_index(const Animation& anim, float time) const {
+    if (anim.frame_indices.empty()) {
         return 0;
     }
 
-    float total_duration = anim->total_duration();
+    float total_duration = anim.total_duration();
     if (total_duration <= 0.0f) {
-        return anim->frame_indices[0];
+        return anim.frame_indices[0];
     }
 
     float t = time;
-    if (anim->looping) {
+    if (anim.looping) {
         t = std::fmod(time, total_duration);
         if (t < 0.0f) t += total_duration;
     } else {
@@ -181,11 +245,11 @@ int SpriteSheet::animation_frame_index(const std::string& anim_name, float time)
         t = std::max(t, 0.0f);
     }
 
-    int frame_num = static_cast<int>(t / anim->frame_duration);
-    frame_num = std::min(frame_num, static_cast<int>(anim->frame_indices.size()) - 1);
+    int frame_num = static_cast<int>(t / anim.frame_duration);
+    frame_num = std::min(frame_num, static_cast<int>(anim.frame_indices.size()) - 1);
     frame_num = std::max(frame_num, 0);
 
-    return anim->frame_indices[frame_num];
+    return anim.frame_indices[frame_num];
 }
 
 TextureRegion SpriteSheet::animation_frame(const std::string& anim_name, float time) const {
@@ -197,6 +261,14 @@ TextureRegion SpriteSheet::animation_frame(const std::string& anim_name, float t
     return TextureRegion(texture_);
 }
 
+TextureRegion SpriteSheet::animation_frame(const Animation& anim, float time) const {
+    const SpriteFrame* f = frame(animation_frame_index(anim, time));
+    if (f) {
+        return f->region;
+    }
+    return TextureRegion(texture_);
+}
+
 void SpriteSheet::unload(Renderer* renderer) {
     if (texture_ != INVALID_TEXTURE && renderer) {
         renderer->destroy_texture(texture_);
@@ -204,7 +276,9 @@ void SpriteSheet::unload(Renderer* renderer) {
     }
     frames_.clear();
     frame_by_name_.clear();
+    manifest_ = nullptr;
     animations_.clear();
+    ++animation_revision_;
     texture_width_ = 0;
     texture_height_ = 0;
 }
@@ -227,18 +301,30 @@ void AnimationPlayer::play(const std::string& animation_name, bool force) {
         return;
     }
 
-    current_animation_ = animation_name;
+    if (current_animation_ != animation_name) {
+        current_animation_ = animation_name;
+        anim_ = nullptr;
+    }
     elapsed_time_ = 0.0f;
     is_playing_ = true;
 }
 
+const Animation* AnimationPlayer::current() const {
+    if (!sheet_ || current_animation_.empty()) return nullptr;
+    if (anim_revision_ != sheet_->animation_revision() || !anim_) {
+        anim_ = sheet_->animation(current_animation_);
+        anim_revision_ = sheet_->animation_revision();
+    }
+    return anim_;
+}
+
 void AnimationPlayer::update(float delta_time) {
     if (!is_playing_ || !sheet_) return;
 
     elapsed_time_ += delta_time * speed_;
 
     // Check if non-looping animation finished
-    const Animation* anim = sheet_->animation(current_animation_);
+    const Animation* anim = current();
     if (anim && !anim->looping) {
         if (elapsed_time_ >= anim->total_duration()) {
             is_playing_ = false;
@@ -250,20 +336,23 @@ TextureRegion AnimationPlayer::current_region() const {
     if (!sheet_) {
         return TextureRegion();
     }
-    return sheet_->animation_frame(current_animation_, elapsed_time_);
+    const Animation* anim = current();
+    if (anim) {
+        return sheet_->animation_frame(*anim, elapsed_time_);
+    }
+    const SpriteFrame* f = sheet_->frame(0);
+    return f ? f->region : TextureRegion(sheet_->texture());
 }
 
 int AnimationPlayer::current_frame_index() const {
-    if (!sheet_) {
-        return 0;
-    }
-    return sheet_->animation_frame_index(current_animation_, elapsed_time_);
+    const Animation* anim = current();
+    return anim ? sheet_->animation_frame_index(*anim, elapsed_time_) : 0;
 }
 
 bool AnimationPlayer::is_finished() const {
     if (!sheet_) return true;
 
-    const Animation* anim = sheet_->animation(current_animation_);
+    const Animation* anim = current();
     if (!anim) return true;
     if (anim->looping) return false;
 
@@ -273,6 +362,7 @@ bool AnimationPlayer::is_finished() const {
 void AnimationPlayer::stop() {
     is_playing_ = false;
     current_animation_.clear();
+    anim_ = nullptr;
     elapsed_time_ = 0.0f;
 }
 
@@ -3,17 +3,20 @@
 
 #include "../renderer/renderer.h"
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 
 namespace cafe {
 
+class SpriteManifest;
+
 // ============================================================================
 // SpriteFrame - A single frame within a sprite sheet
 // ============================================================================
 
 struct SpriteFrame {
-    std::string name;
+    std::string_view name;   // Owned by the sheet (or its SpriteManifest)
     TextureRegion region;
     int width = 0;
     int height = 0;
@@ -53,7 +56,8 @@ public:
     bool load(Renderer* renderer, const std::string& image_path,
               TextureFilter filter = TextureFilter::Nearest);
 
-    // Create from existing texture
+    // Create from existing texture (or swap in a reloaded one: defined
+    // frames keep their pixel rects)
     void set_texture(TextureHandle texture, int width, int height);
 
     // Define frames
@@ -77,6 +81,12 @@ public:
                           float frame_duration = 0.1f,
                           bool looping = true);
 
+    // Replace all frames and animations with a manifest sheet's (see
+    // SpriteManifest). Frame names and name lookups use the manifest's
+    // data, which must stay open while the sheet uses it. Frames keep
+    // the cooked UVs when the texture is the size they were cooked for.
+    bool define_from(const SpriteManifest& manifest, int sheet);
+
     // Accessors
     TextureHandle texture() const { return texture_; }
     int texture_width() const { return texture_width_; }
@@ -92,11 +102,20 @@ public:
 
     // Get animation
     const Animation* animation(const std::string& name) const;
+    const std::unordered_map<std::string, Animation>& animations() const { return animations_; }
+
+    // Bumped whenever animations are (re)defined or cleared, so cached
+    // Animation pointers know when to look the name up again
+    uint32_t animation_revision() const { return animation_revision_; }
 
     // Get texture region for animation at specific time
     TextureRegion animation_frame(const std::string& anim_name, float time) const;
     int animation_frame_index(const std::string& anim_name, float time) const;
 
+    // Same, for an already looked-up animation (no name lookup)
+    TextureRegion animation_frame(const Animation& anim, float time) const;
+    int animation_frame_index(const Animation& anim, float time) const;
+
     // Check validity
     bool is_valid() const { return texture_ != INVALID_TEXTURE; }
 
@@ -109,8 +128,13 @@ private:
     int texture_height_ = 0;
 
     std::vector<SpriteFrame> frames_;
-    std::unordered_map<std::string, int> frame_by_name_;
+    std::unordered_map<std::string, int> frame_by_name_;   // Keys back SpriteFrame::name
+
+    // Set by define_from(): names not defined in code are looked up there
+    const SpriteManifest* manifest_ = nullptr;
+    int manifest_sheet_ = -1;
     std::unordered_map<std::string, Animation> animations_;
+    uint32_t animation_revision_ = 0;
 };
 
 // ============================================================================
@@ -147,8 +171,13 @@ public:
     void set_speed(float speed) { speed_ = speed; }
 
 private:
+    // Resolve current_animation_ (cached until the sheet's animations change)
+    const Animation* current() const;
+
     const SpriteSheet* sheet_ = nullptr;
     std::string current_animation_;
+    mutable const Animation* anim_ = nullptr;
+    mutable uint32_t anim_revision_ = 0;
     float elapsed_time_ = 0.0f;
     float speed_ = 1.0f;
     bool is_playing_ = false;
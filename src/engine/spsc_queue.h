@@ -0,0 +1,152 @@
+#ifndef CAFE_SPSC_QUEUE_H
+#define CAFE_SPSC_QUEUE_H
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+namespace cafe {
+
+// ============================================================================
+// SpscQueue - Lock-free FIFO from one producer thread to one consumer
+// ============================================================================
+//
+// A ring of N slots with two counters: the producer only writes `tail_`,
+// the consumer only writes `head_`. Each side publishes its counter with
+// release and reads the other's with acquire, so a slot's contents are
+// visible before the counter that hands it over. No locks, no allocation,
+// and neither side ever waits - push() on a full queue and pop() on an
+// empty one just return false.
+//
+// Made for real-time consumers such as the audio callback, which must
+// never block on a mutex the game thread holds:
+//
+//   game thread:    queue.push(command);
+//   audio thread:   while (queue.pop(command)) apply(command);
+//
+// Each side also caches the other's last seen counter, so the common
+// case touches only its own cache line. N must be a power of two.
+//
+// ============================================================================
+
+template<typename T, size_t N>
+class SpscQueue {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "SpscQueue capacity must be a power of two");
+
+public:
+    // Producer thread
+    bool push(const T& value) {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_cache_ == N) {
+            head_cache_ = head_.load(std::memory_order_acquire);
+            if (tail - head_cache_ == N) return false;
+        }
+        slots_[tail & MASK] = value;
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer thread
+    bool pop(T& out) {
+        size_t head = head_.load(std::memory_order_relaxed);
+        if (head == tail_cache_) {
+            tail_cache_ = tail_.load(std::memory_order_acquire);
+            if (head == tail_cache_) return false;
+        }
+        out = slots_[head & MASK];
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Approximate when called while the other side is active
+    size_t size() const {
+        return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire);
+    }
+    bool empty() const { return size() == 0; }
+    static constexpr size_t capacity() { return N; }
+
+private:
+    static constexpr size_t MASK = N - 1;
+
+    std::array<T, N> slots_{};
+
+    // Producer side
+    alignas(64) std::atomic<size_t> tail_{0};
+    size_t head_cache_ = 0;
+
+    // Consumer side
+    alignas(64) std::atomic<size_t> head_{0};
+    size_t tail_cache_ = 0;
+};
+
+// ============================================================================
+// SpscRing - Bulk SpscQueue for sample streams
+// ============================================================================
+//
+// Same protocol as SpscQueue, but the capacity is chosen at construction
+// and reads and writes move runs of elements (memcpy-able T) with one
+// counter update each. Used for decoded audio: a decode thread writes
+// samples, the audio callback reads them.
+//
+// ============================================================================
+
+template<typename T>
+class SpscRing {
+public:
+    // Capacity is rounded up to a power of two
+    explicit SpscRing(size_t capacity) {
+        size_t n = 2;
+        while (n < capacity) n *= 2;
+        capacity_ = n;
+        data_ = std::make_unique<T[]>(n);
+    }
+
+    // Producer thread: copies up to `count`, returns how many fit
+    size_t write(const T* values, size_t count) {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        size_t head = head_.load(std::memory_order_acquire);
+        count = std::min(count, capacity_ - (tail - head));
+
+        size_t start = tail & (capacity_ - 1);
+        size_t first = std::min(count, capacity_ - start);
+        std::copy(values, values + first, data_.get() + start);
+        std::copy(values + first, values + count, data_.get());
+        tail_.store(tail + count, std::memory_order_release);
+        return count;
+    }
+
+    // Consumer thread: copies up to `count`, returns how many were there
+    size_t read(T* out, size_t count) {
+        size_t head = head_.load(std::memory_order_relaxed);
+        size_t tail = tail_.load(std::memory_order_acquire);
+        count = std::min(count, tail - head);
+
+        size_t start = head & (capacity_ - 1);
+        size_t first = std::min(count, capacity_ - start);
+        std::copy(data_.get() + start, data_.get() + start + first, out);
+        std::copy(data_.get(), data_.get() + (count - first), out + first);
+        head_.store(head + count, std::memory_order_release);
+        return count;
+    }
+
+    // Producer: room left; consumer: elements waiting (exact for the caller's side)
+    size_t free_space() const {
+        return capacity_ - (tail_.load(std::memory_order_relaxed) - head_.load(std::memory_order_acquire));
+    }
+    size_t available() const {
+        return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_relaxed);
+    }
+    size_t capacity() const { return capacity_; }
+
+private:
+    std::unique_ptr<T[]> data_;
+    size_t capacity_ = 0;
+    alignas(64) std::atomic<size_t> tail_{0};
+    alignas(64) std::atomic<size_t> head_{0};
+};
+
+} // namespace cafe
+
+#endif // CAFE_SPSC_QUEUE_H
@@ -0,0 +1,74 @@
+#include "thread_pool.h"
+#include <algorithm>
+
+namespace cafe {
+
+int ThreadPool::default_thread_count() {
+    int hardware = static_cast<int>(std::thread::hardware_concurrency());
+    return std::max(1, hardware - 1);
+}
+
+ThreadPool::ThreadPool(int threads) {
+    if (threads <= 0) {
+        threads = default_thread_count();
+    }
+    workers_.reserve(threads);
+    for (int i = 0; i < threads; ++i) {
+        workers_.emplace_back([this] { worker_loop(); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+        jobs_.clear();
+    }
+    wake_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+void ThreadPool::submit(Job job) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        jobs_.push_back(std::move(job));
+    }
+    wake_.notify_one();
+}
+
+void ThreadPool::wait_idle() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    idle_.wait(lock, [this] { return jobs_.empty() && running_ == 0; });
+}
+
+size_t ThreadPool::pending() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return jobs_.size() + running_;
+}
+
+void ThreadPool::worker_loop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        wake_.wait(lock, [this] { return stop_ || !jobs_.empty(); });
+        if (stop_) {
+            return;
+        }
+
+        Job job = std::move(jobs_.front());
+        jobs_.pop_front();
+        ++running_;
+
+        lock.unlock();
+        job();
+        lock.lock();
+
+        --running_;
+        if (jobs_.empty() && running_ == 0) {
+            idle_.notify_all();
+        }
+    }
+}
+
+} // namespace cafe
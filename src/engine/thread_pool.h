@@ -0,0 +1,71 @@
+#ifndef CAFE_THREAD_POOL_H
+#define CAFE_THREAD_POOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace cafe {
+
+// ============================================================================
+// ThreadPool - Fixed set of worker threads running queued jobs
+// ============================================================================
+//
+// Jobs run in submission order, each on whichever worker is free. Jobs must
+// not touch the renderer: GPU calls stay on the thread that owns it, so
+// workers only do CPU work (decoding, parsing) and hand results back.
+//
+// Usage:
+//   ThreadPool pool;                  // hardware threads - 1 workers
+//   pool.submit([] { decode(); });
+//   pool.wait_idle();                 // Block until the queue is empty
+//
+// ============================================================================
+
+class ThreadPool {
+public:
+    using Job = std::function<void()>;
+
+    // threads <= 0: one less than the hardware thread count (at least 1),
+    // leaving a core for the main thread
+    explicit ThreadPool(int threads = 0);
+
+    // Discards jobs that have not started and joins the workers
+    ~ThreadPool();
+
+    // Non-copyable, non-movable (workers hold `this`)
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void submit(Job job);
+
+    // Block until every submitted job has finished
+    void wait_idle();
+
+    int thread_count() const { return static_cast<int>(workers_.size()); }
+
+    // Jobs queued or running
+    size_t pending() const;
+
+    static int default_thread_count();
+
+private:
+    void worker_loop();
+
+    std::vector<std::thread> workers_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable wake_;      // Workers: job queued or stopping
+    std::condition_variable idle_;      // wait_idle(): a job finished
+    std::deque<Job> jobs_;
+    size_t running_ = 0;
+    bool stop_ = false;
+};
+
+} // namespace cafe
+
+#endif // CAFE_THREAD_POOL_H
@@ -0,0 +1,287 @@
+#include "tile_layers.h"
+#include "sprite_sheet.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace cafe {
+
+// ============================================================================
+// Construction
+// ============================================================================
+
+LayeredTileMap::LayeredTileMap(int width, int height) {
+    resize(width, height);
+}
+
+void LayeredTileMap::resize(int width, int height) {
+    width_ = width;
+    height_ = height;
+    for (auto& layer : layers_) {
+        layer->tiles.resize(width, height);
+    }
+}
+
+// ============================================================================
+// Layers
+// ============================================================================
+
+TileLayer& LayeredTileMap::add_layer(const std::string& name, int elevation, bool opaque) {
+    auto layer = std::make_unique<TileLayer>();
+    layer->name = name;
+    layer->tiles.resize(width_, height_);
+    layer->elevation = elevation;
+    layer->opaque = opaque;
+
+    layers_.push_back(std::move(layer));
+    return *layers_.back();
+}
+
+void LayeredTileMap::add_standard_layers() {
+    add_layer("floor");
+    add_layer("furniture");
+    add_layer("walls", 0, true);
+    add_layer("roof", 2, true);
+}
+
+TileLayer* LayeredTileMap::layer(const std::string& name) {
+    for (auto& layer : layers_) {
+        if (layer->name == name) return layer.get();
+    }
+    return nullptr;
+}
+
+const TileLayer* LayeredTileMap::layer(const std::string& name) const {
+    for (const auto& layer : layers_) {
+        if (layer->name == name) return layer.get();
+    }
+    return nullptr;
+}
+
+TileLayer* LayeredTileMap::layer(int index) {
+    if (index < 0 || index >= layer_count()) return nullptr;
+    return layers_[index].get();
+}
+
+const TileLayer* LayeredTileMap::layer(int index) const {
+    if (index < 0 || index >= layer_count()) return nullptr;
+    return layers_[index].get();
+}
+
+void LayeredTileMap::set_layer_visible(const std::string& name, bool visible) {
+    if (TileLayer* l = layer(name)) {
+        l->visible = visible;
+    }
+}
+
+bool LayeredTileMap::is_layer_visible(const std::string& name) const {
+    const TileLayer* l = layer(name);
+    return l && l->visible;
+}
+
+Tile LayeredTileMap::layer_tile(int layer, int x, int y) const {
+    const TileLayer& l = *layers_[layer];
+    Tile tile = l.tiles.at(x, y);
+    tile.height += l.elevation;
+    return tile;
+}
+
+// ============================================================================
+// Occlusion Culling
+// ============================================================================
+
+namespace {
+
+// Screen columns half a tile wide, aligned so a tile covers exactly two
+class ColumnGrid {
+public:
+    explicit ColumnGrid(const Rect& viewport)
+        : half_width_(Isometric::tile_width() * 0.5f)
+        , cam_x_(Isometric::camera().x) {
+        base_ = static_cast<int>(std::floor((viewport.x + cam_x_) / half_width_));
+        count_ = static_cast<int>(std::ceil(viewport.width / half_width_)) + 2;
+    }
+
+    int count() const { return count_; }
+
+    // Column containing screen_x
+    int column_at(float screen_x) const {
+        return static_cast<int>(std::floor((screen_x + cam_x_) / half_width_)) - base_;
+    }
+
+    // First column starting at or after screen_x
+    int column_from(float screen_x) const {
+        return static_cast<int>(std::ceil((screen_x + cam_x_) / half_width_)) - base_;
+    }
+
+private:
+    float half_width_;
+    float cam_x_;
+    int base_ = 0;
+    int count_ = 0;
+};
+
+// Tolerance for tile edges that land exactly on column boundaries
+constexpr float kEdgeEpsilon = 0.01f;
+
+// Sprite area inside the viewport (origin-aware)
+double clipped_area(const Sprite& sprite, const Rect& viewport) {
+    float left = sprite.position.x - sprite.size.x * sprite.origin.x;
+    float top = sprite.position.y - sprite.size.y * sprite.origin.y;
+    float w = std::min(left + sprite.size.x, viewport.x + viewport.width) - std::max(left, viewport.x);
+    float h = std::min(top + sprite.size.y, viewport.y + viewport.height) - std::max(top, viewport.y);
+    return (w > 0.0f && h > 0.0f) ? static_cast<double>(w) * h : 0.0;
+}
+
+} // namespace
+
+void LayeredTileMap::collect_unoccluded(const Rect& viewport) const {
+    visible_.clear();
+
+    ColumnGrid columns(viewport);
+    const float empty_top = std::numeric_limits<float>::max();
+    const float empty_bottom = std::numeric_limits<float>::lowest();
+    cover_top_.assign(columns.count(), empty_top);
+    cover_bottom_.assign(columns.count(), empty_bottom);
+
+    const float half_height = Isometric::tile_height() * 0.5f;
+    const float view_top = viewport.y;
+    const float view_bottom = viewport.y + viewport.height;
+
+    DiagonalRange diagonals = visible_diagonals(width_, height_, viewport);
+
+    // Front to back: last diagonal first, top layer first
+    for (int d = diagonals.last; d >= diagonals.first; --d) {
+        DiagonalSpan span = visible_span(width_, height_, viewport, d);
+
+        for (int x = span.x_begin; x <= span.x_end; ++x) {
+            int y = d - x;
+            Vec2 screen = Isometric::tile_to_screen(x, y);
+
+            for (int l = layer_count() - 1; l >= 0; --l) {
+                const TileLayer& layer = *layers_[l];
+                if (!layer.visible) continue;
+
+                Tile tile = layer_tile(l, x, y);
+                if (tile.is_empty()) continue;
+                ++stats_.candidates;
+
+                Sprite sprite;
+                if (!make_tile_sprite(*tileset_, tile, screen.x, screen.y, sprite)) continue;
+
+                float left = sprite.position.x - sprite.size.x * sprite.origin.x;
+                float right = left + sprite.size.x;
+                float top = sprite.position.y - sprite.size.y * sprite.origin.y;
+                float bottom = top + sprite.size.y;
+
+                // Hidden if every on-screen column is already covered
+                float clip_top = std::max(top, view_top);
+                float clip_bottom = std::min(bottom, view_bottom);
+                bool visible = false;
+                if (clip_top < clip_bottom) {
+                    int first = std::max(columns.column_at(left + kEdgeEpsilon), 0);
+                    int last = std::min(columns.column_at(right - kEdgeEpsilon), columns.count() - 1);
+                    for (int c = first; c <= last && !visible; ++c) {
+                        visible = !(cover_top_[c] <= clip_top && cover_bottom_[c] >= clip_bottom);
+                    }
+                }
+
+                if (!visible) {
+                    ++stats_.culled;
+                    continue;
+                }
+
+                visible_.push_back({x, y, l, screen.x, screen.y});
+                stats_.pixels_drawn += clipped_area(sprite, viewport);
+
+                if (!layer.opaque) continue;
+
+                // Solid part between the slanted top and bottom edges
+                float solid_top = top + half_height;
+                float solid_bottom = bottom - half_height;
+                if (solid_top >= solid_bottom) continue;
+
+                int first = std::max(columns.column_from(left - kEdgeEpsilon), 0);
+                int last = std::min(columns.column_at(right + kEdgeEpsilon) - 1, columns.count() - 1);
+                for (int c = first; c <= last; ++c) {
+                    float& ct = cover_top_[c];
+                    float& cb = cover_bottom_[c];
+                    if (ct > cb || (solid_top <= cb && solid_bottom >= ct)) {
+                        // Empty or touching: merge into one band
+                        ct = std::min(ct, solid_top);
+                        cb = std::max(cb, solid_bottom);
+                    } else if (solid_bottom - solid_top > cb - ct) {
+                        // Disjoint: keep the larger band (still conservative)
+                        ct = solid_top;
+                        cb = solid_bottom;
+                    }
+                }
+            }
+        }
+    }
+}
+
+// ============================================================================
+// Rendering
+// ============================================================================
+
+void LayeredTileMap::for_each_visible(const Rect& viewport, const LayerTileCallback& callback) const {
+    stats_ = Stats();
+
+    if (occlusion_culling_ && tileset_) {
+        collect_unoccluded(viewport);
+
+        // Reverse of front-to-back is a valid back-to-front order
+        for (auto it = visible_.rbegin(); it != visible_.rend(); ++it) {
+            callback(it->x, it->y, it->layer, layer_tile(it->layer, it->x, it->y),
+                     it->screen_x, it->screen_y);
+        }
+        stats_.drawn = static_cast<int>(visible_.size());
+    } else {
+        DiagonalRange diagonals = visible_diagonals(width_, height_, viewport);
+        for (int d = diagonals.first; d <= diagonals.last; ++d) {
+            DiagonalSpan span = visible_span(width_, height_, viewport, d);
+            for (int x = span.x_begin; x <= span.x_end; ++x) {
+                int y = d - x;
+                Vec2 screen = Isometric::tile_to_screen(x, y);
+
+                for (int l = 0; l < layer_count(); ++l) {
+                    if (!layers_[l]->visible) continue;
+
+                    Tile tile = layer_tile(l, x, y);
+                    if (tile.is_empty()) continue;
+
+                    ++stats_.candidates;
+                    ++stats_.drawn;
+                    if (tileset_) {
+                        Sprite sprite;
+                        if (make_tile_sprite(*tileset_, tile, screen.x, screen.y, sprite)) {
+                            stats_.pixels_drawn += clipped_area(sprite, viewport);
+                        }
+                    }
+                    callback(x, y, l, tile, screen.x, screen.y);
+                }
+            }
+        }
+    }
+
+    double view_area = static_cast<double>(viewport.width) * viewport.height;
+    stats_.overdraw = view_area > 0.0 ? stats_.pixels_drawn / view_area : 0.0;
+}
+
+void LayeredTileMap::render(Renderer* renderer, const Rect& viewport) const {
+    if (!tileset_ || !renderer) return;
+
+    renderer->begin_batch();
+
+    for_each_visible(viewport, [&](int, int, int, const Tile& tile, float screen_x, float screen_y) {
+        Sprite sprite;
+        if (make_tile_sprite(*tileset_, tile, screen_x, screen_y, sprite)) {
+            renderer->draw_sprite(sprite);
+        }
+    });
+
+    renderer->end_batch();
+}
+
+} // namespace cafe
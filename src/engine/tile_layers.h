@@ -0,0 +1,139 @@
+#ifndef CAFE_TILE_LAYERS_H
+#define CAFE_TILE_LAYERS_H
+
+#include "isometric.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace cafe {
+
+// ============================================================================
+// TileLayer - One named grid of tiles within a LayeredTileMap
+// ============================================================================
+
+struct TileLayer {
+    std::string name;
+    TileMap tiles;
+    int elevation = 0;     // Added to every tile's height (in tile heights)
+    bool visible = true;   // Per-layer render toggle
+    bool opaque = false;   // Tiles hide whatever is behind them (occluders)
+};
+
+// ============================================================================
+// LayeredTileMap - Stacked tile layers with occlusion culling
+// ============================================================================
+//
+// All layers share the same grid size and tileset. Draw order is the
+// diagonal sweep from TileMap, with the layers of each cell drawn bottom to
+// top, so a wall on cell (3, 4) correctly covers the floor of the same cell.
+//
+// Occlusion culling (optional):
+//   Tiles are first visited front to back. A per-column coverage buffer
+//   tracks the screen rows already hidden by opaque tiles. Columns are half a
+//   tile wide and line up with the tile grid. A tile whose sprite lies fully
+//   inside covered rows in every column it touches is skipped. The survivors
+//   are then emitted back to front.
+//
+//   The coverage an opaque tile adds is conservative: only the rectangle
+//   between its slanted top and bottom edges counts (half a tile height is
+//   trimmed at each end). Flat diamonds therefore never occlude. Blocks at
+//   least 1.5 tiles tall (walls, roof slabs) overlap their neighbours and
+//   merge into solid bands.
+//
+// Usage:
+//   LayeredTileMap map(64, 64);
+//   map.add_standard_layers();             // floor, furniture, walls, roof
+//   map.layer("walls")->tiles.at(3, 4).tile_id = 5;
+//   map.set_layer_visible("roof", false);  // Peek inside the cafe
+//   map.render(renderer, viewport);
+//
+// ============================================================================
+
+class LayeredTileMap {
+public:
+    // Per-frame statistics (from the last render / for_each_visible call)
+    struct Stats {
+        int candidates = 0;        // Non-empty visible tiles in visible layers
+        int drawn = 0;             // Tiles emitted
+        int culled = 0;            // Tiles skipped by occlusion culling
+        double pixels_drawn = 0;   // On-screen sprite area of drawn tiles
+        double overdraw = 0;       // pixels_drawn / viewport area
+    };
+
+    LayeredTileMap() = default;
+    LayeredTileMap(int width, int height);
+
+    // Resize every layer (clears existing data)
+    void resize(int width, int height);
+
+    int width() const { return width_; }
+    int height() const { return height_; }
+
+    // ========================================================================
+    // Layers
+    // ========================================================================
+
+    // Add a layer on top of the existing ones
+    TileLayer& add_layer(const std::string& name, int elevation = 0, bool opaque = false);
+
+    // Add floor, furniture, walls (opaque) and roof (opaque, elevation 2)
+    void add_standard_layers();
+
+    // Get layer (returns nullptr if not found)
+    TileLayer* layer(const std::string& name);
+    const TileLayer* layer(const std::string& name) const;
+    TileLayer* layer(int index);
+    const TileLayer* layer(int index) const;
+    int layer_count() const { return static_cast<int>(layers_.size()); }
+
+    // Render toggles
+    void set_layer_visible(const std::string& name, bool visible);
+    bool is_layer_visible(const std::string& name) const;
+
+    // ========================================================================
+    // Rendering
+    // ========================================================================
+
+    void set_tileset(SpriteSheet* tileset) { tileset_ = tileset; }
+    SpriteSheet* tileset() const { return tileset_; }
+
+    // Occlusion culling needs the tileset for sprite sizes
+    void set_occlusion_culling(bool enabled) { occlusion_culling_ = enabled; }
+    bool occlusion_culling() const { return occlusion_culling_; }
+
+    // Visit visible tiles back to front
+    // Callback receives: tile_x, tile_y, layer index, tile (height includes
+    // the layer elevation), screen_x, screen_y
+    using LayerTileCallback = std::function<void(int, int, int, const Tile&, float, float)>;
+    void for_each_visible(const Rect& viewport, const LayerTileCallback& callback) const;
+
+    void render(Renderer* renderer, const Rect& viewport) const;
+
+    const Stats& last_stats() const { return stats_; }
+
+private:
+    struct VisibleTile {
+        int x, y, layer;
+        float screen_x, screen_y;
+    };
+
+    void collect_unoccluded(const Rect& viewport) const;
+    Tile layer_tile(int layer, int x, int y) const;
+
+    int width_ = 0;
+    int height_ = 0;
+    std::vector<std::unique_ptr<TileLayer>> layers_;
+    SpriteSheet* tileset_ = nullptr;
+    bool occlusion_culling_ = true;
+
+    // Reused between frames to avoid per-frame allocation
+    mutable std::vector<VisibleTile> visible_;
+    mutable std::vector<float> cover_top_;
+    mutable std::vector<float> cover_bottom_;
+    mutable Stats stats_;
+};
+
+} // namespace cafe
+
+#endif // CAFE_TILE_LAYERS_H
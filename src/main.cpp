@@ -1,11 +1,15 @@
 #include "platform/platform.h"
 #include "renderer/renderer.h"
+#include "audio/audio.h"
 #include "engine/game_loop.h"
 #include "engine/image.h"
 #include "engine/sprite_sheet.h"
 #include "engine/isometric.h"
+#include "engine/profiler.h"
+#include "engine/render_stats.h"
 #include <iostream>
 #include <cmath>
+#include <cstdlib>
 
 // ============================================================================
 // Phase 3: Renderer Abstraction - Isometric Demo
@@ -18,7 +22,13 @@
 //
 // Controls:
 // - WASD or Arrow Keys: Pan the camera
+// - F3: Toggle the render stats overlay
 // - Escape: Close window
+//
+// CAFE_PROFILE=frame.cprof records profiler zones for the whole run and
+// saves them on exit (view with cafe_trace).
+// CAFE_RENDER_STATS_CSV=stats.csv writes RenderStats for every frame.
+// CAFE_AUDIO_WAV=out.wav records the audio mix (headless builds).
 // ============================================================================
 
 // Generate a simple isometric tileset (4 tile types)
@@ -171,6 +181,13 @@ int main() {
     }
     std::cout << "Renderer: " << renderer->backend_name() << "\n";
 
+    // Create audio (the demo runs on without it)
+    auto audio = cafe::create_audio_system();
+    bool audio_ok = audio->initialize();
+    if (!audio_ok) {
+        std::cerr << "Audio unavailable\n";
+    }
+
     // Set up orthographic projection (pixel coordinates, Y-down)
     float width = static_cast<float>(window->width());
     float height = static_cast<float>(window->height());
@@ -248,12 +265,21 @@ int main() {
     state.camera_y = world_center_y - height / 2.0f;
     cafe::Isometric::set_camera(state.camera_x, state.camera_y);
 
+    // Render statistics (overlay on F3, CSV on request)
+    cafe::RenderStatsMonitor render_stats;
+    if (const char* csv_path = std::getenv("CAFE_RENDER_STATS_CSV")) {
+        if (render_stats.open_csv(csv_path)) {
+            std::cout << "Render stats: " << csv_path << "\n";
+        }
+    }
+
     // Create game loop
     cafe::GameLoop loop(platform.get(), window.get());
     loop.set_target_fps(60);
 
     std::cout << "\nControls:\n";
     std::cout << "  WASD/Arrows: Pan camera\n";
+    std::cout << "  F3: Render stats overlay\n";
     std::cout << "  Escape: Quit\n\n";
 
     // Update callback
@@ -262,6 +288,12 @@ int main() {
             loop.stop();
             return;
         }
+        if (window->is_key_pressed(cafe::Key::F3)) {
+            render_stats.toggle();
+        }
+        if (audio_ok) {
+            audio->update();
+        }
 
         // Camera movement
         float move = state.camera_speed * dt;
@@ -280,6 +312,11 @@ int main() {
 
         // Update isometric camera
         cafe::Isometric::set_camera(state.camera_x, state.camera_y);
+
+        // Positional sounds are heard from the centre of the view
+        if (audio_ok) {
+            audio->set_listener(state.camera_x + width * 0.5f, state.camera_y + height * 0.5f);
+        }
     });
 
     // Render callback
@@ -330,22 +367,46 @@ int main() {
         }
         renderer->end_batch();
 
+        render_stats.draw(renderer.get());
+
         renderer->end_frame();
+        render_stats.record(renderer->stats());
     });
 
     // FPS callback
     loop.set_frame_callback([&](int fps, float) {
-        std::string title = "Cafe Engine - Isometric [" + std::to_string(fps) + " FPS]";
+        std::string title = "Cafe Engine - Isometric [" + std::to_string(fps) + " FPS | " +
+                            render_stats.summary() + "]";
         window->set_title(title);
     });
 
     // Run game loop
+#if CAFE_PROFILER
+    const char* profile_path = std::getenv("CAFE_PROFILE");
+    if (profile_path) {
+        cafe::Profiler::set_thread_name("main");
+        cafe::Profiler::set_enabled(true);
+    }
+#endif
+
     loop.run();
 
+#if CAFE_PROFILER
+    if (profile_path) {
+        cafe::Profiler::set_enabled(false);
+        cafe::ProfileCapture capture = cafe::Profiler::capture();
+        if (capture.save(profile_path)) {
+            std::cout << "\nProfile: " << profile_path << "\n";
+            capture.print_summary(std::cout);
+        }
+    }
+#endif
+
     // Cleanup
     tileset.unload(renderer.get());
     renderer->destroy_texture(char_tex);
     renderer->shutdown();
+    audio->shutdown();
 
     std::cout << "\nWindow closed. Goodbye!\n";
     return 0;
@@ -0,0 +1,147 @@
+#include "headless_platform.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <ctime>
+
+namespace cafe {
+
+// ============================================================================
+// Headless Window Implementation
+// ============================================================================
+
+HeadlessWindow::HeadlessWindow(const WindowConfig& config, HeadlessPlatform* platform)
+    : platform_(platform)
+    , title_(config.title)
+    , width_(config.width)
+    , height_(config.height)
+{
+    if (platform_) {
+        frame_limit_ = platform_->frame_limit_;
+        platform_->windows_.push_back(this);
+    }
+}
+
+HeadlessWindow::~HeadlessWindow() {
+    if (platform_) {
+        auto& windows = platform_->windows_;
+        windows.erase(std::remove(windows.begin(), windows.end(), this), windows.end());
+    }
+}
+
+void HeadlessWindow::set_key(Key key, bool down) {
+    int index = static_cast<int>(key);
+    if (index > 0 && index < kKeyCount) {
+        keys_down_[index] = down;
+    }
+}
+
+void HeadlessWindow::set_mouse_button(MouseButton button, bool down) {
+    int index = static_cast<int>(button);
+    if (index >= 0 && index < kMouseButtonCount) {
+        mouse_buttons_[index] = down;
+    }
+}
+
+void HeadlessWindow::set_mouse_position(float x, float y) {
+    mouse_x_ = x;
+    mouse_y_ = y;
+}
+
+void HeadlessWindow::set_size(int width, int height) {
+    width_ = width;
+    height_ = height;
+}
+
+bool HeadlessWindow::is_key_down(Key key) const {
+    int index = static_cast<int>(key);
+    if (index < 0 || index >= kKeyCount) return false;
+    return keys_down_[index];
+}
+
+bool HeadlessWindow::is_key_pressed(Key key) const {
+    int index = static_cast<int>(key);
+    if (index < 0 || index >= kKeyCount) return false;
+    return keys_down_[index] && !keys_down_prev_[index];
+}
+
+bool HeadlessWindow::is_key_released(Key key) const {
+    int index = static_cast<int>(key);
+    if (index < 0 || index >= kKeyCount) return false;
+    return !keys_down_[index] && keys_down_prev_[index];
+}
+
+bool HeadlessWindow::is_mouse_button_down(MouseButton button) const {
+    int index = static_cast<int>(button);
+    if (index < 0 || index >= kMouseButtonCount) return false;
+    return mouse_buttons_[index];
+}
+
+void HeadlessWindow::update_input() {
+    std::copy(std::begin(keys_down_), std::end(keys_down_), keys_down_prev_);
+}
+
+void HeadlessWindow::poll() {
+    if (!is_open_) return;
+    if (frame_limit_ > 0 && frame_ >= frame_limit_) {
+        is_open_ = false;
+        return;
+    }
+    if (script_) {
+        script_(*this, frame_);
+    }
+    ++frame_;
+}
+
+// ============================================================================
+// Headless Platform Implementation
+// ============================================================================
+
+HeadlessPlatform::HeadlessPlatform()
+    : start_time_(monotonic_seconds())
+{
+}
+
+std::unique_ptr<Window> HeadlessPlatform::create_window(const WindowConfig& config) {
+    return std::make_unique<HeadlessWindow>(config, this);
+}
+
+void HeadlessPlatform::poll_events() {
+    // No OS events: each window runs its script for the new frame
+    for (HeadlessWindow* window : windows_) {
+        window->poll();
+    }
+}
+
+double HeadlessPlatform::get_time() const {
+    return monotonic_seconds() - start_time_;
+}
+
+double HeadlessPlatform::monotonic_seconds() {
+#if defined(CLOCK_MONOTONIC)
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return static_cast<double>(now.tv_sec) + static_cast<double>(now.tv_nsec) * 1e-9;
+#else
+    auto now = std::chrono::steady_clock::now().time_since_epoch();
+    return std::chrono::duration<double>(now).count();
+#endif
+}
+
+// ============================================================================
+// Factory Function
+// ============================================================================
+
+#if !defined(__APPLE__) && !defined(__EMSCRIPTEN__)
+
+std::unique_ptr<Platform> create_platform() {
+    auto platform = std::make_unique<HeadlessPlatform>();
+    if (const char* frames = std::getenv("CAFE_HEADLESS_FRAMES")) {
+        platform->set_frame_limit(std::strtoull(frames, nullptr, 10));
+    }
+    return platform;
+}
+
+#endif
+
+} // namespace cafe
@@ -0,0 +1,131 @@
+#ifndef CAFE_HEADLESS_PLATFORM_H
+#define CAFE_HEADLESS_PLATFORM_H
+
+#include "../platform.h"
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace cafe {
+
+// ============================================================================
+// Headless Platform - No display, no OS input (servers, CI, benchmarks)
+// ============================================================================
+//
+// A window here is only a size and an input state. Input comes from
+// code: set it directly, or give the window a script that runs every
+// poll_events() with the frame number. Time is the monotonic clock
+// (clock_gettime(CLOCK_MONOTONIC)), so it never jumps with NTP or DST.
+//
+// create_platform() returns a HeadlessPlatform on builds with no native
+// platform (Linux). Environment:
+//
+//   CAFE_HEADLESS_FRAMES=N   close windows after N frames (0 = never)
+//
+// Usage:
+//   HeadlessPlatform platform;
+//   platform.set_frame_limit(600);
+//   auto window = platform.create_window(config);
+//   auto* headless = static_cast<HeadlessWindow*>(window.get());
+//   headless->set_input_script([](HeadlessWindow& w, uint64_t frame) {
+//       w.set_key(Key::D, frame % 120 < 60);   // Walk right, pause, ...
+//   });
+//
+// The platform must outlive its windows.
+//
+// ============================================================================
+
+class HeadlessPlatform;
+
+class HeadlessWindow : public Window {
+public:
+    // Runs at the start of every frame, before the game reads input
+    using InputScript = std::function<void(HeadlessWindow& window, uint64_t frame)>;
+
+    HeadlessWindow(const WindowConfig& config, HeadlessPlatform* platform);
+    ~HeadlessWindow() override;
+
+    HeadlessWindow(const HeadlessWindow&) = delete;
+    HeadlessWindow& operator=(const HeadlessWindow&) = delete;
+
+    // Scripted input
+    void set_input_script(InputScript script) { script_ = std::move(script); }
+    void set_key(Key key, bool down);
+    void set_mouse_button(MouseButton button, bool down);
+    void set_mouse_position(float x, float y);
+    void set_size(int width, int height);
+
+    // Close after this many frames (0 = never)
+    void set_frame_limit(uint64_t frames) { frame_limit_ = frames; }
+    uint64_t frame() const { return frame_; }
+    const std::string& title() const { return title_; }
+
+    // Window
+    bool is_open() const override { return is_open_; }
+    void close() override { is_open_ = false; }
+    int width() const override { return width_; }
+    int height() const override { return height_; }
+    float scale_factor() const override { return 1.0f; }
+    void set_title(const std::string& title) override { title_ = title; }
+    void* native_handle() override { return nullptr; }
+
+    bool is_key_down(Key key) const override;
+    bool is_key_pressed(Key key) const override;
+    bool is_key_released(Key key) const override;
+    bool is_mouse_button_down(MouseButton button) const override;
+    float mouse_x() const override { return mouse_x_; }
+    float mouse_y() const override { return mouse_y_; }
+
+    void update_input() override;
+
+private:
+    friend class HeadlessPlatform;
+
+    // One frame: count it, run the script, close at the limit
+    void poll();
+
+    static constexpr int kKeyCount = static_cast<int>(Key::KeyCount);
+    static constexpr int kMouseButtonCount = static_cast<int>(MouseButton::ButtonCount);
+
+    HeadlessPlatform* platform_;
+    InputScript script_;
+    std::string title_;
+    int width_;
+    int height_;
+    bool is_open_ = true;
+    uint64_t frame_ = 0;
+    uint64_t frame_limit_ = 0;
+
+    bool keys_down_[kKeyCount] = {};
+    bool keys_down_prev_[kKeyCount] = {};
+    bool mouse_buttons_[kMouseButtonCount] = {};
+    float mouse_x_ = 0.0f;
+    float mouse_y_ = 0.0f;
+};
+
+class HeadlessPlatform : public Platform {
+public:
+    HeadlessPlatform();
+    ~HeadlessPlatform() override = default;
+
+    // Frame limit given to windows created from now on (0 = never close)
+    void set_frame_limit(uint64_t frames) { frame_limit_ = frames; }
+
+    std::unique_ptr<Window> create_window(const WindowConfig& config) override;
+    void poll_events() override;
+    double get_time() const override;
+    const char* name() const override { return "Headless"; }
+
+private:
+    friend class HeadlessWindow;
+
+    static double monotonic_seconds();
+
+    std::vector<HeadlessWindow*> windows_;   // Live windows (they unregister)
+    double start_time_;
+    uint64_t frame_limit_ = 0;
+};
+
+} // namespace cafe
+
+#endif // CAFE_HEADLESS_PLATFORM_H
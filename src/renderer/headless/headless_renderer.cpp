@@ -0,0 +1,167 @@
+#include "../renderer.h"
+#include <unordered_map>
+
+namespace cafe {
+
+// ============================================================================
+// Headless Renderer (no GPU)
+// ============================================================================
+//
+// The backend for the headless platform. It keeps what the rest of the
+// engine can observe - texture handles and their TextureInfo - and
+// draws nothing, so game code runs unchanged on a server or in CI and
+// the CPU side of a frame (culling, batching, animation) can be profiled
+// on its own.
+//
+// Sprite batches follow the Metal and WebGL rules (a new batch per
+// texture change or per 1000 quads), so RenderStats counts the draw
+// calls a GPU backend would make: a CI run can catch a layout change
+// that doubles them.
+
+class HeadlessRenderer : public Renderer {
+public:
+    bool initialize(Window*) override { return true; }
+    void shutdown() override { textures_.clear(); }
+
+    void begin_frame() override {
+        begin_frame_stats();
+        bound_texture_ = INVALID_TEXTURE;
+    }
+    void end_frame() override {
+        flush_batch();
+        end_frame_stats();
+    }
+
+    void set_clear_color(const Color&) override {}
+    void clear() override {}
+
+    void set_viewport(int, int, int, int) override {}
+    void set_projection(float, float, float, float) override {}
+
+    TextureHandle create_texture(const uint8_t* pixels, const TextureInfo& info) override {
+        if (!pixels || info.width <= 0 || info.height <= 0) {
+            return INVALID_TEXTURE;
+        }
+        TextureInfo stored = info;
+        stored.mip_count = 1;
+        TextureHandle handle = next_texture_++;
+        textures_[handle] = stored;
+        count_upload(stored);
+        return handle;
+    }
+
+    TextureHandle create_texture_mipmapped(const uint8_t* const* levels,
+                                           const TextureInfo& info) override {
+        if (!levels || !levels[0] || info.width <= 0 || info.height <= 0) {
+            return INVALID_TEXTURE;
+        }
+        TextureHandle handle = next_texture_++;
+        textures_[handle] = info;
+        count_upload(info);
+        return handle;
+    }
+
+    bool update_texture(TextureHandle texture, const uint8_t* const* levels,
+                        const TextureInfo& info) override {
+        auto it = textures_.find(texture);
+        if (it == textures_.end() || !levels || !levels[0] || info.width <= 0 || info.height <= 0) {
+            return false;
+        }
+        it->second = info;
+        count_upload(info);
+        return true;
+    }
+
+    void destroy_texture(TextureHandle texture) override { textures_.erase(texture); }
+
+    TextureInfo get_texture_info(TextureHandle texture) const override {
+        auto it = textures_.find(texture);
+        return it != textures_.end() ? it->second : TextureInfo();
+    }
+
+    void draw_quad(Vec2, Vec2, const Color&) override {
+        stats_.draw_calls++;
+        stats_.vertices += 6;
+    }
+    void draw_textured_quad(Vec2, Vec2, const TextureRegion& region, const Color&) override {
+        if (textures_.count(region.texture) == 0) return;
+        bind(region.texture);
+        stats_.draw_calls++;
+        stats_.vertices += 6;
+    }
+
+    void begin_batch() override {
+        batch_vertices_ = 0;
+        batch_texture_ = INVALID_TEXTURE;
+        batching_ = true;
+    }
+
+    void draw_sprite(const Sprite& sprite) override {
+        if (!batching_) return;
+
+        if (batch_texture_ != sprite.region.texture) {
+            if (batch_vertices_ > 0) {
+                stats_.texture_flushes++;
+                flush_batch();
+            }
+            batch_texture_ = sprite.region.texture;
+        }
+        if (batch_vertices_ + 6 > MAX_BATCH_VERTICES) {
+            stats_.full_flushes++;
+            flush_batch();
+        }
+        batch_vertices_ += 6;
+        stats_.sprites++;
+    }
+
+    void end_batch() override {
+        flush_batch();
+        batching_ = false;
+    }
+
+    const char* backend_name() const override { return "Headless"; }
+    int max_texture_size() const override { return 16384; }
+
+private:
+    static constexpr uint32_t MAX_BATCH_VERTICES = 6 * 1000;  // As Metal and WebGL
+
+    void bind(TextureHandle texture) {
+        if (texture != bound_texture_) {
+            bound_texture_ = texture;
+            stats_.texture_binds++;
+        }
+    }
+
+    void flush_batch() {
+        if (batch_vertices_ == 0) return;
+        if (textures_.count(batch_texture_) > 0) {
+            bind(batch_texture_);
+        }
+        stats_.draw_calls++;
+        stats_.batch_flushes++;
+        stats_.vertices += batch_vertices_;
+        batch_vertices_ = 0;
+    }
+
+    std::unordered_map<TextureHandle, TextureInfo> textures_;
+    TextureHandle next_texture_ = 1;
+
+    uint32_t batch_vertices_ = 0;
+    TextureHandle batch_texture_ = INVALID_TEXTURE;
+    TextureHandle bound_texture_ = INVALID_TEXTURE;
+    bool batching_ = false;
+};
+
+// ============================================================================
+// Factory Function
+// ============================================================================
+
+#if !defined(__APPLE__) && !defined(__EMSCRIPTEN__)
+
+std::unique_ptr<Renderer> create_renderer() {
+    return std::make_unique<HeadlessRenderer>();
+}
+
+#endif
+
+} // namespace cafe
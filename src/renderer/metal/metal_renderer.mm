@@ -4,6 +4,9 @@
 
 #include "../renderer.h"
 #include "../../platform/platform.h"
+#include "../../engine/profiler.h"
+#include <atomic>
+#include <memory>
 #include <vector>
 #include <unordered_map>
 #include <cmath>
@@ -79,6 +82,7 @@ namespace cafe {
 
 struct TextureData {
     id<MTLTexture> texture;
+    id<MTLSamplerState> sampler;
     TextureInfo info;
 };
 
@@ -98,8 +102,8 @@ private:
     id<MTLRenderPipelineState> textured_pipeline_ = nil;   // For textured quads
     id<MTLBuffer> vertex_buffer_ = nil;
     id<MTLBuffer> uniform_buffer_ = nil;
-    id<MTLSamplerState> sampler_nearest_ = nil;
-    id<MTLSamplerState> sampler_linear_ = nil;
+    // [TextureFilter][0 = no mips, 1 = nearest mip, 2 = linear mip]
+    id<MTLSamplerState> samplers_[2][3] = {};
 
     // Batch rendering
     static constexpr size_t MAX_BATCH_VERTICES = 6 * 1000;  // 1000 quads
@@ -118,6 +122,11 @@ private:
     __strong id<MTLRenderCommandEncoder> current_encoder_ = nil;
     bool frame_valid_ = false;
 
+    // GPU time of the newest completed command buffer, written by Metal's
+    // completion handler thread; shared so an in-flight handler never
+    // outlives it
+    std::shared_ptr<std::atomic<double>> gpu_ms_ = std::make_shared<std::atomic<double>>(-1.0);
+
     // Settings
     Color clear_color_ = Color::cornflower_blue();
     Uniforms uniforms_;
@@ -258,17 +267,24 @@ public:
                 return false;
             }
 
-            // Create samplers
+            // Create samplers (one per filter / mip filter combination)
             MTLSamplerDescriptor* sampler_desc = [[MTLSamplerDescriptor alloc] init];
-            sampler_desc.minFilter = MTLSamplerMinMagFilterNearest;
-            sampler_desc.magFilter = MTLSamplerMinMagFilterNearest;
             sampler_desc.sAddressMode = MTLSamplerAddressModeClampToEdge;
             sampler_desc.tAddressMode = MTLSamplerAddressModeClampToEdge;
-            sampler_nearest_ = [device_ newSamplerStateWithDescriptor:sampler_desc];
-
-            sampler_desc.minFilter = MTLSamplerMinMagFilterLinear;
-            sampler_desc.magFilter = MTLSamplerMinMagFilterLinear;
-            sampler_linear_ = [device_ newSamplerStateWithDescriptor:sampler_desc];
+            const MTLSamplerMinMagFilter filters[2] = {
+                MTLSamplerMinMagFilterNearest, MTLSamplerMinMagFilterLinear
+            };
+            const MTLSamplerMipFilter mip_filters[3] = {
+                MTLSamplerMipFilterNotMipmapped, MTLSamplerMipFilterNearest, MTLSamplerMipFilterLinear
+            };
+            for (int f = 0; f < 2; ++f) {
+                for (int m = 0; m < 3; ++m) {
+                    sampler_desc.minFilter = filters[f];
+                    sampler_desc.magFilter = filters[f];
+                    sampler_desc.mipFilter = mip_filters[m];
+                    samplers_[f][m] = [device_ newSamplerStateWithDescriptor:sampler_desc];
+                }
+            }
 
             // Set default viewport/projection
             viewport_width_ = window->width();
@@ -294,8 +310,11 @@ public:
             uniform_buffer_ = nil;
             color_pipeline_ = nil;
             textured_pipeline_ = nil;
-            sampler_nearest_ = nil;
-            sampler_linear_ = nil;
+            for (auto& row : samplers_) {
+                for (auto& sampler : row) {
+                    sampler = nil;
+                }
+            }
             command_queue_ = nil;
             device_ = nil;
             metal_layer_ = nil;
@@ -303,6 +322,8 @@ public:
     }
 
     void begin_frame() override {
+        begin_frame_stats();
+        stats_.gpu_ms = gpu_ms_->load(std::memory_order_relaxed);
         frame_valid_ = false;
         current_texture_ = nil;
         current_encoder_ = nil;
@@ -337,6 +358,7 @@ public:
         if (batching_) {
             flush_batch();
         }
+        end_frame_stats();
 
         id<CAMetalDrawable> drawable = current_drawable_;
         id<MTLCommandBuffer> cmd_buffer = current_command_buffer_;
@@ -356,6 +378,14 @@ public:
             return;
         }
 
+        // GPUStartTime/GPUEndTime are only valid once the buffer completed
+        std::shared_ptr<std::atomic<double>> gpu_ms = gpu_ms_;
+        [cmd_buffer addCompletedHandler:^(id<MTLCommandBuffer> cb) {
+            if (cb.status == MTLCommandBufferStatusCompleted) {
+                gpu_ms->store((cb.GPUEndTime - cb.GPUStartTime) * 1000.0, std::memory_order_relaxed);
+            }
+        }];
+
         [cmd_buffer presentDrawable:drawable];
         [cmd_buffer commit];
     }
@@ -409,29 +439,34 @@ public:
     }
 
     TextureHandle create_texture(const uint8_t* pixels, const TextureInfo& info) override {
-        if (!device_ || !pixels || info.width <= 0 || info.height <= 0) {
+        TextureInfo base = info;
+        base.mip_count = 1;
+        return create_texture_mipmapped(&pixels, base);
+    }
+
+    TextureHandle create_texture_mipmapped(const uint8_t* const* levels,
+                                           const TextureInfo& info) override {
+        TextureData data;
+        if (!make_texture(levels, info, data)) {
             return INVALID_TEXTURE;
         }
+        count_upload(info);
+        TextureHandle handle = next_texture_id_++;
+        textures_[handle] = data;
+        return handle;
+    }
 
-        @autoreleasepool {
-            MTLTextureDescriptor* desc = [[MTLTextureDescriptor alloc] init];
-            desc.pixelFormat = MTLPixelFormatRGBA8Unorm;
-            desc.width = info.width;
-            desc.height = info.height;
-            desc.usage = MTLTextureUsageShaderRead;
-
-            id<MTLTexture> tex = [device_ newTextureWithDescriptor:desc];
-            if (!tex) {
-                return INVALID_TEXTURE;
-            }
-
-            MTLRegion region = MTLRegionMake2D(0, 0, info.width, info.height);
-            [tex replaceRegion:region mipmapLevel:0 withBytes:pixels bytesPerRow:info.width * 4];
-
-            TextureHandle handle = next_texture_id_++;
-            textures_[handle] = {tex, info};
-            return handle;
+    bool update_texture(TextureHandle texture, const uint8_t* const* levels,
+                        const TextureInfo& info) override {
+        auto it = textures_.find(texture);
+        TextureData data;
+        if (it == textures_.end() || !make_texture(levels, info, data)) {
+            return false;
         }
+        count_upload(info);
+        // Command buffers still in flight keep the old texture alive
+        it->second = data;
+        return true;
     }
 
     void destroy_texture(TextureHandle texture) override {
@@ -472,6 +507,8 @@ public:
         [encoder setVertexBuffer:vertex_buffer_ offset:0 atIndex:0];
         [encoder setVertexBuffer:uniform_buffer_ offset:0 atIndex:1];
         [encoder drawPrimitives:MTLPrimitiveTypeTriangle vertexStart:0 vertexCount:6];
+        stats_.draw_calls++;
+        stats_.vertices += 6;
     }
 
     void draw_textured_quad(Vec2 position, Vec2 size,
@@ -503,8 +540,11 @@ public:
         [encoder setVertexBuffer:vertex_buffer_ offset:0 atIndex:0];
         [encoder setVertexBuffer:uniform_buffer_ offset:0 atIndex:1];
         [encoder setFragmentTexture:it->second.texture atIndex:0];
-        [encoder setFragmentSamplerState:sampler_nearest_ atIndex:0];
+        [encoder setFragmentSamplerState:it->second.sampler atIndex:0];
         [encoder drawPrimitives:MTLPrimitiveTypeTriangle vertexStart:0 vertexCount:6];
+        stats_.texture_binds++;
+        stats_.draw_calls++;
+        stats_.vertices += 6;
     }
 
     void begin_batch() override {
@@ -519,14 +559,17 @@ public:
         // Flush if texture changes or batch is full
         if (current_batch_texture_ != sprite.region.texture) {
             if (!batch_vertices_.empty()) {
+                stats_.texture_flushes++;
                 flush_batch();
             }
             current_batch_texture_ = sprite.region.texture;
         }
 
         if (batch_vertices_.size() + 6 > MAX_BATCH_VERTICES) {
+            stats_.full_flushes++;
             flush_batch();
         }
+        stats_.sprites++;
 
         // Calculate corners with rotation around center
         float cx = sprite.position.x;
@@ -567,6 +610,8 @@ public:
         return "Metal";
     }
 
+    bool supports_gpu_timing() const override { return true; }
+
     int max_texture_size() const override {
         if (!device_) return 0;
         // Most modern Apple GPUs support at least 16384
@@ -574,8 +619,43 @@ public:
     }
 
 private:
+    // New MTLTexture with every level uploaded, plus the sampler it needs
+    bool make_texture(const uint8_t* const* levels, const TextureInfo& info, TextureData& out) {
+        if (!device_ || !levels || !levels[0] || info.width <= 0 || info.height <= 0 ||
+            info.mip_count < 1 || info.mip_count > max_mip_count(info.width, info.height)) {
+            return false;
+        }
+
+        @autoreleasepool {
+            MTLTextureDescriptor* desc = [[MTLTextureDescriptor alloc] init];
+            desc.pixelFormat = MTLPixelFormatRGBA8Unorm;
+            desc.width = info.width;
+            desc.height = info.height;
+            desc.mipmapLevelCount = info.mip_count;
+            desc.usage = MTLTextureUsageShaderRead;
+
+            id<MTLTexture> tex = [device_ newTextureWithDescriptor:desc];
+            if (!tex) {
+                return false;
+            }
+
+            for (int level = 0; level < info.mip_count; ++level) {
+                int w = mip_size(info.width, level);
+                int h = mip_size(info.height, level);
+                MTLRegion region = MTLRegionMake2D(0, 0, w, h);
+                [tex replaceRegion:region mipmapLevel:level withBytes:levels[level] bytesPerRow:w * 4];
+            }
+
+            int filter = info.filter == TextureFilter::Linear ? 1 : 0;
+            int mip = info.mip_count == 1 ? 0 : (info.mip_filter == MipFilter::Linear ? 2 : 1);
+            out = {tex, samplers_[filter][mip], info};
+            return true;
+        }
+    }
+
     void flush_batch() {
         if (batch_vertices_.empty()) return;
+        CAFE_PROFILE_SCOPE("Renderer::flush_batch");
 
         id<MTLRenderCommandEncoder> encoder = current_encoder_;
         if (!frame_valid_ || !encoder || !vertex_buffer_) {
@@ -591,7 +671,8 @@ private:
         if (it != textures_.end()) {
             [encoder setRenderPipelineState:textured_pipeline_];
             [encoder setFragmentTexture:it->second.texture atIndex:0];
-            [encoder setFragmentSamplerState:sampler_nearest_ atIndex:0];
+            [encoder setFragmentSamplerState:it->second.sampler atIndex:0];
+            stats_.texture_binds++;
         } else {
             [encoder setRenderPipelineState:color_pipeline_];
         }
@@ -601,6 +682,9 @@ private:
         [encoder drawPrimitives:MTLPrimitiveTypeTriangle
                     vertexStart:0
                     vertexCount:batch_vertices_.size()];
+        stats_.draw_calls++;
+        stats_.batch_flushes++;
+        stats_.vertices += static_cast<uint32_t>(batch_vertices_.size());
 
         batch_vertices_.clear();
     }
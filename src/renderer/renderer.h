@@ -1,6 +1,7 @@
 #ifndef CAFE_RENDERER_H
 #define CAFE_RENDERER_H
 
+#include <chrono>
 #include <memory>
 #include <string>
 #include <cstdint>
@@ -67,6 +68,12 @@ enum class TextureFilter {
     Linear    // Smooth (good for photos)
 };
 
+// How a minified texture picks between mip levels (mip_count > 1 only)
+enum class MipFilter {
+    Nearest,  // Closest level, filtered with TextureFilter (crisp pixel art)
+    Linear    // Blend the two closest levels (with Linear: trilinear)
+};
+
 // Texture wrap mode
 enum class TextureWrap {
     Clamp,    // Clamp to edge
@@ -79,8 +86,25 @@ struct TextureInfo {
     int height = 0;
     TextureFilter filter = TextureFilter::Nearest;
     TextureWrap wrap = TextureWrap::Clamp;
+    int mip_count = 1;        // Levels, each half the previous size (min 1)
+    MipFilter mip_filter = MipFilter::Nearest;
 };
 
+// Full mip chain size: max(floor(log2(max(width, height))) + 1, 1)
+inline int max_mip_count(int width, int height) {
+    int count = 1;
+    for (int size = width > height ? width : height; size > 1; size /= 2) {
+        ++count;
+    }
+    return count;
+}
+
+// Size of mip level `level` along one axis
+inline int mip_size(int size, int level) {
+    size >>= level;
+    return size > 0 ? size : 1;
+}
+
 // Region within a texture (for sprite sheets)
 // UV coordinates: (0,0) = top-left, (1,1) = bottom-right
 struct TextureRegion {
@@ -117,6 +141,40 @@ struct Sprite {
     Vec2 origin = {0.5f, 0.5f};  // Origin point (0-1, relative to size)
 };
 
+// ============================================================================
+// Render Statistics
+// ============================================================================
+//
+// What one frame cost the renderer. Every backend counts the same events,
+// so a number that jumps between two builds or two cafe layouts points at
+// the cause:
+//
+//   draw_calls      every draw submitted to the GPU (batches + immediate quads)
+//   batch_flushes   sprite batches drawn, split by why they ended:
+//     texture_flushes  the next sprite used another texture (atlas misses)
+//     full_flushes     the vertex buffer was full
+//   texture_binds   texture changes on the GPU
+//   upload_bytes    texture data sent to the GPU (create/update_texture)
+//
+// GPU time comes from timer queries where the backend has them and
+// arrives a few frames late (the GPU runs behind the CPU); gpu_ms is -1
+// when unavailable.
+
+struct RenderStats {
+    uint64_t frame = 0;             // Frames begun so far
+    uint32_t draw_calls = 0;
+    uint32_t batch_flushes = 0;
+    uint32_t texture_flushes = 0;
+    uint32_t full_flushes = 0;
+    uint32_t sprites = 0;
+    uint32_t vertices = 0;
+    uint32_t texture_binds = 0;
+    uint32_t texture_uploads = 0;
+    uint64_t upload_bytes = 0;
+    double cpu_ms = 0.0;            // begin_frame() to end_frame()
+    double gpu_ms = -1.0;           // Newest finished GPU frame
+};
+
 // ============================================================================
 // Abstract Renderer Interface
 // ============================================================================
@@ -143,7 +201,27 @@ public:
     virtual void set_projection(float left, float right, float bottom, float top) = 0;
 
     // Texture management
+    // create_texture() uploads one level (info.mip_count is treated as 1)
     virtual TextureHandle create_texture(const uint8_t* pixels, const TextureInfo& info) = 0;
+
+    // Upload info.mip_count levels: levels[i] holds mip i, RGBA8,
+    // mip_size(width, i) x mip_size(height, i). Backends without mipmap
+    // support keep the default, which uploads level 0 only.
+    virtual TextureHandle create_texture_mipmapped(const uint8_t* const* levels,
+                                                   const TextureInfo& info) {
+        TextureInfo base = info;
+        base.mip_count = 1;
+        return create_texture(levels ? levels[0] : nullptr, base);
+    }
+
+    // Replace a texture's pixels (size and mip count may change); the
+    // handle stays the same, so everything drawing with it sees the new
+    // image. Returns false if the backend cannot, in which case the caller
+    // creates a new texture instead.
+    virtual bool update_texture(TextureHandle /*texture*/, const uint8_t* const* /*levels*/,
+                                const TextureInfo& /*info*/) {
+        return false;
+    }
     virtual void destroy_texture(TextureHandle texture) = 0;
     virtual TextureInfo get_texture_info(TextureHandle texture) const = 0;
 
@@ -161,6 +239,58 @@ public:
     // Info
     virtual const char* backend_name() const = 0;
     virtual int max_texture_size() const = 0;
+
+    // Statistics: stats() is the last completed frame, frame_stats() the
+    // frame in progress (reset by begin_frame)
+    const RenderStats& stats() const { return last_stats_; }
+    const RenderStats& frame_stats() const { return stats_; }
+    virtual bool supports_gpu_timing() const { return false; }
+
+protected:
+    // Backends call these from begin_frame() / end_frame()
+    void begin_frame_stats() {
+        uint64_t frame = stats_.frame + 1;
+        double gpu_ms = stats_.gpu_ms;
+        stats_ = RenderStats();
+        stats_.frame = frame;
+        stats_.gpu_ms = gpu_ms;
+        stats_.texture_uploads = pending_uploads_;
+        stats_.upload_bytes = pending_upload_bytes_;
+        pending_uploads_ = 0;
+        pending_upload_bytes_ = 0;
+        in_frame_ = true;
+        frame_start_ = std::chrono::steady_clock::now();
+    }
+    void end_frame_stats() {
+        stats_.cpu_ms = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - frame_start_).count();
+        last_stats_ = stats_;
+        in_frame_ = false;
+    }
+
+    // Uploads between frames (loading) count toward the next frame
+    void count_upload(const TextureInfo& info) {
+        uint64_t bytes = 0;
+        for (int level = 0; level < info.mip_count; ++level) {
+            bytes += static_cast<uint64_t>(mip_size(info.width, level)) * mip_size(info.height, level) * 4;
+        }
+        if (in_frame_) {
+            stats_.texture_uploads++;
+            stats_.upload_bytes += bytes;
+        } else {
+            pending_uploads_++;
+            pending_upload_bytes_ += bytes;
+        }
+    }
+
+    RenderStats stats_;
+    RenderStats last_stats_;
+
+private:
+    std::chrono::steady_clock::time_point frame_start_;
+    bool in_frame_ = false;
+    uint32_t pending_uploads_ = 0;
+    uint64_t pending_upload_bytes_ = 0;
 };
 
 // Factory function - implemented per platform
@@ -2,16 +2,26 @@
 
 #include "../renderer.h"
 #include "../../platform/platform.h"
+#include "../../engine/profiler.h"
 
 #include <emscripten.h>
 #include <emscripten/html5.h>
 #include <GLES3/gl3.h>
 
+#include <array>
 #include <vector>
 #include <unordered_map>
 #include <cmath>
 #include <cstring>
 
+// EXT_disjoint_timer_query_webgl2 enums (GLES2/gl2ext.h)
+#ifndef GL_TIME_ELAPSED_EXT
+#define GL_TIME_ELAPSED_EXT 0x88BF
+#endif
+#ifndef GL_GPU_DISJOINT_EXT
+#define GL_GPU_DISJOINT_EXT 0x8FBB
+#endif
+
 // ============================================================================
 // WebGL Shaders (GLSL ES 3.0)
 // ============================================================================
@@ -111,7 +121,17 @@ private:
     std::unordered_map<TextureHandle, TextureData> textures_;
     TextureHandle next_texture_id_ = 1;
 
+    // GPU frame timing (EXT_disjoint_timer_query_webgl2): a small ring of
+    // queries, read back a few frames later without stalling
+    static constexpr int GPU_QUERIES = 4;
+    bool gpu_timer_ = false;
+    std::array<GLuint, GPU_QUERIES> gpu_queries_{};
+    std::array<bool, GPU_QUERIES> gpu_pending_{};
+    int gpu_query_index_ = 0;
+    bool gpu_query_active_ = false;
+
     // State
+    GLuint bound_texture_ = 0;
     Color clear_color_ = Color::cornflower_blue();
     float projection_[16];
     int viewport_width_ = 0;
@@ -235,6 +255,12 @@ public:
 
         set_projection(-1.0f, 1.0f, -1.0f, 1.0f);
 
+        // Optional: browsers may hide it (timing attacks) or not have it
+        gpu_timer_ = emscripten_webgl_enable_extension(gl_context_, "EXT_disjoint_timer_query_webgl2");
+        if (gpu_timer_) {
+            glGenQueries(GPU_QUERIES, gpu_queries_.data());
+        }
+
         emscripten_log(EM_LOG_CONSOLE, "WebGL2 initialized");
         return true;
     }
@@ -245,6 +271,10 @@ public:
         }
         textures_.clear();
 
+        if (gpu_timer_) {
+            glDeleteQueries(GPU_QUERIES, gpu_queries_.data());
+            gpu_timer_ = false;
+        }
         if (vbo_) glDeleteBuffers(1, &vbo_);
         if (vao_) glDeleteVertexArrays(1, &vao_);
         if (color_program_) glDeleteProgram(color_program_);
@@ -257,17 +287,36 @@ public:
     }
 
     void begin_frame() override {
+        begin_frame_stats();
         emscripten_webgl_make_context_current(gl_context_);
         glViewport(0, 0, viewport_width_, viewport_height_);
+
+        if (gpu_timer_) {
+            read_gpu_timers();
+            GLuint query = gpu_queries_[gpu_query_index_];
+            if (!gpu_pending_[gpu_query_index_]) {
+                glBeginQuery(GL_TIME_ELAPSED_EXT, query);
+                gpu_query_active_ = true;
+            }
+        }
     }
 
     void end_frame() override {
         if (batching_) {
             flush_batch();
         }
+        if (gpu_query_active_) {
+            glEndQuery(GL_TIME_ELAPSED_EXT);
+            gpu_pending_[gpu_query_index_] = true;
+            gpu_query_index_ = (gpu_query_index_ + 1) % GPU_QUERIES;
+            gpu_query_active_ = false;
+        }
+        end_frame_stats();
         // WebGL auto-presents
     }
 
+    bool supports_gpu_timing() const override { return gpu_timer_; }
+
     void set_clear_color(const Color& color) override {
         clear_color_ = color;
     }
@@ -296,33 +345,46 @@ public:
     }
 
     TextureHandle create_texture(const uint8_t* pixels, const TextureInfo& info) override {
-        if (!pixels || info.width <= 0 || info.height <= 0) {
+        TextureInfo base = info;
+        base.mip_count = 1;
+        return create_texture_mipmapped(&pixels, base);
+    }
+
+    TextureHandle create_texture_mipmapped(const uint8_t* const* levels,
+                                           const TextureInfo& info) override {
+        if (!levels || !levels[0] || info.width <= 0 || info.height <= 0 ||
+            info.mip_count < 1 || info.mip_count > max_mip_count(info.width, info.height)) {
             return INVALID_TEXTURE;
         }
 
         GLuint tex;
         glGenTextures(1, &tex);
-        glBindTexture(GL_TEXTURE_2D, tex);
-
-        GLenum filter = (info.filter == TextureFilter::Nearest) ? GL_NEAREST : GL_LINEAR;
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
-
-        GLenum wrap = (info.wrap == TextureWrap::Repeat) ? GL_REPEAT : GL_CLAMP_TO_EDGE;
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, wrap);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, wrap);
-
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, info.width, info.height, 0,
-                     GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+        upload_levels(tex, levels, info);
+        count_upload(info);
 
         TextureHandle handle = next_texture_id_++;
         textures_[handle] = {tex, info};
         return handle;
     }
 
+    bool update_texture(TextureHandle texture, const uint8_t* const* levels,
+                        const TextureInfo& info) override {
+        auto it = textures_.find(texture);
+        if (it == textures_.end() || !levels || !levels[0] || info.width <= 0 || info.height <= 0 ||
+            info.mip_count < 1 || info.mip_count > max_mip_count(info.width, info.height)) {
+            return false;
+        }
+        // Respecifying every level replaces the texture under the same GL name
+        upload_levels(it->second.texture, levels, info);
+        count_upload(info);
+        it->second.info = info;
+        return true;
+    }
+
     void destroy_texture(TextureHandle texture) override {
         auto it = textures_.find(texture);
         if (it != textures_.end()) {
+            if (bound_texture_ == it->second.texture) bound_texture_ = 0;
             glDeleteTextures(1, &it->second.texture);
             textures_.erase(it);
         }
@@ -358,6 +420,8 @@ public:
         glUseProgram(color_program_);
         glUniformMatrix4fv(color_proj_loc_, 1, GL_FALSE, projection_);
         glDrawArrays(GL_TRIANGLES, 0, 6);
+        stats_.draw_calls++;
+        stats_.vertices += 6;
     }
 
     void draw_textured_quad(Vec2 position, Vec2 size,
@@ -387,9 +451,11 @@ public:
         glUseProgram(textured_program_);
         glUniformMatrix4fv(textured_proj_loc_, 1, GL_FALSE, projection_);
         glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, it->second.texture);
+        bind_texture(it->second.texture);
         glUniform1i(textured_sampler_loc_, 0);
         glDrawArrays(GL_TRIANGLES, 0, 6);
+        stats_.draw_calls++;
+        stats_.vertices += 6;
     }
 
     void begin_batch() override {
@@ -403,14 +469,17 @@ public:
 
         if (current_batch_texture_ != sprite.region.texture) {
             if (!batch_vertices_.empty()) {
+                stats_.texture_flushes++;
                 flush_batch();
             }
             current_batch_texture_ = sprite.region.texture;
         }
 
         if (batch_vertices_.size() + 6 > MAX_BATCH_VERTICES) {
+            stats_.full_flushes++;
             flush_batch();
         }
+        stats_.sprites++;
 
         float cx = sprite.position.x;
         float cy = sprite.position.y;
@@ -457,8 +526,39 @@ public:
     }
 
 private:
+    // Set the sampling state and (re)specify every level of `tex`
+    void upload_levels(GLuint tex, const uint8_t* const* levels, const TextureInfo& info) {
+        glBindTexture(GL_TEXTURE_2D, tex);
+        bound_texture_ = tex;
+
+        GLenum filter = (info.filter == TextureFilter::Nearest) ? GL_NEAREST : GL_LINEAR;
+        GLenum min_filter = filter;
+        if (info.mip_count > 1) {
+            bool linear_mip = info.mip_filter == MipFilter::Linear;
+            if (info.filter == TextureFilter::Nearest) {
+                min_filter = linear_mip ? GL_NEAREST_MIPMAP_LINEAR : GL_NEAREST_MIPMAP_NEAREST;
+            } else {
+                min_filter = linear_mip ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR_MIPMAP_NEAREST;
+            }
+        }
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, min_filter);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, info.mip_count - 1);
+
+        GLenum wrap = (info.wrap == TextureWrap::Repeat) ? GL_REPEAT : GL_CLAMP_TO_EDGE;
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, wrap);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, wrap);
+
+        for (int level = 0; level < info.mip_count; ++level) {
+            glTexImage2D(GL_TEXTURE_2D, level, GL_RGBA,
+                         mip_size(info.width, level), mip_size(info.height, level), 0,
+                         GL_RGBA, GL_UNSIGNED_BYTE, levels[level]);
+        }
+    }
+
     void flush_batch() {
         if (batch_vertices_.empty()) return;
+        CAFE_PROFILE_SCOPE("Renderer::flush_batch");
 
         glBindVertexArray(vao_);
         glBindBuffer(GL_ARRAY_BUFFER, vbo_);
@@ -469,7 +569,7 @@ private:
             glUseProgram(textured_program_);
             glUniformMatrix4fv(textured_proj_loc_, 1, GL_FALSE, projection_);
             glActiveTexture(GL_TEXTURE0);
-            glBindTexture(GL_TEXTURE_2D, it->second.texture);
+            bind_texture(it->second.texture);
             glUniform1i(textured_sampler_loc_, 0);
         } else {
             glUseProgram(color_program_);
@@ -477,8 +577,43 @@ private:
         }
 
         glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(batch_vertices_.size()));
+        stats_.draw_calls++;
+        stats_.batch_flushes++;
+        stats_.vertices += static_cast<uint32_t>(batch_vertices_.size());
         batch_vertices_.clear();
     }
+
+    // Skip redundant binds (GL keeps the binding across draws)
+    void bind_texture(GLuint texture) {
+        if (texture != bound_texture_) {
+            glBindTexture(GL_TEXTURE_2D, texture);
+            bound_texture_ = texture;
+            stats_.texture_binds++;
+        }
+    }
+
+    // Collect finished timer queries, oldest first; the newest result
+    // becomes gpu_ms. A disjoint event (GPU clock jump) voids them all.
+    void read_gpu_timers() {
+        GLint disjoint = 0;
+        glGetIntegerv(GL_GPU_DISJOINT_EXT, &disjoint);
+
+        for (int i = 1; i <= GPU_QUERIES; ++i) {
+            int index = (gpu_query_index_ + i) % GPU_QUERIES;
+            if (!gpu_pending_[index]) continue;
+
+            GLuint available = 0;
+            glGetQueryObjectuiv(gpu_queries_[index], GL_QUERY_RESULT_AVAILABLE, &available);
+            if (!available) break;
+
+            GLuint elapsed_ns = 0;
+            glGetQueryObjectuiv(gpu_queries_[index], GL_QUERY_RESULT, &elapsed_ns);
+            gpu_pending_[index] = false;
+            if (!disjoint) {
+                stats_.gpu_ms = static_cast<double>(elapsed_ns) * 1e-6;
+            }
+        }
+    }
 };
 
 // ============================================================================
@@ -0,0 +1,55 @@
+#ifndef CAFE_TEST_SCRIPTED_WINDOW_H
+#define CAFE_TEST_SCRIPTED_WINDOW_H
+
+#include "engine/input_recorder.h"
+#include <string>
+
+namespace cafe::test {
+
+// ============================================================================
+// ScriptedWindow - A Window whose input is whatever the test set
+// ============================================================================
+
+class ScriptedWindow : public Window {
+public:
+    InputSnapshot state;
+
+    // Start a frame: edges from the last one are gone
+    void clear_edges() {
+        state.pressed.reset();
+        state.released.reset();
+    }
+
+    void press(Key key) {
+        state.down.set(static_cast<size_t>(key));
+        state.pressed.set(static_cast<size_t>(key));
+    }
+
+    void release(Key key) {
+        state.down.reset(static_cast<size_t>(key));
+        state.released.set(static_cast<size_t>(key));
+    }
+
+    bool is_open() const override { return true; }
+    void close() override {}
+    int width() const override { return 1280; }
+    int height() const override { return 720; }
+    float scale_factor() const override { return 1.0f; }
+    void set_title(const std::string&) override {}
+    void* native_handle() override { return nullptr; }
+
+    bool is_key_down(Key key) const override { return state.down[static_cast<size_t>(key)]; }
+    bool is_key_pressed(Key key) const override { return state.pressed[static_cast<size_t>(key)]; }
+    bool is_key_released(Key key) const override { return state.released[static_cast<size_t>(key)]; }
+    bool is_mouse_button_down(MouseButton button) const override {
+        return (state.buttons >> static_cast<int>(button)) & 1;
+    }
+    float mouse_x() const override { return state.mouse_x; }
+    float mouse_y() const override { return state.mouse_y; }
+
+    void update_input() override {}
+};
+
+} // namespace cafe::test
+
+#endif // CAFE_TEST_SCRIPTED_WINDOW_H
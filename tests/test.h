@@ -0,0 +1,49 @@
+#ifndef CAFE_TEST_H
+#define CAFE_TEST_H
+
+#include <cstdio>
+
+namespace cafe::test {
+
+// ============================================================================
+// Minimal Test Helpers
+// ============================================================================
+//
+// Each test is a small executable registered with ctest. CAFE_CHECK logs a
+// failed condition with its location and keeps going, so one run reports
+// every failure; finish() turns the count into the exit code.
+//
+// Usage:
+//   int main() {
+//       CAFE_CHECK(decode(encode(data)) == data);
+//       return cafe::test::finish("codec");
+//   }
+// ============================================================================
+
+inline int& failures() {
+    static int count = 0;
+    return count;
+}
+
+inline void check(bool ok, const char* expression, const char* file, int line) {
+    if (!ok) {
+        std::fprintf(stderr, "%s:%d: check failed: %s\n", file, line, expression);
+        failures()++;
+    }
+}
+
+inline int finish(const char* name) {
+    if (failures() > 0) {
+        std::fprintf(stderr, "%s: %d check(s) failed\n", name, failures());
+        return 1;
+    }
+    std::printf("%s: ok\n", name);
+    return 0;
+}
+
+} // namespace cafe::test
+
+#define CAFE_CHECK(expression) \
+    ::cafe::test::check(static_cast<bool>(expression), #expression, __FILE__, __LINE__)
+
+#endif // CAFE_TEST_H
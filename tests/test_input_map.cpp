@@ -0,0 +1,128 @@
+#include "test.h"
+#include "scripted_window.h"
+#include "engine/input_map.h"
+#include <string>
+
+// ============================================================================
+// InputMap - compiled action states and callbacks
+// ============================================================================
+//
+// One update() per frame against a ScriptedWindow: ordinary press, hold
+// and release, a tap that starts and ends between two updates, and a
+// callback that registers more callbacks while it runs.
+
+namespace {
+
+struct Counts {
+    int pressed = 0;
+    int released = 0;
+};
+
+void test_press_hold_release() {
+    cafe::test::ScriptedWindow window;
+    cafe::InputMap input;
+    input.set_window(&window);
+    input.define_action("jump").add_key(cafe::Key::Space).add_key(cafe::Key::W);
+
+    Counts counts;
+    input.on_action_pressed("jump", [&] { counts.pressed++; });
+    input.on_action_released("jump", [&] { counts.released++; });
+    cafe::ActionID jump = input.action_id("jump");
+
+    input.update();
+    CAFE_CHECK(!input.is_action_held(jump) && !input.is_action_pressed(jump));
+
+    window.press(cafe::Key::Space);
+    input.update();
+    CAFE_CHECK(input.is_action_held(jump) && input.is_action_pressed(jump));
+    CAFE_CHECK(!input.is_action_released(jump));
+    CAFE_CHECK(counts.pressed == 1 && counts.released == 0);
+
+    // A second binding going down while held is not a new press
+    window.clear_edges();
+    window.press(cafe::Key::W);
+    input.update();
+    CAFE_CHECK(input.is_action_held(jump) && !input.is_action_pressed(jump));
+    CAFE_CHECK(counts.pressed == 1);
+
+    window.clear_edges();
+    window.release(cafe::Key::Space);
+    window.release(cafe::Key::W);
+    input.update();
+    CAFE_CHECK(!input.is_action_held(jump) && input.is_action_released(jump));
+    CAFE_CHECK(counts.pressed == 1 && counts.released == 1);
+
+    window.clear_edges();
+    input.update();
+    CAFE_CHECK(!input.is_action_pressed(jump) && !input.is_action_released(jump));
+}
+
+void test_tap_within_one_frame() {
+    cafe::test::ScriptedWindow window;
+    cafe::InputMap input;
+    input.set_window(&window);
+    input.define_action("serve").add_key(cafe::Key::E);
+    input.define_action("other").add_key(cafe::Key::Q);
+
+    Counts counts;
+    input.on_action_pressed("serve", [&] { counts.pressed++; });
+    input.on_action_released("serve", [&] { counts.released++; });
+    cafe::ActionID serve = input.action_id("serve");
+    cafe::ActionID other = input.action_id("other");
+    input.update();
+
+    // Down and up again before the update: never seen down
+    window.press(cafe::Key::E);
+    window.release(cafe::Key::E);
+    input.update();
+    CAFE_CHECK(input.is_action_pressed(serve));
+    CAFE_CHECK(input.is_action_released(serve));
+    CAFE_CHECK(!input.is_action_held(serve));
+    CAFE_CHECK(counts.pressed == 1 && counts.released == 1);
+    CAFE_CHECK(!input.is_action_pressed(other));
+
+    // The edges last one frame
+    window.clear_edges();
+    input.update();
+    CAFE_CHECK(!input.is_action_pressed(serve) && !input.is_action_released(serve));
+    CAFE_CHECK(counts.pressed == 1 && counts.released == 1);
+}
+
+void test_callback_registers_callbacks() {
+    cafe::test::ScriptedWindow window;
+    cafe::InputMap input;
+    input.set_window(&window);
+
+    // Each press adds listeners to the same action (and defines new
+    // actions), reallocating both callback tables while the caller runs
+    int calls = 0;
+    input.on_action_pressed("order", [&] {
+        calls++;
+        for (int i = 0; i < 16; ++i) {
+            input.on_action_pressed("order", [&] { calls += 100; });
+            input.on_action_pressed("order_" + std::to_string(i), [] {});
+        }
+    });
+    input.define_action("order").add_key(cafe::Key::O);
+
+    window.press(cafe::Key::O);
+    input.update();
+    CAFE_CHECK(calls == 1);     // Listeners added during fire() wait for the next edge
+
+    window.clear_edges();
+    window.release(cafe::Key::O);
+    input.update();
+    window.clear_edges();
+    window.press(cafe::Key::O);
+    input.update();
+    CAFE_CHECK(calls == 1 + 1 + 16 * 100);
+}
+
+} // namespace
+
+int main() {
+    test_press_hold_release();
+    test_tap_within_one_frame();
+    test_callback_registers_callbacks();
+    return cafe::test::finish("input_map");
+}
@@ -0,0 +1,213 @@
+#include "test.h"
+#include "scripted_window.h"
+#include "engine/input_recorder.h"
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+// ============================================================================
+// InputRecorder -> .cinput -> ReplayWindow
+// ============================================================================
+//
+// A scripted 5000-step session (held keys, taps inside one step, mouse
+// drags, button presses, long idle stretches) is recorded through a
+// Window, saved, and played back: every step's InputSnapshot must match
+// the live one bit for bit, on the first replay and after a rewind.
+// Truncated logs must be rejected and corrupt ones must stop cleanly.
+
+namespace {
+
+constexpr int kSteps = 5000;
+constexpr float kFixedDt = 1.0f / 60.0f;
+
+// Next step of the session: mostly idle, with bursts of activity
+cafe::InputSnapshot next_step(std::mt19937& rng, const cafe::InputSnapshot& last) {
+    cafe::InputSnapshot step;
+    step.down = last.down;
+    step.buttons = last.buttons;
+    step.mouse_x = last.mouse_x;
+    step.mouse_y = last.mouse_y;
+
+    if (rng() % 4 != 0) {
+        return step;    // Nothing happens
+    }
+
+    std::uniform_int_distribution<int> any_key(1, cafe::InputSnapshot::KEY_COUNT - 1);
+    switch (rng() % 5) {
+        case 0: {   // Press or release a key
+            int key = any_key(rng);
+            step.down.flip(key);
+            (step.down[key] ? step.pressed : step.released).set(key);
+            break;
+        }
+        case 1: {   // Tap: pressed and released within one step
+            int key = any_key(rng);
+            if (!step.down[key]) {
+                step.pressed.set(key);
+                step.released.set(key);
+            }
+            break;
+        }
+        case 2:     // Drag the mouse (sub-pixel positions must survive)
+            step.mouse_x += std::uniform_real_distribution<float>(-40.0f, 40.0f)(rng);
+            step.mouse_y += std::uniform_real_distribution<float>(-40.0f, 40.0f)(rng);
+            break;
+        case 3:
+            step.buttons ^= static_cast<uint8_t>(1 << (rng() % 3));
+            break;
+        default:    // Several keys at once
+            for (int i = 0; i < 3; ++i) {
+                int key = any_key(rng);
+                step.down.flip(key);
+                (step.down[key] ? step.pressed : step.released).set(key);
+            }
+            break;
+    }
+    return step;
+}
+
+bool same(const cafe::InputSnapshot& a, const cafe::InputSnapshot& b) {
+    return a.down == b.down && a.pressed == b.pressed && a.released == b.released &&
+           a.buttons == b.buttons && std::memcmp(&a.mouse_x, &b.mouse_x, sizeof(float)) == 0 &&
+           std::memcmp(&a.mouse_y, &b.mouse_y, sizeof(float)) == 0;
+}
+
+std::vector<uint8_t> read_file(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    return std::vector<uint8_t>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+// Steps of `replay` that match `expected`, from the current step to the end
+int replay_matches(cafe::ReplayWindow& replay, const std::vector<cafe::InputSnapshot>& expected) {
+    int matched = 0;
+    for (size_t i = 0; replay.is_open() && i < expected.size(); ++i) {
+        cafe::InputSnapshot snapshot;
+        snapshot.capture(replay);
+        if (!same(snapshot, expected[i])) {
+            break;
+        }
+        ++matched;
+        replay.update_input();
+    }
+    return matched;
+}
+
+// Record the session, returning the log bytes and what the game saw
+std::vector<uint8_t> record(const std::string& path, std::vector<cafe::InputSnapshot>& expected) {
+    std::mt19937 rng(2024);
+    cafe::test::ScriptedWindow window;
+    cafe::InputRecorder recorder;
+    recorder.begin(kFixedDt, window.width(), window.height());
+
+    for (int i = 0; i < kSteps; ++i) {
+        window.state = next_step(rng, window.state);
+        recorder.capture(window);
+
+        cafe::InputSnapshot seen;
+        seen.capture(window);
+        expected.push_back(seen);
+    }
+
+    CAFE_CHECK(recorder.step_count() == kSteps);
+    CAFE_CHECK(recorder.save(path));
+    return read_file(path);
+}
+
+void test_replay(const std::string& path, const std::vector<cafe::InputSnapshot>& expected) {
+    cafe::ReplayWindow replay;
+    CAFE_CHECK(replay.open(path));
+    CAFE_CHECK(replay.step_count() == kSteps);
+    CAFE_CHECK(replay.fixed_delta_time() == kFixedDt);
+    CAFE_CHECK(replay.width() == 1280 && replay.height() == 720);
+
+    CAFE_CHECK(replay_matches(replay, expected) == kSteps);
+    CAFE_CHECK(!replay.is_open());
+
+    // A second run sees exactly the same input
+    replay.rewind();
+    CAFE_CHECK(replay_matches(replay, expected) == kSteps);
+    CAFE_CHECK(!replay.is_open());
+}
+
+void test_truncated(const std::vector<uint8_t>& bytes) {
+    for (size_t size : {size_t(0), size_t(4), size_t(31), size_t(32), size_t(33), bytes.size() / 2,
+                        bytes.size() - 1}) {
+        cafe::ReplayWindow replay;
+        CAFE_CHECK(!replay.open(std::vector<uint8_t>(bytes.begin(), bytes.begin() + static_cast<std::ptrdiff_t>(size))));
+        CAFE_CHECK(!replay.is_open());
+    }
+
+    std::vector<uint8_t> longer = bytes;
+    longer.push_back(0);
+    cafe::ReplayWindow replay;
+    CAFE_CHECK(!replay.open(longer));
+}
+
+void test_corrupt(const std::vector<uint8_t>& bytes, const std::vector<cafe::InputSnapshot>& expected) {
+    constexpr size_t kHeader = 32;
+
+    // Bad magic and version
+    for (size_t offset : {size_t(0), size_t(4)}) {
+        std::vector<uint8_t> corrupt = bytes;
+        corrupt[offset] ^= 0xFF;
+        cafe::ReplayWindow replay;
+        CAFE_CHECK(!replay.open(corrupt));
+    }
+
+    // A key index out of range in the first step: nothing to replay
+    {
+        std::vector<uint8_t> corrupt = bytes;
+        corrupt[kHeader] = 0x01;        // Keys changed
+        corrupt[kHeader + 1] = 1;       // One key
+        corrupt[kHeader + 2] = 0xFF;    // Not a key
+        cafe::ReplayWindow replay;
+        CAFE_CHECK(replay.open(corrupt));
+        CAFE_CHECK(replay.step_count() == 0);
+        CAFE_CHECK(!replay.is_open());
+    }
+
+    // Damaged step data: the replay matches the session up to the damage,
+    // then stops or diverges, but never runs past the log or reads past it
+    std::mt19937 rng(5);
+    for (int i = 0; i < 50; ++i) {
+        std::vector<uint8_t> corrupt = bytes;
+        size_t at = kHeader + rng() % (corrupt.size() - kHeader);
+        corrupt[at] = static_cast<uint8_t>(rng());
+
+        cafe::ReplayWindow replay;
+        CAFE_CHECK(replay.open(corrupt));
+        replay_matches(replay, expected);
+
+        uint32_t steps = 0;
+        while (replay.is_open() && steps <= kSteps) {
+            replay.update_input();
+            ++steps;
+        }
+        CAFE_CHECK(!replay.is_open());
+        CAFE_CHECK(replay.step() <= kSteps);
+    }
+}
+
+} // namespace
+
+int main() {
+    std::string path = (std::filesystem::temp_directory_path() / "cafe_test_replay.cinput").string();
+
+    std::vector<cafe::InputSnapshot> expected;
+    std::vector<uint8_t> bytes = record(path, expected);
+    CAFE_CHECK(bytes.size() > 32);
+
+    if (bytes.size() > 32) {
+        test_replay(path, expected);
+        test_truncated(bytes);
+        test_corrupt(bytes, expected);
+    }
+
+    std::remove(path.c_str());
+    return cafe::test::finish("input_replay");
+}
@@ -0,0 +1,123 @@
+#include "test.h"
+#include "engine/isometric.h"
+#include <algorithm>
+#include <random>
+#include <tuple>
+#include <vector>
+
+// ============================================================================
+// TileMap::for_each_visible vs for_each_visible_diagonal
+// ============================================================================
+//
+// Both walks must emit exactly the same tiles at the same screen positions,
+// for viewports that do not start at the screen origin, cameras anywhere
+// (including past the map edges), sparse maps and odd tile sizes. The
+// diagonal walk must also come out in draw order.
+
+namespace {
+
+using TileKey = std::tuple<int, int, float, float>;
+
+std::vector<TileKey> sorted_tiles(const cafe::TileMap& map, const cafe::Rect& viewport) {
+    std::vector<TileKey> tiles;
+    map.for_each_visible(viewport, [&](int x, int y, const cafe::Tile&, float sx, float sy) {
+        tiles.emplace_back(x, y, sx, sy);
+    });
+    std::sort(tiles.begin(), tiles.end());
+    return tiles;
+}
+
+std::vector<TileKey> diagonal_tiles(const cafe::TileMap& map, const cafe::Rect& viewport, bool& in_order) {
+    std::vector<TileKey> tiles;
+    int last_depth = -1;
+    in_order = true;
+    map.for_each_visible_diagonal(viewport, [&](int x, int y, const cafe::Tile&, float sx, float sy) {
+        in_order = in_order && cafe::Isometric::tile_depth(x, y) >= last_depth;
+        last_depth = cafe::Isometric::tile_depth(x, y);
+        tiles.emplace_back(x, y, sx, sy);
+    });
+    std::sort(tiles.begin(), tiles.end());
+    return tiles;
+}
+
+// Every tile set, some raised, about one in five left empty
+cafe::TileMap make_map(int width, int height, std::mt19937& rng) {
+    cafe::TileMap map(width, height);
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            cafe::Tile& tile = map.at(x, y);
+            tile.tile_id = rng() % 5 == 0 ? 0 : 1 + static_cast<int>(rng() % 8);
+            tile.height = static_cast<int>(rng() % 3);
+        }
+    }
+    return map;
+}
+
+bool same_tiles(const cafe::TileMap& map, const cafe::Rect& viewport) {
+    bool in_order = false;
+    std::vector<TileKey> diagonal = diagonal_tiles(map, viewport, in_order);
+    return in_order && diagonal == sorted_tiles(map, viewport) &&
+           static_cast<size_t>(map.count_visible(viewport)) == diagonal.size();
+}
+
+void test_offset_viewports() {
+    std::mt19937 rng(26);
+    cafe::TileMap map = make_map(96, 64, rng);
+    cafe::Isometric::set_tile_size(64.0f, 32.0f);
+    cafe::Isometric::set_camera(-640.0f, 300.0f);
+
+    // A split-screen pane or minimap inset: the viewport starts away from
+    // the origin, so the tile set must follow viewport.x / viewport.y
+    cafe::Rect pane(700.0f, 420.0f, 560.0f, 300.0f);
+    std::vector<TileKey> tiles = sorted_tiles(map, pane);
+    CAFE_CHECK(!tiles.empty());
+    CAFE_CHECK(same_tiles(map, pane));
+
+    for (const TileKey& tile : tiles) {
+        float sx = std::get<2>(tile);
+        float sy = std::get<3>(tile);
+        CAFE_CHECK(sx >= pane.x - 64.0f && sx <= pane.x + pane.width + 64.0f);
+        CAFE_CHECK(sy >= pane.y - 64.0f && sy <= pane.y + pane.height + 64.0f);
+    }
+
+    // The same pane at the origin shows a different part of the map
+    cafe::Rect origin(0.0f, 0.0f, 560.0f, 300.0f);
+    CAFE_CHECK(sorted_tiles(map, origin) != tiles);
+    CAFE_CHECK(same_tiles(map, origin));
+
+    // Negative origins and a viewport entirely off the map
+    CAFE_CHECK(same_tiles(map, cafe::Rect(-333.0f, -211.0f, 800.0f, 450.0f)));
+    cafe::Rect away(1.0e5f, 1.0e5f, 640.0f, 360.0f);
+    CAFE_CHECK(sorted_tiles(map, away).empty());
+    CAFE_CHECK(same_tiles(map, away));
+}
+
+void test_random_viewports() {
+    std::mt19937 rng(2601);
+    std::uniform_real_distribution<float> offset(-2000.0f, 2000.0f);
+    std::uniform_real_distribution<float> size(1.0f, 1500.0f);
+
+    for (int trial = 0; trial < 300; ++trial) {
+        int width = 1 + static_cast<int>(rng() % 80);
+        int height = 1 + static_cast<int>(rng() % 80);
+        cafe::TileMap map = make_map(width, height, rng);
+
+        // Non power of two sizes exercise the float rounding at the edges
+        float tile_width = (trial % 3 == 0) ? 64.0f : 17.0f + static_cast<float>(rng() % 90) * 0.75f;
+        cafe::Isometric::set_tile_size(tile_width, tile_width * 0.5f);
+        cafe::Isometric::set_camera(offset(rng), offset(rng));
+
+        cafe::Rect viewport(offset(rng), offset(rng), size(rng), size(rng));
+        CAFE_CHECK(same_tiles(map, viewport));
+    }
+}
+
+} // namespace
+
+int main() {
+    test_offset_viewports();
+    test_random_viewports();
+    cafe::Isometric::set_tile_size(64.0f, 32.0f);
+    cafe::Isometric::set_camera(0.0f, 0.0f);
+    return cafe::test::finish("isometric");
+}
@@ -0,0 +1,142 @@
+#include "test.h"
+#include "engine/lz4_block.h"
+#include <random>
+#include <string>
+#include <vector>
+
+// ============================================================================
+// lz4::compress / lz4::decompress
+// ============================================================================
+//
+// Round trips over the kinds of payload the cooker produces, and the
+// malformed blocks a damaged .ctex or .cpak can hand to decompress(): it
+// must reject them without reading or writing out of bounds.
+
+namespace {
+
+std::vector<uint8_t> compress(const std::vector<uint8_t>& data) {
+    std::vector<uint8_t> block(cafe::lz4::compress_bound(data.size()));
+    size_t size = cafe::lz4::compress(data.data(), data.size(), block.data(), block.size());
+    block.resize(size);
+    return block;
+}
+
+bool decompress(const std::vector<uint8_t>& block, std::vector<uint8_t>& out, size_t size) {
+    out.assign(size, 0);
+    return cafe::lz4::decompress(block.data(), block.size(), out.data(), size);
+}
+
+bool round_trips(const std::vector<uint8_t>& data) {
+    std::vector<uint8_t> block = compress(data);
+    std::vector<uint8_t> out;
+    return !block.empty() && decompress(block, out, data.size()) && out == data;
+}
+
+std::vector<uint8_t> random_bytes(std::mt19937& rng, size_t size) {
+    std::vector<uint8_t> data(size);
+    for (uint8_t& byte : data) {
+        byte = static_cast<uint8_t>(rng());
+    }
+    return data;
+}
+
+// Runs of one byte (overlapping matches) mixed with repeated phrases
+std::vector<uint8_t> run_heavy(std::mt19937& rng, size_t size) {
+    std::vector<uint8_t> data;
+    while (data.size() < size) {
+        size_t length = 1 + rng() % 600;
+        if (rng() % 2) {
+            data.insert(data.end(), length, static_cast<uint8_t>(rng()));
+        } else {
+            for (size_t i = 0; i < length; ++i) {
+                data.push_back(static_cast<uint8_t>("barista latte "[i % 14]));
+            }
+        }
+    }
+    data.resize(size);
+    return data;
+}
+
+void test_round_trips() {
+    std::mt19937 rng(1234);
+
+    CAFE_CHECK(round_trips({}));
+    for (size_t size = 1; size <= 64; ++size) {
+        CAFE_CHECK(round_trips(random_bytes(rng, size)));
+        CAFE_CHECK(round_trips(std::vector<uint8_t>(size, 0x5A)));
+    }
+
+    CAFE_CHECK(round_trips(random_bytes(rng, 100000)));
+    CAFE_CHECK(round_trips(run_heavy(rng, 100000)));
+    CAFE_CHECK(round_trips(std::vector<uint8_t>(200000, 0)));    // Long length runs
+
+    // Matches further back than the 64 KB window must not be used
+    std::vector<uint8_t> far = random_bytes(rng, 70000);
+    std::vector<uint8_t> repeated = far;
+    repeated.insert(repeated.end(), far.begin(), far.end());
+    CAFE_CHECK(round_trips(repeated));
+
+    // Compressible data shrinks, incompressible stays within the bound
+    CAFE_CHECK(compress(std::vector<uint8_t>(100000, 7)).size() < 1000);
+    CAFE_CHECK(compress(random_bytes(rng, 100000)).size() <= cafe::lz4::compress_bound(100000));
+
+    // Too small a destination is refused
+    std::vector<uint8_t> data = random_bytes(rng, 1000);
+    std::vector<uint8_t> small(cafe::lz4::compress_bound(data.size()) - 1);
+    CAFE_CHECK(cafe::lz4::compress(data.data(), data.size(), small.data(), small.size()) == 0);
+}
+
+void test_truncated() {
+    std::mt19937 rng(99);
+    std::vector<uint8_t> out;
+
+    for (const std::vector<uint8_t>& data : {random_bytes(rng, 3000), run_heavy(rng, 3000)}) {
+        std::vector<uint8_t> block = compress(data);
+        for (size_t cut = 0; cut < block.size(); ++cut) {
+            std::vector<uint8_t> truncated(block.begin(), block.begin() + static_cast<std::ptrdiff_t>(cut));
+            CAFE_CHECK(!decompress(truncated, out, data.size()));
+        }
+
+        // The wrong decompressed size is corrupt input too
+        CAFE_CHECK(!decompress(block, out, data.size() - 1));
+        CAFE_CHECK(!decompress(block, out, data.size() + 1));
+    }
+}
+
+void test_bad_offsets() {
+    std::vector<uint8_t> out;
+
+    // 1 literal 'A', match of 4 at `offset`, then 5 literals
+    auto block = [](uint8_t offset_low, uint8_t offset_high) {
+        return std::vector<uint8_t>{0x10, 'A', offset_low, offset_high, 0x50, 'l', 'a', 't', 't', 'e'};
+    };
+
+    CAFE_CHECK(decompress(block(1, 0), out, 10));
+    CAFE_CHECK(std::string(out.begin(), out.end()) == "AAAAAlatte");
+
+    CAFE_CHECK(!decompress(block(0, 0), out, 10));        // Zero offset
+    CAFE_CHECK(!decompress(block(2, 0), out, 10));        // One byte before the start
+    CAFE_CHECK(!decompress(block(0xFF, 0xFF), out, 10));  // Far before the start
+
+    // A match as the very first sequence has nothing to copy from
+    CAFE_CHECK(!decompress({0x00, 0x01, 0x00, 0x50, 'l', 'a', 't', 't', 'e'}, out, 9));
+
+    // A length continuation that runs off the end
+    CAFE_CHECK(!decompress({0xF0, 0xFF, 0xFF}, out, 300));
+
+    // Random garbage is rejected or decoded, never read past
+    std::mt19937 rng(7);
+    for (int i = 0; i < 2000; ++i) {
+        std::vector<uint8_t> garbage = random_bytes(rng, 1 + rng() % 64);
+        decompress(garbage, out, rng() % 256);
+    }
+}
+
+} // namespace
+
+int main() {
+    test_round_trips();
+    test_truncated();
+    test_bad_offsets();
+    return cafe::test::finish("lz4_block");
+}
@@ -0,0 +1,215 @@
+#include "test.h"
+#include "audio/music_stream.h"
+#include "audio/qoa.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+// ============================================================================
+// QOA encode / decode
+// ============================================================================
+//
+// A round trip stays close to the input, and corrupt or hostile frames -
+// extreme LMS weights, maximum residuals, random bytes - decode without
+// overflowing or reading past the frame. A corrupt file played through
+// MusicStream stops instead of crashing.
+
+namespace {
+
+constexpr int kRate = 44100;
+
+std::vector<int16_t> test_tone(uint32_t frames, int channels) {
+    std::mt19937 rng(3);
+    std::vector<int16_t> pcm(static_cast<size_t>(frames) * channels);
+    for (uint32_t i = 0; i < frames; ++i) {
+        for (int c = 0; c < channels; ++c) {
+            double t = static_cast<double>(i) / kRate;
+            double v = 12000.0 * std::sin(2.0 * 3.14159265 * (220.0 + 110.0 * c) * t) +
+                       static_cast<double>(static_cast<int>(rng() % 2001) - 1000);
+            pcm[static_cast<size_t>(i) * channels + c] = static_cast<int16_t>(v);
+        }
+    }
+    return pcm;
+}
+
+// Decode every frame of a .qoa file; false at the first bad frame
+bool decode_all(const std::vector<uint8_t>& file, std::vector<int16_t>& pcm) {
+    uint32_t samples = 0;
+    if (!cafe::qoa::read_file_header(file.data(), file.size(), samples)) return false;
+
+    pcm.clear();
+    size_t offset = cafe::qoa::FILE_HEADER_SIZE;
+    while (offset < file.size()) {
+        cafe::qoa::FrameHeader header;
+        if (!cafe::qoa::read_frame_header(file.data() + offset, file.size() - offset, header)) return false;
+
+        std::vector<int16_t> frame(static_cast<size_t>(header.samples) * header.channels);
+        if (!cafe::qoa::decode_frame(file.data() + offset, file.size() - offset, header, frame.data())) {
+            return false;
+        }
+        pcm.insert(pcm.end(), frame.begin(), frame.end());
+        offset += header.size;
+    }
+    return true;
+}
+
+void test_round_trip() {
+    for (int channels : {1, 2}) {
+        const uint32_t frames = cafe::qoa::FRAME_LEN * 2 + 777;    // Short last frame and slice
+        std::vector<int16_t> pcm = test_tone(frames, channels);
+
+        std::vector<uint8_t> file;
+        CAFE_CHECK(cafe::qoa::encode(pcm.data(), frames, channels, kRate, file));
+
+        std::vector<int16_t> decoded;
+        CAFE_CHECK(decode_all(file, decoded));
+        CAFE_CHECK(decoded.size() == pcm.size());
+        if (decoded.size() != pcm.size()) continue;
+
+        double error = 0.0;
+        for (size_t i = 0; i < pcm.size(); ++i) {
+            double diff = static_cast<double>(pcm[i]) - decoded[i];
+            error += diff * diff;
+        }
+        double rms = std::sqrt(error / static_cast<double>(pcm.size()));
+        CAFE_CHECK(rms < 600.0);    // Lossy, but well under the signal's ~8500
+    }
+
+    // A full-scale square wave pushes the encoder's residuals to the limit
+    std::vector<int16_t> square(cafe::qoa::FRAME_LEN);
+    for (size_t i = 0; i < square.size(); ++i) {
+        square[i] = (i / 7) % 2 ? 32767 : -32768;
+    }
+    std::vector<uint8_t> file;
+    std::vector<int16_t> decoded;
+    CAFE_CHECK(cafe::qoa::encode(square.data(), static_cast<uint32_t>(square.size()), 1, kRate, file));
+    CAFE_CHECK(decode_all(file, decoded));
+}
+
+// One mono frame with hand-picked LMS state and every slice set to `slice`
+std::vector<uint8_t> hostile_frame(uint64_t history, uint64_t weights, uint64_t slice) {
+    const int samples = cafe::qoa::FRAME_LEN;
+    std::vector<uint8_t> frame;
+    auto put = [&frame](uint64_t v) {
+        for (int i = 7; i >= 0; --i) frame.push_back(static_cast<uint8_t>(v >> (i * 8)));
+    };
+    size_t size = cafe::qoa::frame_size(1, samples);
+    put((uint64_t{1} << 56) | (uint64_t{kRate} << 32) | (uint64_t(samples) << 16) | size);
+    put(history);
+    put(weights);
+    for (int s = 0; s < cafe::qoa::SLICES_PER_FRAME; ++s) put(slice);
+    return frame;
+}
+
+void test_hostile_frames() {
+    // Largest weights and history, largest residuals of alternating sign:
+    // the LMS weights run away from 16 bits within the frame
+    const uint64_t kMax = 0x7FFF7FFF7FFF7FFFull;
+    const uint64_t kMixed = 0x7FFF80007FFF8000ull;
+    const uint64_t kMin = 0x8000800080008000ull;
+    const uint64_t kSlices[] = {
+        0xFFFFFFFFFFFFFFFFull,      // Scale 15, code 7 (-7) every sample
+        0xF249249249249249ull,      // Scale 15, alternating codes
+        0xF000000000000000ull,      // Scale 15, code 0
+    };
+
+    for (uint64_t history : {kMax, kMixed, kMin}) {
+        for (uint64_t weights : {kMax, kMixed, kMin}) {
+            for (uint64_t slice : kSlices) {
+                std::vector<uint8_t> frame = hostile_frame(history, weights, slice);
+                cafe::qoa::FrameHeader header;
+                CAFE_CHECK(cafe::qoa::read_frame_header(frame.data(), frame.size(), header));
+
+                std::vector<int16_t> out(static_cast<size_t>(header.samples));
+                CAFE_CHECK(cafe::qoa::decode_frame(frame.data(), frame.size(), header, out.data()));
+
+                // Truncated: refused before reading past the bytes given
+                CAFE_CHECK(!cafe::qoa::decode_frame(frame.data(), frame.size() - 1, header, out.data()));
+            }
+        }
+    }
+
+    // Random payloads behind a valid header
+    std::mt19937 rng(11);
+    for (int i = 0; i < 200; ++i) {
+        std::vector<uint8_t> frame = hostile_frame(0, 0, 0);
+        for (size_t b = cafe::qoa::FRAME_HEADER_SIZE; b < frame.size(); ++b) {
+            frame[b] = static_cast<uint8_t>(rng());
+        }
+        cafe::qoa::FrameHeader header;
+        CAFE_CHECK(cafe::qoa::read_frame_header(frame.data(), frame.size(), header));
+        std::vector<int16_t> out(static_cast<size_t>(header.samples));
+        CAFE_CHECK(cafe::qoa::decode_frame(frame.data(), frame.size(), header, out.data()));
+    }
+
+    // Headers that lie about the frame are rejected
+    std::vector<uint8_t> frame = hostile_frame(0, 0, 0);
+    frame[0] = 0;                               // No channels
+    cafe::qoa::FrameHeader header;
+    CAFE_CHECK(!cafe::qoa::read_frame_header(frame.data(), frame.size(), header));
+}
+
+void test_corrupt_file() {
+    const uint32_t frames = cafe::qoa::FRAME_LEN * 3;
+    std::vector<int16_t> pcm = test_tone(frames, 2);
+    std::vector<uint8_t> file;
+    CAFE_CHECK(cafe::qoa::encode(pcm.data(), frames, 2, kRate, file));
+
+    // Hostile LMS state in the second frame, and its size field broken in
+    // the third: the stream plays, then stops at the bad frame
+    size_t second = cafe::qoa::FILE_HEADER_SIZE + cafe::qoa::frame_size(2, cafe::qoa::FRAME_LEN);
+    for (size_t b = second + cafe::qoa::FRAME_HEADER_SIZE; b < second + cafe::qoa::FRAME_HEADER_SIZE + 32; ++b) {
+        file[b] = (b % 2) ? 0xFF : 0x7F;
+    }
+    for (size_t b = second + cafe::qoa::FRAME_HEADER_SIZE + 32; b < second + 512; ++b) {
+        file[b] = 0xFF;
+    }
+    size_t third = second + cafe::qoa::frame_size(2, cafe::qoa::FRAME_LEN);
+    file[third + 7] ^= 0x55;
+
+    std::vector<int16_t> decoded;
+    CAFE_CHECK(!decode_all(file, decoded));
+
+    std::string path = (std::filesystem::temp_directory_path() / "cafe_test_corrupt.qoa").string();
+    FILE* out = std::fopen(path.c_str(), "wb");
+    CAFE_CHECK(out != nullptr);
+    if (!out) return;
+    std::fwrite(file.data(), 1, file.size(), out);
+    std::fclose(out);
+
+    cafe::MusicStream stream(48000);
+    CAFE_CHECK(stream.open(path, false));
+
+    // Pull samples like the audio thread until the stream gives up
+    std::vector<float> buffer(2 * 512);
+    size_t total = 0;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(20);
+    while (!stream.finished() && std::chrono::steady_clock::now() < deadline) {
+        size_t got = stream.read(buffer.data(), 512);
+        total += got;
+        if (got == 0) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    CAFE_CHECK(stream.finished());
+    CAFE_CHECK(total > 0);
+    CAFE_CHECK(total < static_cast<size_t>(frames) * 48000 / kRate + 1024);    // Stopped early
+    for (float sample : buffer) {
+        CAFE_CHECK(std::isfinite(sample));
+    }
+
+    stream.close();
+    std::remove(path.c_str());
+}
+
+} // namespace
+
+int main() {
+    test_round_trip();
+    test_hostile_frames();
+    test_corrupt_file();
+    return cafe::test::finish("qoa");
+}
@@ -0,0 +1,132 @@
+// ============================================================================
+// cafe_cook - Offline texture and sprite manifest cooker
+// ============================================================================
+//
+// Converts source images (PNG, JPG, TGA, BMP) into GPU-ready .ctex files
+// next to them, which ResourceManager then loads instead of the source.
+// Sprite manifests (.sheets) are cooked into .csheets the same way.
+// Files whose cooked copy is newer than the source are skipped.
+//
+// Usage:
+//   cafe_cook [options] <file or directory>...
+//
+//   --no-mipmaps   Store level 0 only
+//   --linear-mips  Average mip levels as stored (no sRGB decode)
+//   --premultiply  Premultiply alpha
+//   --lz4          LZ4-compress levels (smaller files, small decode cost)
+//   --force        Re-cook even if up to date
+//
+// ============================================================================
+
+#include "engine/cooked_texture.h"
+#include "engine/sprite_manifest.h"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+std::string lower_extension(const fs::path& path) {
+    std::string ext = path.extension().string();
+    std::transform(ext.begin(), ext.end(), ext.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return ext;
+}
+
+bool is_source_image(const fs::path& path) {
+    std::string ext = lower_extension(path);
+    return ext == ".png" || ext == ".jpg" || ext == ".jpeg" || ext == ".tga" || ext == ".bmp";
+}
+
+bool is_sprite_manifest(const fs::path& path) {
+    return lower_extension(path) == ".sheets";
+}
+
+bool is_up_to_date(const fs::path& source, const fs::path& cooked) {
+    std::error_code error;
+    auto cooked_time = fs::last_write_time(cooked, error);
+    if (error) return false;
+    auto source_time = fs::last_write_time(source, error);
+    return !error && cooked_time >= source_time;
+}
+
+void print_usage() {
+    std::cerr << "Usage: cafe_cook [--no-mipmaps] [--linear-mips] [--premultiply] [--lz4] [--force] "
+                 "<file or directory>...\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    cafe::CookOptions options;
+    bool force = false;
+    std::vector<fs::path> inputs;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--no-mipmaps") == 0) {
+            options.mipmaps = false;
+        } else if (std::strcmp(argv[i], "--linear-mips") == 0) {
+            options.gamma_correct = false;
+        } else if (std::strcmp(argv[i], "--premultiply") == 0) {
+            options.premultiply = true;
+        } else if (std::strcmp(argv[i], "--lz4") == 0) {
+            options.compress = true;
+        } else if (std::strcmp(argv[i], "--force") == 0) {
+            force = true;
+        } else if (argv[i][0] == '-') {
+            print_usage();
+            return 1;
+        } else {
+            inputs.emplace_back(argv[i]);
+        }
+    }
+    if (inputs.empty()) {
+        print_usage();
+        return 1;
+    }
+
+    // Expand directories
+    std::vector<fs::path> sources;
+    for (const fs::path& input : inputs) {
+        std::error_code error;
+        if (fs::is_directory(input, error)) {
+            for (const auto& entry : fs::recursive_directory_iterator(input, error)) {
+                if (entry.is_regular_file() &&
+                    (is_source_image(entry.path()) || is_sprite_manifest(entry.path()))) {
+                    sources.push_back(entry.path());
+                }
+            }
+        } else {
+            sources.push_back(input);
+        }
+    }
+    std::sort(sources.begin(), sources.end());
+
+    int cooked = 0, skipped = 0, failed = 0;
+    for (const fs::path& source : sources) {
+        bool manifest = is_sprite_manifest(source);
+        fs::path target = manifest ? cafe::SpriteManifest::cooked_path(source.string())
+                                   : cafe::CookedTexture::cooked_path(source.string());
+        if (!force && is_up_to_date(source, target)) {
+            skipped++;
+            continue;
+        }
+        bool ok = manifest ? cafe::SpriteManifest::cook_file(source.string(), target.string())
+                           : cafe::CookedTexture::cook_file(source.string(), target.string(), options);
+        if (ok) {
+            std::cout << source.string() << " -> " << target.string() << "\n";
+            cooked++;
+        } else {
+            failed++;
+        }
+    }
+
+    std::cout << cooked << " cooked, " << skipped << " up to date, " << failed << " failed\n";
+    return failed == 0 ? 0 : 1;
+}
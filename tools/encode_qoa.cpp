@@ -0,0 +1,87 @@
+// ============================================================================
+// cafe_qoa - WAV to QOA music encoder
+// ============================================================================
+//
+// Converts a WAV file (any format load_wav reads) to .qoa, the compressed
+// format MusicStream decodes while it plays: 3.2 bits per sample, about a
+// fifth of 16-bit WAV. Prints the size and the signal-to-noise ratio of
+// the result, decoded back.
+//
+// Usage:
+//   cafe_qoa <in.wav> <out.qoa>
+//
+// ============================================================================
+
+#include "audio/qoa.h"
+#include "audio/wav.h"
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Decode `data` again and compare with the input
+double signal_to_noise_db(const std::vector<int16_t>& samples, const std::vector<uint8_t>& data) {
+    std::vector<int16_t> frame(static_cast<size_t>(cafe::qoa::FRAME_LEN) * cafe::qoa::MAX_CHANNELS);
+    double signal = 0.0;
+    double noise = 0.0;
+    size_t index = 0;
+
+    size_t pos = cafe::qoa::FILE_HEADER_SIZE;
+    cafe::qoa::FrameHeader header;
+    while (pos < data.size() &&
+           cafe::qoa::read_frame_header(data.data() + pos, data.size() - pos, header) &&
+           cafe::qoa::decode_frame(data.data() + pos, data.size() - pos, header, frame.data())) {
+        size_t count = static_cast<size_t>(header.samples) * static_cast<size_t>(header.channels);
+        for (size_t i = 0; i < count && index < samples.size(); ++i, ++index) {
+            double s = samples[index];
+            double e = s - frame[i];
+            signal += s * s;
+            noise += e * e;
+        }
+        pos += header.size;
+    }
+    return noise > 0.0 ? 10.0 * std::log10(signal / noise) : 99.0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc != 3 || argv[1][0] == '-') {
+        std::cerr << "Usage: cafe_qoa <in.wav> <out.qoa>\n";
+        return 1;
+    }
+
+    cafe::AudioClip clip;
+    if (!cafe::load_wav(argv[1], clip)) {
+        return 1;
+    }
+
+    std::vector<int16_t> samples(clip.samples.size());
+    for (size_t i = 0; i < samples.size(); ++i) {
+        float s = clip.samples[i] < -1.0f ? -1.0f : (clip.samples[i] > 1.0f ? 1.0f : clip.samples[i]);
+        samples[i] = static_cast<int16_t>(std::lround(s * 32767.0f));
+    }
+
+    std::vector<uint8_t> data;
+    if (!cafe::qoa::encode(samples.data(), static_cast<uint32_t>(clip.frames()), clip.channels,
+                           clip.sample_rate, data)) {
+        return 1;
+    }
+
+    std::FILE* file = std::fopen(argv[2], "wb");
+    bool ok = file && std::fwrite(data.data(), 1, data.size(), file) == data.size();
+    if (file) ok = std::fclose(file) == 0 && ok;
+    if (!ok) {
+        std::cerr << "cafe_qoa: Cannot write " << argv[2] << "\n";
+        return 1;
+    }
+
+    double pcm_bytes = static_cast<double>(samples.size()) * 2.0;
+    std::printf("%s: %.1f s, %d ch, %d Hz -> %zu bytes (%.1f%% of 16-bit PCM), SNR %.1f dB\n",
+                argv[2], clip.duration(), clip.channels, clip.sample_rate, data.size(),
+                100.0 * static_cast<double>(data.size()) / pcm_bytes, signal_to_noise_db(samples, data));
+    return 0;
+}
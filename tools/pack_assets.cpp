@@ -0,0 +1,94 @@
+// ============================================================================
+// cafe_pack - Asset archive packer
+// ============================================================================
+//
+// Packs every file under an asset directory into one .cpak archive, with
+// paths relative to that directory ("sprites/barista.png"), which is how
+// ResourceManager looks them up once the archive is mounted. Run cafe_cook
+// first to include cooked textures.
+//
+// Usage:
+//   cafe_pack [--lz4] [--no-sources] <asset directory> <output.cpak>
+//   cafe_pack --list <archive.cpak>
+//
+//   --lz4         LZ4-compress entries that shrink (PNG/JPG rarely do)
+//   --no-sources  Skip source images that have a cooked .ctex next to them
+//
+// ============================================================================
+
+#include "engine/asset_archive.h"
+#include "engine/cooked_texture.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace {
+
+void print_usage() {
+    std::cerr << "Usage: cafe_pack [--lz4] [--no-sources] <asset directory> <output.cpak>\n"
+                 "       cafe_pack --list <archive.cpak>\n";
+}
+
+int list_archive(const std::string& path) {
+    cafe::AssetArchive archive;
+    if (!archive.open(path)) {
+        return 1;
+    }
+
+    std::vector<std::string> paths = archive.paths();
+    std::sort(paths.begin(), paths.end());
+    for (const std::string& entry : paths) {
+        std::cout << archive.entry_size(entry) << "\t" << entry << "\n";
+    }
+    std::cout << paths.size() << " entries\n";
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    cafe::PackOptions options;
+    bool skip_sources = false;
+    std::vector<std::string> args;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--list") == 0 && i + 1 < argc) {
+            return list_archive(argv[i + 1]);
+        } else if (std::strcmp(argv[i], "--lz4") == 0) {
+            options.compress = true;
+        } else if (std::strcmp(argv[i], "--no-sources") == 0) {
+            skip_sources = true;
+        } else if (argv[i][0] == '-') {
+            print_usage();
+            return 1;
+        } else {
+            args.emplace_back(argv[i]);
+        }
+    }
+    if (args.size() != 2) {
+        print_usage();
+        return 1;
+    }
+
+    std::vector<cafe::ArchiveInput> inputs = cafe::AssetArchive::list_directory(args[0]);
+
+    if (skip_sources) {
+        std::unordered_set<std::string> cooked;
+        for (const auto& input : inputs) {
+            cooked.insert(input.path);
+        }
+        inputs.erase(std::remove_if(inputs.begin(), inputs.end(), [&](const cafe::ArchiveInput& input) {
+            std::string target = cafe::CookedTexture::cooked_path(input.path);
+            return target != input.path && cooked.count(target) > 0;
+        }), inputs.end());
+    }
+
+    if (!cafe::AssetArchive::pack(args[1], inputs, options)) {
+        return 1;
+    }
+    std::cout << "Packed " << inputs.size() << " files into " << args[1] << "\n";
+    return 0;
+}
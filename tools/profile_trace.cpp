@@ -0,0 +1,38 @@
+// ============================================================================
+// cafe_trace - Profiler capture viewer
+// ============================================================================
+//
+// Prints the per-zone summary of a .cprof capture (saved by
+// ProfileCapture::save, or by the demo with CAFE_PROFILE=<path>) and
+// optionally converts it to Chrome trace JSON for chrome://tracing or
+// ui.perfetto.dev.
+//
+// Usage:
+//   cafe_trace <capture.cprof> [trace.json]
+//
+// ============================================================================
+
+#include "engine/profiler.h"
+#include <iostream>
+#include <string>
+
+int main(int argc, char** argv) {
+    if (argc < 2 || argc > 3 || argv[1][0] == '-') {
+        std::cerr << "Usage: cafe_trace <capture.cprof> [trace.json]\n";
+        return 1;
+    }
+
+    cafe::ProfileCapture capture;
+    if (!capture.load(argv[1])) {
+        return 1;
+    }
+    capture.print_summary(std::cout);
+
+    if (argc == 3) {
+        if (!capture.write_chrome_trace(argv[2])) {
+            return 1;
+        }
+        std::cout << "Wrote " << capture.events.size() << " zones to " << argv[2] << "\n";
+    }
+    return 0;
+}